@@ -0,0 +1,186 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace NWQEC
+{
+    /**
+     * @brief RZ angle split into a small residual rotation and an exact Clifford+T correction
+     *
+     * Up to global phase, RZ(angle) = T^t_count · RZ(residual) when not reflected, and
+     * RZ(angle) = T^t_count · X · RZ(residual) · X when reflected, with residual in [0, π/8].
+     */
+    struct CanonicalRz
+    {
+        double residual;
+        unsigned t_count; // Power of T in [0, 8)
+        bool reflected;
+    };
+
+    /**
+     * @brief Reduce an RZ angle modulo π/4, folding (π/8, π/4) onto [0, π/8) by X conjugation
+     *
+     * Angles that differ by multiples of π/4 or only in sign share a residual, so only
+     * residuals need to be synthesized.
+     */
+    inline CanonicalRz canonicalize_rz_angle(double angle)
+    {
+        const double quarter = M_PI_4;
+        double phi = std::fmod(angle, 2 * M_PI);
+        if (phi < 0)
+            phi += 2 * M_PI;
+
+        double steps = std::floor(phi / quarter);
+        double residual = phi - steps * quarter;
+        unsigned t_count = static_cast<unsigned>(steps) & 7u;
+        if (residual >= quarter) // Guard against rounding at the step boundary
+        {
+            residual -= quarter;
+            t_count = (t_count + 1) & 7u;
+        }
+        if (residual < 0)
+            residual = 0;
+
+        // RZ(r) = T · RZ(r - π/4) = T · X · RZ(π/4 - r) · X
+        bool reflected = false;
+        if (residual > quarter / 2)
+        {
+            residual = quarter - residual;
+            t_count = (t_count + 1) & 7u;
+            reflected = true;
+        }
+        return CanonicalRz{residual, t_count, reflected};
+    }
+
+    /**
+     * @brief Coarse class of a synthesis tolerance: floor(log2(epsilon))
+     *
+     * A merged group is synthesized at the tightest tolerance of its members, so
+     * angles are only merged when their tolerances are within a factor of two.
+     */
+    inline int tolerance_bucket(double epsilon)
+    {
+        if (!(epsilon > 0.0) || !std::isfinite(epsilon))
+            return std::numeric_limits<int>::min();
+        return std::ilogb(epsilon);
+    }
+
+    /**
+     * @brief Interns RZ angles into groups that agree to a fixed number of significant digits
+     *
+     * Two angles share a group exactly when their decimal renderings, rounded to
+     * sig_digits significant digits and printed in fixed notation with
+     * max(0, sig_digits - 1 - order) decimals, are identical. The rendering is
+     * encoded as an integer key instead of a string so lookups are O(1) hash
+     * probes. The first angle seen in a group is kept as its representative.
+     * An optional bucket further separates angles that render equally.
+     */
+    class AngleTable
+    {
+    public:
+        // Sentinel for operations that carry no grouped angle
+        static constexpr size_t NO_ANGLE = std::numeric_limits<size_t>::max();
+
+        explicit AngleTable(int sig_digits = 4) : sig_digits_(sig_digits) {}
+
+        /**
+         * @brief Return the group index of an angle, creating the group if needed
+         */
+        size_t intern(double angle, int bucket = 0)
+        {
+            Key key = quantize(angle);
+            key.bucket = bucket;
+            auto [it, inserted] = index_.emplace(key, angles_.size());
+            if (inserted)
+                angles_.push_back(angle);
+            return it->second;
+        }
+
+        /**
+         * @brief Representative angle of each group, in first-seen order
+         */
+        const std::vector<double> &angles() const { return angles_; }
+        std::vector<double> take_angles()
+        {
+            index_.clear();
+            return std::move(angles_);
+        }
+
+        size_t size() const { return angles_.size(); }
+        void reserve(size_t n) { index_.reserve(n); }
+
+    private:
+        struct Key
+        {
+            int64_t mantissa; // Printed digits with the decimal point removed
+            int32_t exponent; // Trailing zeros stripped from integer renderings
+            int16_t decimals; // Digits printed after the decimal point
+            bool negative;
+            int32_t bucket = 0;
+
+            bool operator==(const Key &o) const
+            {
+                return mantissa == o.mantissa && exponent == o.exponent &&
+                       decimals == o.decimals && negative == o.negative && bucket == o.bucket;
+            }
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key &k) const
+            {
+                uint64_t h = static_cast<uint64_t>(k.mantissa) * 0x9E3779B97F4A7C15ULL;
+                h ^= (static_cast<uint64_t>(static_cast<uint32_t>(k.exponent)) << 20) ^
+                     (static_cast<uint64_t>(static_cast<uint16_t>(k.decimals)) << 4) ^
+                     static_cast<uint64_t>(k.negative) ^
+                     (static_cast<uint64_t>(static_cast<uint32_t>(k.bucket)) << 40);
+                return static_cast<size_t>(h ^ (h >> 29));
+            }
+        };
+
+        int sig_digits_;
+        std::vector<double> angles_;
+        std::unordered_map<Key, size_t, KeyHash> index_;
+
+        Key quantize(double angle) const
+        {
+            if (angle == 0.0)
+                return Key{0, 0, static_cast<int16_t>(std::max(0, sig_digits_ - 1)), false};
+
+            if (!std::isfinite(angle))
+            {
+                // Only identical bit patterns group together
+                int64_t bits;
+                std::memcpy(&bits, &angle, sizeof(bits));
+                return Key{bits, 0, -1, false};
+            }
+
+            // Same rounding steps as the fixed-notation rendering
+            double abs_angle = std::abs(angle);
+            int order = static_cast<int>(std::floor(std::log10(abs_angle)));
+            double scaled = abs_angle / std::pow(10, order - (sig_digits_ - 1));
+            int64_t digits = static_cast<int>(std::round(scaled));
+
+            int decimals = std::max(0, (sig_digits_ - 1) - order);
+            int32_t exponent = 0;
+            if (decimals == 0)
+            {
+                // Integer rendering: digits * 10^(order - sig_digits + 1), canonicalized
+                // so equal integers from neighbouring orders map to the same key
+                exponent = order - (sig_digits_ - 1);
+                while (digits != 0 && digits % 10 == 0)
+                {
+                    digits /= 10;
+                    ++exponent;
+                }
+            }
+            return Key{digits, exponent, static_cast<int16_t>(decimals), angle < 0};
+        }
+    };
+
+} // namespace NWQEC
@@ -8,6 +8,9 @@
 #include <iostream>
 #include <unordered_map>
 #include <algorithm>
+#include <array>
+#include <cassert>
+#include <iterator>
 
 namespace NWQEC
 {
@@ -32,6 +35,23 @@ namespace NWQEC
         }
     };
 
+    /**
+     * @brief Run of parameterless single-qubit gates, validated once and appended in bulk
+     *
+     * Used for sequences that are expanded many times, such as one
+     * synthesized RZ angle shared by every RZ in its group.
+     */
+    struct GateBlock
+    {
+        std::vector<Operation::Type> types;
+        std::array<size_t, Operation::NUM_TYPES> type_counts{}; // Gates of each type
+        bool clifford_t = true;                                // Every gate is Clifford+T
+
+        void push_back(Operation::Type type);
+        size_t size() const { return types.size(); }
+        bool empty() const { return types.empty(); }
+    };
+
     /**
      * Represents a flattened quantum circuit with only elementary gates
      */
@@ -59,12 +79,88 @@ namespace NWQEC
         // Basis statistics from last basis_aware_depth calculation
         mutable BasisStatistics basis_stats;
 
+        // Operation counts kept in step with operations. P4/P8/P16 are also
+        // split by sign and axis, which change their printed name.
+        std::array<size_t, Operation::NUM_TYPES> type_counts{};
+        std::array<size_t, 12> pn_counts{};
+
+        // Gate sequences of the RZ_SEQ placeholders, shared with circuits copied
+        // from this one; type_counts count their gates, not the placeholders
+        std::shared_ptr<const std::vector<GateBlock>> rz_sequence_table;
+        size_t rz_sequence_ops = 0;   // RZ_SEQ placeholders among operations
+        size_t rz_sequence_gates = 0; // Gates they stand for
+
+        static size_t pn_slot(Operation::Type type, bool dagger, bool x_rotation)
+        {
+            return (static_cast<size_t>(type) - static_cast<size_t>(Operation::Type::P4)) * 4 +
+                   (dagger ? 2 : 0) + (x_rotation ? 1 : 0);
+        }
+
+        static bool is_pn(Operation::Type type)
+        {
+            return type == Operation::Type::P4 || type == Operation::Type::P8 || type == Operation::Type::P16;
+        }
+
+        // Depth, duration and count_ops results, valid until the next mutation
+        struct StatsCache
+        {
+            bool depth_valid = false;
+            size_t depth = 0;
+            bool duration_valid = false;
+            double duration_distance = 0.0;
+            double duration = 0.0;
+            bool counts_valid = false;
+            std::unordered_map<std::string, size_t> counts;
+        };
+        mutable StatsCache stats_cache;
+
+        void invalidate_stats()
+        {
+            stats_cache.depth_valid = false;
+            stats_cache.duration_valid = false;
+            stats_cache.counts_valid = false;
+        }
+
+        // Dense per-qubit frontier; qubit indices are below num_qubits except
+        // after update_qubit_and_bit_counts, so grow on demand
+        template <typename T>
+        static T &frontier_at(std::vector<T> &frontier, size_t qubit)
+        {
+            if (qubit >= frontier.size())
+                frontier.resize(qubit + 1, T());
+            return frontier[qubit];
+        }
+
+        void count_operation(const Operation &op)
+        {
+            if (op.get_type() == Operation::Type::RZ_SEQ)
+            {
+                const GateBlock &block = rz_sequence(op);
+                for (size_t t = 0; t < type_counts.size(); ++t)
+                    type_counts[t] += block.type_counts[t];
+                ++rz_sequence_ops;
+                rz_sequence_gates += block.size();
+                if (!block.clifford_t)
+                    is_clifford_t_circuit = false;
+                return;
+            }
+            type_counts[static_cast<size_t>(op.get_type())]++;
+            if (is_pn(op.get_type()))
+                pn_counts[pn_slot(op.get_type(), op.get_dagger(), op.get_x_rotation())]++;
+        }
+
     public:
+        // RZ angle grouping for synthesis: representative angle per group, and the
+        // group of each operation by index (AngleTable::NO_ANGLE for non-grouped ops)
         std::vector<double> distinct_rz_angles;
-        std::map<size_t, size_t> rz_angle_map;
+        std::vector<size_t> rz_angle_index;
 
         Circuit() = default;
         virtual ~Circuit() = default; // Good practice to have a virtual function
+        Circuit(const Circuit &) = default;
+        Circuit(Circuit &&) = default; // Not implied once the destructor is declared
+        Circuit &operator=(const Circuit &) = default;
+        Circuit &operator=(Circuit &&) = default;
 
         // Register management
         virtual void add_qreg(const std::string &name, size_t size)
@@ -179,15 +275,94 @@ namespace NWQEC
                 }
             }
 
-            // Update Clifford+T tracking
-            if (is_clifford_t_circuit && !is_clifford_t_operation(operation.get_type()))
+            // Update Clifford+T tracking (count_operation checks RZ_SEQ blocks)
+            if (is_clifford_t_circuit && !is_clifford_t_operation(operation.get_type()) &&
+                operation.get_type() != Operation::Type::RZ_SEQ)
             {
                 is_clifford_t_circuit = false;
             }
 
+            count_operation(operation);
+            invalidate_stats();
             operations.push_back(std::move(operation));
         }
 
+        void reserve_operations(size_t count) { operations.reserve(count); }
+
+        /**
+         * @brief Append every gate of block on qubit
+         *
+         * Same result as add_operation for each gate, with the qubit bound
+         * and Clifford+T status checked once for the whole block.
+         */
+        virtual void append_block(const GateBlock &block, size_t qubit)
+        {
+            if (block.empty())
+                return;
+            if (qubit >= num_qubits)
+                num_qubits = qubit + 1;
+            if (!block.clifford_t)
+                is_clifford_t_circuit = false;
+            invalidate_stats();
+            for (Operation::Type type : block.types)
+            {
+                assert(!is_pn(type)); // Their counts also depend on sign and axis
+                type_counts[static_cast<size_t>(type)]++;
+                operations.push_back(Operation(type, {qubit}));
+            }
+        }
+
+        /**
+         * @brief Copy of the registers and gate table without any operations
+         *
+         * Lets several builders fill disjoint slices of one circuit that are
+         * later joined with append_circuit.
+         */
+        Circuit layout_copy() const
+        {
+            Circuit copy;
+            copy.num_qubits = num_qubits;
+            copy.num_bits = num_bits;
+            copy.qubit_register_map = qubit_register_map;
+            copy.bit_register_map = bit_register_map;
+            copy.qubit_reg_size_map = qubit_reg_size_map;
+            copy.bit_reg_size_map = bit_reg_size_map;
+            copy.gate_definitions = gate_definitions;
+            copy.rz_sequence_table = rz_sequence_table;
+            return copy;
+        }
+
+        /**
+         * @brief Move the operations of other onto the end of this circuit
+         *
+         * Same result as add_operation for each of them, without recounting:
+         * other's counts and bounds are merged in. Registers, gate tables and
+         * RZ angle groups of other are not copied, and other
+         * is left empty. RZ_SEQ placeholders of other must index the
+         * sequences of this circuit.
+         */
+        void append_circuit(Circuit &&other)
+        {
+            assert(other.rz_sequence_ops == 0 || other.rz_sequence_table == rz_sequence_table);
+            rz_sequence_ops += other.rz_sequence_ops;
+            rz_sequence_gates += other.rz_sequence_gates;
+            num_qubits = std::max(num_qubits, other.num_qubits);
+            num_bits = std::max(num_bits, other.num_bits);
+            if (!other.is_clifford_t_circuit)
+                is_clifford_t_circuit = false;
+            for (size_t i = 0; i < type_counts.size(); ++i)
+                type_counts[i] += other.type_counts[i];
+            for (size_t i = 0; i < pn_counts.size(); ++i)
+                pn_counts[i] += other.pn_counts[i];
+            invalidate_stats();
+            if (operations.empty() && operations.capacity() < other.operations.size())
+                operations = std::move(other.operations);
+            else
+                operations.insert(operations.end(), std::make_move_iterator(other.operations.begin()),
+                                  std::make_move_iterator(other.operations.end()));
+            other.set_operations_list({});
+        }
+
         // Allow derived classes to set the full list of operations.
         // Useful for transformations that rebuild the operation list.
         void set_operations_list(std::vector<Operation> new_ops)
@@ -197,9 +372,15 @@ namespace NWQEC
             num_qubits = 0;
             num_bits = 0;
             is_clifford_t_circuit = true;
+            type_counts.fill(0);
+            pn_counts.fill(0);
+            rz_sequence_ops = 0;
+            rz_sequence_gates = 0;
+            invalidate_stats();
 
             for (const auto &op : operations)
             {
+                count_operation(op);
                 for (size_t q_idx : op.get_qubits())
                 {
                     if (q_idx >= num_qubits)
@@ -216,14 +397,14 @@ namespace NWQEC
                 }
 
                 // Check Clifford+T status
-                if (!is_clifford_t_operation(op.get_type()))
+                if (!is_clifford_t_operation(op.get_type()) && op.get_type() != Operation::Type::RZ_SEQ)
                 {
                     is_clifford_t_circuit = false;
                 }
             }
         }
         // Helper method to check if an operation is a Clifford+T gate
-        bool is_clifford_t_operation(Operation::Type type) const
+        static bool is_clifford_t_operation(Operation::Type type)
         {
             switch (type)
             {
@@ -257,21 +438,83 @@ namespace NWQEC
         size_t get_num_bits() const { return num_bits; }
         const std::vector<Operation> &get_operations() const { return operations; }
 
-        // Check if the circuit contains only Clifford+T gates
-        bool is_clifford_t() const { return is_clifford_t_circuit; }
+        // Gates the circuit stands for, counting each RZ_SEQ as its whole sequence
+        size_t gate_count() const { return operations.size() - rz_sequence_ops + rz_sequence_gates; }
 
-        // Get count for a specific operation type
-        size_t get_operation_count(Operation::Type type) const
+        // ===================== Deferred RZ sequences =====================
+
+        /**
+         * @brief Set the sequences RZ_SEQ placeholders added from now on index
+         *
+         * The table is shared, unchanged, with every circuit copied from this
+         * one, possibly on other threads: it must hold every sequence the
+         * placeholders will index before it is set.
+         */
+        void set_rz_sequences(std::shared_ptr<const std::vector<GateBlock>> sequences)
         {
-            size_t count = 0;
-            for (const auto &op : operations)
+            rz_sequence_table = std::move(sequences);
+        }
+
+        const std::shared_ptr<const std::vector<GateBlock>> &rz_sequences() const { return rz_sequence_table; }
+
+        // Whether any operation is an RZ_SEQ placeholder
+        bool has_rz_sequences() const { return rz_sequence_ops != 0; }
+
+        // Gates an RZ_SEQ placeholder stands for, applied to its qubit
+        const GateBlock &rz_sequence(const Operation &op) const
+        {
+            assert(op.get_type() == Operation::Type::RZ_SEQ && rz_sequence_table);
+            return (*rz_sequence_table)[op.get_sequence_index()];
+        }
+
+        /**
+         * @brief Call f(type, qubit) for each gate of an RZ_SEQ placeholder, in order
+         */
+        template <typename F>
+        void for_each_sequence_gate(const Operation &op, F &&f) const
+        {
+            const size_t qubit = op.get_qubits()[0];
+            for (Operation::Type type : rz_sequence(op).types)
+                f(type, qubit);
+        }
+
+        /**
+         * @brief Replace every RZ_SEQ placeholder by the gates it stands for
+         *
+         * For passes that rewrite individual gates. Does nothing for a
+         * circuit without placeholders.
+         */
+        void expand_rz_sequences()
+        {
+            if (!has_rz_sequences())
+                return;
+            std::vector<Operation> expanded;
+            expanded.reserve(gate_count());
+            for (Operation &op : operations)
             {
-                if (op.get_type() == type)
+                if (op.get_type() != Operation::Type::RZ_SEQ)
                 {
-                    count++;
+                    expanded.push_back(std::move(op));
+                    continue;
                 }
+                for_each_sequence_gate(op, [&expanded](Operation::Type type, size_t qubit)
+                                       { expanded.push_back(Operation(type, {qubit})); });
             }
-            return count;
+            const size_t qubits = num_qubits, bits = num_bits;
+            set_operations_list(std::move(expanded));
+            update_qubit_and_bit_counts(std::max(qubits, num_qubits), std::max(bits, num_bits));
+            rz_sequence_table.reset();
+            distinct_rz_angles.clear(); // Grouping indexed the operations before expansion
+            rz_angle_index.clear();
+        }
+
+        // Check if the circuit contains only Clifford+T gates
+        bool is_clifford_t() const { return is_clifford_t_circuit; }
+
+        // Get count for a specific operation type
+        size_t get_operation_count(Operation::Type type) const
+        {
+            return type_counts[static_cast<size_t>(type)];
         }
 
         // Update the qubit and bit counts after removing unused resources
@@ -290,29 +533,33 @@ namespace NWQEC
          */
         size_t depth() const
         {
-            std::unordered_map<size_t, size_t> depth_counts; // track depth of each qubit
+            if (stats_cache.depth_valid)
+                return stats_cache.depth;
+
+            std::vector<size_t> depth_counts(num_qubits, 0); // track depth of each qubit
+            size_t max_depth = 0;
 
-            for (size_t i = 0; i < operations.size(); ++i)
+            for (const Operation &op : operations)
             {
-                auto qubits = operations[i].get_qubits();
+                const Operation::QubitSpan qubits = op.get_qubits();
                 size_t current_depth = 0;
+                // A sequence is a chain of gates on one qubit
+                const size_t layers = op.get_type() == Operation::Type::RZ_SEQ ? rz_sequence(op).size() : 1;
 
                 for (size_t qubit : qubits)
                 {
-                    current_depth = std::max(depth_counts[qubit], current_depth);
+                    current_depth = std::max(frontier_at(depth_counts, qubit), current_depth);
                 }
+                if (!qubits.empty())
+                    max_depth = std::max(max_depth, current_depth + layers);
                 for (size_t qubit : qubits)
                 {
-                    depth_counts[qubit] = current_depth + 1;
+                    depth_counts[qubit] = current_depth + layers;
                 }
             }
 
-            size_t max_depth = 0;
-            for (const auto &[qubit, depth] : depth_counts)
-            {
-                max_depth = std::max(max_depth, depth);
-            }
-
+            stats_cache.depth = max_depth;
+            stats_cache.depth_valid = true;
             return max_depth;
         }
 
@@ -350,33 +597,48 @@ namespace NWQEC
          */
         double duration(double code_distance) const
         {
-            std::unordered_map<size_t, double> duration_counts; // track duration of each qubit
+            if (stats_cache.duration_valid && stats_cache.duration_distance == code_distance)
+                return stats_cache.duration;
 
-            for (size_t i = 0; i < operations.size(); ++i)
-            {
-                auto qubits = operations[i].get_qubits();
+            std::vector<double> duration_counts(num_qubits, 0.0); // track duration of each qubit
+            double max_duration = 0.0;
 
-                // Get gate duration based on type
-                double gate_duration = get_gate_duration(operations[i].get_type(), code_distance);
+            for (const Operation &op : operations)
+            {
+                const Operation::QubitSpan qubits = op.get_qubits();
 
                 double current_duration = 0.0;
 
                 for (size_t qubit : qubits)
                 {
-                    current_duration = std::max(duration_counts[qubit], current_duration);
+                    current_duration = std::max(frontier_at(duration_counts, qubit), current_duration);
+                }
+
+                if (op.get_type() == Operation::Type::RZ_SEQ)
+                {
+                    // Gate by gate, rounding as the expanded circuit would
+                    double &end = duration_counts[qubits[0]];
+                    for (Operation::Type type : rz_sequence(op).types)
+                    {
+                        end += get_gate_duration(type, code_distance);
+                        max_duration = std::max(max_duration, end);
+                    }
+                    continue;
                 }
+
+                // Get gate duration based on type
+                double gate_duration = get_gate_duration(op.get_type(), code_distance);
+                if (!qubits.empty())
+                    max_duration = std::max(max_duration, current_duration + gate_duration);
                 for (size_t qubit : qubits)
                 {
                     duration_counts[qubit] = current_duration + gate_duration;
                 }
             }
 
-            double max_duration = 0.0;
-            for (const auto &[qubit, duration] : duration_counts)
-            {
-                max_duration = std::max(max_duration, duration);
-            }
-
+            stats_cache.duration = max_duration;
+            stats_cache.duration_distance = code_distance;
+            stats_cache.duration_valid = true;
             return max_duration;
         }
 
@@ -397,7 +659,7 @@ namespace NWQEC
             os << "Basic Circuit Information:\n";
             os << "  Number of qubits: " << num_qubits << "\n";
             os << "  Number of classical bits: " << num_bits << "\n";
-            os << "  Total gates: " << operations.size() << "\n";
+            os << "  Total gates: " << gate_count() << "\n";
             os << "  Circuit depth: " << depth() << " gates\n";
             os << "  Clifford+T circuit: " << (is_clifford_t_circuit ? "Yes" : "No") << "\n";
 
@@ -417,8 +679,8 @@ namespace NWQEC
                 }
             }
 
-            // Then print remaining operations
-            for (const auto &[op_name, count] : op_counts)
+            // Then print remaining operations, by name
+            for (const auto &[op_name, count] : std::map<std::string, size_t>(op_counts.begin(), op_counts.end()))
             {
                 os << "    " << op_name << ": " << count << "\n";
             }
@@ -439,10 +701,10 @@ namespace NWQEC
             os << "  Total T-type gates: " << t_gates << "\n";
             os << "  Total two-qubit gates: " << two_qubit_gates << "\n";
 
-            if (operations.size() > 0)
+            if (gate_count() > 0)
             {
-                double t_gate_ratio = static_cast<double>(t_gates) / operations.size() * 100;
-                double two_qubit_ratio = static_cast<double>(two_qubit_gates) / operations.size() * 100;
+                double t_gate_ratio = static_cast<double>(t_gates) / gate_count() * 100;
+                double two_qubit_ratio = static_cast<double>(two_qubit_gates) / gate_count() * 100;
 
                 os << "  T-gate ratio: " << std::fixed << std::setprecision(1) << t_gate_ratio << "%\n";
                 os << "  Two-qubit gate ratio: " << std::fixed << std::setprecision(1) << two_qubit_ratio << "%\n";
@@ -465,7 +727,7 @@ namespace NWQEC
             os << "==================================================\n";
 
             os << "  Number of qubits: " << num_qubits << "\n";
-            os << "  Total gates: " << operations.size() << "\n";
+            os << "  Total gates: " << gate_count() << "\n";
             os << "  Circuit depth: " << depth() << " gates\n";
 
             // Define gate categories with their gates
@@ -507,7 +769,7 @@ namespace NWQEC
             if (!op_counts.empty())
             {
                 os << "\nOther gates:\n";
-                for (const auto &[op_name, count] : op_counts)
+                for (const auto &[op_name, count] : std::map<std::string, size_t>(op_counts.begin(), op_counts.end()))
                 {
                     os << "    " << std::setw(10) << op_name << ": " << count << "\n";
                 }
@@ -522,15 +784,32 @@ namespace NWQEC
          */
         std::unordered_map<std::string, size_t> count_ops() const
         {
+            if (stats_cache.counts_valid)
+                return stats_cache.counts;
+
             std::unordered_map<std::string, size_t> op_counts;
 
-            // Count operations directly from the operations vector
-            for (const auto &op : operations)
+            // Read from the running counters instead of walking the operations
+            for (size_t t = 0; t < Operation::NUM_TYPES; ++t)
             {
-                std::string op_name = op.get_type_name();
-                op_counts[op_name]++;
+                const Operation::Type type = static_cast<Operation::Type>(t);
+                if (type_counts[t] == 0 || is_pn(type))
+                    continue;
+                op_counts[Operation::get_type_name(type)] += type_counts[t];
+            }
+            for (Operation::Type type : {Operation::Type::P4, Operation::Type::P8, Operation::Type::P16})
+            {
+                for (int variant = 0; variant < 4; ++variant)
+                {
+                    const bool dagger = (variant & 2) != 0, x_rotation = (variant & 1) != 0;
+                    const size_t count = pn_counts[pn_slot(type, dagger, x_rotation)];
+                    if (count != 0)
+                        op_counts[Operation(type, {0}, {}, {}, PauliOp(), dagger, x_rotation).get_type_name()] += count;
+                }
             }
 
+            stats_cache.counts = op_counts;
+            stats_cache.counts_valid = true;
             return op_counts;
         }
 
@@ -552,13 +831,27 @@ namespace NWQEC
             }
             os << "\n";
 
-            // Print operations
+            // Print operations, expanding RZ_SEQ placeholders
             for (const auto &op : operations)
             {
+                if (op.get_type() == Operation::Type::RZ_SEQ)
+                {
+                    for_each_sequence_gate(op, [&os](Operation::Type type, size_t qubit)
+                                           { os << Operation::get_type_name(type) << " q[" << qubit << "];\n"; });
+                    continue;
+                }
                 op.print(os);
                 os << "\n";
             }
         }
     };
 
+    inline void GateBlock::push_back(Operation::Type type)
+    {
+        types.push_back(type);
+        type_counts[static_cast<size_t>(type)]++;
+        if (!Circuit::is_clifford_t_operation(type))
+            clifford_t = false;
+    }
+
 } // namespace NWQEC
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "nwqec/core/circuit.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NWQEC
+{
+    /**
+     * @brief Flat, column-wise copy of a circuit's operations for vectorized analysis
+     *
+     * Built in one pass, after which every field is a contiguous array that
+     * can be handed out without further copying (the Python bindings expose
+     * them through the buffer protocol). RZ_SEQ placeholders appear as the
+     * gates they stand for, as in the QASM output.
+     *
+     *   types          Operation::Type of operation i
+     *   qubit_offsets  qubits of operation i are qubits[qubit_offsets[i] .. qubit_offsets[i + 1])
+     *   pauli_rows     row of operation i in the Pauli arrays, -1 if it has no Pauli string
+     *   x_words,       Pauli rows x pauli_words packed X and Z bits, qubit q in bit q % 64
+     *   z_words        of word q / 64 (as PauliOp stores them)
+     *   phases         sign of each Pauli row (1 = negative)
+     */
+    struct CircuitArrays
+    {
+        size_t num_qubits = 0;
+        size_t pauli_words = 0;
+        std::vector<uint8_t> types;
+        std::vector<uint64_t> qubit_offsets;
+        std::vector<uint32_t> qubits;
+        std::vector<int64_t> pauli_rows;
+        std::vector<uint64_t> x_words;
+        std::vector<uint64_t> z_words;
+        std::vector<uint8_t> phases;
+
+        size_t num_operations() const { return types.size(); }
+        size_t num_pauli_rows() const { return phases.size(); }
+
+        static CircuitArrays from(const Circuit &circuit)
+        {
+            const auto &operations = circuit.get_operations();
+            CircuitArrays out;
+            out.num_qubits = circuit.get_num_qubits();
+
+            size_t pauli_count = 0;
+            size_t qubit_count = 0;
+            for (const Operation &op : operations)
+            {
+                const PauliOp &pauli = op.get_pauli_op();
+                if (pauli.get_num_qubits() != 0)
+                {
+                    ++pauli_count;
+                    out.pauli_words = std::max(out.pauli_words, pauli.num_words());
+                }
+                qubit_count += op.get_qubits().size();
+            }
+
+            const size_t count = circuit.gate_count();
+            out.types.reserve(count);
+            out.qubit_offsets.reserve(count + 1);
+            out.qubits.reserve(qubit_count + count);
+            out.pauli_rows.reserve(count);
+            out.x_words.reserve(pauli_count * out.pauli_words);
+            out.z_words.reserve(pauli_count * out.pauli_words);
+            out.phases.reserve(pauli_count);
+
+            out.qubit_offsets.push_back(0);
+            auto add = [&out](Operation::Type type, int64_t pauli_row)
+            {
+                out.types.push_back(static_cast<uint8_t>(type));
+                out.qubit_offsets.push_back(out.qubits.size());
+                out.pauli_rows.push_back(pauli_row);
+            };
+
+            for (const Operation &op : operations)
+            {
+                if (op.get_type() == Operation::Type::RZ_SEQ)
+                {
+                    circuit.for_each_sequence_gate(op, [&out, &add](Operation::Type type, size_t qubit)
+                                                   {
+                        out.qubits.push_back(static_cast<uint32_t>(qubit));
+                        add(type, -1); });
+                    continue;
+                }
+
+                for (size_t qubit : op.get_qubits())
+                    out.qubits.push_back(static_cast<uint32_t>(qubit));
+
+                const PauliOp &pauli = op.get_pauli_op();
+                if (pauli.get_num_qubits() == 0)
+                {
+                    add(op.get_type(), -1);
+                    continue;
+                }
+                const size_t words = pauli.num_words();
+                out.x_words.insert(out.x_words.end(), pauli.x_words(), pauli.x_words() + words);
+                out.z_words.insert(out.z_words.end(), pauli.z_words(), pauli.z_words() + words);
+                out.x_words.resize(out.x_words.size() + out.pauli_words - words, 0);
+                out.z_words.resize(out.z_words.size() + out.pauli_words - words, 0);
+                out.phases.push_back(pauli.get_phase() ? 1 : 0);
+                add(op.get_type(), static_cast<int64_t>(out.phases.size() - 1));
+            }
+            return out;
+        }
+    };
+
+} // namespace NWQEC
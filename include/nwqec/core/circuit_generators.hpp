@@ -0,0 +1,121 @@
+#pragma once
+
+#include "nwqec/core/circuit.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+namespace NWQEC
+{
+    /**
+     * @brief Quantum Fourier transform on n_qubits qubits, with the final qubit-reversal swaps
+     */
+    inline std::unique_ptr<Circuit> generate_qft_circuit(int n_qubits)
+    {
+        auto circuit = std::make_unique<Circuit>();
+
+        // Add quantum register
+        circuit->add_qreg("q", n_qubits);
+
+        // Generate QFT gates
+        for (int i = 0; i < n_qubits; i++)
+        {
+            // Apply Hadamard gate
+            circuit->add_operation(Operation(Operation::Type::H, {static_cast<size_t>(i)}));
+
+            // Apply controlled phase rotations
+            for (int j = i + 1; j < n_qubits; j++)
+            {
+                double angle = M_PI / std::pow(2, j - i);
+                circuit->add_operation(Operation(Operation::Type::CP,
+                                                 {static_cast<size_t>(j), static_cast<size_t>(i)}, {angle}));
+            }
+        }
+
+        // Swap qubits to reverse the order
+        for (int i = 0; i < n_qubits / 2; i++)
+        {
+            circuit->add_operation(Operation(Operation::Type::SWAP,
+                                             {static_cast<size_t>(i), static_cast<size_t>(n_qubits - 1 - i)}));
+        }
+
+        return circuit;
+    }
+
+    /**
+     * @brief Shor-like test circuit for an n_bits-bit number
+     *
+     * Qubit and Toffoli counts follow the scaling of Shor's algorithm; the
+     * Toffolis are placed pseudo-randomly from a fixed seed and followed by
+     * an inverse QFT, so the same n_bits always gives the same circuit.
+     */
+    inline std::unique_ptr<Circuit> generate_shor_circuit(int n_bits)
+    {
+        auto circuit = std::make_unique<Circuit>();
+
+        // Calculate qubits and gates based on Shor's algorithm scaling
+        int num_qubits = static_cast<int>(3 * n_bits + 0.002 * n_bits * std::log2(n_bits));
+        int num_toffolis = static_cast<int>(0.3 * std::pow(n_bits, 3) + 0.0005 * std::pow(n_bits, 3) * std::log2(n_bits));
+
+        // Add quantum register
+        circuit->add_qreg("q", num_qubits);
+
+        // Add some initialization gates (random H gates)
+        int init_gates = std::min(num_qubits / 4, 10);
+        std::srand(42); // Fixed seed for reproducible results
+        for (int i = 0; i < init_gates; i++)
+        {
+            int qubit = std::rand() % num_qubits;
+            circuit->add_operation(Operation(Operation::Type::H, {static_cast<size_t>(qubit)}));
+        }
+
+        // Generate random Toffoli gates
+        for (int i = 0; i < num_toffolis; i++)
+        {
+            // Generate three unique random qubits
+            std::vector<int> qubits;
+            while (qubits.size() < 3)
+            {
+                int qubit = std::rand() % num_qubits;
+                if (std::find(qubits.begin(), qubits.end(), qubit) == qubits.end())
+                {
+                    qubits.push_back(qubit);
+                }
+            }
+
+            // Add CCX gate
+            circuit->add_operation(Operation(Operation::Type::CCX,
+                                             {static_cast<size_t>(qubits[0]),
+                                              static_cast<size_t>(qubits[1]),
+                                              static_cast<size_t>(qubits[2])}));
+        }
+
+        // Add inverse QFT before measurement
+        for (int i = 0; i < num_qubits / 2; i++)
+        {
+            circuit->add_operation(Operation(Operation::Type::SWAP,
+                                             {static_cast<size_t>(i), static_cast<size_t>(num_qubits - 1 - i)}));
+        }
+
+        // Apply inverse QFT gates (reverse order of forward QFT)
+        for (int i = num_qubits - 1; i >= 0; i--)
+        {
+            // Apply inverse controlled phase rotations
+            for (int j = num_qubits - 1; j > i; j--)
+            {
+                double angle = -M_PI / std::pow(2, j - i);
+                circuit->add_operation(Operation(Operation::Type::CP,
+                                                 {static_cast<size_t>(j), static_cast<size_t>(i)}, {angle}));
+            }
+
+            // Apply Hadamard gate
+            circuit->add_operation(Operation(Operation::Type::H, {static_cast<size_t>(i)}));
+        }
+
+        return circuit;
+    }
+
+} // namespace NWQEC
@@ -0,0 +1,326 @@
+#pragma once
+
+#include "nwqec/core/operation.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NWQEC
+{
+    /**
+     * @brief Table-driven reduction of single-qubit Clifford+T runs
+     *
+     * The 24 single-qubit Cliffords modulo phase are tabulated once as
+     * permutations of the six signed Paulis (C P C^dagger for P in +-X,
+     * +-Y, +-Z), with their products, inverses and a shortest word over
+     * X, Y, Z, H, S and SDG.
+     *
+     * A run is read left to right while a single Clifford C is accumulated.
+     * Every T or TDG is pushed through C, which turns it into a pi/4
+     * rotation about the signed Pauli C^dagger Z C. Two adjacent rotations
+     * about the same axis fuse into a Clifford that joins C, and about
+     * opposite axes they cancel. What remains has no two adjacent rotations
+     * on one axis, which is T-optimal for one qubit. It is written back as
+     * T/TDG gates between Clifford words, with the conjugating frame of
+     * each rotation chosen by a small dynamic program to minimise the
+     * number of Clifford gates. Global phase is dropped.
+     */
+    class CliffordTReducer
+    {
+    public:
+        // Gates the tables cover; any other gate splits a run into segments
+        static bool is_reducible(Operation::Type type)
+        {
+            return type == Operation::Type::T || type == Operation::Type::TDG || clifford_slot(type) >= 0;
+        }
+
+        /**
+         * @brief Reduce each maximal segment of reducible gates in a single-qubit run
+         *
+         * Other gates are copied unchanged. A segment is only rewritten when
+         * that lowers its T count, or keeps it and lowers its gate count, so
+         * already-reduced runs come back as they were.
+         */
+        static std::vector<Operation> reduce(const std::vector<Operation> &run)
+        {
+            std::vector<Operation> result;
+            result.reserve(run.size());
+            for (size_t i = 0; i < run.size();)
+            {
+                if (!is_reducible(run[i].get_type()))
+                {
+                    result.push_back(run[i++]);
+                    continue;
+                }
+                size_t end = i;
+                while (end < run.size() && is_reducible(run[end].get_type()))
+                    ++end;
+                reduce_segment(run, i, end, result);
+                i = end;
+            }
+            return result;
+        }
+
+    private:
+        using Id = uint8_t;
+        using Perm = std::array<uint8_t, 6>;             // Images of +X, -X, +Y, -Y, +Z, -Z
+        static constexpr uint8_t PX = 0, PY = 2, PZ = 4; // Signed Pauli p; p ^ 1 negates it
+        static constexpr size_t GROUP_SIZE = 24;
+        static constexpr size_t FRAMES = 8; // Cliffords taking a given axis to +-Z
+
+        struct Tables
+        {
+            std::array<Perm, GROUP_SIZE> perm;
+            std::array<std::array<Id, GROUP_SIZE>, GROUP_SIZE> mul; // mul[a][b]: b applied, then a
+            std::array<Id, GROUP_SIZE> inv;
+            std::array<std::vector<Operation::Type>, GROUP_SIZE> word; // In circuit order
+            std::array<Id, 9> gate;                                    // Indexed by clifford_slot
+            std::array<Id, 6> half_turn;                               // pi/2 rotation about each signed Pauli
+            std::array<std::array<Id, FRAMES>, 6> frames;              // D with D p D^dagger = +-Z
+        };
+
+        // Position of a Clifford gate in Tables::gate, or -1
+        static int clifford_slot(Operation::Type type)
+        {
+            switch (type)
+            {
+            case Operation::Type::X:
+                return 0;
+            case Operation::Type::Y:
+                return 1;
+            case Operation::Type::Z:
+                return 2;
+            case Operation::Type::H:
+                return 3;
+            case Operation::Type::S:
+                return 4;
+            case Operation::Type::SDG:
+                return 5;
+            case Operation::Type::SX:
+                return 6;
+            case Operation::Type::SXDG:
+                return 7;
+            case Operation::Type::ID:
+                return 8;
+            default:
+                return -1;
+            }
+        }
+
+        // Permutation from the images of +X, +Y and +Z
+        static Perm make_perm(uint8_t x, uint8_t y, uint8_t z)
+        {
+            return {x, static_cast<uint8_t>(x ^ 1), y, static_cast<uint8_t>(y ^ 1), z, static_cast<uint8_t>(z ^ 1)};
+        }
+
+        static const Tables &tables()
+        {
+            static const Tables t = build_tables();
+            return t;
+        }
+
+        static Tables build_tables()
+        {
+            const Perm gate_perms[9] = {
+                make_perm(PX, PY ^ 1, PZ ^ 1), // X
+                make_perm(PX ^ 1, PY, PZ ^ 1), // Y
+                make_perm(PX ^ 1, PY ^ 1, PZ), // Z
+                make_perm(PZ, PY ^ 1, PX),     // H
+                make_perm(PY, PX ^ 1, PZ),     // S
+                make_perm(PY ^ 1, PX, PZ),     // SDG
+                make_perm(PX, PZ, PY ^ 1),     // SX
+                make_perm(PX, PZ ^ 1, PY),     // SXDG
+                make_perm(PX, PY, PZ),         // ID
+            };
+            const Operation::Type alphabet[6] = {Operation::Type::X, Operation::Type::Y, Operation::Type::Z,
+                                                 Operation::Type::H, Operation::Type::S, Operation::Type::SDG};
+
+            Tables t{};
+            // Breadth-first over the alphabet, so each element's first word is a shortest one
+            size_t count = 1;
+            t.perm[0] = gate_perms[8];
+            for (size_t head = 0; head < count; ++head)
+            {
+                for (size_t g = 0; g < 6; ++g)
+                {
+                    Perm next = compose(gate_perms[g], t.perm[head]);
+                    if (find(t, count, next) < count)
+                        continue;
+                    t.perm[count] = next;
+                    t.word[count] = t.word[head];
+                    t.word[count].push_back(alphabet[g]);
+                    ++count;
+                }
+            }
+
+            for (size_t a = 0; a < GROUP_SIZE; ++a)
+            {
+                for (size_t b = 0; b < GROUP_SIZE; ++b)
+                {
+                    t.mul[a][b] = static_cast<Id>(find(t, GROUP_SIZE, compose(t.perm[a], t.perm[b])));
+                    if (t.mul[a][b] == 0)
+                        t.inv[a] = static_cast<Id>(b);
+                }
+            }
+            for (size_t g = 0; g < 9; ++g)
+                t.gate[g] = static_cast<Id>(find(t, GROUP_SIZE, gate_perms[g]));
+
+            const Id s = t.gate[4];
+            for (uint8_t p = 0; p < 6; ++p)
+            {
+                size_t n = 0;
+                for (size_t d = 0; d < GROUP_SIZE; ++d)
+                {
+                    if ((t.perm[d][p] | 1) == (PZ | 1))
+                        t.frames[p][n++] = static_cast<Id>(d);
+                }
+                // R_p(pi/2) = D^dagger S D for a frame D taking p to +Z
+                for (Id d : t.frames[p])
+                {
+                    if (t.perm[d][p] == PZ)
+                    {
+                        t.half_turn[p] = t.mul[t.inv[d]][t.mul[s][d]];
+                        break;
+                    }
+                }
+            }
+            return t;
+        }
+
+        // P -> a(b(P))
+        static Perm compose(const Perm &a, const Perm &b)
+        {
+            Perm r{};
+            for (size_t p = 0; p < 6; ++p)
+                r[p] = a[b[p]];
+            return r;
+        }
+
+        static size_t find(const Tables &t, size_t count, const Perm &perm)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (t.perm[i] == perm)
+                    return i;
+            }
+            return count;
+        }
+
+        // C^dagger p C, the axis p is taken to when conjugated back through C
+        static uint8_t pull_back(const Tables &t, Id c, uint8_t p)
+        {
+            const Perm &perm = t.perm[t.inv[c]];
+            return perm[p];
+        }
+
+        static void reduce_segment(const std::vector<Operation> &run, size_t begin, size_t end,
+                                   std::vector<Operation> &out)
+        {
+            const Tables &t = tables();
+
+            // Rotation axes in circuit order, followed by the Clifford c
+            std::vector<uint8_t> axes;
+            Id c = 0;
+            size_t in_t = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                const Operation::Type type = run[i].get_type();
+                if (type != Operation::Type::T && type != Operation::Type::TDG)
+                {
+                    c = t.mul[t.gate[clifford_slot(type)]][c];
+                    continue;
+                }
+                ++in_t;
+                uint8_t axis = pull_back(t, c, PZ);
+                if (type == Operation::Type::TDG)
+                    axis ^= 1;
+                if (!axes.empty() && axes.back() == axis)
+                {
+                    axes.pop_back();
+                    c = t.mul[c][t.half_turn[axis]];
+                }
+                else if (!axes.empty() && axes.back() == (axis ^ 1))
+                    axes.pop_back();
+                else
+                    axes.push_back(axis);
+            }
+
+            // Shortest Clifford words around the rotations: cost[j] for frame j of the latest rotation
+            auto word_len = [&](Id id)
+            { return t.word[id].size(); };
+            const size_t k = axes.size();
+            std::vector<std::array<uint8_t, FRAMES>> parent(k);
+            std::array<size_t, FRAMES> cost{};
+            for (size_t j = 0; j < FRAMES && k > 0; ++j)
+                cost[j] = word_len(t.frames[axes[0]][j]);
+            for (size_t i = 1; i < k; ++i)
+            {
+                std::array<size_t, FRAMES> next{};
+                for (size_t j = 0; j < FRAMES; ++j)
+                {
+                    const Id d = t.frames[axes[i]][j];
+                    next[j] = SIZE_MAX;
+                    for (size_t l = 0; l < FRAMES; ++l)
+                    {
+                        size_t total = cost[l] + word_len(t.mul[d][t.inv[t.frames[axes[i - 1]][l]]]);
+                        if (total < next[j])
+                        {
+                            next[j] = total;
+                            parent[i][j] = static_cast<uint8_t>(l);
+                        }
+                    }
+                }
+                cost = next;
+            }
+            size_t best = 0, best_cost = word_len(c);
+            if (k > 0)
+            {
+                best_cost = SIZE_MAX;
+                for (size_t j = 0; j < FRAMES; ++j)
+                {
+                    size_t total = cost[j] + word_len(t.mul[c][t.inv[t.frames[axes[k - 1]][j]]]);
+                    if (total < best_cost)
+                    {
+                        best_cost = total;
+                        best = j;
+                    }
+                }
+            }
+
+            const size_t in_total = end - begin;
+            if (in_t < k || (in_t == k && in_total <= best_cost + k))
+            {
+                out.insert(out.end(), run.begin() + static_cast<std::ptrdiff_t>(begin),
+                           run.begin() + static_cast<std::ptrdiff_t>(end));
+                return;
+            }
+
+            std::vector<uint8_t> frame(k);
+            for (size_t i = k; i-- > 0;)
+            {
+                frame[i] = static_cast<uint8_t>(best);
+                if (i > 0)
+                    best = parent[i][best];
+            }
+
+            const Operation::QubitSpan qubit = run[begin].get_qubits();
+            auto emit = [&](Id id)
+            {
+                for (Operation::Type type : t.word[id])
+                    out.push_back(Operation(type, qubit));
+            };
+            Id previous = 0; // Frame of the previous rotation, undone before the next
+            for (size_t i = 0; i < k; ++i)
+            {
+                const Id d = t.frames[axes[i]][frame[i]];
+                emit(t.mul[d][t.inv[previous]]);
+                out.push_back(Operation(t.perm[d][axes[i]] == PZ ? Operation::Type::T : Operation::Type::TDG, qubit));
+                previous = d;
+            }
+            emit(t.mul[c][t.inv[previous]]);
+        }
+    };
+
+} // namespace NWQEC
@@ -21,6 +21,8 @@ namespace NWQEC
         OperationDependency(size_t q, size_t n) : qubit(q), node(n) {}
     };
 
+    // Circuit that maintains its dependency lists as operations are added.
+    // For a read-only view of an existing circuit, DependencyGraph is cheaper.
     class DAGCircuit : public Circuit
     {
 
@@ -70,7 +72,7 @@ namespace NWQEC
         void add_operation(Operation operation) override
         {
             // Capture qubit data before moving the operation object
-            const std::vector<size_t> &op_qubits = operation.get_qubits();
+            const Operation::QubitSpan op_qubits = operation.get_qubits();
             size_t new_op_idx = get_operations().size(); // Index this operation will have
 
             // Validate qubit indices against declared qubits
@@ -130,6 +132,13 @@ namespace NWQEC
             Circuit::add_operation(std::move(operation));
         }
 
+        // Blocks go through add_operation so every gate joins the DAG
+        void append_block(const GateBlock &block, size_t qubit) override
+        {
+            for (Operation::Type type : block.types)
+                add_operation(Operation(type, {qubit}));
+        }
+
         // Accessor for successors of an operation
         const std::vector<OperationDependency> &get_successors(size_t op_idx) const
         {
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace NWQEC
+{
+    /**
+     * @brief Destination for optional debug dumps produced by passes
+     *
+     * A pass hands over a name and a writer that owns everything it needs;
+     * the sink decides where the text goes and when the writer runs. Passes
+     * hold a null sink by default and then never format or copy anything.
+     */
+    class DumpSink
+    {
+    public:
+        using Writer = std::function<void(std::ostream &)>;
+
+        virtual ~DumpSink() = default;
+
+        /**
+         * @brief Record the dump called name, whose text write produces
+         */
+        virtual void dump(const std::string &name, Writer write) = 0;
+    };
+
+    /**
+     * @brief Writes each dump to <directory>/<name> on a background thread
+     *
+     * The directory is created if missing. Dumps are written in the order
+     * they were handed over; flush() and the destructor wait for every
+     * pending dump. A file that cannot be written does not stop the others
+     * and is listed by failed().
+     */
+    class AsyncFileDumpSink : public DumpSink
+    {
+    public:
+        /**
+         * @throws std::runtime_error if directory does not exist and cannot be created
+         */
+        explicit AsyncFileDumpSink(std::string directory = ".") : directory_(std::move(directory))
+        {
+            std::error_code error;
+            std::filesystem::create_directories(directory_, error);
+            if (error)
+                throw std::runtime_error("Cannot create dump directory '" + directory_ + "': " + error.message());
+        }
+
+        ~AsyncFileDumpSink() override
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            if (worker_.joinable())
+                worker_.join();
+        }
+
+        void dump(const std::string &name, Writer write) override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.emplace_back(directory_ + "/" + name, std::move(write));
+            if (!worker_.joinable())
+                worker_ = std::thread([this]
+                                      { drain(); });
+            wake_.notify_all();
+        }
+
+        /**
+         * @brief Block until every dump handed over so far is written
+         *
+         * @return false if any dump so far could not be written
+         */
+        bool flush()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            idle_.wait(lock, [this]
+                       { return pending_.empty() && !writing_; });
+            return failed_.empty();
+        }
+
+        // Number of dump files written so far
+        size_t written() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return written_;
+        }
+
+        // Paths of the dumps that could not be written
+        std::vector<std::string> failed() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return failed_;
+        }
+
+    private:
+        void drain()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true)
+            {
+                wake_.wait(lock, [this]
+                           { return stopping_ || !pending_.empty(); });
+                if (pending_.empty())
+                    return;
+
+                std::pair<std::string, Writer> job = std::move(pending_.front());
+                pending_.pop_front();
+                writing_ = true;
+                lock.unlock();
+                bool ok = false;
+                {
+                    std::ofstream file(job.first);
+                    if (file.is_open())
+                    {
+                        job.second(file);
+                        file.close();
+                        ok = !file.fail();
+                    }
+                }
+                lock.lock();
+                if (ok)
+                    ++written_;
+                else
+                    failed_.push_back(std::move(job.first));
+                writing_ = false;
+                if (pending_.empty())
+                    idle_.notify_all();
+            }
+        }
+
+        std::string directory_;
+        mutable std::mutex mutex_;
+        std::condition_variable wake_; // Work arrived or shutting down
+        std::condition_variable idle_; // Queue drained
+        std::deque<std::pair<std::string, Writer>> pending_;
+        size_t written_ = 0;
+        std::vector<std::string> failed_;
+        bool writing_ = false;
+        bool stopping_ = false;
+        std::thread worker_;
+    };
+
+} // namespace NWQEC
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "nwqec/core/operation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NWQEC
+{
+    /**
+     * @brief Qubit dependency DAG over an existing operation list, in CSR form
+     *
+     * Each operand of each operation is one slot, and the slots of an
+     * operation are contiguous, in operation order.
+     * For every slot the graph stores the previous and next operation on that
+     * slot's qubit, which are exactly the predecessor and successor edges of
+     * DAGCircuit. Nothing else is kept: the operations are read in place and
+     * must outlive the graph, and the build is one pass with a last-slot
+     * array per qubit. Memory is two indices per operand and one per operation.
+     */
+    class DependencyGraph
+    {
+    public:
+        static constexpr size_t NONE = SIZE_MAX;
+
+        DependencyGraph() = default;
+
+        explicit DependencyGraph(const std::vector<Operation> &operations, size_t num_qubits = 0)
+        {
+            build(operations, num_qubits);
+        }
+
+        /**
+         * @brief Rebuild the graph for operations
+         * @param num_qubits Expected qubit count; larger indices are still accepted
+         */
+        void build(const std::vector<Operation> &operations, size_t num_qubits = 0)
+        {
+            ops_ = &operations;
+            slot_begin_.assign(operations.size() + 1, 0);
+            for (size_t i = 0; i < operations.size(); ++i)
+                slot_begin_[i + 1] = slot_begin_[i] + operations[i].get_qubits().size();
+
+            const size_t slots = slot_begin_.back();
+            prev_.assign(slots, NONE);
+            next_.assign(slots, NONE);
+
+            std::vector<size_t> last_slot(num_qubits, NONE);
+            std::vector<size_t> last_op(num_qubits, NONE);
+            for (size_t i = 0; i < operations.size(); ++i)
+            {
+                size_t slot = slot_begin_[i];
+                for (size_t qubit : operations[i].get_qubits())
+                {
+                    if (qubit >= last_slot.size())
+                    {
+                        last_slot.resize(qubit + 1, NONE);
+                        last_op.resize(qubit + 1, NONE);
+                    }
+                    if (last_slot[qubit] != NONE)
+                    {
+                        next_[last_slot[qubit]] = i;
+                        prev_[slot] = last_op[qubit];
+                    }
+                    last_slot[qubit] = slot;
+                    last_op[qubit] = i;
+                    ++slot;
+                }
+            }
+        }
+
+        size_t num_operations() const { return slot_begin_.empty() ? 0 : slot_begin_.size() - 1; }
+
+        // Next operation on operand k of op, or NONE
+        size_t successor(size_t op, size_t k) const { return next_[slot_begin_[op] + k]; }
+
+        // Previous operation on operand k of op, or NONE
+        size_t predecessor(size_t op, size_t k) const { return prev_[slot_begin_[op] + k]; }
+
+        // Next operation acting on qubit after op, or NONE if op does not act on it
+        size_t next_on_qubit(size_t op, size_t qubit) const
+        {
+            size_t k = operand_of(op, qubit);
+            return k == NONE ? NONE : successor(op, k);
+        }
+
+        // Previous operation acting on qubit before op, or NONE if op does not act on it
+        size_t prev_on_qubit(size_t op, size_t qubit) const
+        {
+            size_t k = operand_of(op, qubit);
+            return k == NONE ? NONE : predecessor(op, k);
+        }
+
+        bool is_root(size_t op) const
+        {
+            for (size_t s = slot_begin_[op]; s < slot_begin_[op + 1]; ++s)
+            {
+                if (prev_[s] != NONE)
+                    return false;
+            }
+            return true;
+        }
+
+        bool is_leaf(size_t op) const
+        {
+            for (size_t s = slot_begin_[op]; s < slot_begin_[op + 1]; ++s)
+            {
+                if (next_[s] != NONE)
+                    return false;
+            }
+            return true;
+        }
+
+    private:
+        size_t operand_of(size_t op, size_t qubit) const
+        {
+            const Operation::QubitSpan qubits = (*ops_)[op].get_qubits();
+            for (size_t k = 0; k < qubits.size(); ++k)
+            {
+                if (qubits[k] == qubit)
+                    return k;
+            }
+            return NONE;
+        }
+
+        const std::vector<Operation> *ops_ = nullptr;
+        std::vector<size_t> slot_begin_; // Operation i owns slots [slot_begin_[i], slot_begin_[i + 1])
+        std::vector<size_t> prev_;       // Per slot: previous operation on the slot's qubit
+        std::vector<size_t> next_;       // Per slot: next operation on the slot's qubit
+    };
+
+} // namespace NWQEC
@@ -8,11 +8,84 @@
 #include <cmath>
 #include <sstream>
 #include <algorithm>
-#include <set>
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
 #include "pauli_op.hpp"
 
 namespace NWQEC
 {
+    /**
+     * @brief Read-only view of the qubits, bits or parameters of an Operation
+     *
+     * Points into the Operation it came from, so it is only valid while that
+     * Operation is alive and has not been moved. It converts implicitly to a
+     * std::vector for callers that need to keep the values.
+     */
+    template <typename Stored, typename Value = Stored>
+    class OperandSpan
+    {
+    public:
+        using value_type = Value;
+        using const_iterator = const Stored *;
+
+        OperandSpan() = default;
+        OperandSpan(const Stored *data, size_t size) : data_(data), size_(size) {}
+
+        const Stored *begin() const { return data_; }
+        const Stored *end() const { return data_ + size_; }
+        const Stored *data() const { return data_; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        Value operator[](size_t i) const { return data_[i]; }
+        Value front() const { return data_[0]; }
+        Value back() const { return data_[size_ - 1]; }
+
+        std::vector<Value> to_vector() const { return std::vector<Value>(begin(), end()); }
+        operator std::vector<Value>() const { return to_vector(); }
+
+        bool operator==(const OperandSpan &other) const
+        {
+            return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+        }
+        bool operator!=(const OperandSpan &other) const { return !(*this == other); }
+
+    private:
+        const Stored *data_ = nullptr;
+        size_t size_ = 0;
+    };
+
+    /**
+     * @brief Operand list argument for building an Operation
+     *
+     * Accepts a braced list, a std::vector or another Operation's span
+     * without copying; only valid for the full expression it appears in.
+     */
+    template <typename Value, typename Stored = Value>
+    class OperandList
+    {
+    public:
+        OperandList(std::initializer_list<Value> values) : list_(values), size_(values.size()) {}
+        OperandList(const std::vector<Value> &values) : values_(values.data()), size_(values.size()) {}
+        OperandList(const OperandSpan<Stored, Value> &span) : stored_(span.data()), size_(span.size()) {}
+
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        Value operator[](size_t i) const
+        {
+            if (values_)
+                return values_[i];
+            return stored_ ? static_cast<Value>(stored_[i]) : list_.begin()[i];
+        }
+
+    private:
+        std::initializer_list<Value> list_; // Braced operands live until the end of the full expression
+        const Value *values_ = nullptr;
+        const Stored *stored_ = nullptr;
+        size_t size_ = 0;
+    };
 
     /**
      * Represents a quantum operation (gate, measurement, etc.) in a flattened circuit
@@ -20,7 +93,7 @@ namespace NWQEC
     class Operation
     {
     public:
-        enum class Type
+        enum class Type : uint8_t
         {
             // Single-qubit gates
             X,
@@ -84,56 +157,220 @@ namespace NWQEC
             S_PAULI,
             Z_PAULI,
             SWAP_BASIS,
+            // Synthesized RZ left unexpanded: get_sequence_index() indexes Circuit::rz_sequences()
+            RZ_SEQ,
         };
 
+        // Number of Type values, for tables indexed by type
+        static constexpr size_t NUM_TYPES = static_cast<size_t>(Type::RZ_SEQ) + 1;
+
+        using QubitSpan = OperandSpan<uint32_t, size_t>;
+        using ParamSpan = OperandSpan<double>;
+        using QubitList = OperandList<size_t, uint32_t>;
+        using ParamList = OperandList<double>;
+
+        // Operands stored in the Operation itself; larger lists spill to the heap
+        static constexpr size_t kInlineQubits = 3;
+
     private:
+        /**
+         * Everything that does not fit inline: the Pauli string of a PBC
+         * operation, and qubit, parameter or bit lists longer than the
+         * inline slots. Plain gates never allocate one.
+         */
+        struct Overflow
+        {
+            std::vector<uint32_t> qubits;
+            std::vector<double> parameters;
+            std::vector<uint32_t> bits;
+            PauliOp pauli_op;
+        };
+
+        static constexpr uint8_t kSpilled = 0xFF; // Count value: the list lives in overflow
+
+        // The inline parameter, or for RZ_SEQ (which has none) its sequence index
+        union Scalar
+        {
+            double param;
+            size_t sequence;
+        };
+
+        std::unique_ptr<Overflow> overflow;
+        Scalar scalar0 = {0.0};                     // Parameters for parameterized gates
+        uint32_t qubit_slots[kInlineQubits] = {}; // Global qubit indices
+        uint32_t bit0 = 0;                          // Classical bit index (for measurement)
         Type type;
-        std::vector<size_t> qubits;     // Global qubit indices
-        std::vector<double> parameters; // Parameters for parameterized gates
-        std::vector<size_t> bits;       // Classical bit indices (for measurement)
-        PauliOp pauli_op;               // For T_PAULI, M_PAULI, S_PAULI, and Z_PAULI operations
-        bool dagger;                    // Whether this is the dagger (conjugate transpose) of the operation
-        bool x_rotation;                // Whether this operation includes x rotation
-
-        std::vector<size_t> active_qubits(const PauliOp &pauli_op) const
+        uint8_t n_qubits = 0, n_params = 0, n_bits = 0;
+        bool dagger;     // Whether this is the dagger (conjugate transpose) of the operation
+        bool x_rotation; // Whether this operation includes x rotation
+
+        Overflow &spill()
+        {
+            if (!overflow)
+                overflow = std::make_unique<Overflow>();
+            return *overflow;
+        }
+
+        // Operands are stored as 32-bit indices
+        static uint32_t to_index(size_t index)
+        {
+            if (index > UINT32_MAX)
+                throw std::out_of_range("Operation: index " + std::to_string(index) +
+                                        " does not fit the 32-bit operand storage");
+            return static_cast<uint32_t>(index);
+        }
+
+        // Sorted qubits a Pauli string acts on
+        static std::vector<size_t> active_qubits(const PauliOp &pauli_op)
         {
             std::vector<size_t> involved_qubits;
-            
-            // Get X and Z indices from PauliOp and merge them
-            auto x_indices = pauli_op.get_x_indices();
-            auto z_indices = pauli_op.get_z_indices();
-            
-            // Combine and sort unique indices
-            std::set<size_t> unique_indices;
-            unique_indices.insert(x_indices.begin(), x_indices.end());
-            unique_indices.insert(z_indices.begin(), z_indices.end());
-            
-            involved_qubits.assign(unique_indices.begin(), unique_indices.end());
+            const uint64_t *x = pauli_op.x_words();
+            const uint64_t *z = pauli_op.z_words();
+            for (size_t w = 0; w < pauli_op.num_words(); ++w)
+            {
+                uint64_t bits = x[w] | z[w];
+                while (bits)
+                {
+                    involved_qubits.push_back(w * 64 + static_cast<size_t>(ctz_u64(bits)));
+                    bits &= bits - 1;
+                }
+            }
             return involved_qubits;
         }
 
+        void set_qubits(const QubitList &qubits)
+        {
+            if (qubits.size() <= kInlineQubits)
+            {
+                for (size_t i = 0; i < qubits.size(); ++i)
+                    qubit_slots[i] = to_index(qubits[i]);
+                n_qubits = static_cast<uint8_t>(qubits.size());
+                return;
+            }
+            std::vector<uint32_t> &spilled = spill().qubits;
+            spilled.reserve(qubits.size());
+            for (size_t i = 0; i < qubits.size(); ++i)
+                spilled.push_back(to_index(qubits[i]));
+            n_qubits = kSpilled;
+        }
+
     public:
         Operation(Type type,
-                  std::vector<size_t> qubits,
-                  std::vector<double> parameters = {},
-                  std::vector<size_t> bits = {},
+                  QubitList qubits,
+                  ParamList parameters = {},
+                  QubitList bits = {},
                   PauliOp pauli_op = PauliOp(),
                   bool dagger = false,
                   bool x_rotation = false)
-            : type(type),
-              qubits(qubits.empty() ? active_qubits(pauli_op) : std::move(qubits)),
-              parameters(std::move(parameters)),
-              bits(std::move(bits)),
-              pauli_op(std::move(pauli_op)),
-              dagger(dagger),
-              x_rotation(x_rotation) {}
+            : type(type), dagger(dagger), x_rotation(x_rotation)
+        {
+            if (pauli_op.get_num_qubits() != 0)
+            {
+                if (qubits.empty())
+                    set_qubits(active_qubits(pauli_op));
+                else
+                    set_qubits(qubits);
+                spill().pauli_op = std::move(pauli_op);
+            }
+            else
+            {
+                set_qubits(qubits);
+            }
+
+            if (parameters.size() <= 1)
+            {
+                scalar0.param = parameters.empty() ? 0.0 : parameters[0];
+                n_params = static_cast<uint8_t>(parameters.size());
+            }
+            else
+            {
+                std::vector<double> &spilled = spill().parameters;
+                for (size_t i = 0; i < parameters.size(); ++i)
+                    spilled.push_back(parameters[i]);
+                n_params = kSpilled;
+            }
+
+            if (bits.size() <= 1)
+            {
+                bit0 = bits.empty() ? 0 : to_index(bits[0]);
+                n_bits = static_cast<uint8_t>(bits.size());
+            }
+            else
+            {
+                std::vector<uint32_t> &spilled = spill().bits;
+                for (size_t i = 0; i < bits.size(); ++i)
+                    spilled.push_back(to_index(bits[i]));
+                n_bits = kSpilled;
+            }
+        }
+
+        Operation(const Operation &other)
+            : overflow(other.overflow ? std::make_unique<Overflow>(*other.overflow) : nullptr),
+              scalar0(other.scalar0), bit0(other.bit0), type(other.type),
+              n_qubits(other.n_qubits), n_params(other.n_params), n_bits(other.n_bits),
+              dagger(other.dagger), x_rotation(other.x_rotation)
+        {
+            std::copy(std::begin(other.qubit_slots), std::end(other.qubit_slots), std::begin(qubit_slots));
+        }
+
+        Operation(Operation &&) noexcept = default;
+        Operation &operator=(Operation &&) noexcept = default;
+
+        Operation &operator=(const Operation &other)
+        {
+            if (this != &other)
+            {
+                Operation copy(other);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
 
         Type get_type() const { return type; }
-        const std::vector<size_t> &get_qubits() const { return qubits; }
-        const std::vector<size_t> &get_bits() const { return bits; }
-        const std::vector<double> &get_parameters() const { return parameters; }
-        const PauliOp &get_pauli_op() const { return pauli_op; }
-        std::string get_pauli_string() const { return pauli_op.to_string(); }
+
+        QubitSpan get_qubits() const
+        {
+            if (n_qubits == kSpilled)
+                return QubitSpan(overflow->qubits.data(), overflow->qubits.size());
+            return QubitSpan(qubit_slots, n_qubits);
+        }
+
+        QubitSpan get_bits() const
+        {
+            if (n_bits == kSpilled)
+                return QubitSpan(overflow->bits.data(), overflow->bits.size());
+            return QubitSpan(&bit0, n_bits);
+        }
+
+        ParamSpan get_parameters() const
+        {
+            if (n_params == kSpilled)
+                return ParamSpan(overflow->parameters.data(), overflow->parameters.size());
+            return ParamSpan(&scalar0.param, n_params);
+        }
+
+        // An RZ_SEQ placeholder on qubit standing for Circuit::rz_sequences()[index]
+        static Operation rz_seq(size_t qubit, size_t index)
+        {
+            Operation op(Type::RZ_SEQ, {qubit});
+            op.scalar0.sequence = index;
+            return op;
+        }
+
+        // Which of Circuit::rz_sequences() an RZ_SEQ placeholder stands for
+        size_t get_sequence_index() const
+        {
+            assert(type == Type::RZ_SEQ);
+            return scalar0.sequence;
+        }
+
+        const PauliOp &get_pauli_op() const
+        {
+            static const PauliOp empty;
+            return overflow ? overflow->pauli_op : empty;
+        }
+
+        std::string get_pauli_string() const { return get_pauli_op().to_string(); }
         bool get_dagger() const { return dagger; }
         bool get_x_rotation() const { return x_rotation; }
 
@@ -279,6 +516,8 @@ namespace NWQEC
                 return "z_pauli";
             case Type::SWAP_BASIS:
                 return "swap_basis";
+            case Type::RZ_SEQ:
+                return "rz_seq";
             default:
                 return "unknown";
             }
@@ -504,21 +743,25 @@ namespace NWQEC
             if (type == Type::T_PAULI || type == Type::M_PAULI || type == Type::S_PAULI || type == Type::Z_PAULI)
             {
                 // Special case for T_PAULI, M_PAULI, S_PAULI, and Z_PAULI
-                os << " " << pauli_op.to_string() << ";";
+                os << " " << get_pauli_op().to_string() << ";";
                 return;
             }
             
             if (type == Type::SWAP_BASIS)
             {
                 // Special case for SWAP_BASIS - single qubit operation
-                if (!qubits.empty())
+                if (n_qubits != 0)
                 {
-                    os << " q[" << qubits[0] << "]";
+                    os << " q[" << get_qubits()[0] << "]";
                 }
                 os << ";";
                 return;
             }
 
+            const QubitSpan qubits = get_qubits();
+            const QubitSpan bits = get_bits();
+            const ParamSpan parameters = get_parameters();
+
             // Print parameters if any
             if (!parameters.empty())
             {
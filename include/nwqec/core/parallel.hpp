@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace NWQEC
+{
+    /**
+     * @brief Resolve a requested worker count
+     * @param requested Number of workers requested (0 = hardware concurrency)
+     * @return Number of workers to use (always >= 1)
+     */
+    inline size_t resolve_num_threads(size_t requested)
+    {
+        if (requested > 0)
+            return requested;
+        size_t hw = std::thread::hardware_concurrency();
+        return hw > 0 ? hw : 1;
+    }
+
+    /**
+     * @brief Run fn(state, i) for every i in [0, n), with one state object per worker
+     *
+     * Each worker calls make_state() once before taking work and passes the
+     * result to every fn call it makes, so per-worker scratch (solver buffers,
+     * caches) is reused across items without locking. Scheduling and error
+     * handling are those of parallel_for.
+     *
+     * @param n Number of work items
+     * @param num_threads Maximum number of workers (0 = hardware concurrency)
+     * @param make_state Callable returning a fresh worker state
+     * @param fn Callable invoked as fn(State &state, size_t index)
+     */
+    template <typename MakeState, typename Fn>
+    void parallel_for_with_state(size_t n, size_t num_threads, MakeState &&make_state, Fn &&fn)
+    {
+        size_t workers = std::min(resolve_num_threads(num_threads), n);
+        if (workers <= 1)
+        {
+            if (n == 0)
+                return;
+            auto state = make_state();
+            for (size_t i = 0; i < n; ++i)
+                fn(state, i);
+            return;
+        }
+
+        std::atomic<size_t> next{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr first_error;
+        std::mutex error_mutex;
+
+        auto worker = [&]()
+        {
+            try
+            {
+                auto state = make_state();
+                while (!failed.load(std::memory_order_relaxed))
+                {
+                    size_t i = next.fetch_add(1, std::memory_order_relaxed);
+                    if (i >= n)
+                        break;
+                    fn(state, i);
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!first_error)
+                    first_error = std::current_exception();
+                failed.store(true, std::memory_order_relaxed);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(workers - 1);
+        try
+        {
+            for (size_t t = 1; t < workers; ++t)
+                threads.emplace_back(worker);
+        }
+        catch (const std::system_error &)
+        {
+            // No more threads to be had: those already running share the work
+        }
+        worker();
+        for (auto &thread : threads)
+            thread.join();
+
+        if (first_error)
+            std::rethrow_exception(first_error);
+    }
+
+    /**
+     * @brief Run fn(i) for every i in [0, n) on up to num_threads workers
+     *
+     * Indices are handed out one at a time from a shared counter, so items with
+     * very different costs still balance across workers. The calling thread takes
+     * part in the work, and if the system refuses to start more threads the
+     * ones running take it all. If any invocation throws, the remaining indices are
+     * abandoned and the first exception is rethrown on the calling thread.
+     *
+     * @param n Number of work items
+     * @param num_threads Maximum number of workers (0 = hardware concurrency)
+     * @param fn Callable invoked as fn(size_t index)
+     */
+    template <typename Fn>
+    void parallel_for(size_t n, size_t num_threads, Fn &&fn)
+    {
+        parallel_for_with_state(
+            n, num_threads, []
+            { return 0; },
+            [&](int &, size_t i)
+            { fn(i); });
+    }
+
+} // namespace NWQEC
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "nwqec/passes/pass_template.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+namespace NWQEC
+{
+    /**
+     * @brief What the Transpiler knows about one pass of a pipeline
+     *
+     * on_pass_begin sees the name, index, start time and ops_before; the
+     * remaining fields are filled in for on_pass_end.
+     */
+    struct PassEvent
+    {
+        std::string name;                  // pass_type_to_string of the pass
+        size_t index = 0;                  // Position in the pass list
+        std::chrono::steady_clock::time_point start;
+        size_t ops_before = 0;
+        size_t ops_after = 0;
+        bool modified = false;
+        bool failed = false;               // The pass threw; ops_after is the unchanged count
+        double wall_ms = 0.0;
+        long peak_rss_delta_kb = 0;        // Growth of the process's peak RSS during the pass
+        PassCounters counters;             // From Pass::report_counters
+    };
+
+    /**
+     * @brief Callbacks around every pass of Transpiler::execute_passes
+     *
+     * Register observers in PassConfig::observers. With none registered the
+     * Transpiler takes no timings and collects no counters.
+     */
+    class PassObserver
+    {
+    public:
+        virtual ~PassObserver() = default;
+
+        virtual void on_pass_begin(const PassEvent &event) { (void)event; }
+        virtual void on_pass_end(const PassEvent &event) = 0;
+    };
+
+    // Peak resident set size of the process in kilobytes (0 where unavailable)
+    inline long peak_rss_kb()
+    {
+#if !defined(_WIN32)
+        struct rusage usage;
+        if (::getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+#if defined(__APPLE__)
+        return static_cast<long>(usage.ru_maxrss / 1024); // Bytes on macOS
+#else
+        return static_cast<long>(usage.ru_maxrss);
+#endif
+#else
+        return 0;
+#endif
+    }
+
+    /**
+     * @brief Records passes as Chrome trace events
+     *
+     * Each pass becomes a complete ("X") event whose args hold the operation
+     * counts, RSS growth and pass counters, on a track ("tid") per thread
+     * that ran passes, so pipelines of transpile_many do not overlap. The
+     * file loads in chrome://tracing and Perfetto. Events accumulate across
+     * pipelines; flush() appends the events recorded since the last flush
+     * and the destructor flushes.
+     */
+    class ChromeTraceObserver : public PassObserver
+    {
+    public:
+        explicit ChromeTraceObserver(std::string path)
+            : path_(std::move(path)), origin_(std::chrono::steady_clock::now()) {}
+
+        ~ChromeTraceObserver() override { flush(); }
+
+        void on_pass_end(const PassEvent &event) override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            // Tracks are numbered from 1 in the order threads first report
+            const auto track = tracks_.emplace(std::this_thread::get_id(), tracks_.size() + 1).first;
+            events_.push_back({event, track->second});
+        }
+
+        /**
+         * @brief Append the events recorded since the last flush to the trace file
+         *
+         * The first flush creates the file. Later ones write over its closing
+         * bracket and close it again, so every flush leaves a complete trace
+         * and costs only the new events.
+         *
+         * @return false if the file could not be written
+         */
+        bool flush()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!file_.is_open())
+            {
+                file_.open(path_, std::ios::binary | std::ios::trunc);
+                if (!file_)
+                    return false;
+                file_ << kHeader;
+                flushed_ = 0;
+                end_ = file_.tellp();
+            }
+            file_.seekp(end_);
+            for (; flushed_ < events_.size(); ++flushed_)
+                write_event(file_, flushed_);
+            end_ = file_.tellp();
+            file_ << kTrailer;
+            file_.flush();
+            return static_cast<bool>(file_);
+        }
+
+        // The whole trace as JSON
+        void write(std::ostream &os) const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            os << kHeader;
+            for (size_t i = 0; i < events_.size(); ++i)
+                write_event(os, i);
+            os << kTrailer;
+        }
+
+    private:
+        struct Recorded
+        {
+            PassEvent event;
+            size_t track = 0;
+        };
+
+        static constexpr const char *kHeader = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        static constexpr const char *kTrailer = "\n]}\n";
+
+        void write_event(std::ostream &os, size_t i) const
+        {
+            const PassEvent &e = events_[i].event;
+            const double ts = std::chrono::duration<double, std::micro>(e.start - origin_).count();
+            os << (i ? ",\n" : "\n") << "{\"name\":" << quoted(e.name)
+               << ",\"cat\":\"pass\",\"ph\":\"X\",\"pid\":1,\"tid\":" << events_[i].track
+               << ",\"ts\":" << number(ts) << ",\"dur\":" << number(e.wall_ms * 1000.0)
+               << ",\"args\":{\"index\":" << e.index
+               << ",\"ops_before\":" << e.ops_before << ",\"ops_after\":" << e.ops_after
+               << ",\"modified\":" << (e.modified ? "true" : "false")
+               << ",\"failed\":" << (e.failed ? "true" : "false")
+               << ",\"peak_rss_delta_kb\":" << e.peak_rss_delta_kb;
+            for (const auto &counter : e.counters)
+                os << "," << quoted(counter.first) << ":" << number(counter.second);
+            os << "}}";
+        }
+
+        static std::string quoted(const std::string &text)
+        {
+            std::string out = "\"";
+            for (char c : text)
+            {
+                if (c == '"' || c == '\\')
+                    out += '\\';
+                if (static_cast<unsigned char>(c) >= 0x20)
+                    out += c;
+            }
+            return out + "\"";
+        }
+
+        // JSON has no NaN or infinity
+        static std::string number(double value)
+        {
+            if (!std::isfinite(value))
+                return "null";
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+            return buffer;
+        }
+
+        std::string path_;
+        std::chrono::steady_clock::time_point origin_;
+        mutable std::mutex mutex_;
+        std::vector<Recorded> events_;
+        std::unordered_map<std::thread::id, size_t> tracks_;
+        std::ofstream file_;
+        size_t flushed_ = 0;              // Events already in file_
+        std::ofstream::pos_type end_ = 0; // Where the trailer starts in file_
+    };
+
+} // namespace NWQEC
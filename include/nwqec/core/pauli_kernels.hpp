@@ -0,0 +1,670 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <type_traits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#    include <immintrin.h>
+#    define NWQEC_SIMD_X86 1
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#    include <arm_neon.h>
+#    define NWQEC_SIMD_NEON 1
+#endif
+
+/**
+ * pauli_kernels.hpp
+ *
+ * Word-array kernels for multi-word Pauli rows (x and z bit planes of equal
+ * length): commutation test, phase-exponent sum, row multiplication (XOR) and
+ * support size. Scalar, AVX2, AVX-512BW and NEON versions are provided; the
+ * widest one the CPU supports is picked once at first use.
+ *
+ * Builds with NWQEC_SIMD_NATIVE defined (CMake: NWQEC_ENABLE_NATIVE) skip the
+ * runtime check and use the ISA the compiler targets. The NWQEC_SIMD
+ * environment variable (scalar, avx2, avx512, neon) overrides the choice when
+ * that ISA is available, which is mainly useful for testing.
+ *
+ * FixedWidthPauliKernels<W> are compile-time-width versions for rows of
+ * 1, 2, 4 or 8 words; dispatch_pauli_width picks one from a row stride.
+ */
+
+namespace NWQEC
+{
+    inline int popcount_u64(uint64_t value)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return static_cast<int>(__popcnt64(static_cast<unsigned __int64>(value)));
+#else
+        return __builtin_popcountll(static_cast<unsigned long long>(value));
+#endif
+    }
+
+    // Index of the lowest set bit; value must be non-zero
+    inline int ctz_u64(uint64_t value)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward64(&index, static_cast<unsigned __int64>(value));
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(static_cast<unsigned long long>(value));
+#endif
+    }
+
+    /**
+     * @brief Sum of the per-qubit phase exponents g(p1, p2) over one 64-qubit word
+     *
+     * For each qubit, g is +1 for the ordered pairs (Y,Z), (X,Y), (Z,X), -1 for
+     * (Y,X), (X,Z), (Z,Y) and 0 otherwise, so the word total is the popcount of
+     * the +1 lanes minus the popcount of the -1 lanes.
+     */
+    inline int pauli_g_word(uint64_t x1, uint64_t z1, uint64_t x2, uint64_t z2)
+    {
+        const uint64_t y1 = x1 & z1, xo1 = x1 & ~z1, zo1 = z1 & ~x1;
+        const uint64_t y2 = x2 & z2, xo2 = x2 & ~z2, zo2 = z2 & ~x2;
+        const uint64_t plus = (y1 & zo2) | (xo1 & y2) | (zo1 & xo2);
+        const uint64_t minus = (y1 & xo2) | (xo1 & zo2) | (zo1 & y2);
+        return popcount_u64(plus) - popcount_u64(minus);
+    }
+
+    enum class SimdIsa
+    {
+        Scalar,
+        AVX2,
+        AVX512,
+        NEON
+    };
+
+    /**
+     * @brief One ISA's implementation of the Pauli word kernels
+     */
+    struct PauliKernels
+    {
+        // True when rows (x1, z1) and (x2, z2) anticommute
+        bool (*anticommutes)(const uint64_t *x1, const uint64_t *z1,
+                             const uint64_t *x2, const uint64_t *z2, size_t words);
+        // Sum of pauli_g_word over all words (not reduced mod 4)
+        long long (*g_sum)(const uint64_t *x1, const uint64_t *z1,
+                           const uint64_t *x2, const uint64_t *z2, size_t words);
+        // (dx, dz) ^= (sx, sz)
+        void (*xor_into)(uint64_t *dx, uint64_t *dz,
+                         const uint64_t *sx, const uint64_t *sz, size_t words);
+        // Number of qubits with a non-identity Pauli
+        size_t (*support)(const uint64_t *x, const uint64_t *z, size_t words);
+        SimdIsa isa;
+        const char *name;
+    };
+
+    namespace pauli_kernels_detail
+    {
+        // ---------------------------------------------------------------- scalar
+
+        inline bool anticommutes_scalar(const uint64_t *x1, const uint64_t *z1,
+                                        const uint64_t *x2, const uint64_t *z2, size_t words)
+        {
+            // Parity of a sum of popcounts is the parity of the XOR of the words
+            uint64_t acc = 0;
+            for (size_t i = 0; i < words; ++i)
+                acc ^= (x1[i] & z2[i]) ^ (z1[i] & x2[i]);
+            return (popcount_u64(acc) & 1) != 0;
+        }
+
+        inline long long g_sum_scalar(const uint64_t *x1, const uint64_t *z1,
+                                      const uint64_t *x2, const uint64_t *z2, size_t words)
+        {
+            long long g = 0;
+            for (size_t i = 0; i < words; ++i)
+                g += pauli_g_word(x1[i], z1[i], x2[i], z2[i]);
+            return g;
+        }
+
+        inline void xor_into_scalar(uint64_t *dx, uint64_t *dz,
+                                    const uint64_t *sx, const uint64_t *sz, size_t words)
+        {
+            for (size_t i = 0; i < words; ++i)
+            {
+                dx[i] ^= sx[i];
+                dz[i] ^= sz[i];
+            }
+        }
+
+        inline size_t support_scalar(const uint64_t *x, const uint64_t *z, size_t words)
+        {
+            size_t n = 0;
+            for (size_t i = 0; i < words; ++i)
+                n += static_cast<size_t>(popcount_u64(x[i] | z[i]));
+            return n;
+        }
+
+#if defined(NWQEC_SIMD_X86)
+        // ------------------------------------------------------------------ AVX2
+
+        __attribute__((target("avx2"))) inline __m256i popcount_bytes_avx2(__m256i v)
+        {
+            const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+            const __m256i low = _mm256_set1_epi8(0x0f);
+            __m256i lo = _mm256_and_si256(v, low);
+            __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+            return _mm256_add_epi8(_mm256_shuffle_epi8(lut, lo), _mm256_shuffle_epi8(lut, hi));
+        }
+
+        __attribute__((target("avx2"))) inline uint64_t hsum_epi64_avx2(__m256i v)
+        {
+            alignas(32) uint64_t lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), v);
+            return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        }
+
+        __attribute__((target("avx2"))) inline bool anticommutes_avx2(const uint64_t *x1, const uint64_t *z1,
+                                                                      const uint64_t *x2, const uint64_t *z2, size_t words)
+        {
+            __m256i acc = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + 4 <= words; i += 4)
+            {
+                __m256i a = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(x1 + i)),
+                                             _mm256_loadu_si256(reinterpret_cast<const __m256i *>(z2 + i)));
+                __m256i b = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(z1 + i)),
+                                             _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x2 + i)));
+                acc = _mm256_xor_si256(acc, _mm256_xor_si256(a, b));
+            }
+            alignas(32) uint64_t lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), acc);
+            uint64_t folded = lanes[0] ^ lanes[1] ^ lanes[2] ^ lanes[3];
+            for (; i < words; ++i)
+                folded ^= (x1[i] & z2[i]) ^ (z1[i] & x2[i]);
+            return (popcount_u64(folded) & 1) != 0;
+        }
+
+        __attribute__((target("avx2"))) inline long long g_sum_avx2(const uint64_t *x1, const uint64_t *z1,
+                                                                    const uint64_t *x2, const uint64_t *z2, size_t words)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            __m256i plus_acc = zero, minus_acc = zero;
+            size_t i = 0;
+            for (; i + 4 <= words; i += 4)
+            {
+                __m256i vx1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x1 + i));
+                __m256i vz1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(z1 + i));
+                __m256i vx2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x2 + i));
+                __m256i vz2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(z2 + i));
+                __m256i y1 = _mm256_and_si256(vx1, vz1), xo1 = _mm256_andnot_si256(vz1, vx1), zo1 = _mm256_andnot_si256(vx1, vz1);
+                __m256i y2 = _mm256_and_si256(vx2, vz2), xo2 = _mm256_andnot_si256(vz2, vx2), zo2 = _mm256_andnot_si256(vx2, vz2);
+                __m256i plus = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(y1, zo2), _mm256_and_si256(xo1, y2)),
+                                               _mm256_and_si256(zo1, xo2));
+                __m256i minus = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(y1, xo2), _mm256_and_si256(xo1, zo2)),
+                                                _mm256_and_si256(zo1, y2));
+                plus_acc = _mm256_add_epi64(plus_acc, _mm256_sad_epu8(popcount_bytes_avx2(plus), zero));
+                minus_acc = _mm256_add_epi64(minus_acc, _mm256_sad_epu8(popcount_bytes_avx2(minus), zero));
+            }
+            long long g = static_cast<long long>(hsum_epi64_avx2(plus_acc)) - static_cast<long long>(hsum_epi64_avx2(minus_acc));
+            for (; i < words; ++i)
+                g += pauli_g_word(x1[i], z1[i], x2[i], z2[i]);
+            return g;
+        }
+
+        __attribute__((target("avx2"))) inline void xor_into_avx2(uint64_t *dx, uint64_t *dz,
+                                                                  const uint64_t *sx, const uint64_t *sz, size_t words)
+        {
+            size_t i = 0;
+            for (; i + 4 <= words; i += 4)
+            {
+                __m256i *px = reinterpret_cast<__m256i *>(dx + i);
+                __m256i *pz = reinterpret_cast<__m256i *>(dz + i);
+                _mm256_storeu_si256(px, _mm256_xor_si256(_mm256_loadu_si256(px),
+                                                         _mm256_loadu_si256(reinterpret_cast<const __m256i *>(sx + i))));
+                _mm256_storeu_si256(pz, _mm256_xor_si256(_mm256_loadu_si256(pz),
+                                                         _mm256_loadu_si256(reinterpret_cast<const __m256i *>(sz + i))));
+            }
+            for (; i < words; ++i)
+            {
+                dx[i] ^= sx[i];
+                dz[i] ^= sz[i];
+            }
+        }
+
+        __attribute__((target("avx2"))) inline size_t support_avx2(const uint64_t *x, const uint64_t *z, size_t words)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            __m256i acc = zero;
+            size_t i = 0;
+            for (; i + 4 <= words; i += 4)
+            {
+                __m256i v = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + i)),
+                                            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(z + i)));
+                acc = _mm256_add_epi64(acc, _mm256_sad_epu8(popcount_bytes_avx2(v), zero));
+            }
+            size_t n = static_cast<size_t>(hsum_epi64_avx2(acc));
+            for (; i < words; ++i)
+                n += static_cast<size_t>(popcount_u64(x[i] | z[i]));
+            return n;
+        }
+
+        // --------------------------------------------------------------- AVX-512
+
+#    define NWQEC_AVX512_TARGET __attribute__((target("avx512f,avx512bw")))
+
+        // Plain-operator forms: GCC 12 warns on the masked-undefined intrinsics
+        NWQEC_AVX512_TARGET inline __m512i andnot_avx512(__m512i a, __m512i b) { return _mm512_xor_si512(_mm512_or_si512(a, b), a); }
+
+        NWQEC_AVX512_TARGET inline long long hsum_epi64_avx512(__m512i v)
+        {
+            alignas(64) long long lanes[8];
+            _mm512_store_si512(lanes, v);
+            long long sum = 0;
+            for (long long lane : lanes)
+                sum += lane;
+            return sum;
+        }
+
+        NWQEC_AVX512_TARGET inline __m512i popcount_bytes_avx512(__m512i v)
+        {
+            // Nibble popcounts 0..15, packed little-endian into each 128-bit lane
+            const __m512i lut = _mm512_set4_epi32(0x04030302, 0x03020201, 0x03020201, 0x02010100);
+            const __m512i low = _mm512_set1_epi8(0x0f);
+            __m512i lo = _mm512_and_si512(v, low);
+            __m512i hi = _mm512_and_si512(_mm512_srli_epi16(v, 4), low);
+            return _mm512_add_epi8(_mm512_shuffle_epi8(lut, lo), _mm512_shuffle_epi8(lut, hi));
+        }
+
+        NWQEC_AVX512_TARGET inline bool anticommutes_avx512(const uint64_t *x1, const uint64_t *z1,
+                                                            const uint64_t *x2, const uint64_t *z2, size_t words)
+        {
+            __m512i acc = _mm512_setzero_si512();
+            size_t i = 0;
+            for (; i + 8 <= words; i += 8)
+            {
+                __m512i a = _mm512_and_si512(_mm512_loadu_si512(x1 + i), _mm512_loadu_si512(z2 + i));
+                __m512i b = _mm512_and_si512(_mm512_loadu_si512(z1 + i), _mm512_loadu_si512(x2 + i));
+                acc = _mm512_xor_si512(acc, _mm512_xor_si512(a, b));
+            }
+            alignas(64) uint64_t lanes[8];
+            _mm512_store_si512(lanes, acc);
+            uint64_t folded = 0;
+            for (uint64_t lane : lanes)
+                folded ^= lane;
+            for (; i < words; ++i)
+                folded ^= (x1[i] & z2[i]) ^ (z1[i] & x2[i]);
+            return (popcount_u64(folded) & 1) != 0;
+        }
+
+        NWQEC_AVX512_TARGET inline long long g_sum_avx512(const uint64_t *x1, const uint64_t *z1,
+                                                          const uint64_t *x2, const uint64_t *z2, size_t words)
+        {
+            const __m512i zero = _mm512_setzero_si512();
+            __m512i plus_acc = zero, minus_acc = zero;
+            size_t i = 0;
+            for (; i + 8 <= words; i += 8)
+            {
+                __m512i vx1 = _mm512_loadu_si512(x1 + i), vz1 = _mm512_loadu_si512(z1 + i);
+                __m512i vx2 = _mm512_loadu_si512(x2 + i), vz2 = _mm512_loadu_si512(z2 + i);
+                __m512i y1 = _mm512_and_si512(vx1, vz1), xo1 = andnot_avx512(vz1, vx1), zo1 = andnot_avx512(vx1, vz1);
+                __m512i y2 = _mm512_and_si512(vx2, vz2), xo2 = andnot_avx512(vz2, vx2), zo2 = andnot_avx512(vx2, vz2);
+                __m512i plus = _mm512_or_si512(_mm512_or_si512(_mm512_and_si512(y1, zo2), _mm512_and_si512(xo1, y2)),
+                                               _mm512_and_si512(zo1, xo2));
+                __m512i minus = _mm512_or_si512(_mm512_or_si512(_mm512_and_si512(y1, xo2), _mm512_and_si512(xo1, zo2)),
+                                                _mm512_and_si512(zo1, y2));
+                plus_acc = _mm512_add_epi64(plus_acc, _mm512_sad_epu8(popcount_bytes_avx512(plus), zero));
+                minus_acc = _mm512_add_epi64(minus_acc, _mm512_sad_epu8(popcount_bytes_avx512(minus), zero));
+            }
+            long long g = hsum_epi64_avx512(plus_acc) - hsum_epi64_avx512(minus_acc);
+            for (; i < words; ++i)
+                g += pauli_g_word(x1[i], z1[i], x2[i], z2[i]);
+            return g;
+        }
+
+        NWQEC_AVX512_TARGET inline void xor_into_avx512(uint64_t *dx, uint64_t *dz,
+                                                        const uint64_t *sx, const uint64_t *sz, size_t words)
+        {
+            size_t i = 0;
+            for (; i + 8 <= words; i += 8)
+            {
+                _mm512_storeu_si512(dx + i, _mm512_xor_si512(_mm512_loadu_si512(dx + i), _mm512_loadu_si512(sx + i)));
+                _mm512_storeu_si512(dz + i, _mm512_xor_si512(_mm512_loadu_si512(dz + i), _mm512_loadu_si512(sz + i)));
+            }
+            for (; i < words; ++i)
+            {
+                dx[i] ^= sx[i];
+                dz[i] ^= sz[i];
+            }
+        }
+
+        NWQEC_AVX512_TARGET inline size_t support_avx512(const uint64_t *x, const uint64_t *z, size_t words)
+        {
+            const __m512i zero = _mm512_setzero_si512();
+            __m512i acc = zero;
+            size_t i = 0;
+            for (; i + 8 <= words; i += 8)
+            {
+                __m512i v = _mm512_or_si512(_mm512_loadu_si512(x + i), _mm512_loadu_si512(z + i));
+                acc = _mm512_add_epi64(acc, _mm512_sad_epu8(popcount_bytes_avx512(v), zero));
+            }
+            size_t n = static_cast<size_t>(hsum_epi64_avx512(acc));
+            for (; i < words; ++i)
+                n += static_cast<size_t>(popcount_u64(x[i] | z[i]));
+            return n;
+        }
+
+#    undef NWQEC_AVX512_TARGET
+#endif // NWQEC_SIMD_X86
+
+#if defined(NWQEC_SIMD_NEON)
+        // ------------------------------------------------------------------ NEON
+
+        inline uint64x2_t popcount_u64x2_neon(uint64x2_t v)
+        {
+            return vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(vcntq_u8(vreinterpretq_u8_u64(v)))));
+        }
+
+        inline bool anticommutes_neon(const uint64_t *x1, const uint64_t *z1,
+                                      const uint64_t *x2, const uint64_t *z2, size_t words)
+        {
+            uint64x2_t acc = vdupq_n_u64(0);
+            size_t i = 0;
+            for (; i + 2 <= words; i += 2)
+            {
+                uint64x2_t a = vandq_u64(vld1q_u64(x1 + i), vld1q_u64(z2 + i));
+                uint64x2_t b = vandq_u64(vld1q_u64(z1 + i), vld1q_u64(x2 + i));
+                acc = veorq_u64(acc, veorq_u64(a, b));
+            }
+            uint64_t folded = vgetq_lane_u64(acc, 0) ^ vgetq_lane_u64(acc, 1);
+            for (; i < words; ++i)
+                folded ^= (x1[i] & z2[i]) ^ (z1[i] & x2[i]);
+            return (popcount_u64(folded) & 1) != 0;
+        }
+
+        inline long long g_sum_neon(const uint64_t *x1, const uint64_t *z1,
+                                    const uint64_t *x2, const uint64_t *z2, size_t words)
+        {
+            uint64x2_t plus_acc = vdupq_n_u64(0), minus_acc = vdupq_n_u64(0);
+            size_t i = 0;
+            for (; i + 2 <= words; i += 2)
+            {
+                uint64x2_t vx1 = vld1q_u64(x1 + i), vz1 = vld1q_u64(z1 + i);
+                uint64x2_t vx2 = vld1q_u64(x2 + i), vz2 = vld1q_u64(z2 + i);
+                uint64x2_t y1 = vandq_u64(vx1, vz1), xo1 = vbicq_u64(vx1, vz1), zo1 = vbicq_u64(vz1, vx1);
+                uint64x2_t y2 = vandq_u64(vx2, vz2), xo2 = vbicq_u64(vx2, vz2), zo2 = vbicq_u64(vz2, vx2);
+                uint64x2_t plus = vorrq_u64(vorrq_u64(vandq_u64(y1, zo2), vandq_u64(xo1, y2)), vandq_u64(zo1, xo2));
+                uint64x2_t minus = vorrq_u64(vorrq_u64(vandq_u64(y1, xo2), vandq_u64(xo1, zo2)), vandq_u64(zo1, y2));
+                plus_acc = vaddq_u64(plus_acc, popcount_u64x2_neon(plus));
+                minus_acc = vaddq_u64(minus_acc, popcount_u64x2_neon(minus));
+            }
+            long long g = static_cast<long long>(vgetq_lane_u64(plus_acc, 0) + vgetq_lane_u64(plus_acc, 1)) -
+                          static_cast<long long>(vgetq_lane_u64(minus_acc, 0) + vgetq_lane_u64(minus_acc, 1));
+            for (; i < words; ++i)
+                g += pauli_g_word(x1[i], z1[i], x2[i], z2[i]);
+            return g;
+        }
+
+        inline void xor_into_neon(uint64_t *dx, uint64_t *dz,
+                                  const uint64_t *sx, const uint64_t *sz, size_t words)
+        {
+            size_t i = 0;
+            for (; i + 2 <= words; i += 2)
+            {
+                vst1q_u64(dx + i, veorq_u64(vld1q_u64(dx + i), vld1q_u64(sx + i)));
+                vst1q_u64(dz + i, veorq_u64(vld1q_u64(dz + i), vld1q_u64(sz + i)));
+            }
+            for (; i < words; ++i)
+            {
+                dx[i] ^= sx[i];
+                dz[i] ^= sz[i];
+            }
+        }
+
+        inline size_t support_neon(const uint64_t *x, const uint64_t *z, size_t words)
+        {
+            uint64x2_t acc = vdupq_n_u64(0);
+            size_t i = 0;
+            for (; i + 2 <= words; i += 2)
+                acc = vaddq_u64(acc, popcount_u64x2_neon(vorrq_u64(vld1q_u64(x + i), vld1q_u64(z + i))));
+            size_t n = static_cast<size_t>(vgetq_lane_u64(acc, 0) + vgetq_lane_u64(acc, 1));
+            for (; i < words; ++i)
+                n += static_cast<size_t>(popcount_u64(x[i] | z[i]));
+            return n;
+        }
+#endif // NWQEC_SIMD_NEON
+
+        inline bool cpu_supports(SimdIsa isa)
+        {
+            switch (isa)
+            {
+            case SimdIsa::Scalar:
+                return true;
+#if defined(NWQEC_SIMD_X86)
+            case SimdIsa::AVX2:
+                return __builtin_cpu_supports("avx2");
+            case SimdIsa::AVX512:
+                return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+#if defined(NWQEC_SIMD_NEON)
+            case SimdIsa::NEON:
+                return true;
+#endif
+            default:
+                return false;
+            }
+        }
+
+        // ISA pinned at compile time by NWQEC_SIMD_NATIVE
+        inline SimdIsa native_isa()
+        {
+#if defined(NWQEC_SIMD_X86) && defined(__AVX512F__) && defined(__AVX512BW__)
+            return SimdIsa::AVX512;
+#elif defined(NWQEC_SIMD_X86) && defined(__AVX2__)
+            return SimdIsa::AVX2;
+#elif defined(NWQEC_SIMD_NEON)
+            return SimdIsa::NEON;
+#else
+            return SimdIsa::Scalar;
+#endif
+        }
+    } // namespace pauli_kernels_detail
+
+    /**
+     * @brief Kernel table for a given ISA, or nullptr if this build or CPU lacks it
+     */
+    inline const PauliKernels *pauli_kernels_for(SimdIsa isa)
+    {
+        using namespace pauli_kernels_detail;
+        static const PauliKernels scalar{anticommutes_scalar, g_sum_scalar, xor_into_scalar, support_scalar,
+                                         SimdIsa::Scalar, "scalar"};
+#if defined(NWQEC_SIMD_X86)
+        static const PauliKernels avx2{anticommutes_avx2, g_sum_avx2, xor_into_avx2, support_avx2,
+                                       SimdIsa::AVX2, "avx2"};
+        static const PauliKernels avx512{anticommutes_avx512, g_sum_avx512, xor_into_avx512, support_avx512,
+                                         SimdIsa::AVX512, "avx512"};
+#endif
+#if defined(NWQEC_SIMD_NEON)
+        static const PauliKernels neon{anticommutes_neon, g_sum_neon, xor_into_neon, support_neon,
+                                       SimdIsa::NEON, "neon"};
+#endif
+        if (!cpu_supports(isa))
+            return nullptr;
+        switch (isa)
+        {
+#if defined(NWQEC_SIMD_X86)
+        case SimdIsa::AVX2:
+            return &avx2;
+        case SimdIsa::AVX512:
+            return &avx512;
+#endif
+#if defined(NWQEC_SIMD_NEON)
+        case SimdIsa::NEON:
+            return &neon;
+#endif
+        default:
+            return &scalar;
+        }
+    }
+
+    /**
+     * @brief Kernel table selected for this process (resolved once)
+     */
+    inline const PauliKernels &pauli_kernels()
+    {
+        static const PauliKernels *selected = []
+        {
+            using namespace pauli_kernels_detail;
+            if (const char *env = std::getenv("NWQEC_SIMD"))
+            {
+                const struct
+                {
+                    const char *name;
+                    SimdIsa isa;
+                } names[] = {{"scalar", SimdIsa::Scalar}, {"avx2", SimdIsa::AVX2}, {"avx512", SimdIsa::AVX512}, {"neon", SimdIsa::NEON}};
+                for (const auto &entry : names)
+                    if (std::strcmp(env, entry.name) == 0)
+                        if (const PauliKernels *k = pauli_kernels_for(entry.isa))
+                            return k;
+            }
+#if defined(NWQEC_SIMD_NATIVE)
+            return pauli_kernels_for(native_isa());
+#else
+            for (SimdIsa isa : {SimdIsa::AVX512, SimdIsa::AVX2, SimdIsa::NEON})
+                if (const PauliKernels *k = pauli_kernels_for(isa))
+                    return k;
+            return pauli_kernels_for(SimdIsa::Scalar);
+#endif
+        }();
+        return *selected;
+    }
+
+    /**
+     * @brief Pauli word kernels for rows of exactly W words
+     *
+     * The loops have constant trip counts, so the compiler unrolls them and
+     * keeps the rows in registers; callers pass rows padded to W words with
+     * zeros. Without a hardware popcount (__POPCNT__ / NEON) the bit counts
+     * are accumulated per byte across the row and reduced once, which is far
+     * cheaper than one library popcount call per word.
+     */
+    template <size_t W>
+    struct FixedWidthPauliKernels
+    {
+        static_assert(W == 1 || W == 2 || W == 4 || W == 8, "unsupported fixed Pauli width");
+
+        static bool anticommutes(const uint64_t *x1, const uint64_t *z1,
+                                 const uint64_t *x2, const uint64_t *z2)
+        {
+            uint64_t acc = 0;
+            for (size_t i = 0; i < W; ++i)
+                acc ^= (x1[i] & z2[i]) ^ (z1[i] & x2[i]);
+            return parity(acc);
+        }
+
+        // As anticommutes, ignoring qubits whose bit is clear in mask
+        static bool anticommutes_masked(const uint64_t *x1, const uint64_t *z1,
+                                        const uint64_t *x2, const uint64_t *z2, const uint64_t *mask)
+        {
+            uint64_t acc = 0;
+            for (size_t i = 0; i < W; ++i)
+                acc ^= ((x1[i] & z2[i]) ^ (z1[i] & x2[i])) & mask[i];
+            return parity(acc);
+        }
+
+        // Sum of pauli_g_word over the masked words, mod 4
+        static int g_sum_masked(const uint64_t *x1, const uint64_t *z1,
+                                const uint64_t *x2, const uint64_t *z2, const uint64_t *mask)
+        {
+#if defined(__POPCNT__) || defined(NWQEC_SIMD_NEON)
+            int g = 0;
+            for (size_t i = 0; i < W; ++i)
+                g += pauli_g_word(x1[i] & mask[i], z1[i] & mask[i], x2[i] & mask[i], z2[i] & mask[i]);
+            return g & 3;
+#else
+            // Per-byte counts stay below 256 for up to 8 words
+            uint64_t plus_bytes = 0, minus_bytes = 0;
+            for (size_t i = 0; i < W; ++i)
+            {
+                const uint64_t a_x = x1[i] & mask[i], a_z = z1[i] & mask[i];
+                const uint64_t b_x = x2[i] & mask[i], b_z = z2[i] & mask[i];
+                const uint64_t y1 = a_x & a_z, xo1 = a_x & ~a_z, zo1 = a_z & ~a_x;
+                const uint64_t y2 = b_x & b_z, xo2 = b_x & ~b_z, zo2 = b_z & ~b_x;
+                plus_bytes += byte_counts((y1 & zo2) | (xo1 & y2) | (zo1 & xo2));
+                minus_bytes += byte_counts((y1 & xo2) | (xo1 & zo2) | (zo1 & y2));
+            }
+            // Only the total mod 4 is needed, so each byte can be reduced mod 4 first
+            const uint64_t low2 = 0x0303030303030303ULL;
+            const int plus = static_cast<int>(((plus_bytes & low2) * 0x0101010101010101ULL) >> 56);
+            const int minus = static_cast<int>(((minus_bytes & low2) * 0x0101010101010101ULL) >> 56);
+            return (plus - minus) & 3;
+#endif
+        }
+
+        static void xor_into(uint64_t *dx, uint64_t *dz, const uint64_t *sx, const uint64_t *sz)
+        {
+            for (size_t i = 0; i < W; ++i)
+            {
+                dx[i] ^= sx[i];
+                dz[i] ^= sz[i];
+            }
+        }
+
+        static bool equal(const uint64_t *x1, const uint64_t *z1, const uint64_t *x2, const uint64_t *z2)
+        {
+            uint64_t diff = 0;
+            for (size_t i = 0; i < W; ++i)
+                diff |= (x1[i] ^ x2[i]) | (z1[i] ^ z2[i]);
+            return diff == 0;
+        }
+
+    private:
+        static bool parity(uint64_t v)
+        {
+#if defined(__POPCNT__) || defined(NWQEC_SIMD_NEON)
+            return (popcount_u64(v) & 1) != 0;
+#else
+            v ^= v >> 32;
+            v ^= v >> 16;
+            v ^= v >> 8;
+            v ^= v >> 4;
+            return ((0x6996u >> (v & 0xf)) & 1) != 0;
+#endif
+        }
+
+        // Popcount of each byte of v, in that byte
+        static uint64_t byte_counts(uint64_t v)
+        {
+            v = v - ((v >> 1) & 0x5555555555555555ULL);
+            v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+            return (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        }
+    };
+
+    /**
+     * @brief Call fn(std::integral_constant<size_t, W>{}) for the fixed width matching stride
+     *
+     * W is the stride when it is 1, 2, 4 or 8 words and 0 (runtime width)
+     * otherwise, so callers instantiate one specialized code path per circuit.
+     */
+    template <typename Fn>
+    decltype(auto) dispatch_pauli_width(size_t stride, Fn &&fn)
+    {
+        switch (stride)
+        {
+        case 1:
+            return fn(std::integral_constant<size_t, 1>{});
+        case 2:
+            return fn(std::integral_constant<size_t, 2>{});
+        case 4:
+            return fn(std::integral_constant<size_t, 4>{});
+        case 8:
+            return fn(std::integral_constant<size_t, 8>{});
+        default:
+            return fn(std::integral_constant<size_t, 0>{});
+        }
+    }
+
+} // namespace NWQEC
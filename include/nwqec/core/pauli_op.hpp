@@ -7,6 +7,8 @@
 #include <iostream>
 #include <iomanip>
 
+#include "pauli_kernels.hpp"
+
 namespace NWQEC
 {
     enum class RowType
@@ -51,6 +53,13 @@ namespace NWQEC
         void set_phase(bool p) { phase = p; }
         size_t get_num_qubits() const { return num_qubits; }
         size_t get_weight() const { return weight; }
+        // Number of qubits acted on non-trivially, counted from the bits
+        size_t support_size() const
+        {
+            if (is_small_circuit)
+                return static_cast<size_t>(popcount_u64(x_bits_small | z_bits_small));
+            return pauli_kernels().support(x_bits_large.data(), z_bits_large.data(), x_bits_large.size());
+        }
         bool is_valid() const { return valid; }
         void set_valid(bool v) { valid = v; }
         RowType get_rowtype() const { return rowtype; }
@@ -67,6 +76,26 @@ namespace NWQEC
         std::vector<uint64_t>& get_x_bits_large() { return x_bits_large; }
         std::vector<uint64_t>& get_z_bits_large() { return z_bits_large; }
 
+        // Word-level access independent of the small/large representation
+        size_t num_words() const { return is_small_circuit ? 1 : x_bits_large.size(); }
+        const uint64_t *x_words() const { return is_small_circuit ? &x_bits_small : x_bits_large.data(); }
+        const uint64_t *z_words() const { return is_small_circuit ? &z_bits_small : z_bits_large.data(); }
+
+        // Replace the X and Z bits with num_words() words from x and z
+        void assign_words(const uint64_t *x, const uint64_t *z)
+        {
+            const size_t words = num_words();
+            uint64_t *dst_x = is_small_circuit ? &x_bits_small : x_bits_large.data();
+            uint64_t *dst_z = is_small_circuit ? &z_bits_small : z_bits_large.data();
+            weight = 0;
+            for (size_t w = 0; w < words; ++w)
+            {
+                dst_x[w] = x[w];
+                dst_z[w] = z[w];
+                weight += static_cast<size_t>(popcount_u64(x[w]) + popcount_u64(z[w]));
+            }
+        }
+
         void from_string(const std::string &pauli_str)
         {
             phase = (pauli_str[0] == '-');
@@ -426,4 +455,40 @@ namespace NWQEC
         }
     };
 
+
+    /**
+     * @brief Phase exponent of the product of two word arrays over the first n_qubits, mod 4
+     *
+     * Word-level equivalent of summing g over every qubit. Bits at or above
+     * n_qubits are ignored.
+     */
+    inline int pauli_g_words(const uint64_t *x1, const uint64_t *z1,
+                             const uint64_t *x2, const uint64_t *z2,
+                             size_t words, size_t n_qubits)
+    {
+        const size_t full_words = std::min(words, n_qubits / 64);
+        int g_val = 0;
+        if (full_words == 1)
+            g_val = pauli_g_word(x1[0], z1[0], x2[0], z2[0]);
+        else if (full_words > 1)
+            g_val = static_cast<int>(pauli_kernels().g_sum(x1, z1, x2, z2, full_words) & 3);
+        const size_t rem = n_qubits % 64;
+        if (rem != 0 && full_words < words)
+        {
+            const uint64_t mask = (1ULL << rem) - 1;
+            g_val += pauli_g_word(x1[full_words] & mask, z1[full_words] & mask,
+                                  x2[full_words] & mask, z2[full_words] & mask);
+        }
+        return g_val & 3;
+    }
+
+    /**
+     * @brief Phase exponent of the product p1·p2 over the first n_qubits, mod 4
+     */
+    inline int pauli_g_function(const PauliOp &p1, const PauliOp &p2, size_t n_qubits)
+    {
+        return pauli_g_words(p1.x_words(), p1.z_words(), p2.x_words(), p2.z_words(),
+                             p1.num_words(), n_qubits);
+    }
+
 } // namespace NWQEC
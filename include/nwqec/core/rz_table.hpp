@@ -0,0 +1,264 @@
+#pragma once
+
+#include "nwqec/parser/mapped_file.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <ios>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace NWQEC
+{
+    // gridsynth inputs exactly as SynthesizeRzPass formats them
+    inline std::string synthesis_theta_string(double angle)
+    {
+        return std::to_string(angle);
+    }
+
+    // Scientific notation to avoid truncation
+    inline std::string synthesis_epsilon_string(double epsilon)
+    {
+        std::ostringstream eps_ss;
+        eps_ss.setf(std::ios::scientific);
+        eps_ss << std::setprecision(16) << epsilon;
+        return eps_ss.str();
+    }
+
+    /**
+     * @brief Read-only table of precomputed RZ sequences, looked up in place in a mapped file
+     *
+     * Entries are keyed by the theta and epsilon strings gridsynth is called
+     * with, so a hit returns exactly what synthesizing that request would.
+     * The file (little-endian) is:
+     *
+     *     "NWQRZTAB" | u32 version | u32 count
+     *     count x { u64 key | u32 offset | u32 gate count }   sorted by key
+     *     records: u8 theta length, theta, u8 epsilon length, epsilon,
+     *              gates as 4-bit codes, two per byte
+     *
+     * The key is an FNV-1a hash; the strings stored in the record confirm a
+     * match. Only the index and the records that are looked up are paged in.
+     */
+    class RzTable
+    {
+    public:
+        static constexpr uint32_t VERSION = 1;
+
+        struct Entry
+        {
+            std::string theta;
+            std::string epsilon;
+            std::string gates;
+        };
+
+        /**
+         * @brief Map a table file
+         * @return false if it is missing, truncated or of another version
+         */
+        bool open(const std::string &path)
+        {
+            count_ = 0;
+            if (!file_.open(path, false))
+                return false;
+            const std::string_view data = file_.view();
+            if (data.size() < HEADER_BYTES || data.compare(0, 8, MAGIC) != 0 || read_u32(data, 8) != VERSION)
+                return false;
+            const uint32_t count = read_u32(data, 12);
+            if (data.size() < HEADER_BYTES + static_cast<size_t>(count) * INDEX_BYTES)
+                return false;
+            count_ = count;
+            return true;
+        }
+
+        size_t size() const { return count_; }
+
+        /**
+         * @brief Gate string stored for (theta, epsilon), if any
+         */
+        std::optional<std::string> lookup(const std::string &theta, const std::string &epsilon) const
+        {
+            const std::string_view data = file_.view();
+            const uint64_t k = key(theta, epsilon);
+            size_t lo = 0, hi = count_;
+            while (lo < hi)
+            {
+                const size_t mid = lo + (hi - lo) / 2;
+                if (read_u64(data, index_at(mid)) < k)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            for (; lo < count_ && read_u64(data, index_at(lo)) == k; ++lo)
+            {
+                if (auto gates = read_record(data, lo, theta, epsilon))
+                    return gates;
+            }
+            return std::nullopt;
+        }
+
+        /**
+         * @brief Write entries as a table file
+         * @return false if the file could not be written
+         */
+        static bool write(const std::string &path, std::vector<Entry> entries)
+        {
+            std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b)
+                      { return key(a.theta, a.epsilon) < key(b.theta, b.epsilon); });
+
+            std::string index, records;
+            for (const Entry &entry : entries)
+            {
+                if (entry.theta.size() > 255 || entry.epsilon.size() > 255)
+                    return false;
+                append_u64(index, key(entry.theta, entry.epsilon));
+                append_u32(index, static_cast<uint32_t>(records.size()));
+                append_u32(index, static_cast<uint32_t>(entry.gates.size()));
+                records += static_cast<char>(entry.theta.size());
+                records += entry.theta;
+                records += static_cast<char>(entry.epsilon.size());
+                records += entry.epsilon;
+                if (std::any_of(entry.gates.begin(), entry.gates.end(), [](char gate)
+                                { return gate_code(gate) == 0; }))
+                    return false;
+                for (size_t i = 0; i < entry.gates.size(); i += 2)
+                {
+                    unsigned byte = gate_code(entry.gates[i]);
+                    if (i + 1 < entry.gates.size())
+                        byte |= gate_code(entry.gates[i + 1]) << 4;
+                    records += static_cast<char>(byte);
+                }
+            }
+
+            std::string header(MAGIC, 8);
+            append_u32(header, VERSION);
+            append_u32(header, static_cast<uint32_t>(entries.size()));
+
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out << header << index << records;
+            return static_cast<bool>(out);
+        }
+
+        /**
+         * @brief The table shipped with NWQEC, opened on first use
+         *
+         * Read from $NWQEC_RZ_TABLE if set (empty disables the table), else
+         * from NWQEC_RZ_TABLE_PATH fixed at build time. Null if neither yields
+         * a valid table.
+         */
+        static const RzTable *shipped()
+        {
+            static const std::unique_ptr<RzTable> table = []() -> std::unique_ptr<RzTable>
+            {
+                std::string path;
+                if (const char *env = std::getenv("NWQEC_RZ_TABLE"))
+                    path = env;
+#ifdef NWQEC_RZ_TABLE_PATH
+                else
+                    path = NWQEC_RZ_TABLE_PATH;
+#endif
+                auto t = std::make_unique<RzTable>();
+                if (path.empty() || !t->open(path))
+                    return nullptr;
+                return t;
+            }();
+            return table.get();
+        }
+
+    private:
+        static constexpr const char *MAGIC = "NWQRZTAB";
+        static constexpr size_t HEADER_BYTES = 16;
+        static constexpr size_t INDEX_BYTES = 16;
+        static constexpr const char *GATES = " IXYZHSTW"; // Index = 4-bit code, 0 pads the last byte
+
+        static uint64_t key(const std::string &theta, const std::string &epsilon)
+        {
+            uint64_t h = 1469598103934665603ULL;
+            auto mix = [&h](unsigned char c)
+            {
+                h ^= c;
+                h *= 1099511628211ULL;
+            };
+            for (unsigned char c : theta)
+                mix(c);
+            mix(0);
+            for (unsigned char c : epsilon)
+                mix(c);
+            return h;
+        }
+
+        static unsigned gate_code(char gate)
+        {
+            const char *pos = std::strchr(GATES + 1, gate);
+            return pos && gate ? static_cast<unsigned>(pos - GATES) : 0;
+        }
+
+        static size_t index_at(size_t i) { return HEADER_BYTES + i * INDEX_BYTES; }
+
+        std::optional<std::string> read_record(std::string_view data, size_t i,
+                                               const std::string &theta, const std::string &epsilon) const
+        {
+            size_t pos = HEADER_BYTES + count_ * INDEX_BYTES + read_u32(data, index_at(i) + 8);
+            const size_t gates = read_u32(data, index_at(i) + 12);
+            for (const std::string *expected : {&theta, &epsilon})
+            {
+                if (pos >= data.size())
+                    return std::nullopt;
+                const size_t length = static_cast<unsigned char>(data[pos++]);
+                if (pos + length > data.size() || data.compare(pos, length, *expected) != 0)
+                    return std::nullopt;
+                pos += length;
+            }
+            if (pos + (gates + 1) / 2 > data.size())
+                return std::nullopt;
+            std::string out(gates, ' ');
+            for (size_t g = 0; g < gates; ++g)
+            {
+                const unsigned byte = static_cast<unsigned char>(data[pos + g / 2]);
+                const unsigned code = (g & 1) ? byte >> 4 : byte & 15u;
+                if (code == 0 || code > 8)
+                    return std::nullopt;
+                out[g] = GATES[code];
+            }
+            return out;
+        }
+
+        static uint32_t read_u32(std::string_view data, size_t pos)
+        {
+            uint32_t v = 0;
+            for (int b = 3; b >= 0; --b)
+                v = (v << 8) | static_cast<unsigned char>(data[pos + b]);
+            return v;
+        }
+
+        static uint64_t read_u64(std::string_view data, size_t pos)
+        {
+            return static_cast<uint64_t>(read_u32(data, pos)) | (static_cast<uint64_t>(read_u32(data, pos + 4)) << 32);
+        }
+
+        static void append_u32(std::string &out, uint32_t v)
+        {
+            for (int b = 0; b < 4; ++b)
+                out += static_cast<char>((v >> (8 * b)) & 0xff);
+        }
+
+        static void append_u64(std::string &out, uint64_t v)
+        {
+            append_u32(out, static_cast<uint32_t>(v));
+            append_u32(out, static_cast<uint32_t>(v >> 32));
+        }
+
+        MappedFile file_;
+        size_t count_ = 0;
+    };
+
+} // namespace NWQEC
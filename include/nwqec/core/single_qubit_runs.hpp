@@ -0,0 +1,157 @@
+#pragma once
+
+#include "nwqec/core/operation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NWQEC
+{
+    /**
+     * @brief Maximal runs of single-qubit gates on each qubit, found in one sweep
+     *
+     * A run is a chain of single-qubit gates (not measure, reset or barrier)
+     * on one qubit with no other operation on that qubit in between. Any
+     * operation touching the qubit otherwise ends its open run. Runs are
+     * numbered in order of their first gate, and the gate indices of each
+     * run are stored contiguously in circuit order.
+     */
+    class SingleQubitRuns
+    {
+    public:
+        static constexpr size_t NONE = SIZE_MAX;
+
+        static bool is_run_gate(const Operation &op)
+        {
+            return op.get_qubits().size() == 1 &&
+                   op.get_type() != Operation::Type::MEASURE &&
+                   op.get_type() != Operation::Type::RESET &&
+                   op.get_type() != Operation::Type::BARRIER;
+        }
+
+        explicit SingleQubitRuns(const std::vector<Operation> &operations, size_t num_qubits = 0)
+            : run_of_(operations.size(), NONE)
+        {
+            // First sweep: run id of every gate, with the run's size
+            std::vector<size_t> open_run(num_qubits, NONE);
+            std::vector<size_t> sizes;
+            for (size_t i = 0; i < operations.size(); ++i)
+            {
+                const Operation::QubitSpan qubits = operations[i].get_qubits();
+                if (is_run_gate(operations[i]))
+                {
+                    size_t q = qubits[0];
+                    if (q >= open_run.size())
+                        open_run.resize(q + 1, NONE);
+                    if (open_run[q] == NONE)
+                    {
+                        open_run[q] = sizes.size();
+                        sizes.push_back(0);
+                    }
+                    run_of_[i] = open_run[q];
+                    ++sizes[open_run[q]];
+                    continue;
+                }
+                for (size_t q : qubits)
+                {
+                    if (q < open_run.size())
+                        open_run[q] = NONE;
+                }
+            }
+
+            // Second sweep: scatter gate indices into their run's slice
+            begin_.assign(sizes.size() + 1, 0);
+            for (size_t r = 0; r < sizes.size(); ++r)
+                begin_[r + 1] = begin_[r] + sizes[r];
+            std::vector<size_t> fill(begin_.begin(), begin_.end() - 1);
+            gates_.resize(begin_.back());
+            for (size_t i = 0; i < operations.size(); ++i)
+            {
+                if (run_of_[i] != NONE)
+                    gates_[fill[run_of_[i]]++] = i;
+            }
+        }
+
+        size_t size() const { return begin_.size() - 1; }
+        size_t run_size(size_t r) const { return begin_[r + 1] - begin_[r]; }
+
+        // Operation indices of run r, in circuit order
+        const size_t *begin(size_t r) const { return gates_.data() + begin_[r]; }
+        const size_t *end(size_t r) const { return gates_.data() + begin_[r + 1]; }
+
+        // Run containing operation i, or NONE
+        size_t run_of(size_t i) const { return run_of_[i]; }
+
+    private:
+        std::vector<size_t> run_of_;
+        std::vector<size_t> begin_{0}; // Run r owns gates_[begin_[r], begin_[r + 1])
+        std::vector<size_t> gates_;
+    };
+
+    /**
+     * @brief Dense per-operation rewrite plan applied in one pass
+     *
+     * Every operation is kept, dropped, or replaced in place by a sequence
+     * of operations. Replacement sequences share one buffer, so recording a
+     * rewrite is an append rather than a map insertion.
+     */
+    class RewriteTable
+    {
+    public:
+        explicit RewriteTable(size_t num_operations) : action_(num_operations, KEEP) {}
+
+        void drop(size_t i)
+        {
+            rewritten_ += action_[i] == KEEP;
+            action_[i] = DROP;
+        }
+
+        // Emit replacement where operation i was
+        void replace(size_t i, const std::vector<Operation> &replacement)
+        {
+            rewritten_ += action_[i] == KEEP;
+            action_[i] = begin_.size();
+            begin_.push_back(ops_.size());
+            ops_.insert(ops_.end(), replacement.begin(), replacement.end());
+        }
+
+        // Replace a run as a whole: its first gate by replacement, the others dropped
+        void replace_run(const SingleQubitRuns &runs, size_t r, const std::vector<Operation> &replacement)
+        {
+            const size_t *first = runs.begin(r);
+            for (const size_t *it = first + 1; it != runs.end(r); ++it)
+                drop(*it);
+            replace(*first, replacement);
+        }
+
+        // Operations after applying every rewrite
+        std::vector<Operation> apply(const std::vector<Operation> &operations) const
+        {
+            std::vector<Operation> result;
+            result.reserve(operations.size() - rewritten_ + ops_.size());
+            for (size_t i = 0; i < operations.size(); ++i)
+            {
+                const size_t action = action_[i];
+                if (action == KEEP)
+                    result.push_back(operations[i]);
+                else if (action != DROP)
+                {
+                    const size_t end = action + 1 < begin_.size() ? begin_[action + 1] : ops_.size();
+                    result.insert(result.end(), ops_.begin() + begin_[action], ops_.begin() + end);
+                }
+            }
+            return result;
+        }
+
+    private:
+        static constexpr size_t KEEP = SIZE_MAX;
+        static constexpr size_t DROP = SIZE_MAX - 1;
+
+        std::vector<size_t> action_; // KEEP, DROP or index into begin_
+        std::vector<size_t> begin_;  // Replacement k is ops_[begin_[k], begin_[k + 1])
+        std::vector<Operation> ops_;
+        size_t rewritten_ = 0; // Operations no longer KEEP
+    };
+
+} // namespace NWQEC
@@ -0,0 +1,597 @@
+#pragma once
+
+#include "nwqec/core/parallel.hpp"
+#include "nwqec/core/synthesis_backend.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/**
+ * socket_synthesis_backend.hpp
+ *
+ * Shards RZ synthesis across nwqec-synth-worker processes over TCP. The
+ * protocol is line-based text, one connection per worker and pass run:
+ *
+ *   request   "NWQSYN 1 <count> <angle_timeout_ms> <budget_ms> <race> <speculate_k>"
+ *             then <count> lines "<theta> <epsilon>"
+ *   reply     "NWQSYN 1 <count>" then <count> result lines in request order:
+ *             "<success> <timed_out> <k_reached> <diophantine_calls> <elapsed_ms>
+ *              <precision_bits> <boundary_rechecks> <to_upright_ms> <tdgp_ms>
+ *              <diophantine_ms> <tdgp_candidates> <factoring_timeouts>
+ *              <diophantine_timeouts> <gates or ->"
+ *             or "ERR <message>"
+ *
+ * budget_ms is what is left of the pass's budget when the batch is sent
+ * (0 = none). Several batches may follow on one connection. Either side
+ * drops a connection whose next line runs past kMaxLineBytes.
+ */
+
+namespace NWQEC
+{
+    namespace synthesis_protocol
+    {
+        constexpr const char *kMagic = "NWQSYN";
+        constexpr int kVersion = 1;
+        constexpr size_t kMaxBatchAngles = size_t(1) << 16; // Largest <count> a worker accepts
+        constexpr size_t kMaxLineBytes = size_t(1) << 20;   // Longest line either side reads
+
+        /**
+         * @brief Buffered line reader and writer over a connected socket, closed on destruction
+         */
+        class LineSocket
+        {
+        public:
+            explicit LineSocket(int fd = -1) : fd_(fd)
+            {
+#if defined(SO_NOSIGPIPE)
+                if (fd_ >= 0)
+                {
+                    int one = 1;
+                    setsockopt(fd_, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+                }
+#endif
+            }
+            ~LineSocket()
+            {
+                if (fd_ >= 0)
+                    ::close(fd_);
+            }
+            LineSocket(const LineSocket &) = delete;
+            LineSocket &operator=(const LineSocket &) = delete;
+
+            bool is_open() const { return fd_ >= 0; }
+
+            // Fail sends and receives that block longer than timeout_ms (0 = wait indefinitely)
+            void set_timeout_ms(long long timeout_ms)
+            {
+                timeval tv{};
+                tv.tv_sec = static_cast<time_t>(timeout_ms / 1000);
+                tv.tv_usec = static_cast<suseconds_t>((timeout_ms % 1000) * 1000);
+                setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+                setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+            }
+
+            bool write(const std::string &data)
+            {
+#if defined(MSG_NOSIGNAL)
+                const int flags = MSG_NOSIGNAL;
+#else
+                const int flags = 0;
+#endif
+                size_t sent = 0;
+                while (sent < data.size())
+                {
+                    const ssize_t n = ::send(fd_, data.data() + sent, data.size() - sent, flags);
+                    if (n <= 0)
+                        return false;
+                    sent += static_cast<size_t>(n);
+                }
+                return true;
+            }
+
+            // Next line without its '\n'; false on end of stream, error, timeout or a line over kMaxLineBytes
+            bool read_line(std::string &line)
+            {
+                timed_out_ = too_long_ = false;
+                while (true)
+                {
+                    const size_t newline = buffer_.find('\n', start_);
+                    if (newline != std::string::npos)
+                    {
+                        line.assign(buffer_, start_, newline - start_);
+                        start_ = newline + 1;
+                        return true;
+                    }
+                    buffer_.erase(0, start_);
+                    start_ = 0;
+                    if (buffer_.size() > kMaxLineBytes)
+                    {
+                        too_long_ = true;
+                        return false;
+                    }
+                    char chunk[1 << 14];
+                    const ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+                    if (n <= 0)
+                    {
+                        timed_out_ = n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+                        return false;
+                    }
+                    buffer_.append(chunk, static_cast<size_t>(n));
+                }
+            }
+
+            // Whether the last failed read_line ran into the timeout
+            bool timed_out() const { return timed_out_; }
+
+            // Whether the last failed read_line gave up on a line longer than kMaxLineBytes
+            bool line_too_long() const { return too_long_; }
+
+        private:
+            int fd_;
+            std::string buffer_;
+            size_t start_ = 0;
+            bool timed_out_ = false;
+            bool too_long_ = false;
+        };
+
+        // Split "host:port" at its last colon
+        inline bool split_endpoint(const std::string &endpoint, std::string &host, std::string &port)
+        {
+            const size_t colon = endpoint.rfind(':');
+            if (colon == std::string::npos || colon + 1 == endpoint.size())
+                return false;
+            host = endpoint.substr(0, colon);
+            port = endpoint.substr(colon + 1);
+            if (host.size() >= 2 && host.front() == '[' && host.back() == ']')
+                host = host.substr(1, host.size() - 2);
+            return true;
+        }
+
+        /**
+         * @brief Connect to "host:port"
+         * @return Connected socket, or -1
+         */
+        inline int connect_to(const std::string &endpoint)
+        {
+            std::string host, port;
+            if (!split_endpoint(endpoint, host, port))
+                return -1;
+            addrinfo hints{};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            addrinfo *addresses = nullptr;
+            if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0)
+                return -1;
+            int fd = -1;
+            for (addrinfo *a = addresses; a && fd < 0; a = a->ai_next)
+            {
+                fd = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+                if (fd < 0)
+                    continue;
+                if (::connect(fd, a->ai_addr, a->ai_addrlen) != 0)
+                {
+                    ::close(fd);
+                    fd = -1;
+                }
+            }
+            freeaddrinfo(addresses);
+            if (fd >= 0)
+            {
+                // Notice a worker node that went away without closing the connection
+                int one = 1;
+                setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &one, sizeof(one));
+            }
+            return fd;
+        }
+
+        /**
+         * @brief Listen for client connections on host:port
+         * @param host Address to bind, e.g. "127.0.0.1", "0.0.0.0" for all IPv4
+         *             interfaces or "::" for all IPv6 and IPv4 interfaces
+         * @param port Port to bind (0 = any free port)
+         * @param bound_port Set to the port actually bound
+         * @return Listening socket, or -1
+         */
+        inline int listen_on(const std::string &host, int port, int &bound_port)
+        {
+            addrinfo hints{};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+            addrinfo *addresses = nullptr;
+            const std::string service = std::to_string(port);
+            if (getaddrinfo(host.c_str(), service.c_str(), &hints, &addresses) != 0)
+                return -1;
+            int fd = -1;
+            for (addrinfo *a = addresses; a && fd < 0; a = a->ai_next)
+            {
+                fd = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+                if (fd < 0)
+                    continue;
+                int one = 1, zero = 0;
+                setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+                if (a->ai_family == AF_INET6)
+                    setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &zero, sizeof(zero));
+                if (::bind(fd, a->ai_addr, a->ai_addrlen) != 0 || ::listen(fd, 64) != 0)
+                {
+                    ::close(fd);
+                    fd = -1;
+                }
+            }
+            freeaddrinfo(addresses);
+            if (fd < 0)
+                return -1;
+
+            sockaddr_storage address{};
+            socklen_t length = sizeof(address);
+            if (getsockname(fd, reinterpret_cast<sockaddr *>(&address), &length) != 0)
+            {
+                ::close(fd);
+                return -1;
+            }
+            bound_port = address.ss_family == AF_INET6
+                             ? ntohs(reinterpret_cast<const sockaddr_in6 &>(address).sin6_port)
+                             : ntohs(reinterpret_cast<const sockaddr_in &>(address).sin_port);
+            return fd;
+        }
+
+        inline std::string format_result(const gridsynth::SynthesisResult &r)
+        {
+            char buf[256];
+            std::snprintf(buf, sizeof(buf), "%d %d %d %d %.3f %d %d %.3f %.3f %.3f %d %d %d ",
+                          r.success ? 1 : 0, r.timed_out ? 1 : 0, r.k_reached, r.diophantine_calls, r.elapsed_ms,
+                          r.precision_bits, r.boundary_rechecks, r.to_upright_ms, r.tdgp_ms, r.diophantine_ms,
+                          r.tdgp_candidates, r.factoring_timeouts, r.diophantine_timeouts);
+            std::string line(buf);
+            line += r.gates.empty() ? "-" : r.gates;
+            line += '\n';
+            return line;
+        }
+
+        inline bool parse_result(const std::string &line, gridsynth::SynthesisResult &r)
+        {
+            std::istringstream in(line);
+            int success = 0, timed_out = 0;
+            in >> success >> timed_out >> r.k_reached >> r.diophantine_calls >> r.elapsed_ms >> r.precision_bits >>
+                r.boundary_rechecks >> r.to_upright_ms >> r.tdgp_ms >> r.diophantine_ms >> r.tdgp_candidates >>
+                r.factoring_timeouts >> r.diophantine_timeouts >> r.gates;
+            if (!in)
+                return false;
+            r.success = success != 0;
+            r.timed_out = timed_out != 0;
+            if (r.gates == "-")
+                r.gates.clear();
+            // Only what gridsynth emits, so a confused worker cannot seed the cache with junk
+            return r.gates.find_first_not_of("HSTXWI") == std::string::npos;
+        }
+
+        /**
+         * @brief Answer batches on one client connection until it closes
+         *
+         * Never throws: a malformed request or a failed batch is answered
+         * with an ERR line, anything else ends the connection.
+         *
+         * @param fd Connected socket, closed on return
+         * @param num_threads Synthesis workers for each batch (0 = hardware concurrency)
+         */
+        inline void serve_connection(int fd, size_t num_threads)
+        {
+            LineSocket socket(fd);
+            try
+            {
+                std::string line;
+                while (socket.read_line(line))
+                {
+                    std::istringstream header(line);
+                    std::string magic;
+                    int version = 0, race = 0;
+                    size_t count = 0;
+                    long long budget_ms = 0;
+                    gridsynth::BatchOptions options;
+                    header >> magic >> version >> count >> options.angle_timeout_ms >> budget_ms >> race >> options.speculate_k;
+                    if (!header || magic != kMagic || version != kVersion)
+                    {
+                        socket.write(std::string("ERR bad request header\n"));
+                        return;
+                    }
+                    if (count > kMaxBatchAngles)
+                    {
+                        socket.write("ERR batch of " + std::to_string(count) + " angles exceeds the limit of " +
+                                     std::to_string(kMaxBatchAngles) + "\n");
+                        return;
+                    }
+                    options.num_threads = num_threads;
+                    options.race_diophantine = race != 0;
+                    if (budget_ms > 0)
+                        options.budget.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(budget_ms);
+
+                    std::vector<std::string> thetas(count), epsilons(count);
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        if (!socket.read_line(line))
+                        {
+                            if (socket.line_too_long())
+                                socket.write(std::string("ERR request line too long\n"));
+                            return;
+                        }
+                        std::istringstream request(line);
+                        if (!(request >> thetas[i] >> epsilons[i]))
+                        {
+                            socket.write(std::string("ERR bad angle line\n"));
+                            return;
+                        }
+                    }
+
+                    std::string reply = std::string(kMagic) + " " + std::to_string(kVersion) + " " + std::to_string(count) + "\n";
+                    try
+                    {
+                        for (const auto &result : gridsynth::gridsynth_batch(thetas, epsilons, options))
+                            reply += format_result(result);
+                    }
+                    catch (const std::exception &e)
+                    {
+                        reply = std::string("ERR ") + e.what() + "\n";
+                    }
+                    if (!socket.write(reply))
+                        return;
+                }
+                if (socket.line_too_long())
+                    socket.write(std::string("ERR request line too long\n"));
+            }
+            catch (const std::exception &e)
+            {
+                socket.write(std::string("ERR ") + e.what() + "\n");
+            }
+            catch (...)
+            {
+            }
+        }
+    } // namespace synthesis_protocol
+
+    /**
+     * @brief Backend that shards the angles across nwqec-synth-worker processes
+     *
+     * The angles are cut into chunks that the workers take as they finish
+     * the previous one, so faster nodes do more of the work. A chunk whose
+     * worker is unreachable, disconnects or does not answer in time goes
+     * back to the queue for the others; synthesize() throws once no worker
+     * is left. A worker that answers ERR could synthesize the chunk no
+     * better than the others, so that error is thrown right away. Results are placed
+     * by angle index, so they come back in request order whatever node
+     * produced them, and match in-process synthesis since every angle is
+     * seeded from its own inputs.
+     */
+    class SocketSynthesisBackend : public SynthesisBackend
+    {
+    public:
+        static constexpr size_t DEFAULT_CHUNK_ANGLES = 64;
+
+        /**
+         * @param endpoints Workers as "host:port"
+         * @param chunk_angles Angles per request, at most kMaxBatchAngles; a worker synthesizes
+         *                     one request on all its threads
+         */
+        explicit SocketSynthesisBackend(std::vector<std::string> endpoints, size_t chunk_angles = DEFAULT_CHUNK_ANGLES)
+            : endpoints_(std::move(endpoints)),
+              chunk_angles_(std::min(std::max<size_t>(1, chunk_angles), synthesis_protocol::kMaxBatchAngles))
+        {
+            if (endpoints_.empty())
+                throw std::invalid_argument("SocketSynthesisBackend: no worker endpoints");
+        }
+
+        // Endpoints from a comma-separated "host:port,host:port" list
+        static std::vector<std::string> parse_endpoints(const std::string &list)
+        {
+            std::vector<std::string> endpoints;
+            std::istringstream in(list);
+            std::string item;
+            while (std::getline(in, item, ','))
+            {
+                if (item.empty())
+                    continue;
+                std::string host, port;
+                if (!synthesis_protocol::split_endpoint(item, host, port))
+                    throw std::invalid_argument("Invalid synthesis worker '" + item + "' (expected host:port)");
+                endpoints.push_back(item);
+            }
+            return endpoints;
+        }
+
+        std::string name() const override
+        {
+            return "socket (" + std::to_string(endpoints_.size()) + " workers)";
+        }
+
+        std::vector<gridsynth::SynthesisResult> synthesize(const std::vector<std::string> &thetas,
+                                                           const std::vector<std::string> &epsilons,
+                                                           const gridsynth::BatchOptions &options) override
+        {
+            if (thetas.size() != epsilons.size())
+                throw std::invalid_argument("SocketSynthesisBackend: thetas and epsilons differ in length");
+            std::vector<gridsynth::SynthesisResult> results(thetas.size());
+            if (thetas.empty())
+                return results;
+
+            Shared shared(thetas, epsilons, options, results);
+            for (size_t begin = 0; begin < thetas.size(); begin += chunk_angles_)
+                shared.queue.push_back(begin);
+
+            // Rounds over the workers still alive, until the queue drains;
+            // a chunk handed back late in one round is taken in the next
+            std::vector<std::string> live = endpoints_;
+            while (!shared.queue.empty() && !live.empty())
+            {
+                std::vector<char> alive(live.size(), 1);
+                parallel_for(live.size(), live.size(), [&](size_t w)
+                             { alive[w] = serve_chunks(live[w], shared) ? 1 : 0; });
+                std::vector<std::string> still_live;
+                for (size_t w = 0; w < live.size(); ++w)
+                    if (alive[w])
+                        still_live.push_back(live[w]);
+                live = std::move(still_live);
+            }
+
+            if (!shared.synthesis_error.empty())
+                throw std::runtime_error(shared.synthesis_error);
+            if (!shared.queue.empty())
+                throw std::runtime_error("No synthesis worker reachable (last error: " + shared.last_error + ")");
+            return results;
+        }
+
+    private:
+        struct Shared
+        {
+            Shared(const std::vector<std::string> &thetas_, const std::vector<std::string> &epsilons_,
+                   const gridsynth::BatchOptions &options_, std::vector<gridsynth::SynthesisResult> &results_)
+                : thetas(thetas_), epsilons(epsilons_), options(options_), results(results_) {}
+
+            const std::vector<std::string> &thetas;
+            const std::vector<std::string> &epsilons;
+            const gridsynth::BatchOptions &options;
+            std::vector<gridsynth::SynthesisResult> &results;
+            std::mutex mutex;
+            std::deque<size_t> queue; // First angle of each chunk still to synthesize
+            std::string last_error;
+            std::string synthesis_error; // ERR reply of a worker; stops all workers
+        };
+
+        // Grace beyond the pass budget for a worker to report its timed-out angles
+        static constexpr long long kReplyGraceMs = 2000;
+
+        /**
+         * @brief Send chunks to one worker until the queue is empty
+         * @return false if the worker failed; its chunk is back in the queue
+         */
+        bool serve_chunks(const std::string &endpoint, Shared &shared) const
+        {
+            auto fail = [&](const std::string &error, size_t begin, bool requeue)
+            {
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                if (requeue)
+                    shared.queue.push_front(begin);
+                shared.last_error = endpoint + ": " + error;
+                return false;
+            };
+
+            synthesis_protocol::LineSocket socket(synthesis_protocol::connect_to(endpoint));
+            if (!socket.is_open())
+                return fail("connection failed", 0, false);
+
+            while (true)
+            {
+                size_t begin;
+                {
+                    std::lock_guard<std::mutex> lock(shared.mutex);
+                    if (shared.queue.empty())
+                        return true;
+                    begin = shared.queue.front();
+                    shared.queue.pop_front();
+                }
+                const size_t end = std::min(begin + chunk_angles_, shared.thetas.size());
+
+                const long long timeout_ms = reply_timeout_ms(shared.options, end - begin);
+                socket.set_timeout_ms(timeout_ms);
+                if (!socket.write(request(shared, begin, end)))
+                    return fail("send failed", begin, true);
+
+                // Why the last read_line failed
+                auto read_error = [&socket, timeout_ms]() -> std::string
+                {
+                    if (socket.timed_out())
+                        return "no reply within " + std::to_string(timeout_ms) + " ms";
+                    if (socket.line_too_long())
+                        return "reply line longer than " + std::to_string(synthesis_protocol::kMaxLineBytes) + " bytes";
+                    return "connection closed";
+                };
+
+                std::string line;
+                if (!socket.read_line(line))
+                    return fail(read_error(), begin, true);
+                if (line.compare(0, 4, "ERR ") == 0)
+                {
+                    std::lock_guard<std::mutex> lock(shared.mutex);
+                    if (shared.synthesis_error.empty())
+                        shared.synthesis_error = "Synthesis worker " + endpoint + " failed: " + line.substr(4);
+                    shared.queue.clear();
+                    return true;
+                }
+                const std::string expected = std::string(synthesis_protocol::kMagic) + " " +
+                                             std::to_string(synthesis_protocol::kVersion) + " " +
+                                             std::to_string(end - begin);
+                if (line != expected)
+                    return fail("unexpected reply", begin, true);
+
+                std::vector<gridsynth::SynthesisResult> chunk(end - begin);
+                for (auto &result : chunk)
+                {
+                    if (!socket.read_line(line))
+                        return fail(read_error(), begin, true);
+                    if (!synthesis_protocol::parse_result(line, result))
+                        return fail("malformed result", begin, true);
+                }
+                std::move(chunk.begin(), chunk.end(), shared.results.begin() + static_cast<std::ptrdiff_t>(begin));
+            }
+        }
+
+        /**
+         * @brief How long to wait for a worker's reply to a chunk (0 = indefinitely)
+         *
+         * The remaining pass budget if there is one, else every angle of the
+         * chunk running into its own timeout one after the other, plus grace
+         * for the worker to report the angles it gave up on.
+         */
+        static long long reply_timeout_ms(const gridsynth::BatchOptions &options, size_t angles)
+        {
+            const auto deadline = options.budget.deadline;
+            if (deadline != std::chrono::steady_clock::time_point::max())
+            {
+                const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now());
+                return std::max<long long>(0, left.count()) + kReplyGraceMs;
+            }
+            if (options.angle_timeout_ms > 0)
+                return static_cast<long long>(options.angle_timeout_ms) * static_cast<long long>(angles) + kReplyGraceMs;
+            return 0;
+        }
+
+        static std::string request(const Shared &shared, size_t begin, size_t end)
+        {
+            long long budget_ms = 0;
+            const auto deadline = shared.options.budget.deadline;
+            if (deadline != std::chrono::steady_clock::time_point::max())
+            {
+                const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now());
+                budget_ms = std::max<long long>(1, left.count());
+            }
+            std::ostringstream out;
+            out << synthesis_protocol::kMagic << ' ' << synthesis_protocol::kVersion << ' ' << (end - begin) << ' '
+                << shared.options.angle_timeout_ms << ' ' << budget_ms << ' '
+                << (shared.options.race_diophantine ? 1 : 0) << ' ' << shared.options.speculate_k << '\n';
+            for (size_t i = begin; i < end; ++i)
+                out << shared.thetas[i] << ' ' << shared.epsilons[i] << '\n';
+            return out.str();
+        }
+
+        std::vector<std::string> endpoints_;
+        size_t chunk_angles_;
+    };
+
+} // namespace NWQEC
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "nwqec/gridsynth/gridsynth.hpp"
+
+#include <string>
+#include <vector>
+
+namespace NWQEC
+{
+    /**
+     * @brief Where SynthesizeRzPass sends the distinct angles the table and cache miss
+     *
+     * synthesize() gets the theta and epsilon strings gridsynth is called
+     * with and returns one result per angle, in the same order. Since every
+     * angle is seeded from its own inputs, an implementation may synthesize
+     * them anywhere and in any order without changing the output.
+     * Implementations must be safe to call from concurrent passes.
+     */
+    class SynthesisBackend
+    {
+    public:
+        virtual ~SynthesisBackend() = default;
+
+        virtual std::string name() const = 0;
+
+        virtual std::vector<gridsynth::SynthesisResult> synthesize(const std::vector<std::string> &thetas,
+                                                                   const std::vector<std::string> &epsilons,
+                                                                   const gridsynth::BatchOptions &options) = 0;
+    };
+
+    /**
+     * @brief Default backend: gridsynth_batch on this process's threads
+     */
+    class LocalSynthesisBackend : public SynthesisBackend
+    {
+    public:
+        std::string name() const override { return "local"; }
+
+        std::vector<gridsynth::SynthesisResult> synthesize(const std::vector<std::string> &thetas,
+                                                           const std::vector<std::string> &epsilons,
+                                                           const gridsynth::BatchOptions &options) override
+        {
+            return gridsynth::gridsynth_batch(thetas, epsilons, options);
+        }
+    };
+
+} // namespace NWQEC
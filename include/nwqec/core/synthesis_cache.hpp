@@ -0,0 +1,275 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace NWQEC
+{
+    // Default upper bound on the cache file size (bytes)
+    inline constexpr uint64_t DEFAULT_SYNTHESIS_CACHE_MAX_BYTES = 256ULL << 20;
+
+    /**
+     * @brief Persistent cache of RZ synthesis results keyed by (angle, epsilon, search)
+     *
+     * Entries live in an append-only text file, one per line:
+     *
+     *     [r ]<angle bits hex> <epsilon bits hex> <gate count> <gate string>
+     *
+     * Keys are the exact IEEE-754 bit patterns of the doubles, so a hit only ever
+     * returns the sequence synthesized for the same request. Racing the diophantine
+     * candidates can accept a different, equally valid sequence than the serial
+     * search, so raced results (the "r " lines) are kept apart and a run gets the
+     * output its own search mode would have produced. The file is loaded once
+     * on open; new entries are appended and flushed line by line, which keeps the
+     * file usable if a run is interrupted. Lines that fail to parse or whose gate
+     * count does not match (e.g. a torn final line) are skipped. Once the file reaches max_bytes, new results are
+     * still served from memory for the rest of the run but no longer persisted.
+     *
+     * All methods are safe to call from concurrent synthesis workers.
+     */
+    class SynthesisCache
+    {
+    public:
+        /**
+         * @brief Open (or create) a cache file
+         * @param path Location of the cache file
+         * @param max_bytes Size cap for the file (0 = unlimited)
+         */
+        explicit SynthesisCache(std::string path, uint64_t max_bytes = DEFAULT_SYNTHESIS_CACHE_MAX_BYTES)
+            : path_(std::move(path)), max_bytes_(max_bytes)
+        {
+            load();
+        }
+
+        /**
+         * @brief Look up a previously synthesized gate sequence
+         * @param raced Whether the sequence is wanted from the raced search
+         */
+        std::optional<std::string> lookup(double angle, double epsilon, bool raced = false)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(Key{bits_of(angle), bits_of(epsilon), raced});
+            if (it == entries_.end())
+            {
+                ++misses_;
+                return std::nullopt;
+            }
+            ++hits_;
+            return it->second;
+        }
+
+        /**
+         * @brief Record a synthesized gate sequence and persist it if under the size cap
+         * @param raced Whether the sequence came from the raced search
+         */
+        void insert(double angle, double epsilon, const std::string &gates, bool raced = false)
+        {
+            Key key{bits_of(angle), bits_of(epsilon), raced};
+            std::string line = format_line(key, gates);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!entries_.emplace(key, gates).second)
+                return;
+            if (max_bytes_ != 0 && file_bytes_ + line.size() > max_bytes_)
+                return;
+
+            std::ofstream out(path_, std::ios::app | std::ios::binary);
+            if (!out)
+                return; // Cache is best-effort; synthesis results are still returned
+            if (needs_newline_)
+            {
+                out << '\n';
+                file_bytes_ += 1;
+                needs_newline_ = false;
+            }
+            out << line;
+            out.flush();
+            if (out)
+                file_bytes_ += line.size();
+        }
+
+        /**
+         * @brief The cache open on path in this process, opened if there is none
+         *
+         * Transforms running at the same time share one instance per file, so
+         * their appends are serialized by its mutex instead of interleaving in
+         * the file. The instance closes with the last transform using it; while
+         * shared, the max_bytes of the first opener applies.
+         */
+        static std::shared_ptr<SynthesisCache> shared(const std::string &path,
+                                                      uint64_t max_bytes = DEFAULT_SYNTHESIS_CACHE_MAX_BYTES)
+        {
+            static std::mutex registry_mutex;
+            static std::map<std::string, std::weak_ptr<SynthesisCache>> registry;
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            std::weak_ptr<SynthesisCache> &slot = registry[path];
+            auto cache = slot.lock();
+            if (!cache)
+            {
+                cache = std::make_shared<SynthesisCache>(path, max_bytes);
+                slot = cache;
+            }
+            return cache;
+        }
+
+        const std::string &path() const { return path_; }
+        size_t size() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return entries_.size();
+        }
+        size_t hits() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return hits_;
+        }
+        size_t misses() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return misses_;
+        }
+
+    private:
+        struct Key
+        {
+            uint64_t angle;
+            uint64_t epsilon;
+            bool raced;
+            bool operator==(const Key &o) const
+            {
+                return angle == o.angle && epsilon == o.epsilon && raced == o.raced;
+            }
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key &k) const
+            {
+                uint64_t h = k.angle * 0x9E3779B97F4A7C15ULL;
+                h ^= k.epsilon + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+                h ^= static_cast<uint64_t>(k.raced);
+                return static_cast<size_t>(h);
+            }
+        };
+
+        std::string path_;
+        uint64_t max_bytes_;
+        uint64_t file_bytes_ = 0;
+        bool needs_newline_ = false; // Terminate a torn final line before appending
+        std::unordered_map<Key, std::string, KeyHash> entries_;
+        size_t hits_ = 0;
+        size_t misses_ = 0;
+        mutable std::mutex mutex_;
+
+        static uint64_t bits_of(double value)
+        {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        static std::string format_line(const Key &key, const std::string &gates)
+        {
+            char buf[64];
+            std::snprintf(buf, sizeof(buf), "%016llx %016llx %zu ",
+                          static_cast<unsigned long long>(key.angle),
+                          static_cast<unsigned long long>(key.epsilon),
+                          gates.size());
+            std::string line(key.raced ? "r " : "");
+            line += buf;
+            line += gates;
+            line += '\n';
+            return line;
+        }
+
+        static bool is_gate_char(char c)
+        {
+            return c == 'X' || c == 'Y' || c == 'Z' || c == 'H' || c == 'S' || c == 'T' || c == 'W' || c == 'I';
+        }
+
+        static bool parse_hex64(const std::string &s, uint64_t &out)
+        {
+            if (s.size() != 16)
+                return false;
+            out = 0;
+            for (char c : s)
+            {
+                int v;
+                if (c >= '0' && c <= '9')
+                    v = c - '0';
+                else if (c >= 'a' && c <= 'f')
+                    v = c - 'a' + 10;
+                else
+                    return false;
+                out = (out << 4) | static_cast<uint64_t>(v);
+            }
+            return true;
+        }
+
+        void load()
+        {
+            std::ifstream in(path_, std::ios::binary);
+            if (!in)
+                return;
+
+            std::string line;
+            while (std::getline(in, line))
+            {
+                if (in.eof())
+                {
+                    // A final line without '\n' was torn by an interrupted write
+                    file_bytes_ += line.size();
+                    needs_newline_ = !line.empty();
+                    break;
+                }
+                file_bytes_ += line.size() + 1;
+
+                Key key;
+                key.raced = line.compare(0, 2, "r ") == 0;
+                if (key.raced)
+                    line.erase(0, 2);
+                // 16 hex + ' ' + 16 hex + ' ' + count + ' ' + gates
+                if (line.size() < 36 || line[16] != ' ' || line[33] != ' ')
+                    continue;
+                if (!parse_hex64(line.substr(0, 16), key.angle) || !parse_hex64(line.substr(17, 16), key.epsilon))
+                    continue;
+                size_t sep = line.find(' ', 34);
+                if (sep == std::string::npos || sep == 34 || sep - 34 > 19)
+                    continue;
+                size_t count = 0;
+                bool ok = true;
+                for (size_t i = 34; i < sep; ++i)
+                {
+                    if (line[i] < '0' || line[i] > '9')
+                    {
+                        ok = false;
+                        break;
+                    }
+                    count = count * 10 + static_cast<size_t>(line[i] - '0');
+                }
+                std::string gates = line.substr(sep + 1);
+                if (!ok || gates.size() != count)
+                    continue;
+                for (char c : gates)
+                {
+                    if (!is_gate_char(c))
+                    {
+                        ok = false;
+                        break;
+                    }
+                }
+                if (ok)
+                    entries_.emplace(key, std::move(gates));
+            }
+        }
+    };
+
+} // namespace NWQEC
@@ -2,6 +2,10 @@
 
 #include "nwqec/core/circuit.hpp"
 #include "nwqec/core/transpiler_passes.hpp"
+#include "nwqec/core/synthesis_cache.hpp"
+#include "nwqec/core/synthesis_backend.hpp"
+#include "nwqec/core/debug_dump.hpp"
+#include "nwqec/core/pass_observer.hpp"
 
 #include "nwqec/passes/clifford_reduction_pass.hpp"
 #include "nwqec/passes/pbc_pass.hpp"
@@ -17,6 +21,7 @@
 #include <memory>
 #include <iostream>
 #include <iomanip>
+#include <chrono>
 
 namespace NWQEC {
 
@@ -26,7 +31,20 @@ namespace NWQEC {
 struct PassConfig {
     bool keep_ccx = false;          // Preserve CCX gates during decomposition
     bool keep_cx = false;           // Preserve CX gates in PBC format
+    bool pbc_streaming = false;     // PBC conversion through a Clifford frame: O(n^2) memory, no tableau over all rotations
     double epsilon_override = -1.0; // Override epsilon for RZ synthesis (-1 = use default)
+    size_t num_threads = 0;         // Worker threads for RZ synthesis, PBC conversion and Tfuse (0 = hardware concurrency)
+    std::string synthesis_cache_path;  // Persistent RZ synthesis cache file (empty = disabled)
+    uint64_t synthesis_cache_max_bytes = DEFAULT_SYNTHESIS_CACHE_MAX_BYTES; // Cache file size cap (0 = unlimited)
+    int synthesis_angle_timeout_ms = 0; // Wall-clock limit per distinct RZ angle (0 = unlimited)
+    int synthesis_budget_ms = 0;        // Wall-clock limit for all RZ synthesis in a pass (0 = unlimited)
+    bool synthesis_race_diophantine = false; // Solve each angle's diophantine equations concurrently
+    size_t synthesis_speculate_k = 0;        // TDGP levels solved ahead of the current k per angle (0 = off)
+    bool use_rz_table = true;                // Take precomputed sequences from the shipped RZ table
+    bool defer_rz_expansion = true;          // Keep synthesized RZs as RZ_SEQ placeholders until output
+    std::shared_ptr<SynthesisBackend> synthesis_backend; // Synthesizes the angles table and cache miss, e.g. SocketSynthesisBackend (null = in-process)
+    std::shared_ptr<DumpSink> debug_dump; // Receives pass debug dumps, e.g. Tfuse's optimized circuit (null = none)
+    std::vector<std::shared_ptr<PassObserver>> observers; // Called around every pass, e.g. ChromeTraceObserver (empty = no timing)
     bool silent = false;            // Suppress output during pass execution
 };
 
@@ -65,7 +83,17 @@ public:
         return execute_passes(std::move(circuit), sequence, config);
     }
 
+    /**
+     * @brief Gridsynth counters of the RZ synthesis passes in the last execute_passes call
+     *
+     * Filled even when synthesis throws, so a run that ran out of budget
+     * can still be diagnosed.
+     */
+    const SynthesisStats& synthesis_stats() const { return synthesis_stats_; }
+
 private:
+    SynthesisStats synthesis_stats_;
+
     /**
      * @brief Create and configure a pass instance
      */
@@ -74,12 +102,17 @@ private:
     /**
      * @brief Print execution statistics for a pass
      */
-    void print_pass_stats(const std::string& pass_name, const Circuit& before, const Circuit& after, bool modified);
+    void print_pass_stats(const std::string& pass_name, size_t gates_before, const Circuit& after, bool modified);
     
     /**
      * @brief Print table header for pass execution log
      */
     void print_table_header();
+
+    /**
+     * @brief Print the gridsynth counters gathered in synthesis_stats_
+     */
+    void print_synthesis_stats();
 };
 
 // Inline implementations
@@ -88,12 +121,16 @@ inline std::unique_ptr<Circuit> Transpiler::execute_passes(
     const std::vector<PassType>& passes,
     const PassConfig& config
 ) {
+    synthesis_stats_ = SynthesisStats{};
+    bool synthesized = false;
+
     if (!config.silent) {
         std::cout << "\n=== Pass Execution Summary ===\n";
         print_table_header();
     }
 
-    for (PassType pass_type : passes) {
+    for (size_t pass_index = 0; pass_index < passes.size(); ++pass_index) {
+        const PassType pass_type = passes[pass_index];
         auto pass = create_pass(pass_type, config);
         if (!pass) {
             if (!config.silent) {
@@ -102,14 +139,62 @@ inline std::unique_ptr<Circuit> Transpiler::execute_passes(
             continue;
         }
 
-        Circuit before_copy = *circuit; // For stats
-        bool modified = pass->run(*circuit);
-        
+        const size_t gates_before = circuit->gate_count();
+        auto* synthesis = dynamic_cast<SynthesizeRzPass*>(pass.get());
+
+        const bool observed = !config.observers.empty();
+        PassEvent event;
+        long rss_before = 0;
+        if (observed) {
+            event.name = pass_type_to_string(pass_type);
+            event.index = pass_index;
+            event.ops_before = gates_before;
+            rss_before = peak_rss_kb();
+            for (const auto& observer : config.observers) {
+                observer->on_pass_begin(event);
+            }
+            event.start = std::chrono::steady_clock::now();
+        }
+        auto end_event = [&](bool failed) {
+            if (!observed) {
+                return;
+            }
+            event.wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - event.start).count();
+            event.peak_rss_delta_kb = peak_rss_kb() - rss_before;
+            event.ops_after = circuit->gate_count();
+            event.failed = failed;
+            pass->report_counters(event.counters);
+            for (const auto& observer : config.observers) {
+                observer->on_pass_end(event);
+            }
+        };
+
+        bool modified = false;
+        try {
+            modified = pass->run(*circuit);
+        } catch (...) {
+            if (synthesis) {
+                synthesis_stats_.merge(synthesis->stats());
+            }
+            end_event(true);
+            throw;
+        }
+        if (synthesis) {
+            synthesis_stats_.merge(synthesis->stats());
+            synthesized = true;
+        }
+        event.modified = modified;
+        end_event(false);
+
         if (!config.silent) {
-            print_pass_stats(pass_type_to_string(pass_type), before_copy, *circuit, modified);
+            print_pass_stats(pass_type_to_string(pass_type), gates_before, *circuit, modified);
         }
     }
 
+    if (!config.silent && synthesized) {
+        print_synthesis_stats();
+    }
+
     if (!config.silent) {
         std::cout << "\n=== Final Statistics ===\n";
         circuit->print_stats(std::cout);
@@ -133,21 +218,29 @@ inline std::unique_ptr<Pass> Transpiler::create_pass(PassType type, const PassCo
             return std::make_unique<RemovePauliPass>();
         
         case PassType::TO_PBC:
-            return std::make_unique<PbcPass>(config.keep_cx);
+            return std::make_unique<PbcPass>(config.keep_cx, config.num_threads, config.pbc_streaming);
         
         case PassType::CLIFFORD_REDUCTION:
             return std::make_unique<CRPass>();
         
         case PassType::SYNTHESIZE_RZ: {
-            if (config.epsilon_override >= 0.0) {
-                return std::make_unique<SynthesizeRzPass>(config.epsilon_override);
-            } else {
-                return std::make_unique<SynthesizeRzPass>();
+            std::shared_ptr<SynthesisCache> cache;
+            if (!config.synthesis_cache_path.empty()) {
+                cache = SynthesisCache::shared(config.synthesis_cache_path, config.synthesis_cache_max_bytes);
             }
+            SynthesisLimits limits;
+            limits.angle_timeout_ms = config.synthesis_angle_timeout_ms;
+            limits.budget_ms = config.synthesis_budget_ms;
+            limits.race_diophantine = config.synthesis_race_diophantine;
+            limits.speculate_k = config.synthesis_speculate_k;
+            limits.use_rz_table = config.use_rz_table;
+            limits.defer_expansion = config.defer_rz_expansion;
+            return std::make_unique<SynthesizeRzPass>(config.epsilon_override, config.num_threads, std::move(cache), limits,
+                                                      config.synthesis_backend);
         }
         
         case PassType::TFUSE:
-            return std::make_unique<TfusePass>();
+            return std::make_unique<TfusePass>(config.num_threads, config.debug_dump);
         
         default:
             return nullptr;
@@ -165,21 +258,39 @@ inline void Transpiler::print_table_header() {
     std::cout << std::string(75, '-') << std::endl;
 }
 
-inline void Transpiler::print_pass_stats(const std::string& pass_name, const Circuit& before, const Circuit& after, bool modified) {
-    auto before_ops = before.count_ops();
-    auto after_ops = after.count_ops();
-    
-    int before_total = 0, after_total = 0;
-    for (const auto& [gate, count] : before_ops) before_total += count;
-    for (const auto& [gate, count] : after_ops) after_total += count;
-    
+inline void Transpiler::print_pass_stats(const std::string& pass_name, size_t gates_before, const Circuit& after, bool modified) {
     std::cout << std::left
               << std::setw(25) << pass_name
               << std::setw(10) << (modified ? "Yes" : "No")
-              << std::setw(15) << before_total
-              << std::setw(15) << after_total
+              << std::setw(15) << gates_before
+              << std::setw(15) << after.gate_count()
               << std::setw(10) << after.depth()
               << std::endl;
 }
 
+inline void Transpiler::print_synthesis_stats() {
+    const SynthesisStats& s = synthesis_stats_;
+    std::cout << "\n=== RZ Synthesis ===\n"
+              << "Angles: " << s.angles << " (" << s.synthesized << " synthesized, "
+              << s.table_hits << " from table, " << s.cache_hits << " cached, " << s.exact << " exact, "
+              << s.failed << " failed)\n";
+    if (s.synthesized == 0) {
+        return;
+    }
+    std::cout << std::fixed << std::setprecision(1)
+              << "Time (summed over angles): " << s.elapsed_ms << " ms"
+              << " [upright " << s.to_upright_ms << ", tdgp " << s.tdgp_ms
+              << ", diophantine " << s.diophantine_ms << "]\n"
+              << "k iterations: " << s.k_iterations << " (max k " << s.max_k << ")"
+              << ", TDGP candidates: " << s.tdgp_candidates
+              << ", diophantine calls: " << s.diophantine_calls << "\n"
+              << "Timeouts: " << s.factoring_timeouts << " factoring, " << s.diophantine_timeouts
+              << " diophantine; boundary rechecks: " << s.boundary_rechecks
+              << "; max precision: " << s.max_precision_bits << " bits\n"
+              << "Slowest angle: " << std::setprecision(6) << s.slowest_angle
+              << " (" << std::setprecision(1) << s.slowest_ms << " ms)\n";
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
 } // namespace NWQEC
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <optional>
+#include <atomic>
 #include <vector>
 #include <random>
 #include <chrono>
@@ -11,10 +12,12 @@
 #include <string>
 #include <iostream>
 #include <cassert>
+#include <cstdint>
 #include <gmp.h>
 
 #include "types.hpp"
 #include "ring.hpp"
+#include "prime_cache.hpp"
 
 // Port of src/diophantine.py (exact algorithmic structure, no simplifications)
 // All timeouts are in milliseconds.
@@ -27,6 +30,52 @@ namespace gridsynth
         static thread_local std::mt19937_64 rng(std::random_device{}());
         return rng;
     }
+
+    // Reseed the calling thread's RNG so a synthesis run becomes reproducible
+    inline void seed_rng(std::uint64_t seed)
+    {
+        global_rng().seed(seed);
+    }
+    /**
+     * Give-ups on the calling thread; gridsynth reads them around each synthesis
+     */
+    struct DiophantineCounters
+    {
+        int factoring_timeouts = 0;   // Factor searches stopped at their iteration or time limit
+        int diophantine_timeouts = 0; // Equations abandoned at the diophantine timeout
+    };
+
+    inline DiophantineCounters &diophantine_counters()
+    {
+        static thread_local DiophantineCounters counters;
+        return counters;
+    }
+
+    /**
+     * Lets a race over several candidates abandon the ones it no longer needs
+     *
+     * While first_success is set, the calling thread's diophantine work gives
+     * up as soon as a candidate earlier than its own has succeeded. Giving up
+     * this way is not counted as a timeout.
+     */
+    struct DiophantineCancel
+    {
+        const std::atomic<size_t> *first_success = nullptr; // Lowest candidate index solved so far
+        size_t candidate = 0;                               // Index of the equation this thread is solving
+    };
+
+    inline DiophantineCancel &diophantine_cancel()
+    {
+        static thread_local DiophantineCancel cancel;
+        return cancel;
+    }
+
+    inline bool diophantine_cancelled()
+    {
+        const DiophantineCancel &cancel = diophantine_cancel();
+        return cancel.first_success && cancel.first_success->load(std::memory_order_relaxed) < cancel.candidate;
+    }
+
     // Sentinel: we use std::nullopt to indicate NO_SOLUTION externally. Internally we use a bool flag.
     struct ZOmegaOrNoSolution
     {
@@ -73,6 +122,12 @@ namespace gridsynth
             return 2; // even
         if (n <= 3)
             return std::nullopt;
+        if (auto p = small_prime_factor(n))
+        {
+            if (*p == n)
+                return std::nullopt; // n is itself a small prime
+            return p;
+        }
         auto &rng = global_rng();
         Integer a = _rand_between(1, n - 1, rng);
         Integer y = a;
@@ -133,9 +188,12 @@ namespace gridsynth
                         return g;
                     }
                 }
+                if (diophantine_cancelled())
+                    return std::nullopt;
                 auto now = std::chrono::steady_clock::now();
                 if (k >= L || std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count() >= factoring_timeout_ms)
                 {
+                    ++diophantine_counters().factoring_timeouts;
                     return std::nullopt;
                 }
             }
@@ -143,30 +201,33 @@ namespace gridsynth
         }
     }
 
-    // Random square root of -1 mod p for p prime p ≡ 1 (mod 4)
+    // Square root of -1 mod p for p prime p ≡ 1 (mod 4)
+    // Bases are tried in order 2, 3, ... rather than at random, so the root
+    // depends only on p and can be shared through prime_cache()
     inline std::optional<Integer> _sqrt_negative_one(Integer p, Integer L = 100)
     {
         if (p <= 2)
             return std::nullopt;
-        auto &rng = global_rng();
-        for (Integer i = 0; i < L; ++i)
-        {
-            Integer b = _rand_between(1, p - 1, rng);
-            Integer h = mod_pow(b, (p - 1) >> 2, p);
-            Integer r = (h * h) % p;
-            if (r == p - 1)
-                return h;
-            else if (r != 1)
-                return std::nullopt; // fail fast as python returns None
-        }
-        return std::nullopt;
+        return prime_cache().sqrt_negative_one.get(p, PrimeCache::hash(p), [&]() -> std::optional<Integer>
+                                                   {
+            for (Integer b = 2; b < L + 2 && b < p; ++b)
+            {
+                Integer h = mod_pow(b, (p - 1) >> 2, p);
+                Integer r = (h * h) % p;
+                if (r == p - 1)
+                    return h;
+                else if (r != 1)
+                    return std::nullopt; // fail fast as python returns None
+            }
+            return std::nullopt; });
     }
 
     class F_p2
     {
     public:
-        static Integer base; // element with base^((p-1)/2) ≡ -1 ?
-        static Integer p;
+        // Per-thread field parameters so independent syntheses can run concurrently
+        static thread_local Integer base; // element with base^((p-1)/2) ≡ -1 ?
+        static thread_local Integer p;
         Integer _a; // a + b * x where x^2 = base
         Integer _b;
         F_p2(Integer a = 0, Integer b = 0) : _a((a % p + p) % p), _b((b % p + p) % p) {}
@@ -196,8 +257,8 @@ namespace gridsynth
             return res;
         }
     };
-    inline Integer F_p2::base = 0;
-    inline Integer F_p2::p = 0;
+    inline thread_local Integer F_p2::base = 0;
+    inline thread_local Integer F_p2::p = 0;
 
     inline std::optional<Integer> _root_mod(Integer x, Integer p, Integer L = 100)
     {
@@ -210,35 +271,37 @@ namespace gridsynth
             return 0LL;
         if (!(p & 1LL) && p > 2)
             return std::nullopt;
-        // Euler criterion
-        Integer t = mod_pow(x, (p - 1) / 2, p);
-        if (t != 1)
-            return std::nullopt;
-        auto &rng = global_rng();
-        for (Integer iter = 0; iter < L; ++iter)
-        {
-            Integer b = _rand_between(1, p - 1, rng);
-            // r = b^{p-1} mod p
-            Integer r = mod_pow(b, p - 1, p);
-            if (r != 1)
-                return std::nullopt; // as python does
-            Integer candidate_base = ((b * b + p - x) % p);
-            // candidate_base^{(p-1)/2} must !=1
-            Integer check = mod_pow(candidate_base, (p - 1) / 2, p);
-            if (check != 1)
+        // Cipolla with bases 1, 2, ... in order, so the root depends only on (x, p)
+        return prime_cache().root.get({x, p}, PrimeCache::hash(p), [&]() -> std::optional<Integer>
+                                      {
+            // Euler criterion
+            Integer t = mod_pow(x, (p - 1) / 2, p);
+            if (t != 1)
+                return std::nullopt;
+            for (Integer b = 1; b < L + 1 && b < p; ++b)
             {
-                F_p2::p = p;
-                F_p2::base = candidate_base;
-                Integer power = (p + 1) / 2;
-                F_p2 elem(b, 1);
-                F_p2 rfp = elem.pow(power);
-                return rfp.a();
+                // r = b^{p-1} mod p
+                Integer r = mod_pow(b, p - 1, p);
+                if (r != 1)
+                    return std::nullopt; // as python does
+                Integer candidate_base = ((b * b + p - x) % p);
+                // candidate_base^{(p-1)/2} must !=1
+                Integer check = mod_pow(candidate_base, (p - 1) / 2, p);
+                if (check != 1)
+                {
+                    F_p2::p = p;
+                    F_p2::base = candidate_base;
+                    Integer power = (p + 1) / 2;
+                    F_p2 elem(b, 1);
+                    F_p2 rfp = elem.pow(power);
+                    return rfp.a();
+                }
             }
-        }
-        return std::nullopt;
+            return std::nullopt; });
     }
 
-    inline bool _is_prime(Integer n, Integer L = 4)
+    // Primality by GMP's BPSW and Miller-Rabin test, memoized in prime_cache()
+    inline bool _is_prime(Integer n)
     {
         if (n < 0)
             n = -n;
@@ -246,34 +309,8 @@ namespace gridsynth
             return false;
         if (!(n & 1LL))
             return n == 2;
-        Integer d = n - 1;
-        Integer r = 0;
-        while (!(d & 1LL))
-        {
-            d >>= 1;
-            ++r;
-        }
-        auto &rng = global_rng();
-        for (Integer i = 0; i < L; ++i)
-        {
-            Integer a = _rand_between(1, n - 1, rng);
-            Integer x = mod_pow(a, d, n);
-            if (x == 1)
-                return true; // matches python's early return (note: python code seems flawed; we keep behavior)
-            bool passed = false;
-            for (Integer j = 0; j < r; ++j)
-            {
-                if (x == n - 1)
-                {
-                    passed = true;
-                    break;
-                }
-                x = x * x % n;
-            }
-            if (passed)
-                return true;
-        }
-        return false;
+        return prime_cache().primality.get(n, PrimeCache::hash(n), [&]
+                                           { return mpz_probab_prime_p(n.get_mpz_t(), 24) > 0; });
     }
 
     // Decompose relatively integer prime factors - identical logic
@@ -455,10 +492,13 @@ namespace gridsynth
                 if (!fac)
                 {
                     facs.emplace_back(p, k);
+                    if (diophantine_cancelled())
+                        return {ZOmega(), false, true};
                     auto now = std::chrono::steady_clock::now();
                     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
                     if (elapsed >= diophantine_timeout_ms)
                     {
+                        ++diophantine_counters().diophantine_timeouts;
                         return {ZOmega(), false, true};
                     }
                 }
@@ -678,10 +718,13 @@ namespace gridsynth
                 if (!fac_n)
                 {
                     facs.emplace_back(eta, k);
+                    if (diophantine_cancelled())
+                        return {ZOmega(), false, true};
                     auto now = std::chrono::steady_clock::now();
                     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
                     if (elapsed >= diophantine_timeout_ms)
                     {
+                        ++diophantine_counters().diophantine_timeouts;
                         return {ZOmega(), false, true};
                     }
                 }
@@ -82,6 +82,14 @@ namespace gridsynth
             return cos_similarity + tol >= _d; // allow tiny undershoot due to rounding
         }
 
+        Float margin(const std::array<Float, 2> &u) const override
+        {
+            Float tol = Float(1e-30);
+            Float disk = Float(1.0) + tol - (u[0] * u[0] + u[1] * u[1]);
+            Float cap = _z_x * u[0] + _z_y * u[1] + tol - _d;
+            return min(disk, cap);
+        }
+
         std::optional<std::pair<Float, Float>> intersect(
             const std::array<Float, 2> &u0,
             const std::array<Float, 2> &v) const override
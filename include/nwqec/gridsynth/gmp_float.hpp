@@ -8,16 +8,48 @@
 // <algorithm> not needed after refactor
 
 #include "gmp_integer.hpp" // Include GMPInteger for mixed operations>
+#include "mp_pool.hpp"
 
 /**
  * gmp_float.hpp
  *
  * MPFR-based arbitrary precision floating point implementation that provides
  * the same interface as double with arbitrary precision arithmetic.
+ *
+ * Precision is a per-thread working setting (see ScopedPrecision): new values
+ * and arithmetic results are rounded to it, independent of operand precision.
+ * Storage for values and temporaries is recycled through a thread-local pool
+ * (mp_pool.hpp), so expression evaluation does not allocate once warm.
  */
 
 namespace gridsynth
 {
+    // MPFR <-> Integer bridges that keep inline Integer values off the mpz path.
+    // Results are identical to the mpfr_*_z forms since both round correctly.
+    inline void set_mpfr_integer(mpfr_t rop, const GMPInteger &z, mpfr_rnd_t rnd)
+    {
+        if (sizeof(long) >= sizeof(long long) && z.is_small())
+            mpfr_set_si(rop, static_cast<long>(z.small_value()), rnd);
+        else
+            mpfr_set_z(rop, z.get_mpz_t(), rnd);
+    }
+
+    inline void mul_mpfr_integer(mpfr_t rop, const mpfr_t op, const GMPInteger &z, mpfr_rnd_t rnd)
+    {
+        if (sizeof(long) >= sizeof(long long) && z.is_small())
+            mpfr_mul_si(rop, op, static_cast<long>(z.small_value()), rnd);
+        else
+            mpfr_mul_z(rop, op, z.get_mpz_t(), rnd);
+    }
+
+    inline void get_mpfr_integer(GMPInteger &rop, const mpfr_t op, mpfr_rnd_t rnd)
+    {
+        if (mpfr_fits_slong_p(op, rnd))
+            rop = static_cast<long long>(mpfr_get_si(op, rnd));
+        else
+            mpfr_get_z(rop.get_mpz_t(), op, rnd);
+    }
+
     /**
      * MPFR-based floating point class with arbitrary precision arithmetic
      */
@@ -25,14 +57,15 @@ namespace gridsynth
     {
     private:
         mpfr_t value_;
-        static mpfr_prec_t default_precision_;
+        // Working precision of the calling thread; every newly created value uses it
+        inline static thread_local mpfr_prec_t default_precision_ = 256;
         // Internal tag to construct directly with a specified precision without re-init overhead
         struct direct_init_tag
         {
         };
         GMPFloat(direct_init_tag, mpfr_prec_t prec)
         {
-            mpfr_init2(value_, prec);
+            pooled_mpfr_init2(value_, prec);
             mpfr_set_zero(value_, 1);
         }
 
@@ -59,49 +92,49 @@ namespace gridsynth
         // Constructors
         GMPFloat()
         {
-            mpfr_init2(value_, default_precision_);
+            pooled_mpfr_init2(value_, default_precision_);
             mpfr_set_zero(value_, 1);
         }
 
         GMPFloat(int val)
         {
-            mpfr_init2(value_, default_precision_);
+            pooled_mpfr_init2(value_, default_precision_);
             mpfr_set_si(value_, val, MPFR_RNDN);
         }
 
         GMPFloat(long val)
         {
-            mpfr_init2(value_, default_precision_);
+            pooled_mpfr_init2(value_, default_precision_);
             mpfr_set_si(value_, val, MPFR_RNDN);
         }
 
         GMPFloat(long long val)
         {
-            mpfr_init2(value_, default_precision_);
+            pooled_mpfr_init2(value_, default_precision_);
             mpfr_set_si(value_, val, MPFR_RNDN);
         }
 
         GMPFloat(float val)
         {
-            mpfr_init2(value_, default_precision_);
+            pooled_mpfr_init2(value_, default_precision_);
             mpfr_set_flt(value_, val, MPFR_RNDN);
         }
 
         GMPFloat(double val)
         {
-            mpfr_init2(value_, default_precision_);
+            pooled_mpfr_init2(value_, default_precision_);
             mpfr_set_d(value_, val, MPFR_RNDN);
         }
 
         GMPFloat(const GMPInteger &val)
         {
-            mpfr_init2(value_, default_precision_);
-            mpfr_set_z(value_, val.get_mpz_t(), MPFR_RNDN);
+            pooled_mpfr_init2(value_, default_precision_);
+            set_mpfr_integer(value_, val, MPFR_RNDN);
         }
 
         GMPFloat(long double val)
         {
-            mpfr_init2(value_, default_precision_);
+            pooled_mpfr_init2(value_, default_precision_);
             mpfr_set_ld(value_, val, MPFR_RNDN);
         }
 
@@ -175,7 +208,7 @@ namespace gridsynth
 
         GMPFloat(const std::string &str)
         {
-            mpfr_init2(value_, default_precision_);
+            pooled_mpfr_init2(value_, default_precision_);
             if (!parse_pi_expr(str, value_))
                 mpfr_set_str(value_, str.c_str(), 10, MPFR_RNDN);
         }
@@ -183,19 +216,19 @@ namespace gridsynth
         // Copy constructor
         GMPFloat(const GMPFloat &other)
         {
-            mpfr_init2(value_, mpfr_get_prec(other.value_));
+            pooled_mpfr_init2(value_, default_precision_);
             mpfr_set(value_, other.value_, MPFR_RNDN);
         }
 
         // Move constructor
         GMPFloat(GMPFloat &&other) noexcept
         {
-            mpfr_init2(value_, default_precision_);
+            pooled_mpfr_init2(value_, default_precision_);
             mpfr_swap(value_, other.value_);
         }
 
         // Destructor
-        ~GMPFloat() { mpfr_clear(value_); }
+        ~GMPFloat() { pooled_mpfr_clear(value_); }
 
         // Assignment operators
         GMPFloat &operator=(const GMPFloat &other)
@@ -270,32 +303,28 @@ namespace gridsynth
         // Arithmetic operators
         GMPFloat operator+(const GMPFloat &other) const
         {
-            mpfr_prec_t prec = std::max(mpfr_get_prec(value_), mpfr_get_prec(other.value_));
-            GMPFloat result(direct_init_tag{}, prec);
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_add(result.value_, value_, other.value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat operator-(const GMPFloat &other) const
         {
-            mpfr_prec_t prec = std::max(mpfr_get_prec(value_), mpfr_get_prec(other.value_));
-            GMPFloat result(direct_init_tag{}, prec);
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_sub(result.value_, value_, other.value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat operator*(const GMPFloat &other) const
         {
-            mpfr_prec_t prec = std::max(mpfr_get_prec(value_), mpfr_get_prec(other.value_));
-            GMPFloat result(direct_init_tag{}, prec);
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_mul(result.value_, value_, other.value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat operator/(const GMPFloat &other) const
         {
-            mpfr_prec_t prec = std::max(mpfr_get_prec(value_), mpfr_get_prec(other.value_));
-            GMPFloat result(direct_init_tag{}, prec);
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_div(result.value_, value_, other.value_, MPFR_RNDN);
             return result;
         }
@@ -407,7 +436,7 @@ namespace gridsynth
         // Unary operators
         GMPFloat operator-() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_neg(result.value_, value_, MPFR_RNDN);
             return result;
         }
@@ -422,133 +451,133 @@ namespace gridsynth
         // Mathematical functions (mimicking std::cmath functions)
         GMPFloat abs() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_abs(result.value_, value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat sqrt() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_sqrt(result.value_, value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat pow(const GMPFloat &exp) const
         {
-            GMPFloat result(direct_init_tag{}, std::max(mpfr_get_prec(value_), mpfr_get_prec(exp.value_)));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_pow(result.value_, value_, exp.value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat exp() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_exp(result.value_, value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat log() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_log(result.value_, value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat log10() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_log10(result.value_, value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat sin() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_sin(result.value_, value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat cos() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_cos(result.value_, value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat tan() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_tan(result.value_, value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat asin() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_asin(result.value_, value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat acos() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_acos(result.value_, value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat atan() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_atan(result.value_, value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat atan2(const GMPFloat &x) const
         {
-            GMPFloat result(direct_init_tag{}, std::max(mpfr_get_prec(value_), mpfr_get_prec(x.value_)));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_atan2(result.value_, value_, x.value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat sinh() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_sinh(result.value_, value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat cosh() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_cosh(result.value_, value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat tanh() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_tanh(result.value_, value_, MPFR_RNDN);
             return result;
         }
 
         GMPFloat floor() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_floor(result.value_, value_);
             return result;
         }
 
         GMPFloat ceil() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_ceil(result.value_, value_);
             return result;
         }
 
         GMPFloat round() const
         {
-            GMPFloat result(direct_init_tag{}, mpfr_get_prec(value_));
+            GMPFloat result(direct_init_tag{}, default_precision_);
             mpfr_round(result.value_, value_);
             return result;
         }
@@ -660,7 +689,6 @@ namespace gridsynth
     };
 
     // Static member initialization
-    mpfr_prec_t GMPFloat::default_precision_ = 256; // Default precision in bits (sufficient for ~1e-50 accuracy)
 
     // Global mathematical functions (mimicking std namespace functions)
     inline GMPFloat abs(const GMPFloat &x) { return x.abs(); }
@@ -683,12 +711,33 @@ namespace gridsynth
     inline GMPFloat ceil(const GMPFloat &x) { return x.ceil(); }
     inline GMPFloat round(const GMPFloat &x) { return x.round(); }
 
+    /**
+     * RAII guard that sets the calling thread's working precision and restores
+     * the previous one on destruction. Values created inside the scope, and the
+     * results of arithmetic on them, carry the new precision.
+     */
+    class ScopedPrecision
+    {
+    public:
+        explicit ScopedPrecision(mpfr_prec_t prec) : saved_(GMPFloat::get_default_precision())
+        {
+            GMPFloat::set_default_precision(prec);
+        }
+        ~ScopedPrecision() { GMPFloat::set_default_precision(saved_); }
+
+        ScopedPrecision(const ScopedPrecision &) = delete;
+        ScopedPrecision &operator=(const ScopedPrecision &) = delete;
+
+    private:
+        mpfr_prec_t saved_;
+    };
+
     // Direct GMPFloat to GMPInteger conversions (much faster than via double)
     inline GMPInteger floor_to_gmpinteger(const GMPFloat &x)
     {
         GMPFloat floored = x.floor();
         GMPInteger result;
-        mpfr_get_z(result.get_mpz_t(), floored.get_mpfr(), MPFR_RNDN);
+        get_mpfr_integer(result, floored.get_mpfr(), MPFR_RNDN);
         return result;
     }
 
@@ -696,7 +745,7 @@ namespace gridsynth
     {
         GMPFloat ceiled = x.ceil();
         GMPInteger result;
-        mpfr_get_z(result.get_mpz_t(), ceiled.get_mpfr(), MPFR_RNDN);
+        get_mpfr_integer(result, ceiled.get_mpfr(), MPFR_RNDN);
         return result;
     }
 
@@ -704,7 +753,7 @@ namespace gridsynth
     {
         GMPFloat rounded = x.round();
         GMPInteger result;
-        mpfr_get_z(result.get_mpz_t(), rounded.get_mpfr(), MPFR_RNDN);
+        get_mpfr_integer(result, rounded.get_mpfr(), MPFR_RNDN);
         return result;
     }
 
@@ -737,49 +786,49 @@ namespace gridsynth
     // Optimized mixed operations with double (avoid temporary GMPFloat creation)
     inline GMPFloat operator+(const GMPFloat &lhs, double rhs)
     {
-        GMPFloat result = GMPFloat::with_precision(lhs.precision());
+        GMPFloat result;
         mpfr_add_d(result.get_mpfr(), lhs.get_mpfr(), rhs, MPFR_RNDN);
         return result;
     }
     inline GMPFloat operator+(double lhs, const GMPFloat &rhs)
     {
-        GMPFloat result = GMPFloat::with_precision(rhs.precision());
+        GMPFloat result;
         mpfr_add_d(result.get_mpfr(), rhs.get_mpfr(), lhs, MPFR_RNDN);
         return result;
     }
     inline GMPFloat operator-(const GMPFloat &lhs, double rhs)
     {
-        GMPFloat result = GMPFloat::with_precision(lhs.precision());
+        GMPFloat result;
         mpfr_sub_d(result.get_mpfr(), lhs.get_mpfr(), rhs, MPFR_RNDN);
         return result;
     }
     inline GMPFloat operator-(double lhs, const GMPFloat &rhs)
     {
-        GMPFloat result = GMPFloat::with_precision(rhs.precision());
+        GMPFloat result;
         mpfr_d_sub(result.get_mpfr(), lhs, rhs.get_mpfr(), MPFR_RNDN);
         return result;
     }
     inline GMPFloat operator*(const GMPFloat &lhs, double rhs)
     {
-        GMPFloat result = GMPFloat::with_precision(lhs.precision());
+        GMPFloat result;
         mpfr_mul_d(result.get_mpfr(), lhs.get_mpfr(), rhs, MPFR_RNDN);
         return result;
     }
     inline GMPFloat operator*(double lhs, const GMPFloat &rhs)
     {
-        GMPFloat result = GMPFloat::with_precision(rhs.precision());
+        GMPFloat result;
         mpfr_mul_d(result.get_mpfr(), rhs.get_mpfr(), lhs, MPFR_RNDN);
         return result;
     }
     inline GMPFloat operator/(const GMPFloat &lhs, double rhs)
     {
-        GMPFloat result = GMPFloat::with_precision(lhs.precision());
+        GMPFloat result;
         mpfr_div_d(result.get_mpfr(), lhs.get_mpfr(), rhs, MPFR_RNDN);
         return result;
     }
     inline GMPFloat operator/(double lhs, const GMPFloat &rhs)
     {
-        GMPFloat result = GMPFloat::with_precision(rhs.precision());
+        GMPFloat result;
         mpfr_d_div(result.get_mpfr(), lhs, rhs.get_mpfr(), MPFR_RNDN);
         return result;
     }
@@ -787,49 +836,49 @@ namespace gridsynth
     // Optimized mixed operations with int using mpfr_*_si helpers
     inline GMPFloat operator+(const GMPFloat &lhs, int rhs)
     {
-        GMPFloat result = GMPFloat::with_precision(lhs.precision());
+        GMPFloat result;
         mpfr_add_si(result.get_mpfr(), lhs.get_mpfr(), static_cast<long>(rhs), MPFR_RNDN);
         return result;
     }
     inline GMPFloat operator+(int lhs, const GMPFloat &rhs)
     {
-        GMPFloat result = GMPFloat::with_precision(rhs.precision());
+        GMPFloat result;
         mpfr_add_si(result.get_mpfr(), rhs.get_mpfr(), static_cast<long>(lhs), MPFR_RNDN);
         return result;
     }
     inline GMPFloat operator-(const GMPFloat &lhs, int rhs)
     {
-        GMPFloat result = GMPFloat::with_precision(lhs.precision());
+        GMPFloat result;
         mpfr_sub_si(result.get_mpfr(), lhs.get_mpfr(), static_cast<long>(rhs), MPFR_RNDN);
         return result;
     }
     inline GMPFloat operator-(int lhs, const GMPFloat &rhs)
     {
-        GMPFloat result = GMPFloat::with_precision(rhs.precision());
+        GMPFloat result;
         mpfr_si_sub(result.get_mpfr(), static_cast<long>(lhs), rhs.get_mpfr(), MPFR_RNDN);
         return result;
     }
     inline GMPFloat operator*(const GMPFloat &lhs, int rhs)
     {
-        GMPFloat result = GMPFloat::with_precision(lhs.precision());
+        GMPFloat result;
         mpfr_mul_si(result.get_mpfr(), lhs.get_mpfr(), static_cast<long>(rhs), MPFR_RNDN);
         return result;
     }
     inline GMPFloat operator*(int lhs, const GMPFloat &rhs)
     {
-        GMPFloat result = GMPFloat::with_precision(rhs.precision());
+        GMPFloat result;
         mpfr_mul_si(result.get_mpfr(), rhs.get_mpfr(), static_cast<long>(lhs), MPFR_RNDN);
         return result;
     }
     inline GMPFloat operator/(const GMPFloat &lhs, int rhs)
     {
-        GMPFloat result = GMPFloat::with_precision(lhs.precision());
+        GMPFloat result;
         mpfr_div_si(result.get_mpfr(), lhs.get_mpfr(), static_cast<long>(rhs), MPFR_RNDN);
         return result;
     }
     inline GMPFloat operator/(int lhs, const GMPFloat &rhs)
     {
-        GMPFloat result = GMPFloat::with_precision(rhs.precision());
+        GMPFloat result;
         mpfr_si_div(result.get_mpfr(), static_cast<long>(lhs), rhs.get_mpfr(), MPFR_RNDN);
         return result;
     }
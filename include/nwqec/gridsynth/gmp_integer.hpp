@@ -1,196 +1,486 @@
 #pragma once
+#include <climits>
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <gmp.h>
 
+#include "mp_pool.hpp"
+
 /**
  * gmp_integer.hpp
  *
- * GMP-based arbitrary precision Integer implementation that provides
+ * Hybrid arbitrary precision Integer implementation that provides
  * the same interface as the __int128_t-based Integer class.
+ *
+ * Values that fit in a long long are stored inline and all arithmetic on
+ * them is done with overflow-checked machine instructions. An operation
+ * whose result does not fit promotes the value to a GMP mpz_t; big results
+ * that shrink back into range are demoted again. Small coefficients, which
+ * dominate the ring arithmetic at low k, therefore never touch the heap.
+ * Big values draw their mpz_t from a thread-local pool (mp_pool.hpp).
  */
 
 namespace gridsynth
 {
+    namespace detail
+    {
+        inline bool add_overflow(long long a, long long b, long long &r)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_add_overflow(a, b, &r);
+#else
+            if ((b > 0 && a > LLONG_MAX - b) || (b < 0 && a < LLONG_MIN - b))
+                return true;
+            r = a + b;
+            return false;
+#endif
+        }
+
+        inline bool sub_overflow(long long a, long long b, long long &r)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_sub_overflow(a, b, &r);
+#else
+            if ((b < 0 && a > LLONG_MAX + b) || (b > 0 && a < LLONG_MIN + b))
+                return true;
+            r = a - b;
+            return false;
+#endif
+        }
+
+        inline bool mul_overflow(long long a, long long b, long long &r)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_mul_overflow(a, b, &r);
+#else
+            // Conservative: only products of two 31-bit magnitudes stay inline
+            const long long lim = 1LL << 31;
+            if (a <= -lim || a >= lim || b <= -lim || b >= lim)
+                return true;
+            r = a * b;
+            return false;
+#endif
+        }
+
+        inline unsigned long long magnitude(long long v)
+        {
+            return v < 0 ? 0ULL - static_cast<unsigned long long>(v) : static_cast<unsigned long long>(v);
+        }
+    } // namespace detail
+
     /**
-     * GMP-based Integer class with arbitrary precision arithmetic
+     * Hybrid Integer class: inline long long with GMP promotion on overflow
      */
     class GMPInteger
     {
+    public:
+        /**
+         * Read-only mpz_t view of an Integer, valid for the enclosing full expression.
+         * Inline values are exposed through limbs on the stack, so passing a small
+         * Integer to a GMP/MPFR routine does not allocate.
+         */
+        class MpzView
+        {
+        public:
+            explicit MpzView(mpz_srcptr z) : ptr_(z) {}
+
+            explicit MpzView(long long v)
+            {
+                unsigned long long mag = detail::magnitude(v);
+                mp_size_t n = 0;
+                while (mag != 0)
+                {
+                    limbs_[n++] = static_cast<mp_limb_t>(mag & GMP_NUMB_MASK);
+                    if constexpr (GMP_NUMB_BITS >= 64)
+                        mag = 0;
+                    else
+                        mag >>= GMP_NUMB_BITS;
+                }
+                ptr_ = mpz_roinit_n(&view_, limbs_, v < 0 ? -n : n);
+            }
+
+            MpzView(const MpzView &) = delete;
+            MpzView &operator=(const MpzView &) = delete;
+
+            operator mpz_srcptr() const { return ptr_; }
+
+        private:
+            static constexpr int kLimbs = (64 + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+            mp_limb_t limbs_[kLimbs];
+            __mpz_struct view_;
+            mpz_srcptr ptr_;
+        };
+
     private:
-        mpz_t value_;
+        union
+        {
+            long long small_; // valid when !big_
+            mpz_t value_;     // initialized only when big_
+        };
+        bool big_ = false;
+
+        static void init_mpz(mpz_t z, long long v)
+        {
+            pooled_mpz_init(z);
+            if constexpr (sizeof(long) >= sizeof(long long))
+                mpz_set_si(z, static_cast<long>(v));
+            else
+                mpz_set(z, MpzView(v));
+        }
+
+        // Switch to GMP storage, keeping the current value
+        void promote()
+        {
+            if (!big_)
+            {
+                long long v = small_;
+                init_mpz(value_, v);
+                big_ = true;
+            }
+        }
+
+        // Return to inline storage when the GMP value fits
+        void demote()
+        {
+            if (big_ && mpz_fits_slong_p(value_))
+            {
+                long v = mpz_get_si(value_);
+                pooled_mpz_clear(value_);
+                small_ = v;
+                big_ = false;
+            }
+        }
+
+        void set_small(long long v)
+        {
+            if (big_)
+            {
+                pooled_mpz_clear(value_);
+                big_ = false;
+            }
+            small_ = v;
+        }
+
+        using MpzBinaryOp = void (*)(mpz_ptr, mpz_srcptr, mpz_srcptr);
+
+        static GMPInteger big_binary(const GMPInteger &a, const GMPInteger &b, MpzBinaryOp op)
+        {
+            GMPInteger result;
+            pooled_mpz_init(result.value_);
+            result.big_ = true;
+            op(result.value_, a.get_mpz_t(), b.get_mpz_t());
+            result.demote();
+            return result;
+        }
+
+        GMPInteger &big_compound(const GMPInteger &other, MpzBinaryOp op)
+        {
+            promote();
+            op(value_, value_, other.get_mpz_t());
+            demote();
+            return *this;
+        }
+
+        static int compare(const GMPInteger &a, const GMPInteger &b)
+        {
+            if (!a.big_ && !b.big_)
+                return (a.small_ > b.small_) - (a.small_ < b.small_);
+            return mpz_cmp(a.get_mpz_t(), b.get_mpz_t());
+        }
 
     public:
         // Constructors
-        GMPInteger() { mpz_init(value_); }
+        GMPInteger() : small_(0) {}
 
-        GMPInteger(int val) { mpz_init_set_si(value_, val); }
+        GMPInteger(int val) : small_(val) {}
 
-        GMPInteger(long val) { mpz_init_set_si(value_, val); }
+        GMPInteger(long val) : small_(val) {}
 
-        GMPInteger(long long val) { mpz_init_set_si(value_, val); }
+        GMPInteger(long long val) : small_(val) {}
 
-        GMPInteger(double val) { mpz_init_set_d(value_, val); }
+        GMPInteger(double val)
+        {
+            if (val > -9.2e18 && val < 9.2e18)
+                small_ = static_cast<long long>(val); // Truncates like mpz_set_d
+            else
+            {
+                pooled_mpz_init(value_);
+                mpz_set_d(value_, val);
+                big_ = true;
+                demote();
+            }
+        }
 
         // Copy constructor
-        GMPInteger(const GMPInteger &other) { mpz_init_set(value_, other.value_); }
+        GMPInteger(const GMPInteger &other)
+        {
+            if (other.big_ && !mpz_fits_slong_p(other.value_))
+            {
+                pooled_mpz_init(value_);
+                mpz_set(value_, other.value_);
+                big_ = true;
+            }
+            else
+                small_ = other.big_ ? mpz_get_si(other.value_) : other.small_;
+        }
 
         // Move constructor
         GMPInteger(GMPInteger &&other) noexcept
         {
-            mpz_init(value_);
-            mpz_swap(value_, other.value_);
+            if (other.big_)
+            {
+                value_[0] = other.value_[0];
+                big_ = true;
+                other.big_ = false;
+                other.small_ = 0;
+            }
+            else
+                small_ = other.small_;
         }
 
         // Destructor
-        ~GMPInteger() { mpz_clear(value_); }
+        ~GMPInteger()
+        {
+            if (big_)
+                pooled_mpz_clear(value_);
+        }
 
         // No global pre-allocation; use GMP growth heuristics
 
         bool is_odd() const
         {
-            return mpz_odd_p(value_);
+            return big_ ? mpz_odd_p(value_) : (small_ & 1) != 0;
         }
 
+        // Inline storage queries (for fast paths that bypass GMP)
+        bool is_small() const { return !big_; }
+        long long small_value() const { return small_; }
+
         // Assignment operators
         GMPInteger &operator=(const GMPInteger &other)
         {
-            if (this != &other)
+            if (this == &other)
+                return *this;
+            if (!other.big_)
+                set_small(other.small_);
+            else if (big_)
+                mpz_set(value_, other.value_);
+            else
             {
+                pooled_mpz_init(value_);
                 mpz_set(value_, other.value_);
+                big_ = true;
             }
             return *this;
         }
 
         GMPInteger &operator=(GMPInteger &&other) noexcept
         {
-            if (this != &other)
+            if (this == &other)
+                return *this;
+            if (!other.big_)
+                set_small(other.small_);
+            else if (big_)
+                std::swap(value_[0], other.value_[0]);
+            else
             {
-                mpz_swap(value_, other.value_);
+                value_[0] = other.value_[0];
+                big_ = true;
+                other.big_ = false;
+                other.small_ = 0;
             }
             return *this;
         }
 
         GMPInteger &operator=(int val)
         {
-            mpz_set_si(value_, val);
+            set_small(val);
             return *this;
         }
 
         GMPInteger &operator=(long val)
         {
-            mpz_set_si(value_, val);
+            set_small(val);
             return *this;
         }
 
         GMPInteger &operator=(long long val)
         {
-            mpz_set_si(value_, val);
+            set_small(val);
             return *this;
         }
 
         // Conversion operators
-        explicit operator int() const { return static_cast<int>(mpz_get_si(value_)); }
+        explicit operator int() const { return big_ ? static_cast<int>(mpz_get_si(value_)) : static_cast<int>(small_); }
 
-        explicit operator long long() const { return static_cast<long long>(mpz_get_si(value_)); }
+        explicit operator long long() const { return big_ ? static_cast<long long>(mpz_get_si(value_)) : small_; }
 
-        explicit operator double() const { return mpz_get_d(value_); }
+        explicit operator double() const
+        {
+            // Exact below 2^53; beyond that keep mpz_get_d's truncation
+            if (!big_ && small_ >= -(1LL << 53) && small_ <= (1LL << 53))
+                return static_cast<double>(small_);
+            return mpz_get_d(get_mpz_t());
+        }
 
-        operator size_t() const { return static_cast<size_t>(mpz_get_ui(value_)); } // Implicit for array indexing
+        // Implicit for array indexing; like mpz_get_ui, yields the magnitude
+        operator size_t() const { return big_ ? static_cast<size_t>(mpz_get_ui(value_)) : static_cast<size_t>(detail::magnitude(small_)); }
 
-        explicit operator bool() const { return mpz_cmp_si(value_, 0) != 0; }
+        explicit operator bool() const { return big_ ? mpz_sgn(value_) != 0 : small_ != 0; }
 
-        // Access to internal representation for efficient operations
-        mpz_t &get_mpz_t() { return value_; }
-        const mpz_t &get_mpz_t() const { return value_; }
+        // Access to internal representation for efficient operations.
+        // The mutable accessor switches to GMP storage so the caller may write through it.
+        mpz_t &get_mpz_t()
+        {
+            promote();
+            return value_;
+        }
+        MpzView get_mpz_t() const
+        {
+            if (big_)
+                return MpzView(value_);
+            return MpzView(small_);
+        }
 
         // Arithmetic operators
         GMPInteger operator+(const GMPInteger &other) const
         {
-            GMPInteger result;
-            mpz_add(result.value_, value_, other.value_);
-            return result;
+            long long r;
+            if (!big_ && !other.big_ && !detail::add_overflow(small_, other.small_, r))
+                return GMPInteger(r);
+            return big_binary(*this, other, mpz_add);
         }
 
         GMPInteger operator-(const GMPInteger &other) const
         {
-            GMPInteger result;
-            mpz_sub(result.value_, value_, other.value_);
-            return result;
+            long long r;
+            if (!big_ && !other.big_ && !detail::sub_overflow(small_, other.small_, r))
+                return GMPInteger(r);
+            return big_binary(*this, other, mpz_sub);
         }
 
         GMPInteger operator*(const GMPInteger &other) const
         {
-            GMPInteger result;
-            mpz_mul(result.value_, value_, other.value_);
-            return result;
+            long long r;
+            if (!big_ && !other.big_ && !detail::mul_overflow(small_, other.small_, r))
+                return GMPInteger(r);
+            return big_binary(*this, other, mpz_mul);
         }
 
         GMPInteger operator/(const GMPInteger &other) const
         {
-            GMPInteger result;
-            mpz_tdiv_q(result.value_, value_, other.value_);
-            return result;
+            // Zero divisors go to GMP so the failure mode is unchanged
+            if (!big_ && !other.big_ && other.small_ != 0 && !(small_ == LLONG_MIN && other.small_ == -1))
+                return GMPInteger(small_ / other.small_);
+            return big_binary(*this, other, mpz_tdiv_q);
         }
 
         GMPInteger operator%(const GMPInteger &other) const
         {
-            GMPInteger result;
-            mpz_tdiv_r(result.value_, value_, other.value_);
-            return result;
+            if (!big_ && !other.big_ && other.small_ != 0)
+                return GMPInteger(other.small_ == -1 ? 0LL : small_ % other.small_);
+            return big_binary(*this, other, mpz_tdiv_r);
         }
 
         // Compound assignment operators
         GMPInteger &operator+=(const GMPInteger &other)
         {
-            mpz_add(value_, value_, other.value_);
-            return *this;
+            long long r;
+            if (!big_ && !other.big_ && !detail::add_overflow(small_, other.small_, r))
+            {
+                small_ = r;
+                return *this;
+            }
+            return big_compound(other, mpz_add);
         }
 
         GMPInteger &operator-=(const GMPInteger &other)
         {
-            mpz_sub(value_, value_, other.value_);
-            return *this;
+            long long r;
+            if (!big_ && !other.big_ && !detail::sub_overflow(small_, other.small_, r))
+            {
+                small_ = r;
+                return *this;
+            }
+            return big_compound(other, mpz_sub);
         }
 
         GMPInteger &operator*=(const GMPInteger &other)
         {
-            mpz_mul(value_, value_, other.value_);
-            return *this;
+            long long r;
+            if (!big_ && !other.big_ && !detail::mul_overflow(small_, other.small_, r))
+            {
+                small_ = r;
+                return *this;
+            }
+            return big_compound(other, mpz_mul);
         }
 
         GMPInteger &operator/=(const GMPInteger &other)
         {
-            mpz_tdiv_q(value_, value_, other.value_);
-            return *this;
+            if (!big_ && !other.big_ && other.small_ != 0 && !(small_ == LLONG_MIN && other.small_ == -1))
+            {
+                small_ /= other.small_;
+                return *this;
+            }
+            return big_compound(other, mpz_tdiv_q);
         }
 
         GMPInteger &operator%=(const GMPInteger &other)
         {
-            mpz_tdiv_r(value_, value_, other.value_);
-            return *this;
+            if (!big_ && !other.big_ && other.small_ != 0)
+            {
+                small_ = other.small_ == -1 ? 0 : small_ % other.small_;
+                return *this;
+            }
+            return big_compound(other, mpz_tdiv_r);
         }
 
         // Compound assignment with built-in signed types (avoid temporary objects)
         GMPInteger &operator+=(long long rhs)
         {
+            long long r;
+            if (!big_ && !detail::add_overflow(small_, rhs, r))
+            {
+                small_ = r;
+                return *this;
+            }
+            promote();
             if (rhs >= 0)
                 mpz_add_ui(value_, value_, static_cast<unsigned long>(rhs));
             else
-                mpz_sub_ui(value_, value_, static_cast<unsigned long>(-rhs));
+                mpz_sub_ui(value_, value_, static_cast<unsigned long>(detail::magnitude(rhs)));
+            demote();
             return *this;
         }
         GMPInteger &operator-=(long long rhs)
         {
+            long long r;
+            if (!big_ && !detail::sub_overflow(small_, rhs, r))
+            {
+                small_ = r;
+                return *this;
+            }
+            promote();
             if (rhs >= 0)
                 mpz_sub_ui(value_, value_, static_cast<unsigned long>(rhs));
             else
-                mpz_add_ui(value_, value_, static_cast<unsigned long>(-rhs));
+                mpz_add_ui(value_, value_, static_cast<unsigned long>(detail::magnitude(rhs)));
+            demote();
             return *this;
         }
         GMPInteger &operator*=(long long rhs)
         {
+            long long r;
+            if (!big_ && !detail::mul_overflow(small_, rhs, r))
+            {
+                small_ = r;
+                return *this;
+            }
+            promote();
 #if defined(__GNU_MP_VERSION)
             // mpz_mul_si is available in GMP
             mpz_mul_si(value_, value_, rhs);
@@ -203,30 +493,40 @@ namespace gridsynth
                 mpz_neg(value_, value_);
             }
 #endif
+            demote();
             return *this;
         }
         GMPInteger &operator/=(long long rhs)
         {
             if (rhs == 0)
                 throw std::runtime_error("Division by zero");
+            if (!big_ && !(small_ == LLONG_MIN && rhs == -1))
+            {
+                small_ /= rhs;
+                return *this;
+            }
+            promote();
             bool neg = rhs < 0;
-            unsigned long mag = static_cast<unsigned long>(neg ? -rhs : rhs);
+            unsigned long mag = static_cast<unsigned long>(detail::magnitude(rhs));
             mpz_tdiv_q_ui(value_, value_, mag);
             if (neg)
                 mpz_neg(value_, value_);
+            demote();
             return *this;
         }
         GMPInteger &operator%=(long long rhs)
         {
             if (rhs == 0)
                 throw std::runtime_error("Modulo by zero");
-            bool neg = rhs < 0; // Sign of remainder follows dividend per C++ semantics, so ignore sign of rhs
-            unsigned long mag = static_cast<unsigned long>(neg ? -rhs : rhs);
-            mpz_t r;
-            mpz_init(r);
-            mpz_tdiv_r_ui(r, value_, mag);
-            mpz_set(value_, r); // store remainder
-            mpz_clear(r);
+            if (!big_)
+            {
+                small_ = rhs == -1 ? 0 : small_ % rhs;
+                return *this;
+            }
+            // Sign of remainder follows dividend per C++ semantics, so ignore sign of rhs
+            unsigned long mag = static_cast<unsigned long>(detail::magnitude(rhs));
+            mpz_tdiv_r_ui(value_, value_, mag);
+            demote();
             return *this;
         }
 
@@ -239,107 +539,135 @@ namespace gridsynth
         // Increment and decrement operators
         GMPInteger &operator++()
         {
-            mpz_add_ui(value_, value_, 1);
-            return *this;
+            return (*this += 1LL);
         }
 
         GMPInteger operator++(int)
         {
             GMPInteger temp(*this);
-            mpz_add_ui(value_, value_, 1);
+            *this += 1LL;
             return temp;
         }
 
         // Comparison operators
-        bool operator==(const GMPInteger &other) const { return mpz_cmp(value_, other.value_) == 0; }
-        bool operator!=(const GMPInteger &other) const { return mpz_cmp(value_, other.value_) != 0; }
-        bool operator<(const GMPInteger &other) const { return mpz_cmp(value_, other.value_) < 0; }
-        bool operator<=(const GMPInteger &other) const { return mpz_cmp(value_, other.value_) <= 0; }
-        bool operator>(const GMPInteger &other) const { return mpz_cmp(value_, other.value_) > 0; }
-        bool operator>=(const GMPInteger &other) const { return mpz_cmp(value_, other.value_) >= 0; }
+        bool operator==(const GMPInteger &other) const { return compare(*this, other) == 0; }
+        bool operator!=(const GMPInteger &other) const { return compare(*this, other) != 0; }
+        bool operator<(const GMPInteger &other) const { return compare(*this, other) < 0; }
+        bool operator<=(const GMPInteger &other) const { return compare(*this, other) <= 0; }
+        bool operator>(const GMPInteger &other) const { return compare(*this, other) > 0; }
+        bool operator>=(const GMPInteger &other) const { return compare(*this, other) >= 0; }
 
         // Bitwise operators
         GMPInteger operator<<(int shift) const
         {
+            if (!big_ && shift >= 0)
+            {
+                if (small_ == 0)
+                    return GMPInteger();
+                if (shift < 62 && small_ >= (LLONG_MIN >> shift) && small_ <= (LLONG_MAX >> shift))
+                    return GMPInteger(small_ * (1LL << shift));
+            }
             GMPInteger result;
-            mpz_mul_2exp(result.value_, value_, shift);
+            pooled_mpz_init(result.value_);
+            result.big_ = true;
+            mpz_mul_2exp(result.value_, get_mpz_t(), shift);
+            result.demote();
             return result;
         }
 
         GMPInteger operator>>(int shift) const
         {
+            if (!big_ && shift >= 0)
+            {
+                // Truncates toward zero like mpz_tdiv_q_2exp
+                unsigned long long mag = detail::magnitude(small_);
+                unsigned long long q = shift >= 64 ? 0 : (mag >> shift);
+                if (q <= static_cast<unsigned long long>(LLONG_MAX))
+                    return GMPInteger(small_ < 0 ? -static_cast<long long>(q) : static_cast<long long>(q));
+            }
             GMPInteger result;
-            mpz_tdiv_q_2exp(result.value_, value_, shift);
+            pooled_mpz_init(result.value_);
+            result.big_ = true;
+            mpz_tdiv_q_2exp(result.value_, get_mpz_t(), shift);
+            result.demote();
             return result;
         }
 
         GMPInteger operator<<(const GMPInteger &shift) const
         {
-            GMPInteger result;
-            mpz_mul_2exp(result.value_, value_, static_cast<mp_bitcnt_t>(mpz_get_ui(shift.value_)));
-            return result;
+            return *this << static_cast<int>(static_cast<mp_bitcnt_t>(static_cast<size_t>(shift)));
         }
 
         GMPInteger operator>>(const GMPInteger &shift) const
         {
-            GMPInteger result;
-            mpz_tdiv_q_2exp(result.value_, value_, static_cast<mp_bitcnt_t>(mpz_get_ui(shift.value_)));
-            return result;
+            return *this >> static_cast<int>(static_cast<mp_bitcnt_t>(static_cast<size_t>(shift)));
         }
 
+        // Two's complement semantics match mpz_and/ior/xor, and results of inline operands stay inline
         GMPInteger operator&(const GMPInteger &other) const
         {
-            GMPInteger result;
-            mpz_and(result.value_, value_, other.value_);
-            return result;
+            if (!big_ && !other.big_)
+                return GMPInteger(small_ & other.small_);
+            return big_binary(*this, other, mpz_and);
         }
 
         GMPInteger operator|(const GMPInteger &other) const
         {
-            GMPInteger result;
-            mpz_ior(result.value_, value_, other.value_);
-            return result;
+            if (!big_ && !other.big_)
+                return GMPInteger(small_ | other.small_);
+            return big_binary(*this, other, mpz_ior);
         }
 
         GMPInteger operator^(const GMPInteger &other) const
         {
-            GMPInteger result;
-            mpz_xor(result.value_, value_, other.value_);
-            return result;
+            if (!big_ && !other.big_)
+                return GMPInteger(small_ ^ other.small_);
+            return big_binary(*this, other, mpz_xor);
         }
 
         // Compound bitwise assignment operators
         GMPInteger &operator<<=(int shift)
         {
-            mpz_mul_2exp(value_, value_, shift);
+            *this = *this << shift;
             return *this;
         }
 
         GMPInteger &operator>>=(int shift)
         {
-            mpz_tdiv_q_2exp(value_, value_, shift);
+            *this = *this >> shift;
             return *this;
         }
 
         GMPInteger &operator&=(const GMPInteger &other)
         {
-            mpz_and(value_, value_, other.value_);
-            return *this;
+            if (!big_ && !other.big_)
+            {
+                small_ &= other.small_;
+                return *this;
+            }
+            return big_compound(other, mpz_and);
         }
 
         // Unary operators
         GMPInteger operator-() const
         {
+            if (!big_ && small_ != LLONG_MIN)
+                return GMPInteger(-small_);
             GMPInteger result;
-            mpz_neg(result.value_, value_);
+            pooled_mpz_init(result.value_);
+            result.big_ = true;
+            mpz_neg(result.value_, get_mpz_t());
+            result.demote();
             return result;
         }
 
-        bool operator!() const { return mpz_cmp_si(value_, 0) == 0; }
+        bool operator!() const { return !static_cast<bool>(*this); }
 
         // Stream output operator
         friend std::ostream &operator<<(std::ostream &os, const GMPInteger &val)
         {
+            if (!val.big_)
+                return os << val.small_;
             char *str = mpz_get_str(nullptr, 10, val.value_);
             os << str;
             free(str);
@@ -348,8 +676,21 @@ namespace gridsynth
 
         GMPInteger floorsqrt() const
         {
+            if (!big_ && small_ >= 0)
+            {
+                unsigned long long v = static_cast<unsigned long long>(small_);
+                unsigned long long r = static_cast<unsigned long long>(std::sqrt(static_cast<double>(v)));
+                while (r * r > v)
+                    --r;
+                while ((r + 1) * (r + 1) <= v)
+                    ++r;
+                return GMPInteger(static_cast<long long>(r));
+            }
             GMPInteger result;
-            mpz_sqrt(result.value_, value_);
+            pooled_mpz_init(result.value_);
+            result.big_ = true;
+            mpz_sqrt(result.value_, get_mpz_t());
+            result.demote();
             return result;
         }
     };
@@ -376,9 +717,7 @@ namespace gridsynth
     }
     inline GMPInteger operator-(long long lhs, const GMPInteger &rhs)
     {
-        GMPInteger result(lhs);
-        result -= static_cast<long long>(rhs.operator long long());
-        return result;
+        return GMPInteger(lhs) - rhs;
     }
     inline GMPInteger operator*(const GMPInteger &lhs, long long rhs)
     {
@@ -400,10 +739,7 @@ namespace gridsynth
     }
     inline GMPInteger operator/(long long lhs, const GMPInteger &rhs)
     {
-        GMPInteger result(lhs);
-        // Division by large rhs still needs full mpz operation
-        mpz_tdiv_q(result.get_mpz_t(), result.get_mpz_t(), rhs.get_mpz_t());
-        return result;
+        return GMPInteger(lhs) / rhs;
     }
     inline GMPInteger operator%(const GMPInteger &lhs, long long rhs)
     {
@@ -413,9 +749,7 @@ namespace gridsynth
     }
     inline GMPInteger operator%(long long lhs, const GMPInteger &rhs)
     {
-        GMPInteger result(lhs);
-        mpz_tdiv_r(result.get_mpz_t(), result.get_mpz_t(), rhs.get_mpz_t());
-        return result;
+        return GMPInteger(lhs) % rhs;
     }
     inline GMPInteger operator<<(long long lhs, const GMPInteger &rhs)
     {
@@ -423,7 +757,7 @@ namespace gridsynth
         return temp << static_cast<int>(rhs); // potential narrowing
     }
 
-    // Comparison operators with long long
+    // Comparison operators with long long (GMPInteger(long long) is inline, so these do not allocate)
     inline bool operator==(const GMPInteger &lhs, long long rhs) { return lhs == GMPInteger(rhs); }
     inline bool operator!=(const GMPInteger &lhs, long long rhs) { return lhs != GMPInteger(rhs); }
     inline bool operator<(const GMPInteger &lhs, long long rhs) { return lhs < GMPInteger(rhs); }
@@ -11,7 +11,12 @@
 #include <sstream>
 #include <memory>
 #include <optional>
+#include <stdexcept>
+#include <cstdint>
+#include <atomic>
+#include <deque>
 #include "nwqec/core/constants.hpp"
+#include "nwqec/core/parallel.hpp"
 
 #include "nwqec/gridsynth/ring.hpp"
 #include "nwqec/gridsynth/grid_op.hpp"
@@ -41,7 +46,7 @@ namespace gridsynth
         DOmegaUnitary Uu = DOmegaUnitary::from_gates(gates);
         auto M = Uu.to_matrix(); // 2x2 DOmega
         const Float inv_scale = Float(1.0) / pow_sqrt2(Uu.k());
-        const Float sqrt2_over_2 = SQRT2 / Float(2.0);
+        const Float sqrt2_over_2 = sqrt2_value() / Float(2.0);
 
         // Extract U entries
         Float u00r, u00i, u01r, u01i, u10r, u10i, u11r, u11i;
@@ -68,48 +73,365 @@ namespace gridsynth
     }
 
     /**
-     * Main gridsynth algorithm - finds a DOmegaUnitary approximation
+     * Limits for a single synthesis run; a default-constructed budget is unlimited
+     */
+    struct SynthesisBudget
+    {
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+        int max_k = -1;                 // Largest denominator exponent to try (-1 = unlimited)
+        int max_diophantine_calls = -1; // Diophantine attempts allowed (-1 = unlimited)
+
+        static SynthesisBudget with_timeout_ms(int timeout_ms)
+        {
+            SynthesisBudget budget;
+            if (timeout_ms > 0)
+                budget.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+            return budget;
+        }
+    };
+
+    /**
+     * Outcome of a budgeted synthesis run, with where its time went
      *
+     * Filled on every path, so an angle that runs out of budget reports the
+     * same counters as one that succeeds.
+     */
+    struct SynthesisResult
+    {
+        bool success = false;
+        bool timed_out = false;    // Stopped by the wall-clock deadline
+        int k_reached = 0;         // Last denominator exponent tried (k_reached + 1 iterations)
+        int diophantine_calls = 0; // Diophantine equations attempted
+        double elapsed_ms = 0.0;
+        int precision_bits = 0;    // Working MPFR precision when the run ended
+        int boundary_rechecks = 0; // Candidates re-verified at higher precision
+        double to_upright_ms = 0.0;   // Grid operator search
+        double tdgp_ms = 0.0;         // TDGP solves over all k
+        double diophantine_ms = 0.0;  // Candidate checks and diophantine equations
+        int tdgp_candidates = 0;      // Points returned by TDGP over all k
+        int factoring_timeouts = 0;   // Factor searches that gave up
+        int diophantine_timeouts = 0; // Diophantine equations abandoned at their timeout
+        std::string gates;            // Gate sequence (valid only on success)
+    };
+
+    /**
+     * Working MPFR precision (bits) for a synthesis at tolerance epsilon
+     *
+     * Starts from 15 + 2.5 * ceil(log10(1/epsilon)) decimal digits, the rule used
+     * by the reference Python implementation, and adds k/2 bits for the growth of
+     * the ring coefficients at denominator exponent k. The result is rounded up to
+     * whole limbs, since MPFR cost scales per limb.
+     */
+    inline mpfr_prec_t working_precision(const Float &epsilon, long long k = 0)
+    {
+        if (!(epsilon > Float(0.0)))
+            return GMPFloat::get_default_precision();
+        long exp2 = 0;
+        double mant = mpfr_get_d_2exp(&exp2, epsilon.get_mpfr(), MPFR_RNDN);
+        double log10_inv = -(std::log10(mant) + static_cast<double>(exp2) * std::log10(2.0));
+        double digits = 15.0 + 2.5 * std::ceil(std::max(0.0, log10_inv) - 1e-9);
+        long long bits = static_cast<long long>(std::ceil(digits * std::log2(10.0))) + std::max(0LL, k) / 2;
+        long long limbs = (bits + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+        return static_cast<mpfr_prec_t>(limbs * GMP_NUMB_BITS);
+    }
+
+    /**
+     * Confirm that a TDGP candidate really lies in the epsilon region
+     *
+     * Candidates were accepted at the working precision. One whose margin is
+     * within rounding distance of either boundary is re-checked from its exact
+     * ring coordinates at twice the precision, against a region rebuilt from
+     * the caller's theta and epsilon.
+     */
+    inline bool confirm_candidate(const DOmega &z,
+                                  const EpsilonRegion &region, const UnitDisk &disk,
+                                  const Float &theta, const Float &epsilon,
+                                  SynthesisResult &stats)
+    {
+        auto inside = [&](const ConvexSet &set_z, const ConvexSet &set_conj, const Float *threshold)
+        {
+            const Float inv_scale = Float(1.0) / pow_sqrt2(z.k());
+            const Float sqrt2_over_2 = sqrt2_value() / Float(2.0);
+            Float zr, zi, zcr, zci;
+            z.coords_into_with(inv_scale, sqrt2_over_2, zr, zi);
+            z.conj_sq2().coords_into_with(inv_scale, sqrt2_over_2, zcr, zci);
+            const std::array<Float, 2> z_coords = {zr, zi};
+            const std::array<Float, 2> z_conj_coords = {zcr, zci};
+            if (threshold)
+                return set_z.margin(z_coords) > *threshold && set_conj.margin(z_conj_coords) > *threshold;
+            return set_z.inside(z_coords) && set_conj.inside(z_conj_coords);
+        };
+
+        // Rounding error in the coordinates grows like 2^(k/2) ulps
+        const mpfr_prec_t prec = GMPFloat::get_default_precision();
+        const long long k = static_cast<long long>(z.k());
+        Float threshold;
+        mpfr_set_ui_2exp(threshold.get_mpfr(), 1, static_cast<mpfr_exp_t>(std::max(0LL, k) / 2 + 16 - prec), MPFR_RNDN);
+        if (inside(region, disk, &threshold))
+            return true;
+
+        ++stats.boundary_rechecks;
+        ScopedPrecision high(2 * prec);
+        EpsilonRegion region_high(theta, epsilon);
+        UnitDisk disk_high;
+        return inside(region_high, disk_high, nullptr);
+    }
+
+    /**
+     * Angle-independent state reused across synthesis calls on one thread
+     *
+     * Holds the unit disk and a TDGP solver whose ODGP scratch registers and
+     * candidate buffers survive from one angle to the next. A context is not
+     * thread-safe; give each worker its own.
+     */
+    class SynthesisContext
+    {
+    public:
+        const UnitDisk &unit_disk() const { return unit_disk_; }
+
+        // Solver re-targeted at the given sets, allocated on first use
+        TdgpSolver &solver(const ConvexSet &setA, const ConvexSet &setB,
+                           const GridOp &opG_inv,
+                           const Rectangle &bboxA, const Rectangle &bboxB,
+                           const Interval &bboxA_y_fattened, const Interval &bboxB_y_fattened)
+        {
+            return retarget(solver_, setA, setB, opG_inv, bboxA, bboxB, bboxA_y_fattened, bboxB_y_fattened);
+        }
+
+        /**
+         * Solve the diophantine equations of each k concurrently
+         *
+         * Every candidate that passes the region check gets its own equation,
+         * seeded from its position in TDGP order, and the first one in that
+         * order with a solution is accepted. Later equations are abandoned once
+         * an earlier one succeeds. The result therefore does not depend on
+         * num_threads, but it can differ from the serial search, which draws
+         * all equations from one random stream.
+         *
+         * @param num_threads Workers per k (0 = hardware concurrency)
+         */
+        void race_diophantine(size_t num_threads)
+        {
+            racing_ = true;
+            race_threads_ = num_threads;
+        }
+
+        bool racing() const { return racing_; }
+        size_t race_threads() const { return race_threads_; }
+
+        /**
+         * Solve TDGP for the next levels values of k together with the current one
+         *
+         * When the current k has no candidates to try, the next levels are
+         * usually already solved on other cores. Levels are still consumed in
+         * order, so the result and its T-count are those of the serial search;
+         * a success at k discards the levels computed beyond it.
+         *
+         * @param levels Extra k values solved ahead (0 = off)
+         * @param num_threads Workers for one window of levels (0 = hardware concurrency)
+         */
+        void speculate_k(size_t levels, size_t num_threads = 0)
+        {
+            lookahead_levels_ = levels;
+            lookahead_threads_ = num_threads;
+        }
+
+        size_t lookahead_levels() const { return lookahead_levels_; }
+        size_t lookahead_threads() const { return lookahead_threads_; }
+
+        // Solver for look-ahead slot i, re-targeted like solver()
+        TdgpSolver &spare_solver(size_t i, const ConvexSet &setA, const ConvexSet &setB,
+                                 const GridOp &opG_inv,
+                                 const Rectangle &bboxA, const Rectangle &bboxB,
+                                 const Interval &bboxA_y_fattened, const Interval &bboxB_y_fattened)
+        {
+            if (spare_solvers_.size() <= i)
+                spare_solvers_.resize(i + 1);
+            return retarget(spare_solvers_[i], setA, setB, opG_inv, bboxA, bboxB, bboxA_y_fattened, bboxB_y_fattened);
+        }
+
+    private:
+        // A solver and the working precision it was built at
+        struct SolverSlot
+        {
+            std::optional<TdgpSolver> solver;
+            mpfr_prec_t precision = 0;
+        };
+
+        // Reuse the slot's solver at the precision it was built at. Float assignment
+        // keeps the destination's precision, so resetting a solver built for a looser
+        // epsilon would round the new bounding boxes and lose every candidate.
+        static TdgpSolver &retarget(SolverSlot &slot, const ConvexSet &setA, const ConvexSet &setB,
+                                    const GridOp &opG_inv,
+                                    const Rectangle &bboxA, const Rectangle &bboxB,
+                                    const Interval &bboxA_y_fattened, const Interval &bboxB_y_fattened)
+        {
+            const mpfr_prec_t precision = GMPFloat::get_default_precision();
+            if (slot.solver && slot.precision == precision)
+                slot.solver->reset(setA, setB, opG_inv, bboxA, bboxB, bboxA_y_fattened, bboxB_y_fattened);
+            else
+                slot.solver.emplace(setA, setB, opG_inv, bboxA, bboxB, bboxA_y_fattened, bboxB_y_fattened);
+            slot.precision = precision;
+            return *slot.solver;
+        }
+
+        UnitDisk unit_disk_; // Exact at every precision (coefficients are 0 and 1)
+        SolverSlot solver_;
+        std::deque<SolverSlot> spare_solvers_; // Growing keeps earlier slots in place
+        bool racing_ = false;
+        size_t race_threads_ = 0;
+        size_t lookahead_levels_ = 0;
+        size_t lookahead_threads_ = 0;
+    };
+
+    /**
+     * Outcome of racing the diophantine equations of one k
+     */
+    struct DiophantineRace
+    {
+        size_t winner = 0;       // Index of the accepted candidate (== count if none succeeded)
+        std::optional<DOmega> w; // Its solution
+        int calls = 0;           // Equations a serial walk would have tried up to the winner
+    };
+
+    /**
+     * Solve xi = 1 - z*z for the first count candidates concurrently
+     *
+     * Candidate i is seeded from one value drawn from the caller's RNG and
+     * from i, so each outcome depends only on its own equation and timeouts.
+     * Timeouts of equations after the winner are not added to the caller's
+     * diophantine counters.
+     */
+    inline DiophantineRace race_diophantine(const std::vector<DOmega> &candidates, size_t count,
+                                            int diophantine_timeout_ms, int factoring_timeout_ms,
+                                            size_t num_threads)
+    {
+        const std::uint64_t base_seed = global_rng()();
+        const std::mt19937_64 saved_rng = global_rng(); // The calling thread also solves equations
+        const mpfr_prec_t prec = GMPFloat::get_default_precision();
+
+        std::atomic<size_t> first_success{count};
+        std::vector<std::optional<DOmega>> solutions(count);
+        std::vector<DiophantineCounters> counters(count);
+
+        // Restores the worker's cancel hook even if the equation throws
+        struct CancelScope
+        {
+            DiophantineCancel saved = diophantine_cancel();
+            CancelScope(const std::atomic<size_t> &first, size_t i) { diophantine_cancel() = {&first, i}; }
+            ~CancelScope() { diophantine_cancel() = saved; }
+        };
+
+        const size_t workers = mpfr_buildopt_tls_p() ? num_threads : 1;
+        NWQEC::parallel_for(count, workers, [&](size_t i)
+                            {
+            if (first_success.load(std::memory_order_relaxed) < i)
+                return;
+            ScopedPrecision precision(prec);
+            const DiophantineCounters before = diophantine_counters();
+            {
+                CancelScope cancel(first_success, i);
+                seed_rng(base_seed ^ (0x9E3779B97F4A7C15ULL * (i + 1)));
+                DRootTwo xi = DRootTwo(1) - DRootTwo::fromDOmega(candidates[i].conj() * candidates[i]);
+                solutions[i] = diophantine_dyadic(xi, diophantine_timeout_ms, factoring_timeout_ms);
+            }
+            counters[i].factoring_timeouts = diophantine_counters().factoring_timeouts - before.factoring_timeouts;
+            counters[i].diophantine_timeouts = diophantine_counters().diophantine_timeouts - before.diophantine_timeouts;
+            if (solutions[i])
+            {
+                size_t current = first_success.load(std::memory_order_relaxed);
+                while (i < current && !first_success.compare_exchange_weak(current, i))
+                {
+                }
+            } });
+        global_rng() = saved_rng;
+
+        DiophantineRace race;
+        race.winner = first_success.load();
+        race.calls = static_cast<int>(std::min(race.winner + 1, count));
+        DiophantineCounters &total = diophantine_counters();
+        for (size_t i = 0; i < count && i <= race.winner; ++i)
+        {
+            total.factoring_timeouts += counters[i].factoring_timeouts;
+            total.diophantine_timeouts += counters[i].diophantine_timeouts;
+        }
+        if (race.winner < count)
+            race.w = std::move(solutions[race.winner]);
+        return race;
+    }
+
+    /**
+     * Budgeted gridsynth - finds a DOmegaUnitary approximation or gives up
+     *
+     * Stops when the deadline passes, when k would exceed max_k, or when the
+     * diophantine call limit is used up. The diophantine timeout is clipped to
+     * the time left before the deadline.
+     *
+     * @param context Reusable per-thread solver state
      * @param theta Target rotation angle
      * @param epsilon Error tolerance
+     * @param budget Wall-clock and iteration limits
+     * @param stats Filled with per-stage times and counters (gates are not set)
      * @param diophantine_timeout_ms Timeout for diophantine solving in milliseconds
      * @param factoring_timeout_ms Timeout for factoring in milliseconds
      * @param verbose Enable verbose output
-     * @param measure_time Enable timing measurements
-     * @return DOmegaUnitary approximation
+     * @param measure_time Print the per-stage times when the run ends
+     * @return DOmegaUnitary approximation, or std::nullopt if the budget ran out
      */
-    inline DOmegaUnitary gridsynth(
+    inline std::optional<DOmegaUnitary> gridsynth_budgeted(
+        SynthesisContext &context,
         Float theta,
         Float epsilon,
+        const SynthesisBudget &budget,
+        SynthesisResult &stats,
         int diophantine_timeout_ms = NWQEC::DEFAULT_DIOPHANTINE_TIMEOUT_MS,
         int factoring_timeout_ms = NWQEC::DEFAULT_FACTORING_TIMEOUT_MS,
         bool verbose = false,
         bool measure_time = false)
     {
+        using Clock = std::chrono::steady_clock;
+        const auto run_start = Clock::now();
+        const DiophantineCounters counters_before = diophantine_counters();
+        auto ms_since = [](Clock::time_point start)
+        {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        };
+        auto finish = [&](bool success, bool timed_out)
+        {
+            stats.success = success;
+            stats.timed_out = timed_out;
+            stats.elapsed_ms = ms_since(run_start);
+            stats.factoring_timeouts = diophantine_counters().factoring_timeouts - counters_before.factoring_timeouts;
+            stats.diophantine_timeouts = diophantine_counters().diophantine_timeouts - counters_before.diophantine_timeouts;
+            if (measure_time)
+            {
+                std::cout << "time of to_upright: " << stats.to_upright_ms << " ms" << std::endl;
+                std::cout << "time of solve_TDGP(" << stats.tdgp_candidates << " candidates): " << stats.tdgp_ms << " ms" << std::endl;
+                std::cout << "time of diophantine(" << stats.diophantine_calls << "): " << stats.diophantine_ms << " ms" << std::endl;
+            }
+        };
+        // Milliseconds left before the deadline (<= 0 once it has passed)
+        auto remaining_ms = [&]() -> long long
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(budget.deadline - Clock::now()).count();
+        };
+        stats = SynthesisResult{};
 
-        double time_of_solve_TDGP = 0.0;
-        double time_of_diophantine_dyadic = 0.0;
-        double time_of_to_upright = 0.0;
+        // Work at the precision epsilon calls for; restored when the call returns
+        ScopedPrecision working(working_precision(epsilon));
 
         // Create proper EpsilonRegion and UnitDisk objects
         EpsilonRegion epsilon_region(theta, epsilon);
-        UnitDisk unit_disk;
+        const UnitDisk &unit_disk = context.unit_disk();
 
         // Transform to upright position
-        auto start = std::chrono::high_resolution_clock::now();
+        auto start = Clock::now();
 
         ToUpright transformer(epsilon_region.ellipse(), unit_disk.ellipse());
         transformer.run(verbose);
         auto transformed = transformer.get_result();
 
-        // exit(0); // (was present previously; keeping commented out for safety)
-
-        if (measure_time)
-        {
-            auto end = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-            time_of_to_upright += duration.count() / 1000.0;
-        }
+        stats.to_upright_ms = ms_since(start);
 
         if (verbose)
         {
@@ -122,103 +444,260 @@ namespace gridsynth
         Interval bboxB_y_fattened = transformed.bboxB.I_y().fatten(transformed.bboxB.I_y().width() * epsilon_factor);
         GridOp opG_inv = transformed.opG.inv();
 
-        int num_diophantine_calls = 0;
+        int &num_diophantine_calls = stats.diophantine_calls;
 
-        TdgpSolver gp_solver(epsilon_region,
-                             unit_disk,
-                             opG_inv,
-                             transformed.bboxA, transformed.bboxB,
-                             bboxA_y_fattened, bboxB_y_fattened);
+        TdgpSolver &gp_solver = context.solver(epsilon_region,
+                                               unit_disk,
+                                               opG_inv,
+                                               transformed.bboxA, transformed.bboxB,
+                                               bboxA_y_fattened, bboxB_y_fattened);
         Integer k = 0;
 
-        while (true) // Use infinite loop like Python version
+        // Look-ahead window: TDGP solutions of ahead_k, ahead_k + 1, ... solved together
+        const size_t lookahead_workers = mpfr_buildopt_tls_p() ? NWQEC::resolve_num_threads(context.lookahead_threads()) : 1;
+        const size_t window = std::min(context.lookahead_levels() + 1, lookahead_workers);
+        std::vector<TdgpSolver *> window_solvers = {&gp_solver};
+        for (size_t j = 1; j < window; ++j)
+            window_solvers.push_back(&context.spare_solver(j - 1, epsilon_region, unit_disk, opG_inv,
+                                                           transformed.bboxA, transformed.bboxB,
+                                                           bboxA_y_fattened, bboxB_y_fattened));
+        std::vector<std::vector<DOmega>> ahead;
+        long long ahead_k = 0;
+        auto solve_tdgp = [&](long long level) -> std::vector<DOmega>
         {
-            // Solve TDGP
-            if (measure_time)
+            if (window <= 1)
+                return gp_solver.solve(level, verbose);
+            if (level < ahead_k || level >= ahead_k + static_cast<long long>(ahead.size()))
             {
-                start = std::chrono::high_resolution_clock::now();
+                size_t levels = window;
+                if (budget.max_k >= 0)
+                    levels = std::min<size_t>(levels, static_cast<size_t>(budget.max_k - level + 1));
+                // Each level at the precision the serial loop would have reached by then
+                std::vector<mpfr_prec_t> precisions(levels);
+                mpfr_prec_t prec = GMPFloat::get_default_precision();
+                for (size_t j = 0; j < levels; ++j)
+                    precisions[j] = prec = std::max(prec, working_precision(epsilon, level + static_cast<long long>(j)));
+                ahead.assign(levels, {});
+                ahead_k = level;
+                NWQEC::parallel_for(levels, levels, [&](size_t j)
+                                    {
+                    ScopedPrecision precision(precisions[j]);
+                    ahead[j] = window_solvers[j]->solve(level + static_cast<long long>(j)); });
             }
+            std::vector<DOmega> sol = std::move(ahead[static_cast<size_t>(level - ahead_k)]);
+            if (verbose)
+                std::cout << "k=" << level << " size of sol: " << sol.size() << " (look-ahead)\n";
+            return sol;
+        };
+
+        // Unitary with first column (z, w) at the smaller common denominator exponent
+        auto make_unitary = [&](const DOmega &z, const DOmega &w)
+        {
+            DOmega z_reduced = z.reduce_denomexp();
+            DOmega w_reduced = w.reduce_denomexp();
 
-            auto sol = gp_solver.solve(k, verbose);
+            // Align denominator exponents
+            if (z_reduced.k() > w_reduced.k())
+            {
+                w_reduced = w_reduced.renew_denomexp(z_reduced.k());
+            }
+            else if (z_reduced.k() < w_reduced.k())
+            {
+                z_reduced = z_reduced.renew_denomexp(w_reduced.k());
+            }
 
-            if (measure_time)
+            DOmegaUnitary u_approx(DOmega::from_int(0), DOmega::from_int(0), 0); // Initialize with dummy values
+            if ((z_reduced + w_reduced).reduce_denomexp().k() < z_reduced.k())
             {
-                auto end = std::chrono::high_resolution_clock::now();
-                auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-                time_of_solve_TDGP += duration.count() / 1000.0;
-                start = std::chrono::high_resolution_clock::now();
+                u_approx = DOmegaUnitary(z_reduced, w_reduced, 0);
+            }
+            else
+            {
+                u_approx = DOmegaUnitary(z_reduced, w_reduced.mul_by_omega(), 0);
             }
 
-            // Try each solution from TDGP
-            for (const DOmega &z : sol)
+            if (verbose)
             {
-                if ((z * z.conj()).residue() == 0)
+                std::cout << "z=" << z_reduced.to_string()
+                          << ", w=" << w_reduced.to_string() << std::endl;
+                std::cout << "------------------" << std::endl;
+            }
+            return u_approx;
+        };
+
+        while (true) // Use infinite loop like Python version
+        {
+            if (budget.max_k >= 0 && k > budget.max_k)
+            {
+                finish(false, false);
+                return std::nullopt;
+            }
+            if (remaining_ms() <= 0)
+            {
+                finish(false, true);
+                return std::nullopt;
+            }
+            stats.k_reached = static_cast<int>(static_cast<long long>(k));
+            const mpfr_prec_t needed = working_precision(epsilon, static_cast<long long>(k));
+            if (needed > GMPFloat::get_default_precision())
+                GMPFloat::set_default_precision(needed);
+            stats.precision_bits = static_cast<int>(GMPFloat::get_default_precision());
+
+            // Solve TDGP
+            start = Clock::now();
+            auto sol = solve_tdgp(static_cast<long long>(k));
+            stats.tdgp_ms += ms_since(start);
+            stats.tdgp_candidates += static_cast<int>(sol.size());
+
+            // Everything until the next k is candidate checking and diophantine solving
+            start = Clock::now();
+            auto end_candidates = [&]
+            { stats.diophantine_ms += ms_since(start); };
+
+            if (context.racing())
+            {
+                std::vector<DOmega> confirmed;
+                for (const DOmega &z : sol)
                 {
-                    continue;
+                    if ((z * z.conj()).residue() != 0 && confirm_candidate(z, epsilon_region, unit_disk, theta, epsilon, stats))
+                        confirmed.push_back(z);
                 }
 
-                DRootTwo xi = DRootTwo(1) - DRootTwo::fromDOmega(z.conj() * z);
-                std::optional<DOmega> w_opt = diophantine_dyadic(xi, diophantine_timeout_ms, factoring_timeout_ms);
-                num_diophantine_calls++;
-                if (w_opt.has_value())
+                // Never start more equations than the call limit leaves
+                size_t count = confirmed.size();
+                bool limited = false;
+                if (budget.max_diophantine_calls >= 0)
                 {
-
-                    DOmega z_reduced = z.reduce_denomexp();
-                    DOmega w_reduced = w_opt->reduce_denomexp();
-
-                    // Align denominator exponents
-                    if (z_reduced.k() > w_reduced.k())
-                    {
-                        w_reduced = w_reduced.renew_denomexp(z_reduced.k());
-                    }
-                    else if (z_reduced.k() < w_reduced.k())
+                    const size_t left = static_cast<size_t>(std::max(0, budget.max_diophantine_calls - num_diophantine_calls));
+                    if (left < count)
                     {
-                        z_reduced = z_reduced.renew_denomexp(w_reduced.k());
+                        count = left;
+                        limited = true;
                     }
-
-                    DOmegaUnitary u_approx(DOmega::from_int(0), DOmega::from_int(0), 0); // Initialize with dummy values
-                    if ((z_reduced + w_reduced).reduce_denomexp().k() < z_reduced.k())
+                }
+                if (count > 0)
+                {
+                    long long left_ms = remaining_ms();
+                    if (left_ms <= 0)
                     {
-                        u_approx = DOmegaUnitary(z_reduced, w_reduced, 0);
+                        end_candidates();
+                        finish(false, true);
+                        return std::nullopt;
                     }
-                    else
+                    int call_timeout_ms = static_cast<int>(std::min<long long>(diophantine_timeout_ms, left_ms));
+                    DiophantineRace race = race_diophantine(confirmed, count, call_timeout_ms, factoring_timeout_ms,
+                                                            context.race_threads());
+                    num_diophantine_calls += race.calls;
+                    if (race.w)
                     {
-                        u_approx = DOmegaUnitary(z_reduced, w_reduced.mul_by_omega(), 0);
+                        DOmegaUnitary u_approx = make_unitary(confirmed[race.winner], *race.w);
+                        end_candidates();
+                        finish(true, false);
+                        return u_approx;
                     }
+                }
+                if (limited)
+                {
+                    end_candidates();
+                    finish(false, false);
+                    return std::nullopt;
+                }
+                end_candidates();
+                k++;
+                continue;
+            }
 
-                    if (measure_time)
-                    {
-                        auto end = std::chrono::high_resolution_clock::now();
-                        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-                        time_of_diophantine_dyadic += duration.count() / 1000.0;
-
-                        std::cout << "time of to_upright: " << time_of_to_upright << " ms" << std::endl;
-                        std::cout << "time of solve_TDGP: " << time_of_solve_TDGP << " ms" << std::endl;
-                        std::cout << "time of diophantine(" << num_diophantine_calls << "): " << time_of_diophantine_dyadic << " ms" << std::endl;
-                    }
+            // Try each solution from TDGP
+            for (const DOmega &z : sol)
+            {
+                if ((z * z.conj()).residue() == 0)
+                {
+                    continue;
+                }
+                if (!confirm_candidate(z, epsilon_region, unit_disk, theta, epsilon, stats))
+                {
+                    continue;
+                }
 
-                    if (verbose)
-                    {
-                        std::cout << "z=" << z_reduced.to_string()
-                                  << ", w=" << w_reduced.to_string() << std::endl;
-                        std::cout << "------------------" << std::endl;
-                    }
+                if (budget.max_diophantine_calls >= 0 && num_diophantine_calls >= budget.max_diophantine_calls)
+                {
+                    end_candidates();
+                    finish(false, false);
+                    return std::nullopt;
+                }
+                long long left_ms = remaining_ms();
+                if (left_ms <= 0)
+                {
+                    end_candidates();
+                    finish(false, true);
+                    return std::nullopt;
+                }
 
+                DRootTwo xi = DRootTwo(1) - DRootTwo::fromDOmega(z.conj() * z);
+                int call_timeout_ms = static_cast<int>(std::min<long long>(diophantine_timeout_ms, left_ms));
+                std::optional<DOmega> w_opt = diophantine_dyadic(xi, call_timeout_ms, factoring_timeout_ms);
+                num_diophantine_calls++;
+                if (w_opt.has_value())
+                {
+                    DOmegaUnitary u_approx = make_unitary(z, *w_opt);
+                    end_candidates();
+                    finish(true, false);
                     return u_approx;
                 }
             }
 
-            if (measure_time)
-            {
-                auto end = std::chrono::high_resolution_clock::now();
-                auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-                time_of_diophantine_dyadic += duration.count() / 1000.0;
-            }
-
+            end_candidates();
             k++;
         }
     }
 
+    /**
+     * Budgeted gridsynth with a one-off context
+     */
+    inline std::optional<DOmegaUnitary> gridsynth_budgeted(
+        Float theta,
+        Float epsilon,
+        const SynthesisBudget &budget,
+        SynthesisResult &stats,
+        int diophantine_timeout_ms = NWQEC::DEFAULT_DIOPHANTINE_TIMEOUT_MS,
+        int factoring_timeout_ms = NWQEC::DEFAULT_FACTORING_TIMEOUT_MS,
+        bool verbose = false,
+        bool measure_time = false)
+    {
+        SynthesisContext context;
+        return gridsynth_budgeted(context, theta, epsilon, budget, stats,
+                                  diophantine_timeout_ms, factoring_timeout_ms,
+                                  verbose, measure_time);
+    }
+
+    /**
+     * Main gridsynth algorithm - finds a DOmegaUnitary approximation
+     *
+     * @param theta Target rotation angle
+     * @param epsilon Error tolerance
+     * @param diophantine_timeout_ms Timeout for diophantine solving in milliseconds
+     * @param factoring_timeout_ms Timeout for factoring in milliseconds
+     * @param verbose Enable verbose output
+     * @param measure_time Enable timing measurements
+     * @return DOmegaUnitary approximation
+     */
+    inline DOmegaUnitary gridsynth(
+        Float theta,
+        Float epsilon,
+        int diophantine_timeout_ms = NWQEC::DEFAULT_DIOPHANTINE_TIMEOUT_MS,
+        int factoring_timeout_ms = NWQEC::DEFAULT_FACTORING_TIMEOUT_MS,
+        bool verbose = false,
+        bool measure_time = false)
+    {
+        SynthesisResult stats;
+        auto u_approx = gridsynth_budgeted(theta, epsilon, SynthesisBudget{}, stats,
+                                           diophantine_timeout_ms, factoring_timeout_ms,
+                                           verbose, measure_time);
+        if (!u_approx)
+            throw std::runtime_error("gridsynth: no solution found"); // Unreachable without a budget
+        return *u_approx;
+    }
+
     /**
      * Main gridsynth algorithm - returns gate sequence
      *
@@ -240,6 +719,8 @@ namespace gridsynth
     {
         auto start_total = std::chrono::high_resolution_clock::now();
 
+        // Parse at the boundary re-check precision so confirm_candidate sees full inputs
+        ScopedPrecision reference(2 * working_precision(Float(epsilon)));
         DOmegaUnitary u_approx = gridsynth(
             Float(theta), Float(epsilon),
             diophantine_timeout_ms, factoring_timeout_ms,
@@ -258,4 +739,136 @@ namespace gridsynth
         return gates_str;
     }
 
+    /**
+     * Budgeted gridsynth - returns a structured result instead of looping indefinitely
+     *
+     * @param theta Target rotation angle
+     * @param epsilon Error tolerance
+     * @param budget Wall-clock and iteration limits
+     * @param diophantine_timeout_ms Timeout for diophantine solving in milliseconds
+     * @param factoring_timeout_ms Timeout for factoring in milliseconds
+     * @return Result with the gate sequence on success, and k / call counts either way
+     */
+    inline SynthesisResult gridsynth_gates_budgeted(
+        SynthesisContext &context,
+        const std::string &theta,
+        const std::string &epsilon,
+        const SynthesisBudget &budget,
+        int diophantine_timeout_ms = NWQEC::DEFAULT_DIOPHANTINE_TIMEOUT_MS,
+        int factoring_timeout_ms = NWQEC::DEFAULT_FACTORING_TIMEOUT_MS)
+    {
+        SynthesisResult result;
+        ScopedPrecision reference(2 * working_precision(Float(epsilon)));
+        auto u_approx = gridsynth_budgeted(context, Float(theta), Float(epsilon), budget, result,
+                                           diophantine_timeout_ms, factoring_timeout_ms);
+        if (u_approx)
+            result.gates = decompose_domega_unitary(*u_approx);
+        return result;
+    }
+
+    inline SynthesisResult gridsynth_gates_budgeted(
+        const std::string &theta,
+        const std::string &epsilon,
+        const SynthesisBudget &budget,
+        int diophantine_timeout_ms = NWQEC::DEFAULT_DIOPHANTINE_TIMEOUT_MS,
+        int factoring_timeout_ms = NWQEC::DEFAULT_FACTORING_TIMEOUT_MS)
+    {
+        SynthesisContext context;
+        return gridsynth_gates_budgeted(context, theta, epsilon, budget,
+                                        diophantine_timeout_ms, factoring_timeout_ms);
+    }
+
+    /**
+     * FNV-1a hash of the synthesis inputs, used as a per-angle RNG seed
+     */
+    inline std::uint64_t synthesis_seed(const std::string &theta, const std::string &epsilon)
+    {
+        std::uint64_t h = 1469598103934665603ULL;
+        for (const std::string *part : {&theta, &epsilon})
+        {
+            for (unsigned char c : *part)
+            {
+                h ^= c;
+                h *= 1099511628211ULL;
+            }
+            h ^= 0xff; // separator
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    /**
+     * Options for gridsynth_batch
+     */
+    struct BatchOptions
+    {
+        SynthesisBudget budget;   // Shared limits; the deadline applies to the whole batch
+        int angle_timeout_ms = 0; // Extra deadline per angle, measured from its start (0 = none)
+        size_t num_threads = 1;   // Workers (0 = hardware concurrency)
+        int diophantine_timeout_ms = NWQEC::DEFAULT_DIOPHANTINE_TIMEOUT_MS;
+        int factoring_timeout_ms = NWQEC::DEFAULT_FACTORING_TIMEOUT_MS;
+        bool race_diophantine = false; // Race each angle's equations on the workers the angles leave idle
+        size_t speculate_k = 0;        // TDGP levels each angle solves ahead on those workers (0 = off)
+    };
+
+    /**
+     * Synthesize many angles, reusing solver state across them
+     *
+     * Each worker keeps one SynthesisContext for all the angles it takes. Every
+     * angle is seeded from its own inputs, so results do not depend on the
+     * worker count or on scheduling. With race_diophantine they match each
+     * other across worker counts but not the serial search. Returns one result
+     * per angle, in order.
+     *
+     * @param thetas Target rotation angles
+     * @param epsilons Error tolerance per angle (same length as thetas)
+     * @param options Limits, worker count and diophantine timeouts
+     */
+    inline std::vector<SynthesisResult> gridsynth_batch(
+        const std::vector<std::string> &thetas,
+        const std::vector<std::string> &epsilons,
+        const BatchOptions &options = {})
+    {
+        if (thetas.size() != epsilons.size())
+            throw std::invalid_argument("gridsynth_batch: thetas and epsilons differ in length");
+
+        std::vector<SynthesisResult> results(thetas.size());
+        // MPFR without thread-local caches is not safe to call concurrently
+        const size_t workers = mpfr_buildopt_tls_p() ? options.num_threads : 1;
+        // Fewer angles than workers: split the rest among the angles' races and look-ahead
+        const size_t angle_workers = std::max<size_t>(1, std::min(NWQEC::resolve_num_threads(workers), thetas.size()));
+        const size_t race_threads = std::max<size_t>(1, NWQEC::resolve_num_threads(workers) / angle_workers);
+        NWQEC::parallel_for_with_state(
+            thetas.size(), workers, [&]
+            {
+                SynthesisContext context;
+                if (options.race_diophantine)
+                    context.race_diophantine(race_threads);
+                if (options.speculate_k > 0)
+                    context.speculate_k(options.speculate_k, race_threads);
+                return context; },
+            [&](SynthesisContext &context, size_t i)
+            {
+                SynthesisBudget budget = options.budget;
+                if (options.angle_timeout_ms > 0)
+                    budget.deadline = std::min(budget.deadline,
+                                               std::chrono::steady_clock::now() + std::chrono::milliseconds(options.angle_timeout_ms));
+                seed_rng(synthesis_seed(thetas[i], epsilons[i]));
+                results[i] = gridsynth_gates_budgeted(context, thetas[i], epsilons[i], budget,
+                                                      options.diophantine_timeout_ms, options.factoring_timeout_ms);
+            });
+        return results;
+    }
+
+    /**
+     * Synthesize many angles at one shared tolerance
+     */
+    inline std::vector<SynthesisResult> gridsynth_batch(
+        const std::vector<std::string> &thetas,
+        const std::string &epsilon,
+        const BatchOptions &options = {})
+    {
+        return gridsynth_batch(thetas, std::vector<std::string>(thetas.size(), epsilon), options);
+    }
+
 } // namespace gridsynth
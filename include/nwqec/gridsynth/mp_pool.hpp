@@ -0,0 +1,118 @@
+#pragma once
+#include <vector>
+#include <gmp.h>
+#include <mpfr.h>
+
+/**
+ * mp_pool.hpp
+ *
+ * Thread-local free lists of initialized mpz_t / mpfr_t values.
+ *
+ * Short-lived GMPInteger and GMPFloat temporaries take their storage from
+ * these pools and hand it back on destruction instead of going through
+ * mpz_init/mpfr_init2 and the matching clear. The limb buffers are kept, so
+ * in a steady state compound expressions evaluate without touching malloc.
+ * Each pool is capped; values released beyond the cap are cleared normally.
+ */
+
+namespace gridsynth
+{
+    namespace detail
+    {
+        template <typename Struct, void (*Clear)(Struct *)>
+        class MpFreeList
+        {
+        public:
+            static constexpr size_t kCapacity = 256;
+
+            MpFreeList() { items_.reserve(kCapacity); }
+
+            ~MpFreeList()
+            {
+                for (Struct &s : items_)
+                    Clear(&s);
+                alive() = false;
+            }
+
+            MpFreeList(const MpFreeList &) = delete;
+            MpFreeList &operator=(const MpFreeList &) = delete;
+
+            bool pop(Struct &out)
+            {
+                if (items_.empty())
+                    return false;
+                out = items_.back();
+                items_.pop_back();
+                return true;
+            }
+
+            bool push(const Struct &in)
+            {
+                if (items_.size() >= kCapacity)
+                    return false;
+                items_.push_back(in);
+                return true;
+            }
+
+            // Cleared once the pool is destroyed at thread exit; values released
+            // afterwards (other thread_local or static objects) are cleared directly
+            static bool &alive()
+            {
+                static thread_local bool flag = true;
+                return flag;
+            }
+
+            static MpFreeList *instance()
+            {
+                if (!alive())
+                    return nullptr;
+                static thread_local MpFreeList pool;
+                return &pool;
+            }
+
+        private:
+            std::vector<Struct> items_;
+        };
+
+        inline void clear_mpz_struct(__mpz_struct *z) { mpz_clear(z); }
+        inline void clear_mpfr_struct(__mpfr_struct *x) { mpfr_clear(x); }
+
+        using MpzFreeList = MpFreeList<__mpz_struct, clear_mpz_struct>;
+        using MpfrFreeList = MpFreeList<__mpfr_struct, clear_mpfr_struct>;
+    } // namespace detail
+
+    // Equivalent to mpz_init, reusing a released value when one is available
+    inline void pooled_mpz_init(mpz_t z)
+    {
+        detail::MpzFreeList *pool = detail::MpzFreeList::instance();
+        if (pool && pool->pop(z[0]))
+            mpz_set_ui(z, 0);
+        else
+            mpz_init(z);
+    }
+
+    inline void pooled_mpz_clear(mpz_t z)
+    {
+        detail::MpzFreeList *pool = detail::MpzFreeList::instance();
+        if (!pool || !pool->push(z[0]))
+            mpz_clear(z);
+    }
+
+    // Equivalent to mpfr_init2 (value is NaN), reusing a released value when one is available
+    inline void pooled_mpfr_init2(mpfr_t x, mpfr_prec_t prec)
+    {
+        detail::MpfrFreeList *pool = detail::MpfrFreeList::instance();
+        if (pool && pool->pop(x[0]))
+            mpfr_set_prec(x, prec); // Reallocates only when the limbs do not fit
+        else
+            mpfr_init2(x, prec);
+    }
+
+    inline void pooled_mpfr_clear(mpfr_t x)
+    {
+        detail::MpfrFreeList *pool = detail::MpfrFreeList::instance();
+        if (!pool || !pool->push(x[0]))
+            mpfr_clear(x);
+    }
+
+} // namespace gridsynth
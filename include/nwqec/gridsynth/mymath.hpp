@@ -12,9 +12,34 @@
 namespace gridsynth
 {
 
-    // High precision SQRT2 constant (100+ digits)
-    const Float SQRT2 = Float("1.4142135623730950488016887242096980785696718753769480731766797379907324784621070388503875343276415727");
-    const Float PI = Float("3.1415926535897932384626433832795028841971693993751058209749445923078164062862089986280348253421170679");
+    // √2 and π at the calling thread's working precision. Each thread keeps one
+    // cached copy and recomputes it only when the working precision changes.
+    inline const Float &sqrt2_value()
+    {
+        thread_local Float value;
+        thread_local mpfr_prec_t prec = 0;
+        if (prec != Float::get_default_precision())
+        {
+            prec = Float::get_default_precision();
+            mpfr_set_prec(value.get_mpfr(), prec);
+            mpfr_sqrt_ui(value.get_mpfr(), 2, MPFR_RNDN);
+        }
+        return value;
+    }
+
+    inline const Float &pi_value()
+    {
+        thread_local Float value;
+        thread_local mpfr_prec_t prec = 0;
+        if (prec != Float::get_default_precision())
+        {
+            prec = Float::get_default_precision();
+            mpfr_set_prec(value.get_mpfr(), prec);
+            mpfr_const_pi(value.get_mpfr(), MPFR_RNDN);
+        }
+        return value;
+    }
+
     // Number of trailing zeros in binary representation
     inline Integer ntz(Integer n) noexcept
     {
@@ -149,7 +174,7 @@ namespace gridsynth
         }
         if (odd != Integer(0))
         {
-            result = result * SQRT2; // multiply by √2 for odd k
+            result = result * sqrt2_value(); // multiply by √2 for odd k
         }
         return result;
     }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <vector>
 #include <cmath>
 #include <mpfr.h>
@@ -22,23 +23,8 @@ namespace gridsynth
         {
             if (scratch_init_)
             {
-                mpfr_clear(mp_a_);
-                mpfr_clear(mp_b_);
-                mpfr_clear(mp_tmp_);
-                mpfr_clear(mp_real_);
-                mpfr_clear(mp_conj_);
-                mpfr_clear(mp_tmp2_);
-                mpfr_clear(mp_q_);
-                mpfr_clear(mp_R0_);
-                mpfr_clear(mp_Rslope_);
-                mpfr_clear(mp_C0_);
-                mpfr_clear(mp_Cslope_);
-                mpfr_clear(mp_rs_step_);
-                mpfr_clear(mp_cs_step_);
-                mpfr_clear(mp_I_l_);
-                mpfr_clear(mp_I_r_);
-                mpfr_clear(mp_J_l_);
-                mpfr_clear(mp_J_r_);
+                for (mpfr_ptr v : scratch_vars())
+                    mpfr_clear(v);
             }
         }
 
@@ -56,7 +42,7 @@ namespace gridsynth
             static const Float TWO(2.0);
             static const Float FOUR(4.0);
             Integer a = floor_to_integer((I.l() + J.l()) / TWO);
-            Integer b = floor_to_integer(SQRT2 * (I.l() - J.l()) / FOUR);
+            Integer b = floor_to_integer(sqrt2_value() * (I.l() - J.l()) / FOUR);
             ZRootTwo alpha(a, b);
 
             Interval shifted_I = I - alpha.to_real();
@@ -86,8 +72,8 @@ namespace gridsynth
         {
             Integer p = beta.parity();
             static const Float TWO(2.0);
-            Interval scaled_I = (I + (-static_cast<Float>(p))) * (SQRT2 / TWO);
-            Interval scaled_J = (J + (-static_cast<Float>(p))) * (-SQRT2 / TWO);
+            Interval scaled_I = (I + (-static_cast<Float>(p))) * (sqrt2_value() / TWO);
+            Interval scaled_J = (J + (-static_cast<Float>(p))) * (-sqrt2_value() / TWO);
 
             tmp_z_.clear();
             auto base = solve(scaled_I, scaled_J);
@@ -146,30 +132,31 @@ namespace gridsynth
         }
 
     private:
+        // Allocate scratch at the working precision, re-sizing it when that changes
         void ensure_scratch()
         {
-            if (!scratch_init_)
+            const mpfr_prec_t prec = GMPFloat::get_default_precision();
+            if (scratch_init_ && scratch_prec_ == prec)
+                return;
+            for (mpfr_ptr v : scratch_vars())
             {
-                mpfr_init2(mp_a_, GMPFloat::get_default_precision());
-                mpfr_init2(mp_b_, GMPFloat::get_default_precision());
-                mpfr_init2(mp_tmp_, GMPFloat::get_default_precision());
-                mpfr_init2(mp_real_, GMPFloat::get_default_precision());
-                mpfr_init2(mp_conj_, GMPFloat::get_default_precision());
-                mpfr_init2(mp_tmp2_, GMPFloat::get_default_precision());
-                mpfr_init2(mp_q_, GMPFloat::get_default_precision());
-                mpfr_init2(mp_R0_, GMPFloat::get_default_precision());
-                mpfr_init2(mp_Rslope_, GMPFloat::get_default_precision());
-                mpfr_init2(mp_C0_, GMPFloat::get_default_precision());
-                mpfr_init2(mp_Cslope_, GMPFloat::get_default_precision());
-                mpfr_init2(mp_rs_step_, GMPFloat::get_default_precision());
-                mpfr_init2(mp_cs_step_, GMPFloat::get_default_precision());
-                mpfr_init2(mp_I_l_, GMPFloat::get_default_precision());
-                mpfr_init2(mp_I_r_, GMPFloat::get_default_precision());
-                mpfr_init2(mp_J_l_, GMPFloat::get_default_precision());
-                mpfr_init2(mp_J_r_, GMPFloat::get_default_precision());
-                scratch_init_ = true;
+                if (scratch_init_)
+                    mpfr_set_prec(v, prec);
+                else
+                    mpfr_init2(v, prec);
             }
+            scratch_init_ = true;
+            scratch_prec_ = prec;
+        }
+
+        std::array<mpfr_ptr, 17> scratch_vars()
+        {
+            return {mp_a_, mp_b_, mp_tmp_, mp_real_, mp_conj_,
+                    mp_tmp2_, mp_q_, mp_R0_, mp_Rslope_, mp_C0_, mp_Cslope_,
+                    mp_rs_step_, mp_cs_step_,
+                    mp_I_l_, mp_I_r_, mp_J_l_, mp_J_r_};
         }
+
         // Recursive internal solver. Appends solutions to tmp_z_ after applying
         // accumulated transform (conjugation flag and right-multiplication by M).
         void solve_internal(const Interval &I, const Interval &J, const ZRootTwo &M, bool conj_flag)
@@ -200,8 +187,8 @@ namespace gridsynth
 
                 for (Integer a = a_min; a <= a_max; ++a)
                 {
-                    Integer b_min = ceil_to_integer(SQRT2 * (a - J.r()) / TWO);
-                    Integer b_max = floor_to_integer(SQRT2 * (a - J.l()) / TWO);
+                    Integer b_min = ceil_to_integer(sqrt2_value() * (a - J.r()) / TWO);
+                    Integer b_max = floor_to_integer(sqrt2_value() * (a - J.l()) / TWO);
                     for (Integer b = b_min; b <= b_max; ++b)
                     {
                         ZRootTwo beta(a, b);
@@ -211,7 +198,7 @@ namespace gridsynth
                     }
                 }
             }
-            else
+            else if (n > 0)
             {
                 const auto &lp = get_lambda_powers(n);
                 const ZRootTwo &lambda_inv_n = lp.lambda_inv_n;
@@ -222,6 +209,18 @@ namespace gridsynth
                 ZRootTwo newM = M * lambda_inv_n;
                 solve_internal(scaled_I, scaled_J, newM, conj_flag);
             }
+            else
+            {
+                // J narrower than 1: scale by λ^n with n < 0 through the inverse powers
+                const auto &lp = get_lambda_powers(-n);
+                static const Float ONE(1.0);
+
+                Interval scaled_I = I * (ONE / lp.lambda_n_real);
+                Interval scaled_J = J * (ONE / lp.lambda_conj_n_real);
+
+                ZRootTwo newM = M * lp.lambda_n;
+                solve_internal(scaled_I, scaled_J, newM, conj_flag);
+            }
         }
 
         // Recursive internal solver that emits fully checked candidates directly into 'out'.
@@ -272,11 +271,11 @@ namespace gridsynth
                 const Integer two_Mb = Mb * Integer(2);
                 const Integer step = conj_flag ? Integer(-1) : Integer(1);
                 // Precompute slopes independent of 'a'
-                mpfr_set_z(mp_Rslope_, two_Mb.get_mpz_t(), MPFR_RNDN);
-                mpfr_mul_z(mp_tmp_, SQRT2.get_mpfr(), Ma.get_mpz_t(), MPFR_RNDN);
+                set_mpfr_integer(mp_Rslope_, two_Mb, MPFR_RNDN);
+                mul_mpfr_integer(mp_tmp_, sqrt2_value().get_mpfr(), Ma, MPFR_RNDN);
                 mpfr_add(mp_Rslope_, mp_Rslope_, mp_tmp_, MPFR_RNDN);
-                mpfr_set_z(mp_Cslope_, two_Mb.get_mpz_t(), MPFR_RNDN);
-                mpfr_mul_z(mp_tmp_, SQRT2.get_mpfr(), Ma.get_mpz_t(), MPFR_RNDN);
+                set_mpfr_integer(mp_Cslope_, two_Mb, MPFR_RNDN);
+                mul_mpfr_integer(mp_tmp_, sqrt2_value().get_mpfr(), Ma, MPFR_RNDN);
                 mpfr_sub(mp_Cslope_, mp_Cslope_, mp_tmp_, MPFR_RNDN);
                 if (step > 0)
                 {
@@ -291,8 +290,8 @@ namespace gridsynth
 
                 for (Integer a = a_min; a <= a_max; ++a)
                 {
-                    Integer b_min = ceil_to_integer(SQRT2 * (a - J.r()) / TWO);
-                    Integer b_max = floor_to_integer(SQRT2 * (a - J.l()) / TWO);
+                    Integer b_min = ceil_to_integer(sqrt2_value() * (a - J.r()) / TWO);
+                    Integer b_max = floor_to_integer(sqrt2_value() * (a - J.l()) / TWO);
                     if (b_max < b_min) continue;
 
                     const Integer base_a = a * Ma;
@@ -306,12 +305,12 @@ namespace gridsynth
                     GMPInteger BbB = base_b + Alpb;
 
                     // Build offsets
-                    mpfr_set_z(mp_R0_, BaA.get_mpz_t(), MPFR_RNDN);
-                    mpfr_mul_z(mp_tmp_, SQRT2.get_mpfr(), BbB.get_mpz_t(), MPFR_RNDN);
+                    set_mpfr_integer(mp_R0_, BaA, MPFR_RNDN);
+                    mul_mpfr_integer(mp_tmp_, sqrt2_value().get_mpfr(), BbB, MPFR_RNDN);
                     mpfr_add(mp_R0_, mp_R0_, mp_tmp_, MPFR_RNDN);
 
-                    mpfr_set_z(mp_C0_, BaA.get_mpz_t(), MPFR_RNDN);
-                    mpfr_mul_z(mp_tmp_, SQRT2.get_mpfr(), BbB.get_mpz_t(), MPFR_RNDN);
+                    set_mpfr_integer(mp_C0_, BaA, MPFR_RNDN);
+                    mul_mpfr_integer(mp_tmp_, sqrt2_value().get_mpfr(), BbB, MPFR_RNDN);
                     mpfr_sub(mp_C0_, mp_C0_, mp_tmp_, MPFR_RNDN);
 
                     // slopes already computed outside loop
@@ -330,12 +329,12 @@ namespace gridsynth
                         mpfr_sub(mp_q_, L, offset, MPFR_RNDN);
                         mpfr_div(mp_q_, mp_q_, slope, MPFR_RNDN);
                         GMPInteger ql;
-                        mpfr_get_z(ql.get_mpz_t(), mp_q_, MPFR_RNDU);
+                        get_mpfr_integer(ql, mp_q_, MPFR_RNDU);
 
                         mpfr_sub(mp_q_, R, offset, MPFR_RNDN);
                         mpfr_div(mp_q_, mp_q_, slope, MPFR_RNDN);
                         GMPInteger qh;
-                        mpfr_get_z(qh.get_mpz_t(), mp_q_, MPFR_RNDD);
+                        get_mpfr_integer(qh, mp_q_, MPFR_RNDD);
 
                         if (mpfr_sgn(slope) < 0) {
                             GMPInteger t = ql; ql = qh; qh = t;
@@ -369,23 +368,11 @@ namespace gridsynth
 
                     // Initialize exact MPFR linear forms at bb0
                     // real = R0 + bb*Rslope; conj = C0 + bb*Cslope
-                    mpfr_mul_z(mp_tmp_, mp_Rslope_, bb.get_mpz_t(), MPFR_RNDN);
+                    mul_mpfr_integer(mp_tmp_, mp_Rslope_, bb, MPFR_RNDN);
                     mpfr_add(mp_real_, mp_R0_, mp_tmp_, MPFR_RNDN);
-                    mpfr_mul_z(mp_tmp_, mp_Cslope_, bb.get_mpz_t(), MPFR_RNDN);
+                    mul_mpfr_integer(mp_tmp_, mp_Cslope_, bb, MPFR_RNDN);
                     mpfr_add(mp_conj_, mp_C0_, mp_tmp_, MPFR_RNDN);
 
-                    // Prepare per-step slope (handles conj via step sign)
-                    mpfr_t rs_step, cs_step;
-                    mpfr_init2(rs_step, GMPFloat::get_default_precision());
-                    mpfr_init2(cs_step, GMPFloat::get_default_precision());
-                    if (step > 0) {
-                        mpfr_set(rs_step, mp_Rslope_, MPFR_RNDN);
-                        mpfr_set(cs_step, mp_Cslope_, MPFR_RNDN);
-                    } else {
-                        mpfr_neg(rs_step, mp_Rslope_, MPFR_RNDN);
-                        mpfr_neg(cs_step, mp_Cslope_, MPFR_RNDN);
-                    }
-
                     for (; b <= b_max; ++b)
                     {
                         // candidate coefficients with alpha
@@ -403,15 +390,12 @@ namespace gridsynth
                         bb += step;
                         prod_a += two_Mb * step;
                         prod_b += Ma * step;
-                        mpfr_add(mp_real_, mp_real_, rs_step, MPFR_RNDN);
-                        mpfr_add(mp_conj_, mp_conj_, cs_step, MPFR_RNDN);
+                        mpfr_add(mp_real_, mp_real_, mp_rs_step_, MPFR_RNDN);
+                        mpfr_add(mp_conj_, mp_conj_, mp_cs_step_, MPFR_RNDN);
                     }
-
-                    mpfr_clear(rs_step);
-                    mpfr_clear(cs_step);
                 }
             }
-            else
+            else if (n > 0)
             {
                 const auto &lp = get_lambda_powers(n);
                 Interval scaled_I = I * lp.lambda_n_real;
@@ -419,6 +403,16 @@ namespace gridsynth
                 ZRootTwo newM = M * lp.lambda_inv_n;
                 solve_internal_emit(scaled_I, scaled_J, newM, conj_flag, alpha, orig_I, orig_J, out);
             }
+            else
+            {
+                // J narrower than 1: scale by λ^n with n < 0 through the inverse powers
+                const auto &lp = get_lambda_powers(-n);
+                static const Float ONE(1.0);
+                Interval scaled_I = I * (ONE / lp.lambda_n_real);
+                Interval scaled_J = J * (ONE / lp.lambda_conj_n_real);
+                ZRootTwo newM = M * lp.lambda_n;
+                solve_internal_emit(scaled_I, scaled_J, newM, conj_flag, alpha, orig_I, orig_J, out);
+            }
         }
 
         // Cache for powers of LAMBDA and its conjugates (and their real values)
@@ -434,8 +428,15 @@ namespace gridsynth
         const LambdaPowTriplet &get_lambda_powers(Integer n)
         {
             size_t idx = static_cast<size_t>(n);
-            // static thread-local cache shared across instances
+            // static thread-local cache shared across instances, rebuilt when the
+            // working precision changes so the real parts keep full accuracy
             static thread_local std::vector<LambdaPowTriplet> cache;
+            static thread_local mpfr_prec_t cache_prec = 0;
+            if (cache_prec != GMPFloat::get_default_precision())
+            {
+                cache.clear();
+                cache_prec = GMPFloat::get_default_precision();
+            }
             if (cache.empty())
             {
                 LambdaPowTriplet base{ZRootTwo::from_int(1), ZRootTwo::from_int(1), ZRootTwo::from_int(1), Float(1.0), Float(1.0)};
@@ -479,6 +480,7 @@ namespace gridsynth
 
         // mpfr scratch for tight loops
         bool scratch_init_ = false;
+        mpfr_prec_t scratch_prec_ = 0;
         mpfr_t mp_a_, mp_b_, mp_tmp_, mp_real_, mp_conj_;
         mpfr_t mp_tmp2_, mp_q_, mp_R0_, mp_Rslope_, mp_C0_, mp_Cslope_;
         mpfr_t mp_rs_step_, mp_cs_step_;
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "mymath.hpp"
+#include "types.hpp"
+
+// Number-theory results shared by the diophantine solvers of all threads
+
+namespace gridsynth
+{
+    // Factors below this bound are found by one gcd instead of Pollard-Brent
+    inline constexpr unsigned long SMALL_PRIME_LIMIT = 1UL << 12;
+
+    // Primes below SMALL_PRIME_LIMIT, by a sieve of Eratosthenes run once
+    inline const std::vector<unsigned long> &small_primes()
+    {
+        static const std::vector<unsigned long> primes = []
+        {
+            std::vector<bool> composite(SMALL_PRIME_LIMIT, false);
+            std::vector<unsigned long> out;
+            for (unsigned long i = 2; i < SMALL_PRIME_LIMIT; ++i)
+            {
+                if (composite[i])
+                    continue;
+                out.push_back(i);
+                for (unsigned long j = i * i; j < SMALL_PRIME_LIMIT; j += i)
+                    composite[j] = true;
+            }
+            return out;
+        }();
+        return primes;
+    }
+
+    inline const Integer &small_prime_product()
+    {
+        static const Integer product = []
+        {
+            Integer p = 1;
+            for (unsigned long prime : small_primes())
+                p *= Integer(static_cast<long long>(prime));
+            return p;
+        }();
+        return product;
+    }
+
+    // Smallest prime factor of n below SMALL_PRIME_LIMIT, if it has one
+    inline std::optional<Integer> small_prime_factor(const Integer &n)
+    {
+        const Integer g = gcd(n, small_prime_product());
+        if (g == 1 || g == 0)
+            return std::nullopt;
+        for (unsigned long prime : small_primes())
+        {
+            Integer p(static_cast<long long>(prime));
+            if (g % p == 0)
+                return p;
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * Thread-safe memo table split into independently locked shards
+     *
+     * Only for pure functions: a value computed twice by racing threads is
+     * the same, so whichever insert lands first is kept. Once a shard holds
+     * max_entries_per_shard values, new results are returned but not stored.
+     */
+    template <typename Key, typename Value>
+    class ShardedCache
+    {
+    public:
+        explicit ShardedCache(size_t max_entries_per_shard = 1 << 14)
+            : max_entries_per_shard_(max_entries_per_shard) {}
+
+        template <typename Compute>
+        Value get(const Key &key, size_t hash, Compute &&compute)
+        {
+            Shard &shard = shards_[hash % SHARDS];
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                auto it = shard.entries.find(key);
+                if (it != shard.entries.end())
+                {
+                    hits_.fetch_add(1, std::memory_order_relaxed);
+                    return it->second;
+                }
+            }
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            Value value = compute();
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (shard.entries.size() < max_entries_per_shard_)
+                shard.entries.emplace(key, value);
+            return value;
+        }
+
+        size_t hits() const { return hits_.load(std::memory_order_relaxed); }
+        size_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr size_t SHARDS = 16;
+
+        struct Shard
+        {
+            std::mutex mutex;
+            std::map<Key, Value> entries;
+        };
+
+        std::array<Shard, SHARDS> shards_;
+        size_t max_entries_per_shard_;
+        std::atomic<size_t> hits_{0};
+        std::atomic<size_t> misses_{0};
+    };
+
+    /**
+     * Primality and modular square roots, keyed by the prime candidate p
+     *
+     * The same p recurs across the candidates of one angle and across angles,
+     * so the results are kept for the whole process.
+     */
+    struct PrimeCache
+    {
+        ShardedCache<Integer, bool> primality;
+        ShardedCache<Integer, std::optional<Integer>> sqrt_negative_one;       // Some h with h^2 = -1 mod p
+        ShardedCache<std::pair<Integer, Integer>, std::optional<Integer>> root; // (x mod p, p) -> a root of x
+
+        // Shard selector: low bits of p above the parity bit, since p is odd
+        static size_t hash(const Integer &p)
+        {
+            return static_cast<size_t>(static_cast<long long>((p >> 1) & 0xffLL));
+        }
+    };
+
+    inline PrimeCache &prime_cache()
+    {
+        static PrimeCache cache;
+        return cache;
+    }
+
+} // namespace gridsynth
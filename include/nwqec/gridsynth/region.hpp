@@ -31,6 +31,10 @@ namespace gridsynth
 
         // Method for line intersection - returns parameter values where line intersects set boundary
         virtual std::optional<std::pair<Float, Float>> intersect(const std::array<Float, 2> &u0, const std::array<Float, 2> &v) const = 0;
+
+        // Signed distance-like slack of the membership test (>= 0 exactly when inside).
+        // Sets without a cheap margin report +/-1, so they are never treated as borderline.
+        virtual Float margin(const std::array<Float, 2> &v) const { return Float(inside(v) ? 1.0 : -1.0); }
     };
 
     class Interval
@@ -485,7 +489,7 @@ namespace gridsynth
 
         Float area() const
         {
-            return PI / sqrt_det();
+            return pi_value() / sqrt_det();
         }
 
         Float skew() const
@@ -641,6 +645,12 @@ namespace gridsynth
             return norm_squared <= Float(1.0) + tol;
         }
 
+        Float margin(const std::array<Float, 2> &u) const override
+        {
+            Float norm_squared = u[0] * u[0] + u[1] * u[1];
+            return Float(1.0) + Float(1e-30) - norm_squared;
+        }
+
         std::optional<std::pair<Float, Float>> intersect(const std::array<Float, 2> &u0, const std::array<Float, 2> &v) const override
         {
             // throw std::runtime_error("intersect");
@@ -168,7 +168,7 @@ namespace gridsynth
 
         Float to_real() const noexcept
         {
-            return Float(_a) + SQRT2 * Float(_b);
+            return Float(_a) + sqrt2_value() * Float(_b);
         }
 
         ZRootTwo conj_sq2() const
@@ -727,15 +727,15 @@ namespace gridsynth
 
         std::complex<Float> to_complex() const noexcept
         {
-            Float real_part = Float(_d) + SQRT2 * Float(_c - _a) / Float(2.0);
-            Float imag_part = Float(_b) + SQRT2 * Float(_c + _a) / Float(2.0);
+            Float real_part = Float(_d) + sqrt2_value() * Float(_c - _a) / Float(2.0);
+            Float imag_part = Float(_b) + sqrt2_value() * Float(_c + _a) / Float(2.0);
             return std::complex<Float>(real_part, imag_part);
         }
 
         inline void to_real_imag(Float &out_real, Float &out_imag) const noexcept
         {
-            out_real = Float(_d) + SQRT2 * Float(_c - _a) / Float(2.0);
-            out_imag = Float(_b) + SQRT2 * Float(_c + _a) / Float(2.0);
+            out_real = Float(_d) + sqrt2_value() * Float(_c - _a) / Float(2.0);
+            out_imag = Float(_b) + sqrt2_value() * Float(_c + _a) / Float(2.0);
         }
 
         ZOmega conj() const noexcept
@@ -1053,7 +1053,7 @@ namespace gridsynth
         inline Float real_part() const
         {
             // Real(u) = d + (c - a)/√2 then scaled by 1/scale()
-            const Float numerator = Float(_u.d()) + (Float(_u.c() - _u.a()) * SQRT2 / Float(2.0));
+            const Float numerator = Float(_u.d()) + (Float(_u.c() - _u.a()) * sqrt2_value() / Float(2.0));
             const Float inv_scale = Float(1.0) / scale();
             return numerator * inv_scale;
         }
@@ -1061,7 +1061,7 @@ namespace gridsynth
         inline Float imag_part() const
         {
             // Imag(u) = b + (c + a)/√2 then scaled by 1/scale()
-            const Float numerator = Float(_u.b()) + (Float(_u.c() + _u.a()) * SQRT2 / Float(2.0));
+            const Float numerator = Float(_u.b()) + (Float(_u.c() + _u.a()) * sqrt2_value() / Float(2.0));
             const Float inv_scale = Float(1.0) / scale();
             return numerator * inv_scale;
         }
@@ -1069,8 +1069,8 @@ namespace gridsynth
         inline std::array<Float, 2> coords() const
         {
             const Float inv_scale = Float(1.0) / scale();
-            const Float real_numer = Float(_u.d()) + (Float(_u.c() - _u.a()) * SQRT2 / Float(2.0));
-            const Float imag_numer = Float(_u.b()) + (Float(_u.c() + _u.a()) * SQRT2 / Float(2.0));
+            const Float real_numer = Float(_u.d()) + (Float(_u.c() - _u.a()) * sqrt2_value() / Float(2.0));
+            const Float imag_numer = Float(_u.b()) + (Float(_u.c() + _u.a()) * sqrt2_value() / Float(2.0));
             return {real_numer * inv_scale, imag_numer * inv_scale};
         }
 
@@ -1078,8 +1078,8 @@ namespace gridsynth
         inline void coords_into(Float &out_real, Float &out_imag) const noexcept
         {
             const Float inv_scale = Float(1.0) / scale();
-            const Float real_numer = Float(_u.d()) + (Float(_u.c() - _u.a()) * SQRT2 / Float(2.0));
-            const Float imag_numer = Float(_u.b()) + (Float(_u.c() + _u.a()) * SQRT2 / Float(2.0));
+            const Float real_numer = Float(_u.d()) + (Float(_u.c() - _u.a()) * sqrt2_value() / Float(2.0));
+            const Float imag_numer = Float(_u.b()) + (Float(_u.c() + _u.a()) * sqrt2_value() / Float(2.0));
             out_real = real_numer * inv_scale;
             out_imag = imag_numer * inv_scale;
         }
@@ -38,13 +38,33 @@ namespace gridsynth
         {
         }
 
+        // Re-target the solver at a new pair of sets, keeping the ODGP scratch
+        // state and the candidate buffers allocated by earlier solves.
+        void reset(const ConvexSet &setA,
+                   const ConvexSet &setB,
+                   const GridOp &opG_inv,
+                   const Rectangle &bboxA,
+                   const Rectangle &bboxB,
+                   const Interval &bboxA_y_fattened,
+                   const Interval &bboxB_y_fattened)
+        {
+            setA_ = setA.clone();
+            setB_ = setB.clone();
+            opG_inv_ = opG_inv;
+            bboxA_ = bboxA;
+            bboxB_ = bboxB;
+            bboxA_y_fattened_ = bboxA_y_fattened;
+            bboxB_y_fattened_ = bboxB_y_fattened;
+            step_k_ = -1;
+        }
+
         // Solve for a given scale k and return solutions.
         std::vector<DOmega> solve(Integer k, bool verbose = false)
         {
             // Precompute invariants for this k
             const Float inv_scale_k = Float(1.0) / pow_sqrt2(k);
             const Float inv_scale_kp1 = Float(1.0) / pow_sqrt2(k + 1);
-            const Float sqrt2_over_2 = SQRT2 / Float(2.0);
+            const Float sqrt2_over_2 = sqrt2_value() / Float(2.0);
 
             // x- and y-direction ODGP solves
             dr2_x_ = odgp_.solve_scaled(bboxA_.I_x(), bboxB_.I_x(), k + 1);
@@ -153,7 +173,7 @@ namespace gridsynth
         bool verify_solution(const DOmega &candidate) const
         {
             const Float inv_scale = Float(1.0) / pow_sqrt2(candidate.k());
-            const Float sqrt2_over_2 = SQRT2 / Float(2.0);
+            const Float sqrt2_over_2 = sqrt2_value() / Float(2.0);
             Float zr, zi;
             candidate.coords_into_with(inv_scale, sqrt2_over_2, zr, zi);
             const std::array<Float, 2> z_coords = {zr, zi};
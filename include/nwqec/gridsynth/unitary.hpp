@@ -76,7 +76,7 @@ namespace gridsynth
 
             // All entries share the same denominator exponent k
             const Float inv_scale = Float(1.0) / pow_sqrt2(_w.k());
-            const Float sqrt2_over_2 = SQRT2 / Float(2.0);
+            const Float sqrt2_over_2 = sqrt2_value() / Float(2.0);
 
             Float r00, i00, r01, i01, r10, i10, r11, i11;
             m00.coords_into_with(inv_scale, sqrt2_over_2, r00, i00);
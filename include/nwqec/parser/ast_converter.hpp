@@ -411,9 +411,7 @@ namespace NWQEC
         // Build a circuit from a parsed program
         Circuit build(const ASTProgram *program)
         {
-            circuit = Circuit(); // Reset circuit
-            gate_definitions.clear();
-            qubit_binding_stack.clear();
+            begin();
 
             // Process all statements in the program
             for (const auto &stmt : program->get_statements())
@@ -421,7 +419,51 @@ namespace NWQEC
                 process_stmt(stmt.get());
             }
 
-            return circuit;
+            return take_circuit();
+        }
+
+        // Start a new circuit; statements are then fed one by one to add_statement
+        void begin()
+        {
+            circuit = Circuit(); // Reset circuit
+            gate_definitions.clear();
+            qubit_binding_stack.clear();
+        }
+
+        // Append the operations of one top-level statement; stmt need not outlive the call
+        void add_statement(const Stmt *stmt)
+        {
+            process_stmt(stmt);
+        }
+
+        /**
+         * Converter for statements that follow the ones added so far
+         *
+         * The copy shares this converter's registers and gate definitions but
+         * starts with no operations, so slices of a flat circuit body can be
+         * converted independently and joined with Circuit::append_circuit.
+         */
+        ASTCircuitConverter fork() const
+        {
+            ASTCircuitConverter copy;
+            copy.circuit = circuit.layout_copy();
+            for (const auto &[name, def] : gate_definitions)
+            {
+                gate_defination &copy_def = copy.gate_definitions[name];
+                copy_def.params = def.params;
+                copy_def.qubits = def.qubits;
+                for (const auto &body_stmt : def.body)
+                {
+                    copy_def.body.push_back(std::unique_ptr<Stmt>(body_stmt->clone()));
+                }
+            }
+            return copy;
+        }
+
+        // The circuit built since begin()
+        Circuit take_circuit()
+        {
+            return std::move(circuit);
         }
     };
 
@@ -1,13 +1,21 @@
 #pragma once
 
 #include "token.hpp"
+#include "lexer.hpp"
 #include "ast.hpp"
 #include <vector>
+#include <iostream>
 #include <map>
 #include <string>
 #include <stdexcept>
 #include <unordered_map>
 #include <limits>
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <string_view>
+#include <system_error>
 
 namespace NWQEC
 {
@@ -20,14 +28,31 @@ namespace NWQEC
                                  ", column " + std::to_string(column) + ": " + message) {}
     };
 
+    /**
+     * Raised in flat-body mode when a token could change the parser state
+     * seen by later statements: a register, a gate definition or a block
+     */
+    class NonFlatInput : public std::runtime_error
+    {
+    public:
+        explicit NonFlatInput(const Token &token)
+            : std::runtime_error("Statement at line " + std::to_string(token.line) +
+                                 " is not allowed in a flat circuit body") {}
+    };
+
     /**
      * Parser class that converts tokens into an AST
      */
     class ASTGenerator
     {
     private:
-        std::vector<Token> tokens;
+        // Without a lexer this holds every token up to EOF. With one it is a
+        // window refilled on demand and trimmed after each statement.
+        mutable std::vector<Token> tokens;
         size_t current = 0;
+        Lexer *lexer = nullptr;
+        std::ostream *diagnostics = &std::cerr;
+        bool flat_body = false;
 
         // Maps for fast checking if a given identifier is a valid gate or not
         std::unordered_map<std::string, bool> predefined_gates = {
@@ -85,27 +110,79 @@ namespace NWQEC
         std::unordered_map<std::string, bool> user_defined_gates;
 
     public:
-        ASTGenerator(const std::vector<Token> &tokens) : tokens(tokens) {}
+        ASTGenerator(std::vector<Token> tokens) : tokens(std::move(tokens)) {}
+
+        /**
+         * Pull tokens from lexer as statements are parsed instead of taking them all up front
+         *
+         * Invalid tokens raise LexError from parse() or next_statement().
+         */
+        explicit ASTGenerator(Lexer &lexer) : lexer(&lexer) {}
+
+        // Where skipped statements are reported (std::cerr by default)
+        void set_diagnostics(std::ostream &os) { diagnostics = &os; }
+
+        /**
+         * Reject qreg, creg, gate and braces with NonFlatInput as they are scanned
+         *
+         * Used when a slice of a file is parsed on its own: with none of these
+         * the statements in the slice depend only on the header before it.
+         */
+        void set_flat_body(bool flat) { flat_body = flat; }
+
+        // Make gates declared in the header parsed by other known to this parser
+        void copy_gate_names(const ASTGenerator &other)
+        {
+            user_defined_gates = other.user_defined_gates;
+        }
+
+        // The token the next statement starts at; EOF_TOKEN at the end
+        const Token &lookahead() const
+        {
+            return peek();
+        }
 
         ASTProgram parse()
         {
             ASTProgram program;
 
+            while (std::unique_ptr<Stmt> stmt = next_statement())
+            {
+                program.add_statement(std::move(stmt));
+            }
+
+            return program;
+        }
+
+        /**
+         * Parse the next top-level statement
+         *
+         * Statements with parse errors are reported and skipped, as in parse().
+         *
+         * @return the statement, or nullptr once all tokens are consumed
+         */
+        std::unique_ptr<Stmt> next_statement()
+        {
             while (!is_at_end())
             {
+                if (lexer && current > 1)
+                {
+                    // Only previous() looks behind the current token
+                    tokens.erase(tokens.begin(), tokens.begin() + static_cast<std::ptrdiff_t>(current - 1));
+                    current = 1;
+                }
                 try
                 {
-                    program.add_statement(declaration());
+                    return declaration();
                 }
                 catch (const ParseError &e)
                 {
                     // Report error and synchronize
-                    std::cerr << e.what() << std::endl;
+                    *diagnostics << e.what() << std::endl;
                     synchronize();
                 }
             }
-
-            return program;
+            return nullptr;
         }
 
     private:
@@ -120,7 +197,25 @@ namespace NWQEC
 
         const Token &peek() const
         {
-            return tokens[current];
+            return token_at(current);
+        }
+
+        // Token i of the window, scanning more from the lexer if needed; EOF past the end
+        const Token &token_at(size_t i) const
+        {
+            while (lexer && i >= tokens.size() &&
+                   (tokens.empty() || tokens.back().type != TokenType::EOF_TOKEN))
+            {
+                Token token = lexer->next_token();
+                if (token.type == TokenType::INVALID)
+                    throw LexError(token);
+                if (flat_body && (token.type == TokenType::QREG || token.type == TokenType::CREG ||
+                                  token.type == TokenType::GATE || token.type == TokenType::LBRACE ||
+                                  token.type == TokenType::RBRACE))
+                    throw NonFlatInput(token);
+                tokens.push_back(token);
+            }
+            return i < tokens.size() ? tokens[i] : tokens.back();
         }
 
         const Token &previous() const
@@ -215,7 +310,7 @@ namespace NWQEC
         std::unique_ptr<Stmt> version_declaration()
         {
             Token version_token = consume(TokenType::REAL, "Expected version number after OPENQASM.");
-            std::string version = version_token.lexeme;
+            std::string version(version_token.lexeme);
             consume(TokenType::SEMICOLON, "Expected ';' after version number.");
 
             return std::make_unique<VersionDecl>(version);
@@ -224,32 +319,81 @@ namespace NWQEC
         std::unique_ptr<Stmt> include_statement()
         {
             Token filename_token = consume(TokenType::STRING, "Expected file name after include.");
-            std::string filename = filename_token.lexeme;
+            std::string filename(filename_token.lexeme);
             consume(TokenType::SEMICOLON, "Expected ';' after include statement.");
 
             return std::make_unique<IncludeStmt>(filename);
         }
 
+        // std::stoull/stoll/stod over a lexeme view, without copying it into a string
+        static unsigned long long parse_unsigned(std::string_view text)
+        {
+            unsigned long long value = 0;
+            auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (ec == std::errc::result_out_of_range)
+                throw std::out_of_range("parse_unsigned");
+            if (ec != std::errc() || end != text.data() + text.size())
+                throw std::invalid_argument("parse_unsigned");
+            return value;
+        }
+
+        static long long parse_signed(std::string_view text)
+        {
+            long long value = 0;
+            auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (ec == std::errc::result_out_of_range)
+                throw std::out_of_range("parse_signed");
+            if (ec != std::errc() || end != text.data() + text.size())
+                throw std::invalid_argument("parse_signed");
+            return value;
+        }
+
+        static double parse_real(std::string_view text)
+        {
+            // strtod needs a terminated string; lexemes of realistic length fit the stack buffer
+            char buffer[64];
+            std::string heap;
+            const char *str = buffer;
+            if (text.size() < sizeof(buffer))
+            {
+                std::copy(text.begin(), text.end(), buffer);
+                buffer[text.size()] = '\0';
+            }
+            else
+            {
+                heap.assign(text);
+                str = heap.c_str();
+            }
+            char *end = nullptr;
+            errno = 0;
+            double value = std::strtod(str, &end);
+            if (end == str)
+                throw std::invalid_argument("stod");
+            if (errno == ERANGE)
+                throw std::out_of_range("stod");
+            return value;
+        }
+
         size_t parse_register_size(const Token &size_token)
         {
             try
             {
-                unsigned long long raw = std::stoull(size_token.lexeme);
+                unsigned long long raw = parse_unsigned(size_token.lexeme);
                 if (raw > std::numeric_limits<size_t>::max())
                 {
-                    throw ParseError("Register size " + size_token.lexeme + " exceeds supported range.",
+                    throw ParseError("Register size " + std::string(size_token.lexeme) + " exceeds supported range.",
                                      size_token.line, size_token.column);
                 }
                 return static_cast<size_t>(raw);
             }
             catch (const std::invalid_argument &)
             {
-                throw ParseError("Invalid register size: " + size_token.lexeme + ".",
+                throw ParseError("Invalid register size: " + std::string(size_token.lexeme) + ".",
                                  size_token.line, size_token.column);
             }
             catch (const std::out_of_range &)
             {
-                throw ParseError("Register size " + size_token.lexeme + " is out of range.",
+                throw ParseError("Register size " + std::string(size_token.lexeme) + " is out of range.",
                                  size_token.line, size_token.column);
             }
         }
@@ -258,16 +402,16 @@ namespace NWQEC
         {
             try
             {
-                return std::stoll(token.lexeme);
+                return parse_signed(token.lexeme);
             }
             catch (const std::invalid_argument &)
             {
-                throw ParseError("Invalid integer literal: " + token.lexeme + ".",
+                throw ParseError("Invalid integer literal: " + std::string(token.lexeme) + ".",
                                  token.line, token.column);
             }
             catch (const std::out_of_range &)
             {
-                throw ParseError("Integer literal " + token.lexeme + " is out of range.",
+                throw ParseError("Integer literal " + std::string(token.lexeme) + " is out of range.",
                                  token.line, token.column);
             }
         }
@@ -275,7 +419,7 @@ namespace NWQEC
         std::unique_ptr<Stmt> qreg_declaration()
         {
             Token name_token = consume(TokenType::IDENTIFIER, "Expected register name after qreg.");
-            std::string name = name_token.lexeme;
+            std::string name(name_token.lexeme);
 
             consume(TokenType::LBRACKET, "Expected '[' after register name.");
             Token size_token = consume(TokenType::INTEGER, "Expected size after '['.");
@@ -289,7 +433,7 @@ namespace NWQEC
         std::unique_ptr<Stmt> creg_declaration()
         {
             Token name_token = consume(TokenType::IDENTIFIER, "Expected register name after creg.");
-            std::string name = name_token.lexeme;
+            std::string name(name_token.lexeme);
 
             consume(TokenType::LBRACKET, "Expected '[' after register name.");
             Token size_token = consume(TokenType::INTEGER, "Expected size after '['.");
@@ -304,7 +448,7 @@ namespace NWQEC
         {
             // Parse gate name
             Token name_token = consume(TokenType::IDENTIFIER, "Expected gate name.");
-            std::string name = name_token.lexeme;
+            std::string name(name_token.lexeme);
 
             // Register this gate name so we can use it later
             user_defined_gates[name] = true;
@@ -320,7 +464,7 @@ namespace NWQEC
                     do
                     {
                         Token param_token = consume(TokenType::IDENTIFIER, "Expected parameter name.");
-                        params.push_back(param_token.lexeme);
+                        params.emplace_back(param_token.lexeme);
                     } while (match({TokenType::COMMA}));
                 }
                 consume(TokenType::RPAREN, "Expected ')' after parameters.");
@@ -332,7 +476,7 @@ namespace NWQEC
                 do
                 {
                     Token qubit_token = consume(TokenType::IDENTIFIER, "Expected qubit name.");
-                    qubits.push_back(qubit_token.lexeme);
+                    qubits.emplace_back(qubit_token.lexeme);
                 } while (match({TokenType::COMMA}));
             }
 
@@ -364,7 +508,7 @@ namespace NWQEC
             if (match({TokenType::IDENTIFIER}))
             {
                 // This is a gate application inside a gate definition
-                std::string gate_name = previous().lexeme;
+                std::string gate_name(previous().lexeme);
 
                 // Parse parameters if any
                 std::vector<std::unique_ptr<Expr>> params;
@@ -383,15 +527,15 @@ namespace NWQEC
 
                 // Parse qubits
                 std::vector<std::unique_ptr<Expr>> qubits;
-                qubits.push_back(std::make_unique<VariableExpr>(consume(
+                qubits.push_back(std::make_unique<VariableExpr>(std::string(consume(
                                                                     TokenType::IDENTIFIER, "Expected qubit argument.")
-                                                                    .lexeme));
+                                                                    .lexeme)));
 
                 while (match({TokenType::COMMA}))
                 {
-                    qubits.push_back(std::make_unique<VariableExpr>(consume(
+                    qubits.push_back(std::make_unique<VariableExpr>(std::string(consume(
                                                                         TokenType::IDENTIFIER, "Expected qubit argument.")
-                                                                        .lexeme));
+                                                                        .lexeme)));
                 }
 
                 consume(TokenType::SEMICOLON, "Expected ';' after gate operation.");
@@ -462,7 +606,7 @@ namespace NWQEC
 
             std::unique_ptr<Stmt> then_branch = statement();
 
-            return std::make_unique<IfStmt>(creg_token.lexeme, parse_integer_literal(value_token), std::move(then_branch));
+            return std::make_unique<IfStmt>(std::string(creg_token.lexeme), parse_integer_literal(value_token), std::move(then_branch));
         }
 
         std::unique_ptr<Stmt> block_statement()
@@ -482,7 +626,7 @@ namespace NWQEC
         std::unique_ptr<Stmt> gate_statement()
         {
             Token name_token = consume(TokenType::IDENTIFIER, "Expected gate name.");
-            std::string name = name_token.lexeme;
+            std::string name(name_token.lexeme);
 
             // Check if this is a valid gate
             bool is_valid_gate = predefined_gates.find(name) != predefined_gates.end() ||
@@ -643,7 +787,7 @@ namespace NWQEC
 
             if (match({TokenType::REAL}))
             {
-                double value = std::stod(previous().lexeme);
+                double value = parse_real(previous().lexeme);
                 return std::make_unique<NumberExpr>(value, false);
             }
 
@@ -661,7 +805,7 @@ namespace NWQEC
 
             if (match({TokenType::IDENTIFIER}))
             {
-                std::string name = previous().lexeme;
+                std::string name(previous().lexeme);
 
                 // Check if it's a register index
                 if (match({TokenType::LBRACKET}))
@@ -681,9 +825,7 @@ namespace NWQEC
         // Helper to peek one token ahead
         const Token &peekNext() const
         {
-            if (current + 1 >= tokens.size())
-                return tokens.back();
-            return tokens[current + 1];
+            return token_at(current + 1);
         }
     };
 
@@ -0,0 +1,501 @@
+#pragma once
+
+#include "nwqec/core/circuit.hpp"
+#include "nwqec/parser/mapped_file.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace NWQEC
+{
+
+    /**
+     * Compact binary encoding of a flattened Circuit
+     *
+     * Meant for handing circuits between pipeline stages: writing and reading
+     * it skips printing and re-parsing gate names, angles and Pauli strings.
+     * All integers are little-endian; "varint" is LEB128 (7 bits per byte,
+     * high bit set on all but the last byte).
+     *
+     *   header     "NWQC", u8 version, 3 reserved bytes (zero),
+     *              u64 num_qubits, u64 num_bits, u64 num_operations
+     *   operation  u8 type (Operation::Type), u8 flags, varint qubit count,
+     *              varint qubits (count 0 for Pauli operations on exactly
+     *              the Pauli string's support, which Operation rebuilds)
+     *              [flags & PARAMS] varint count, IEEE-754 doubles as u64
+     *              [flags & BITS]   varint count, varint bits
+     *              [flags & PAULI]  varint Pauli qubit count, u8 Pauli flags,
+     *                               X words then Z words as u64
+     *
+     * Like the QASM output, registers are flattened to q[num_qubits] and
+     * c[num_bits] on load. Operation types are stored by enum value, so the
+     * version is bumped whenever Operation::Type changes.
+     */
+    namespace circuit_binary
+    {
+        constexpr char kMagic[4] = {'N', 'W', 'Q', 'C'};
+        constexpr uint8_t kVersion = 1;
+        constexpr size_t kHeaderSize = 32;
+
+        // Operation flags
+        constexpr uint8_t kDagger = 1 << 0;
+        constexpr uint8_t kXRotation = 1 << 1;
+        constexpr uint8_t kParams = 1 << 2;
+        constexpr uint8_t kBits = 1 << 3;
+        constexpr uint8_t kPauli = 1 << 4;
+
+        // Pauli flags; the row type takes bits 2-3
+        constexpr uint8_t kPauliPhase = 1 << 0;
+        constexpr uint8_t kPauliInvalid = 1 << 1;
+
+        inline size_t pauli_words(size_t n_qubits)
+        {
+            return n_qubits <= 64 ? 1 : (n_qubits + 63) / 64;
+        }
+
+        // Whether qubits lists the support of pauli in ascending order
+        inline bool is_pauli_support(Operation::QubitSpan qubits, const PauliOp &pauli)
+        {
+            size_t i = 0;
+            const uint64_t *x = pauli.x_words();
+            const uint64_t *z = pauli.z_words();
+            for (size_t w = 0; w < pauli.num_words(); ++w)
+            {
+                uint64_t bits = x[w] | z[w];
+                while (bits)
+                {
+                    if (i >= qubits.size() || qubits[i] != w * 64 + static_cast<size_t>(ctz_u64(bits)))
+                        return false;
+                    ++i;
+                    bits &= bits - 1;
+                }
+            }
+            return i == qubits.size();
+        }
+
+        // Qubits and classical bits an operation of a type takes; kAnyCount where it varies
+        struct Arity
+        {
+            uint8_t qubits;
+            uint8_t bits;
+        };
+        constexpr uint8_t kAnyCount = 0xFF;
+
+        inline Arity operation_arity(Operation::Type type)
+        {
+            using T = Operation::Type;
+            switch (type)
+            {
+            case T::MEASURE:
+                return {1, 1};
+            case T::RESET:
+                return {1, 0};
+            case T::BARRIER:
+            case T::SWAP_BASIS:
+            case T::T_PAULI:
+            case T::S_PAULI:
+            case T::Z_PAULI:
+                return {kAnyCount, 0};
+            case T::M_PAULI:
+                return {kAnyCount, kAnyCount};
+            case T::CCX:
+            case T::CSWAP:
+            case T::RCCX:
+                return {3, 0};
+            default:
+                // Two-qubit gates fill the enum from CX up to the three-qubit ones
+                if (type >= T::CX && type < T::CCX)
+                    return {2, 0};
+                return {1, 0};
+            }
+        }
+
+        // Whether operations of a type carry a Pauli string
+        inline bool is_pauli_type(Operation::Type type)
+        {
+            return type == Operation::Type::T_PAULI || type == Operation::Type::M_PAULI ||
+                   type == Operation::Type::S_PAULI || type == Operation::Type::Z_PAULI;
+        }
+
+        class Writer
+        {
+        public:
+            explicit Writer(std::ostream &os) : os_(os) { buffer_.reserve(kFlushSize + 1024); }
+            ~Writer() { flush(); }
+
+            void u8(uint8_t value) { buffer_.push_back(static_cast<char>(value)); }
+
+            void u64(uint64_t value)
+            {
+                for (int i = 0; i < 8; ++i)
+                    u8(static_cast<uint8_t>(value >> (8 * i)));
+            }
+
+            void varint(uint64_t value)
+            {
+                while (value >= 0x80)
+                {
+                    u8(static_cast<uint8_t>(value | 0x80));
+                    value >>= 7;
+                }
+                u8(static_cast<uint8_t>(value));
+            }
+
+            void bytes(const char *data, size_t size) { buffer_.append(data, size); }
+
+            // Hand buffered bytes to the stream once enough have accumulated
+            void maybe_flush()
+            {
+                if (buffer_.size() >= kFlushSize)
+                    flush();
+            }
+
+            void flush()
+            {
+                os_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+                buffer_.clear();
+            }
+
+        private:
+            static constexpr size_t kFlushSize = 1 << 20;
+            std::ostream &os_;
+            std::string buffer_;
+        };
+
+        class Reader
+        {
+        public:
+            explicit Reader(std::string_view data) : data_(data) {}
+
+            size_t remaining() const { return data_.size() - pos_; }
+
+            uint8_t u8()
+            {
+                need(1);
+                return static_cast<uint8_t>(data_[pos_++]);
+            }
+
+            uint64_t u64()
+            {
+                need(8);
+                uint64_t value = 0;
+                for (int i = 0; i < 8; ++i)
+                    value |= static_cast<uint64_t>(static_cast<uint8_t>(data_[pos_ + i])) << (8 * i);
+                pos_ += 8;
+                return value;
+            }
+
+            uint64_t varint()
+            {
+                uint64_t value = 0;
+                for (int shift = 0; shift < 64; shift += 7)
+                {
+                    const uint8_t byte = u8();
+                    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                    if ((byte & 0x80) == 0)
+                        return value;
+                }
+                throw std::runtime_error("Binary circuit: malformed varint");
+            }
+
+            // A count of items of at least min_bytes each, checked against the remaining input
+            size_t count(size_t min_bytes)
+            {
+                const uint64_t n = varint();
+                if (min_bytes != 0 && n > remaining() / min_bytes)
+                    throw std::runtime_error("Binary circuit: truncated input");
+                return static_cast<size_t>(n);
+            }
+
+            std::string_view bytes(size_t size)
+            {
+                need(size);
+                std::string_view out = data_.substr(pos_, size);
+                pos_ += size;
+                return out;
+            }
+
+        private:
+            void need(size_t size) const
+            {
+                if (remaining() < size)
+                    throw std::runtime_error("Binary circuit: truncated input");
+            }
+
+            std::string_view data_;
+            size_t pos_ = 0;
+        };
+    } // namespace circuit_binary
+
+    /**
+     * Whether data starts with the binary circuit magic
+     */
+    inline bool is_binary_circuit(std::string_view data)
+    {
+        return data.size() >= sizeof(circuit_binary::kMagic) &&
+               std::memcmp(data.data(), circuit_binary::kMagic, sizeof(circuit_binary::kMagic)) == 0;
+    }
+
+    /**
+     * Whether filename holds a binary circuit (by its magic), false if unreadable
+     */
+    inline bool is_binary_circuit_file(const std::string &filename)
+    {
+        std::ifstream file(filename, std::ios::binary);
+        char magic[sizeof(circuit_binary::kMagic)] = {};
+        if (!file.read(magic, sizeof(magic)))
+            return false;
+        return is_binary_circuit(std::string_view(magic, sizeof(magic)));
+    }
+
+    /**
+     * Write circuit in the binary format to os
+     *
+     * RZ_SEQ placeholders are written as the gates they stand for.
+     */
+    inline void write_binary(const Circuit &circuit, std::ostream &os)
+    {
+        using namespace circuit_binary;
+        const std::vector<Operation> &operations = circuit.get_operations();
+
+        Writer out(os);
+        out.bytes(kMagic, sizeof(kMagic));
+        out.u8(kVersion);
+        out.u8(0);
+        out.u8(0);
+        out.u8(0);
+        out.u64(circuit.get_num_qubits());
+        out.u64(circuit.get_num_bits());
+        out.u64(circuit.gate_count());
+
+        auto write_operation = [&out](const Operation &op)
+        {
+            const Operation::ParamSpan params = op.get_parameters();
+            const Operation::QubitSpan bits = op.get_bits();
+            const PauliOp &pauli = op.get_pauli_op();
+            const bool has_pauli = pauli.get_num_qubits() != 0;
+
+            uint8_t flags = 0;
+            flags |= op.get_dagger() ? kDagger : 0;
+            flags |= op.get_x_rotation() ? kXRotation : 0;
+            flags |= params.empty() ? 0 : kParams;
+            flags |= bits.empty() ? 0 : kBits;
+            flags |= has_pauli ? kPauli : 0;
+
+            out.u8(static_cast<uint8_t>(op.get_type()));
+            out.u8(flags);
+            const Operation::QubitSpan qubits = op.get_qubits();
+            if (has_pauli && is_pauli_support(qubits, pauli))
+            {
+                out.varint(0);
+            }
+            else
+            {
+                out.varint(qubits.size());
+                for (size_t q : qubits)
+                    out.varint(q);
+            }
+
+            if (!params.empty())
+            {
+                out.varint(params.size());
+                for (double value : params)
+                {
+                    uint64_t raw;
+                    std::memcpy(&raw, &value, sizeof(raw));
+                    out.u64(raw);
+                }
+            }
+            if (!bits.empty())
+            {
+                out.varint(bits.size());
+                for (size_t b : bits)
+                    out.varint(b);
+            }
+            if (has_pauli)
+            {
+                out.varint(pauli.get_num_qubits());
+                uint8_t pauli_flags = static_cast<uint8_t>(static_cast<uint8_t>(pauli.get_rowtype()) << 2);
+                pauli_flags |= pauli.get_phase() ? kPauliPhase : 0;
+                pauli_flags |= pauli.is_valid() ? 0 : kPauliInvalid;
+                out.u8(pauli_flags);
+                for (const uint64_t *words : {pauli.x_words(), pauli.z_words()})
+                {
+                    for (size_t w = 0; w < pauli.num_words(); ++w)
+                        out.u64(words[w]);
+                }
+            }
+            out.maybe_flush();
+        };
+
+        for (const Operation &op : operations)
+        {
+            if (op.get_type() == Operation::Type::RZ_SEQ)
+                circuit.for_each_sequence_gate(op, [&write_operation](Operation::Type type, size_t qubit)
+                                               { write_operation(Operation(type, {qubit})); });
+            else
+                write_operation(op);
+        }
+        out.flush();
+    }
+
+    /**
+     * Decode a binary circuit held in memory
+     *
+     * Every operation must fit the header: indices below num_qubits and
+     * num_bits, as many qubits and bits as its type takes, and Pauli strings
+     * exactly num_qubits wide.
+     *
+     * @throws std::runtime_error if data is not a well-formed binary circuit
+     */
+    inline Circuit read_binary(std::string_view data)
+    {
+        using namespace circuit_binary;
+        if (!is_binary_circuit(data) || data.size() < kHeaderSize)
+            throw std::runtime_error("Binary circuit: missing NWQC header");
+
+        Reader in(data);
+        in.bytes(sizeof(kMagic));
+        const uint8_t version = in.u8();
+        if (version != kVersion)
+            throw std::runtime_error("Binary circuit: unsupported version " + std::to_string(version));
+        in.bytes(3);
+        const uint64_t num_qubits = in.u64();
+        const uint64_t num_bits = in.u64();
+        const uint64_t num_operations = in.u64();
+        // Every operation takes at least three bytes
+        if (num_operations > in.remaining() / 3)
+            throw std::runtime_error("Binary circuit: truncated input");
+
+        Circuit circuit;
+        if (num_qubits > 0)
+            circuit.add_qreg("q", static_cast<size_t>(num_qubits));
+        if (num_bits > 0)
+            circuit.add_creg("c", static_cast<size_t>(num_bits));
+        circuit.reserve_operations(static_cast<size_t>(num_operations));
+
+        std::vector<size_t> qubits, bits;
+        std::vector<double> params;
+        std::vector<uint64_t> x_words, z_words;
+        for (uint64_t i = 0; i < num_operations; ++i)
+        {
+            const uint8_t type = in.u8();
+            if (type >= Operation::NUM_TYPES || type == static_cast<uint8_t>(Operation::Type::RZ_SEQ))
+                throw std::runtime_error("Binary circuit: unknown operation type " + std::to_string(type));
+            const Operation::Type op_type = static_cast<Operation::Type>(type);
+            const uint8_t flags = in.u8();
+            const Arity arity = operation_arity(op_type);
+
+            qubits.resize(in.count(1));
+            for (size_t &q : qubits)
+            {
+                const uint64_t index = in.varint();
+                if (index >= num_qubits)
+                    throw std::runtime_error("Binary circuit: qubit " + std::to_string(index) + " out of range for " +
+                                             std::to_string(num_qubits) + " qubits");
+                q = static_cast<size_t>(index);
+            }
+
+            if (arity.qubits != kAnyCount && qubits.size() != arity.qubits)
+                throw std::runtime_error("Binary circuit: " + Operation::get_type_name(op_type) +
+                                         " with " + std::to_string(qubits.size()) + " qubits");
+
+            params.clear();
+            if (flags & kParams)
+            {
+                params.resize(in.count(8));
+                for (double &value : params)
+                {
+                    const uint64_t raw = in.u64();
+                    std::memcpy(&value, &raw, sizeof(value));
+                }
+            }
+            bits.clear();
+            if (flags & kBits)
+            {
+                bits.resize(in.count(1));
+                for (size_t &b : bits)
+                {
+                    const uint64_t index = in.varint();
+                    if (index >= num_bits)
+                        throw std::runtime_error("Binary circuit: bit " + std::to_string(index) + " out of range for " +
+                                                 std::to_string(num_bits) + " bits");
+                    b = static_cast<size_t>(index);
+                }
+            }
+
+            if (arity.bits != kAnyCount && bits.size() != arity.bits)
+                throw std::runtime_error("Binary circuit: " + Operation::get_type_name(op_type) +
+                                         " with " + std::to_string(bits.size()) + " bits");
+            if (((flags & kPauli) != 0) != is_pauli_type(op_type))
+                throw std::runtime_error("Binary circuit: Pauli string on the wrong operation type");
+
+            PauliOp pauli;
+            if (flags & kPauli)
+            {
+                const uint64_t pauli_qubits = in.varint();
+                const uint8_t pauli_flags = in.u8();
+                if (pauli_qubits != num_qubits || pauli_qubits > in.remaining() * 4)
+                    throw std::runtime_error("Binary circuit: bad Pauli width");
+                const size_t words = pauli_words(static_cast<size_t>(pauli_qubits));
+                x_words.resize(words);
+                z_words.resize(words);
+                for (size_t w = 0; w < words; ++w)
+                    x_words[w] = in.u64();
+                for (size_t w = 0; w < words; ++w)
+                    z_words[w] = in.u64();
+                // No X or Z past the last qubit
+                if (pauli_qubits % 64 != 0 &&
+                    ((x_words[words - 1] | z_words[words - 1]) >> (pauli_qubits % 64)) != 0)
+                    throw std::runtime_error("Binary circuit: Pauli string wider than its qubit count");
+                pauli = PauliOp(static_cast<size_t>(pauli_qubits));
+                pauli.assign_words(x_words.data(), z_words.data());
+                pauli.set_phase((pauli_flags & kPauliPhase) != 0);
+                pauli.set_valid((pauli_flags & kPauliInvalid) == 0);
+                pauli.set_rowtype(static_cast<RowType>((pauli_flags >> 2) & 3));
+            }
+
+            circuit.add_operation(Operation(op_type, qubits, params, bits,
+                                            std::move(pauli), (flags & kDagger) != 0, (flags & kXRotation) != 0));
+        }
+        if (in.remaining() != 0)
+            throw std::runtime_error("Binary circuit: trailing bytes after last operation");
+        return circuit;
+    }
+
+    /**
+     * Write circuit to filename in the binary format
+     *
+     * @throws std::runtime_error if the file cannot be written
+     */
+    inline void save_binary(const Circuit &circuit, const std::string &filename)
+    {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file)
+            throw std::runtime_error("Failed to open file for writing: " + filename);
+        write_binary(circuit, file);
+        if (!file)
+            throw std::runtime_error("Failed to write binary circuit: " + filename);
+    }
+
+    /**
+     * Load a binary circuit from filename, decoding straight from a memory mapping
+     *
+     * @throws std::runtime_error if the file cannot be read or is malformed
+     */
+    inline std::unique_ptr<Circuit> load_binary(const std::string &filename)
+    {
+        MappedFile file;
+        if (!file.open(filename))
+            throw std::runtime_error("Could not open file: " + filename);
+        return std::make_unique<Circuit>(read_binary(file.view()));
+    }
+
+} // namespace NWQEC
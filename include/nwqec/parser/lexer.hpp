@@ -2,8 +2,9 @@
 
 #include "token.hpp"
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
-#include <unordered_map>
 #include <cctype>
 #include <stdexcept>
 #include <regex>
@@ -11,42 +12,69 @@
 namespace NWQEC
 {
 
+    /**
+     * Error raised for an invalid token when tokens are pulled one at a time
+     */
+    class LexError : public std::runtime_error
+    {
+    public:
+        explicit LexError(const Token &token)
+            : std::runtime_error("Lexical error at line " + std::to_string(token.line) +
+                                 ", column " + std::to_string(token.column) +
+                                 ": Invalid token '" + std::string(token.lexeme) + "'") {}
+    };
+
     /**
      * Lexer class tokenizes a QASM program string into a sequence of tokens
+     *
+     * The lexer does not copy the source: token lexemes are views into it,
+     * so the source must outlive the lexer and every token it returns.
      */
     class Lexer
     {
     private:
-        std::string source;
-        std::vector<Token> tokens;
+        std::string_view source;
+        std::vector<Token> tokens; // Tokens scanned but not yet returned by next_token
         size_t start = 0;
         size_t current = 0;
         int line = 1;
         int column = 1;
+        int first_line = 1;
+        int first_column = 1;
 
-        // Keywords map for fast lookup
-        const std::unordered_map<std::string, TokenType> keywords = {
-            {"OPENQASM", TokenType::OPENQASM},
-            {"include", TokenType::INCLUDE},
-            {"qreg", TokenType::QREG},
-            {"creg", TokenType::CREG},
-            {"gate", TokenType::GATE},
-            {"measure", TokenType::MEASURE},
-            {"reset", TokenType::RESET},
-            {"if", TokenType::IF},
-            {"barrier", TokenType::BARRIER},
-            {"pi", TokenType::PI}};
+        static TokenType keyword_type(std::string_view text)
+        {
+            static const std::pair<std::string_view, TokenType> keywords[] = {
+                {"OPENQASM", TokenType::OPENQASM},
+                {"include", TokenType::INCLUDE},
+                {"qreg", TokenType::QREG},
+                {"creg", TokenType::CREG},
+                {"gate", TokenType::GATE},
+                {"measure", TokenType::MEASURE},
+                {"reset", TokenType::RESET},
+                {"if", TokenType::IF},
+                {"barrier", TokenType::BARRIER},
+                {"pi", TokenType::PI}};
+            for (const auto &[keyword, type] : keywords)
+            {
+                if (text == keyword)
+                    return type;
+            }
+            return TokenType::IDENTIFIER;
+        }
 
     public:
-        Lexer(const std::string &source) : source(source) {}
+        Lexer(std::string_view source) : source(source) {}
+
+        /**
+         * Lex a slice of a larger file, numbering tokens from the slice's position in it
+         */
+        Lexer(std::string_view source, int line, int column)
+            : source(source), line(line), column(column), first_line(line), first_column(column) {}
 
         std::vector<Token> tokenize()
         {
-            tokens.clear();
-            start = 0;
-            current = 0;
-            line = 1;
-            column = 1;
+            reset();
 
             while (!isAtEnd())
             {
@@ -56,7 +84,34 @@ namespace NWQEC
 
             // Add EOF token
             tokens.emplace_back(TokenType::EOF_TOKEN, "", line, column);
-            return tokens;
+            return std::move(tokens);
+        }
+
+        /**
+         * Scan and return the next token; EOF_TOKEN once the source is exhausted
+         */
+        Token next_token()
+        {
+            while (tokens.empty() && !isAtEnd())
+            {
+                start = current;
+                scanToken();
+            }
+            if (tokens.empty())
+                return Token(TokenType::EOF_TOKEN, "", line, column);
+            Token token = tokens.back();
+            tokens.pop_back();
+            return token;
+        }
+
+        // Restart scanning from the beginning of the source
+        void reset()
+        {
+            tokens.clear();
+            start = 0;
+            current = 0;
+            line = first_line;
+            column = first_column;
         }
 
     private:
@@ -97,8 +152,7 @@ namespace NWQEC
 
         void addToken(TokenType type)
         {
-            std::string lexeme = source.substr(start, current - start);
-            tokens.emplace_back(type, lexeme, line, column - (current - start));
+            tokens.emplace_back(type, source.substr(start, current - start), line, column - (current - start));
         }
 
         void scanToken()
@@ -207,7 +261,7 @@ namespace NWQEC
                 else
                 {
                     // Invalid character
-                    tokens.emplace_back(TokenType::INVALID, std::string(1, c), line, column - 1);
+                    tokens.emplace_back(TokenType::INVALID, source.substr(start, 1), line, column - 1);
                 }
                 break;
             }
@@ -218,13 +272,8 @@ namespace NWQEC
             while (std::isalnum(peek()) || peek() == '_')
                 advance();
 
-            std::string text = source.substr(start, current - start);
-
             // Check if it's a keyword
-            auto it = keywords.find(text);
-            TokenType type = (it != keywords.end()) ? it->second : TokenType::IDENTIFIER;
-
-            addToken(type);
+            addToken(keyword_type(source.substr(start, current - start)));
         }
 
         void number()
@@ -302,7 +351,7 @@ namespace NWQEC
             advance();
 
             // Extract the string value (excluding quotes)
-            std::string value = source.substr(start + 1, current - start - 2);
+            std::string_view value = source.substr(start + 1, current - start - 2);
             tokens.emplace_back(TokenType::STRING, value, line, column - (current - start));
         }
     };
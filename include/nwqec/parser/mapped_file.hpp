@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace NWQEC
+{
+
+    /**
+     * Read-only view of a whole file's contents
+     *
+     * Regular files are memory-mapped, so the lexer can read them in place
+     * and pages are only faulted in as it walks forward. Pipes, devices and
+     * platforms without mmap fall back to reading the file into a buffer.
+     * The view is valid until close() or destruction.
+     */
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { close(); }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        /**
+         * Map filename, replacing any file mapped before
+         *
+         * @param sequential Hint that the file is read front to back; lookup
+         *                   tables pass false
+         * @return false if the file could not be opened or read
+         */
+        bool open(const std::string &filename, bool sequential = true)
+        {
+            close();
+#if !defined(_WIN32)
+            int fd = ::open(filename.c_str(), O_RDONLY);
+            if (fd < 0)
+                return false;
+            struct stat info;
+            if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode))
+            {
+                size_ = static_cast<size_t>(info.st_size);
+                if (size_ == 0)
+                {
+                    ::close(fd);
+                    return true;
+                }
+                void *addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                ::close(fd);
+                if (addr == MAP_FAILED)
+                {
+                    size_ = 0;
+                    return read_into_buffer(filename);
+                }
+#if defined(MADV_SEQUENTIAL)
+                ::madvise(addr, size_, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+#endif
+                data_ = static_cast<const char *>(addr);
+                mapped_ = true;
+                return true;
+            }
+            ::close(fd);
+#endif
+            return read_into_buffer(filename);
+        }
+
+        void close()
+        {
+#if !defined(_WIN32)
+            if (mapped_)
+                ::munmap(const_cast<char *>(data_), size_);
+#endif
+            data_ = nullptr;
+            size_ = 0;
+            mapped_ = false;
+            buffer_.clear();
+            buffer_.shrink_to_fit();
+        }
+
+        std::string_view view() const { return std::string_view(data_ ? data_ : "", size_); }
+        size_t size() const { return size_; }
+
+        // Whether the contents are mapped rather than copied into memory
+        bool is_mapped() const { return mapped_; }
+
+    private:
+        bool read_into_buffer(const std::string &filename)
+        {
+            std::ifstream file(filename, std::ios::binary);
+            if (!file.is_open())
+                return false;
+            buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            data_ = buffer_.data();
+            size_ = buffer_.size();
+            return true;
+        }
+
+        const char *data_ = nullptr;
+        size_t size_ = 0;
+        bool mapped_ = false;
+        std::string buffer_;
+    };
+
+} // namespace NWQEC
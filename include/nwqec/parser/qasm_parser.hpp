@@ -5,14 +5,20 @@
 #include "nwqec/parser/ast.hpp"
 #include "nwqec/parser/ast_generator.hpp"
 #include "nwqec/parser/ast_converter.hpp"
+#include "nwqec/parser/mapped_file.hpp"
 
 #include "nwqec/core/circuit.hpp"
+#include "nwqec/core/parallel.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <string>
-#include <fstream>
-#include <sstream>
+#include <string_view>
 #include <iostream>
 #include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
 
 namespace NWQEC
 {
@@ -27,18 +33,174 @@ namespace NWQEC
         std::unique_ptr<Circuit> circuit;
         std::string lastError;
         bool hasError = false;
+        size_t num_threads = 0;
+
+        // Bodies smaller than this are not worth splitting
+        static constexpr size_t parallel_min_bytes = size_t(1) << 20;
+        static constexpr size_t min_chunk_bytes = size_t(256) << 10;
+
+        // Statements that may only precede a flat body
+        static bool is_header_token(TokenType type)
+        {
+            return type == TokenType::OPENQASM || type == TokenType::INCLUDE ||
+                   type == TokenType::QREG || type == TokenType::CREG || type == TokenType::GATE;
+        }
+
+        // A line that ends a statement and leaves the lexer outside any comment
+        static bool ends_statement(std::string_view line)
+        {
+            size_t last = line.find_last_not_of(" \t\r");
+            return last != std::string_view::npos && line[last] == ';' &&
+                   line.substr(0, last).find("//") == std::string_view::npos;
+        }
+
+        struct BodyChunk
+        {
+            size_t begin = 0;
+            int line = 1;
+            int column = 1;
+        };
+
+        /**
+         * Cut source[offset..] at line ends that close a statement, about
+         * target bytes apart. Chunks after the first start at column 1.
+         */
+        static std::vector<BodyChunk> split_body(std::string_view source, size_t offset, int line, int column,
+                                                 size_t target)
+        {
+            std::vector<BodyChunk> chunks{{offset, line, column}};
+            size_t pos = offset;
+            while (source.size() - pos > target)
+            {
+                size_t newline = source.find('\n', pos + target);
+                while (newline != std::string_view::npos)
+                {
+                    size_t line_begin = source.rfind('\n', newline - 1);
+                    line_begin = line_begin == std::string_view::npos || line_begin < pos ? pos : line_begin + 1;
+                    if (ends_statement(source.substr(line_begin, newline - line_begin)))
+                        break;
+                    newline = source.find('\n', newline + 1);
+                }
+                if (newline == std::string_view::npos || newline + 1 >= source.size())
+                    break;
+                line += static_cast<int>(std::count(source.begin() + pos, source.begin() + newline + 1, '\n'));
+                pos = newline + 1;
+                chunks.push_back({pos, line, 1});
+            }
+            return chunks;
+        }
+
+        struct ChunkResult
+        {
+            Circuit circuit;
+            std::string diagnostics;
+            std::string error;
+            bool failed = false;
+            bool not_flat = false;
+        };
+
+        /**
+         * Convert a body without registers, gate definitions or blocks on
+         * several threads
+         *
+         * Each chunk is lexed, parsed and converted on its own against a fork
+         * of the header state, then the operation vectors are joined in order.
+         * Skipped-statement reports are replayed in order, and a fatal error
+         * is the first one the serial parser would have hit.
+         *
+         * @return false, with builder untouched, if the body is not flat
+         */
+        bool stream_body_parallel(std::string_view source, const Token &first, const ASTGenerator &header,
+                                  ASTCircuitConverter &builder, size_t threads)
+        {
+            const size_t offset = static_cast<size_t>(first.lexeme.data() - source.data());
+            std::string_view body = source.substr(offset);
+            if (body.size() < parallel_min_bytes || std::memchr(body.data(), '"', body.size()) != nullptr)
+                return false; // Strings may span lines, so the cut points would not be statement ends
+
+            size_t target = std::max(min_chunk_bytes, body.size() / (threads * 4));
+            std::vector<BodyChunk> chunks = split_body(source, offset, first.line, first.column, target);
+            if (chunks.size() < 2)
+                return false;
+
+            std::vector<ChunkResult> results(chunks.size());
+            parallel_for(chunks.size(), threads, [&](size_t i)
+                         {
+                size_t end = i + 1 < chunks.size() ? chunks[i + 1].begin : source.size();
+                Lexer lexer(source.substr(chunks[i].begin, end - chunks[i].begin), chunks[i].line, chunks[i].column);
+                ASTGenerator ast_gen(lexer);
+                ast_gen.set_flat_body(true);
+                ast_gen.copy_gate_names(header);
+                std::ostringstream diagnostics;
+                ast_gen.set_diagnostics(diagnostics);
+                ChunkResult &result = results[i];
+                try
+                {
+                    ASTCircuitConverter converter = builder.fork();
+                    while (std::unique_ptr<Stmt> stmt = ast_gen.next_statement())
+                    {
+                        converter.add_statement(stmt.get());
+                    }
+                    result.circuit = converter.take_circuit();
+                }
+                catch (const NonFlatInput &)
+                {
+                    result.not_flat = true;
+                }
+                catch (const std::exception &e)
+                {
+                    result.failed = true;
+                    result.error = e.what();
+                }
+                result.diagnostics = diagnostics.str(); });
+
+            size_t stop = results.size();
+            for (size_t i = 0; i < results.size() && stop == results.size(); ++i)
+            {
+                if (results[i].not_flat)
+                    return false;
+                if (results[i].failed)
+                    stop = i;
+            }
+            for (size_t i = 0; i < results.size() && i <= stop; ++i)
+                std::cerr << results[i].diagnostics;
+            if (stop < results.size())
+                throw std::runtime_error(results[stop].error);
+
+            size_t total = 0;
+            for (const ChunkResult &result : results)
+                total += result.circuit.get_operations().size();
+            Circuit merged = builder.take_circuit();
+            merged.reserve_operations(merged.get_operations().size() + total);
+            for (ChunkResult &result : results)
+                merged.append_circuit(std::move(result.circuit));
+            circuit = std::make_unique<Circuit>(std::move(merged));
+            return true;
+        }
 
     public:
+        /**
+         * Worker threads for stream_string() and stream_file()
+         *
+         * @param threads Number of threads (0 = hardware concurrency, the default; 1 = serial)
+         */
+        void set_num_threads(size_t threads)
+        {
+            num_threads = threads;
+        }
+
         /**
          * Parse QASM code from a string
          *
          * @param source QASM code string to parse
          * @return true if parsing succeeded, false otherwise
          */
-        bool parse_string(const std::string &source)
+        bool parse_string(std::string_view source)
         {
             hasError = false;
             lastError = "";
+            program.reset();
+            circuit.reset();
 
             try
             {
@@ -51,16 +213,14 @@ namespace NWQEC
                 {
                     if (token.type == TokenType::INVALID)
                     {
-                        lastError = "Lexical error at line " + std::to_string(token.line) +
-                                    ", column " + std::to_string(token.column) +
-                                    ": Invalid token '" + token.lexeme + "'";
+                        lastError = LexError(token).what();
                         hasError = true;
                         return false;
                     }
                 }
 
                 // Parse tokens into AST
-                ASTGenerator ast_gen(tokens);
+                ASTGenerator ast_gen(std::move(tokens));
                 program = std::make_unique<ASTProgram>(ast_gen.parse());
 
                 // Build the flattened circuit
@@ -85,17 +245,93 @@ namespace NWQEC
          */
         bool parse_file(const std::string &filename)
         {
-            std::ifstream file(filename);
-            if (!file.is_open())
+            MappedFile file;
+            if (!file.open(filename))
             {
                 lastError = "Could not open file: " + filename;
                 hasError = true;
                 return false;
             }
+            return parse_string(file.view());
+        }
+
+        /**
+         * Parse QASM code from a string without keeping the AST
+         *
+         * Tokens are scanned as the parser needs them and each statement is
+         * flattened into the circuit as soon as it is parsed, so memory holds
+         * the circuit plus one statement rather than every token and AST node.
+         * The circuit matches parse_string(); get_program() returns nullptr.
+         *
+         * A body of at least 1 MB with no registers, gate definitions, blocks
+         * or strings after the header is split at statement ends and converted
+         * on set_num_threads() workers; the result does not depend on the
+         * thread count. Other inputs are converted serially.
+         *
+         * @param source QASM code string to parse
+         * @return true if parsing succeeded, false otherwise
+         */
+        bool stream_string(std::string_view source)
+        {
+            hasError = false;
+            lastError = "";
+            program.reset();
+            circuit.reset();
+
+            try
+            {
+                Lexer lexer(source);
+                ASTGenerator ast_gen(lexer);
+                ASTCircuitConverter builder;
+                builder.begin();
+
+                size_t threads = resolve_num_threads(num_threads);
+                if (threads > 1 && source.size() >= parallel_min_bytes)
+                {
+                    // Header statements are converted in order, then the body may be split
+                    while (is_header_token(ast_gen.lookahead().type))
+                    {
+                        if (std::unique_ptr<Stmt> stmt = ast_gen.next_statement())
+                            builder.add_statement(stmt.get());
+                    }
+                    const Token &first = ast_gen.lookahead();
+                    if (first.type != TokenType::EOF_TOKEN &&
+                        stream_body_parallel(source, first, ast_gen, builder, threads))
+                        return true;
+                }
 
-            std::stringstream buffer;
-            buffer << file.rdbuf();
-            return parse_string(buffer.str());
+                // Serial path, or the rest of a body that was not flat
+                while (std::unique_ptr<Stmt> stmt = ast_gen.next_statement())
+                {
+                    builder.add_statement(stmt.get());
+                }
+                circuit = std::make_unique<Circuit>(builder.take_circuit());
+                return true;
+            }
+            catch (const std::exception &e)
+            {
+                lastError = e.what();
+                hasError = true;
+                return false;
+            }
+        }
+
+        /**
+         * Stream QASM code from a memory-mapped file, see stream_string()
+         *
+         * @param filename Path to the QASM file
+         * @return true if parsing succeeded, false otherwise
+         */
+        bool stream_file(const std::string &filename)
+        {
+            MappedFile file;
+            if (!file.open(filename))
+            {
+                lastError = "Could not open file: " + filename;
+                hasError = true;
+                return false;
+            }
+            return stream_string(file.view());
         }
 
         /**
@@ -1,14 +1,12 @@
 #pragma once
 
-#include "nwqec/core/dag_circuit.hpp"
+#include "nwqec/core/clifford_t_reducer.hpp"
+#include "nwqec/core/single_qubit_runs.hpp"
 #include "nwqec/core/pauli_op.hpp"
 #include "pass_template.hpp"
 #include <vector>
 #include <cmath>
-#include <map>
-#include <set>
 #include <algorithm>
-#include <optional>
 #include <cassert>
 
 namespace NWQEC
@@ -18,7 +16,7 @@ namespace NWQEC
      *
      * This pass applies a specific sequence of optimizations to single-qubit gate sequences:
      * 1. Replace CCX gate with a sequence of T_PAULI gates
-     * 2. General optimization (combining rotation gates, canceling pairs)
+     * 2. General optimization (each Clifford+T stretch reduced to a T-optimal form)
      * 3. Convert T S sequences to TDG Z
      * 4. Commute all Hadamard gates to the end using rewriting rules:
      *    - HXH = Z, HZH = X, HYH = -Y
@@ -41,41 +39,35 @@ namespace NWQEC
 
         bool run(Circuit &circuit) override
         {
-
-            DAGCircuit dag(circuit);
-
-            auto consecutive_sequences = get_1q_sequences(dag);
+            const auto &original_ops = circuit.get_operations();
+            SingleQubitRuns runs(original_ops, circuit.get_num_qubits());
 
             bool modified = false;
-            std::set<size_t> optimized_indices;
-            std::map<size_t, std::vector<Operation>> replacements;
+            RewriteTable rewrites(original_ops.size());
 
             // First, handle CCX gates (Step 1 - Replace CCX gates with T_PAULI operations)
-            const auto &original_ops = circuit.get_operations();
             for (size_t i = 0; i < original_ops.size(); i++)
             {
                 if (original_ops[i].get_type() == Operation::Type::CCX)
                 {
                     auto qubits = original_ops[i].get_qubits();
-                    auto ccx_ops = create_ccx_t_ops(qubits[0], qubits[1], qubits[2], circuit.get_num_qubits());
-                    replacements[i] = ccx_ops;
-                    optimized_indices.insert(i);
+                    rewrites.replace(i, create_ccx_t_ops(qubits[0], qubits[1], qubits[2], circuit.get_num_qubits()));
                     modified = true;
                 }
             }
 
-            for (const auto &sequence : consecutive_sequences)
+            std::vector<Operation> ops_only;
+            for (size_t r = 0; r < runs.size(); ++r)
             {
-                if (sequence.empty())
-                    continue;
-
-                size_t first_idx = sequence[0].first;
-
-                std::vector<Operation> ops_only;
-                for (const auto &[idx, op] : sequence)
+                ops_only.clear();
+                for (const size_t *it = runs.begin(r); it != runs.end(r); ++it)
                 {
-                    ops_only.push_back(op);
-                    optimized_indices.insert(idx);
+                    // RZ_SEQ placeholders are reduced as the gates they stand for
+                    if (original_ops[*it].get_type() == Operation::Type::RZ_SEQ)
+                        circuit.for_each_sequence_gate(original_ops[*it], [&ops_only](Operation::Type type, size_t qubit)
+                                                       { ops_only.push_back(Operation(type, {qubit})); });
+                    else
+                        ops_only.push_back(original_ops[*it]);
                 }
 
                 // Apply the four-step optimization process
@@ -96,29 +88,13 @@ namespace NWQEC
                     modified = true;
                 }
 
-                replacements[first_idx] = optimized;
+                rewrites.replace_run(runs, r, optimized);
             }
 
             // Rebuild circuit with optimizations
             if (modified)
             {
-                const auto &original_ops = circuit.get_operations();
-                std::vector<Operation> final_operations;
-
-                for (size_t i = 0; i < original_ops.size(); i++)
-                {
-                    if (replacements.count(i))
-                    {
-                        for (const auto &opt_op : replacements[i])
-                        {
-                            final_operations.push_back(opt_op);
-                        }
-                    }
-                    else if (optimized_indices.count(i) == 0)
-                    {
-                        final_operations.push_back(original_ops[i]);
-                    }
-                }
+                std::vector<Operation> final_operations = rewrites.apply(original_ops);
 
                 // Create new circuit
                 Circuit new_circuit;
@@ -126,11 +102,13 @@ namespace NWQEC
                 // Copy register information
                 new_circuit.add_qreg("q", circuit.get_num_qubits());
                 new_circuit.add_creg("c", circuit.get_num_bits());
+                new_circuit.set_rz_sequences(circuit.rz_sequences());
+                new_circuit.reserve_operations(final_operations.size());
 
                 // Add operations
-                for (const auto &op : final_operations)
+                for (auto &op : final_operations)
                 {
-                    new_circuit.add_operation(op);
+                    new_circuit.add_operation(std::move(op));
                 }
 
                 circuit = std::move(new_circuit);
@@ -158,183 +136,10 @@ namespace NWQEC
             return t_ops;
         }
 
-        // Check if an operation is a single-qubit gate
-        bool is_single_qubit_gate(const Operation &op) const
-        {
-            return op.get_qubits().size() == 1 &&
-                   op.get_type() != Operation::Type::MEASURE &&
-                   op.get_type() != Operation::Type::RESET &&
-                   op.get_type() != Operation::Type::BARRIER;
-        }
-
-        // Check if two gates can cancel each other
-        bool gates_cancel(Operation::Type gate1, Operation::Type gate2) const
-        {
-            // Self-inverse gates
-            if (gate1 == gate2 && (gate1 == Operation::Type::X ||
-                                   gate1 == Operation::Type::Y ||
-                                   gate1 == Operation::Type::Z ||
-                                   gate1 == Operation::Type::H))
-            {
-                return true;
-            }
-
-            // Inverse pairs
-            if ((gate1 == Operation::Type::S && gate2 == Operation::Type::SDG) ||
-                (gate1 == Operation::Type::SDG && gate2 == Operation::Type::S) ||
-                (gate1 == Operation::Type::T && gate2 == Operation::Type::TDG) ||
-                (gate1 == Operation::Type::TDG && gate2 == Operation::Type::T) ||
-                (gate1 == Operation::Type::SX && gate2 == Operation::Type::SXDG) ||
-                (gate1 == Operation::Type::SXDG && gate2 == Operation::Type::SX) ||
-                // Note: P4 with x_rotation inverse pairs would need Operation objects, not just types
-                false) // Placeholder - P4 inverse pairs need more complex logic
-            {
-                return true;
-            }
-
-            return false;
-        }
-
-        // Step 1: General optimization - combine rotation gates and remove canceling pairs
+        // Step 1: General optimization - reduce each Clifford+T stretch to a T-optimal form
         std::vector<Operation> gate_merging(const std::vector<Operation> &sequence) const
         {
-            std::vector<Operation> result;
-
-            for (size_t i = 0; i < sequence.size(); i++)
-            {
-                const Operation &current = sequence[i];
-
-                // Check for canceling pairs first
-                if (i + 1 < sequence.size() &&
-                    gates_cancel(current.get_type(), sequence[i + 1].get_type()))
-                {
-                    i++; // Skip both operations
-                    continue;
-                }
-
-                // Check for merging pairs (gates that combine into other gates)
-                if (i + 1 < sequence.size())
-                {
-                    auto merged_gate = try_merge_gates(current, sequence[i + 1]);
-                    if (merged_gate.has_value())
-                    {
-                        result.push_back(merged_gate.value());
-                        i++; // Skip the second gate as it's been merged
-                        continue;
-                    }
-                }
-
-                result.push_back(current);
-            }
-
-            // Apply iterative merging until no more changes occur
-            bool changed = true;
-            while (changed)
-            {
-                changed = false;
-                std::vector<Operation> new_result;
-
-                for (size_t i = 0; i < result.size(); i++)
-                {
-                    const Operation &current = result[i];
-
-                    // Check for canceling pairs first
-                    if (i + 1 < result.size() &&
-                        gates_cancel(current.get_type(), result[i + 1].get_type()))
-                    {
-                        i++; // Skip both operations
-                        changed = true;
-                        continue;
-                    }
-
-                    // Check for merging pairs (gates that combine into other gates)
-                    if (i + 1 < result.size())
-                    {
-                        auto merged_gate = try_merge_gates(current, result[i + 1]);
-                        if (merged_gate.has_value())
-                        {
-                            new_result.push_back(merged_gate.value());
-                            i++; // Skip the second gate as it's been merged
-                            changed = true;
-                            continue;
-                        }
-                    }
-
-                    new_result.push_back(current);
-                }
-
-                result = std::move(new_result);
-            }
-
-            return result;
-        }
-
-        // Try to merge two consecutive gates into a single gate
-        std::optional<Operation> try_merge_gates(const Operation &gate1, const Operation &gate2) const
-        {
-            // Only merge gates on the same qubit
-            if (gate1.get_qubits() != gate2.get_qubits())
-            {
-                return std::nullopt;
-            }
-
-            Operation::Type type1 = gate1.get_type();
-            Operation::Type type2 = gate2.get_type();
-
-            // T T = S
-            if (type1 == Operation::Type::T && type2 == Operation::Type::T)
-            {
-                return Operation(Operation::Type::S, gate1.get_qubits());
-            }
-
-            // TDG TDG = SDG
-            if (type1 == Operation::Type::TDG && type2 == Operation::Type::TDG)
-            {
-                return Operation(Operation::Type::SDG, gate1.get_qubits());
-            }
-
-            // S S = Z
-            if (type1 == Operation::Type::S && type2 == Operation::Type::S)
-            {
-                return Operation(Operation::Type::Z, gate1.get_qubits());
-            }
-
-            // SDG SDG = Z
-            if (type1 == Operation::Type::SDG && type2 == Operation::Type::SDG)
-            {
-                return Operation(Operation::Type::Z, gate1.get_qubits());
-            }
-
-            // T TDG T = T (T TDG cancels, leaving T)
-            // This is handled by the cancellation logic, not merging
-
-            // S TDG = T (since S = T T, so S TDG = T T TDG = T)
-            if (type1 == Operation::Type::S && type2 == Operation::Type::TDG)
-            {
-                return Operation(Operation::Type::T, gate1.get_qubits());
-            }
-
-            // TDG S = TDG (since S = T T, so TDG S = TDG T T = T T = S, wait that's wrong)
-            // Actually: TDG S = TDG T T = (TDG T) T = I T = T
-            if (type1 == Operation::Type::TDG && type2 == Operation::Type::S)
-            {
-                return Operation(Operation::Type::T, gate1.get_qubits());
-            }
-
-            // SDG T = TDG (since SDG = TDG TDG, so SDG T = TDG TDG T = TDG (TDG T) = TDG I = TDG)
-            if (type1 == Operation::Type::SDG && type2 == Operation::Type::T)
-            {
-                return Operation(Operation::Type::TDG, gate1.get_qubits());
-            }
-
-            // T SDG = TDG (since SDG = TDG TDG, so T SDG = T TDG TDG = (T TDG) TDG = I TDG = TDG)
-            if (type1 == Operation::Type::T && type2 == Operation::Type::SDG)
-            {
-                return Operation(Operation::Type::TDG, gate1.get_qubits());
-            }
-
-            // No merging rule found
-            return std::nullopt;
+            return CliffordTReducer::reduce(sequence);
         }
 
         // Step 2: Convert T S sequences to TDG Z
@@ -493,7 +298,7 @@ namespace NWQEC
                 case Operation::Type::RY:
                 {
                     // RY(θ) -> RY(-θ) under Hadamard conjugation
-                    auto params = op.get_parameters();
+                    std::vector<double> params = op.get_parameters();
                     assert(params.size() == 1 && "RY gate must have exactly one parameter");
                     params[0] = -params[0];
                     return Operation(Operation::Type::RY, op.get_qubits(), params);
@@ -514,64 +319,5 @@ namespace NWQEC
 
             return Operation(new_type, op.get_qubits(), op.get_parameters());
         }
-
-        // Extract consecutive single-qubit gate sequences using DAG traversal
-        std::vector<std::vector<std::pair<size_t, Operation>>> get_1q_sequences(const DAGCircuit &dag) const
-        {
-            std::vector<std::vector<std::pair<size_t, Operation>>> sequences;
-            std::set<size_t> visited;
-            const auto &operations = dag.get_operations();
-
-            for (size_t start_idx = 0; start_idx < operations.size(); start_idx++)
-            {
-                if (visited.count(start_idx) || !is_single_qubit_gate(operations[start_idx]))
-                {
-                    continue;
-                }
-
-                std::vector<std::pair<size_t, Operation>> sequence;
-                size_t current_qubit = operations[start_idx].get_qubits()[0];
-                size_t current_idx = start_idx;
-
-                while (current_idx < operations.size() &&
-                       !visited.count(current_idx) &&
-                       is_single_qubit_gate(operations[current_idx]) &&
-                       operations[current_idx].get_qubits()[0] == current_qubit)
-                {
-                    sequence.push_back({current_idx, operations[current_idx]});
-                    visited.insert(current_idx);
-
-                    const auto &successors = dag.get_successors(current_idx);
-                    size_t next_idx = std::numeric_limits<size_t>::max();
-
-                    for (const auto &succ : successors)
-                    {
-                        if (succ.qubit == current_qubit)
-                        {
-                            next_idx = succ.node;
-                            break;
-                        }
-                    }
-
-                    if (next_idx == std::numeric_limits<size_t>::max() ||
-                        next_idx >= operations.size() ||
-                        !is_single_qubit_gate(operations[next_idx]) ||
-                        operations[next_idx].get_qubits()[0] != current_qubit)
-                    {
-                        break;
-                    }
-
-                    current_idx = next_idx;
-                }
-
-                // Add sequences with at least one gate (apply optimization even to single gates)
-                if (!sequence.empty())
-                {
-                    sequences.push_back(sequence);
-                }
-            }
-
-            return sequences;
-        }
     };
 }
@@ -2,10 +2,12 @@
 
 #include "nwqec/core/circuit.hpp"
 #include "pass_template.hpp"
-#include <set>
-#include <string>
+#include <algorithm>
+#include <array>
 #include <cmath>
-#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 namespace NWQEC
 {
@@ -13,6 +15,8 @@ namespace NWQEC
      * @brief Pass to decompose gates into basis gates
      *
      * This pass decomposes complex gates into a sequence of basis gates.
+     * Each decomposition is a template in a table indexed by gate type,
+     * expanded straight into the output circuit, which is sized up front.
      */
     class DecomposePass : public Pass
     {
@@ -36,354 +40,197 @@ namespace NWQEC
 
         bool run(Circuit &circuit) override
         {
+            circuit.expand_rz_sequences(); // Templates apply to individual gates
+            const Templates &table = templates();
+            const auto &operations = circuit.get_operations();
 
+            // Size the output first; a circuit with nothing to expand is left untouched
+            size_t output_size = 0;
             bool circuit_modified = false;
+            for (const auto &operation : operations)
+            {
+                const Range &range = table.range[static_cast<size_t>(operation.get_type())];
+                if (range.size == 0 || should_keep_operation(operation, circuit))
+                {
+                    ++output_size;
+                    continue;
+                }
+                output_size += range.size;
+                circuit_modified = true;
+            }
+            if (!circuit_modified)
+                return false;
 
             // Create new circuit and copy register information
             Circuit new_circuit;
             new_circuit.add_qreg("q", circuit.get_num_qubits());
             new_circuit.add_creg("c", circuit.get_num_bits());
+            new_circuit.reserve_operations(output_size);
 
-            // Process each operation
-            for (const auto &operation : circuit.get_operations())
+            for (const auto &operation : operations)
             {
-                if (should_keep_operation(operation, circuit))
+                const Range &range = table.range[static_cast<size_t>(operation.get_type())];
+                if (range.size == 0 || should_keep_operation(operation, circuit))
                 {
                     new_circuit.add_operation(operation);
+                    continue;
                 }
-                else if (auto decomposed_ops = decompose_gate(operation); !decomposed_ops.empty())
-                {
-                    for (const auto &decomposed_op : decomposed_ops)
-                    {
-                        new_circuit.add_operation(decomposed_op);
-                    }
-                    circuit_modified = true;
-                }
-                else
+
+                const Operation::QubitSpan qubits = operation.get_qubits();
+                const Operation::ParamSpan params = operation.get_parameters();
+                const TemplateGate *gate = table.gates.data() + range.begin;
+                for (const TemplateGate *end = gate + range.size; gate != end; ++gate)
                 {
-                    // Keep original operation if decomposition not available
-                    new_circuit.add_operation(operation);
+                    if (gate->type == Operation::Type::RZ)
+                        new_circuit.add_operation(Operation(gate->type, {qubits[gate->slot[0]]}, {gate->angle(params)}));
+                    else if (gate->slot[1] == NO_SLOT)
+                        new_circuit.add_operation(Operation(gate->type, {qubits[gate->slot[0]]}));
+                    else
+                        new_circuit.add_operation(Operation(gate->type, {qubits[gate->slot[0]], qubits[gate->slot[1]]}));
                 }
             }
 
-            // Replace circuit if modifications were made
-            if (circuit_modified)
-            {
-                circuit = std::move(new_circuit);
-            }
-
-            return circuit_modified;
+            circuit = std::move(new_circuit);
+            return true;
         }
 
     private:
-        /**
-         * @brief Check if an operation should be kept as-is without decomposition
-         */
-        bool should_keep_operation(const Operation &operation, const Circuit &circuit) const
-        {
-            return circuit.is_clifford_t_operation(operation.get_type()) ||
-                   (keep_ccx_ && operation.get_type() == Operation::Type::CCX);
-        }
+        static constexpr uint8_t NO_SLOT = 0xFF;
+        static constexpr size_t MAX_PARAMS = 4;
 
         /**
-         * @brief Decompose a gate into a sequence of basis gates
+         * @brief One gate of a decomposition template
          *
-         * @param op The operation to decompose
-         * @return Vector of decomposed operations
+         * Operands are slots into the decomposed gate's qubits. An RZ angle
+         * is offset + sum coeff[k] * params[k]; terms are added from the
+         * highest parameter down and the offset last, which reproduces the
+         * rounding of the expressions the templates were written from.
          */
-        std::vector<Operation> decompose_gate(const Operation &op)
+        struct TemplateGate
         {
-            std::vector<Operation> result;
-
-            // Get the operation parameters and qubits
-            auto type = op.get_type();
-            auto qubits = op.get_qubits();
-            auto params = op.get_parameters();
-
-            switch (type)
-            {
-
-            case Operation::Type::RX:
-            {
-                result.push_back(Operation(Operation::Type::H, {qubits[0]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[0]}));
-                result.push_back(Operation(Operation::Type::H, {qubits[0]}, {}));
-                break;
-            }
-            case Operation::Type::RY:
-            {
-                result.push_back(Operation(Operation::Type::SDG, {qubits[0]}, {}));
-                result.push_back(Operation(Operation::Type::H, {qubits[0]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[0]}));
-                result.push_back(Operation(Operation::Type::H, {qubits[0]}, {}));
-                result.push_back(Operation(Operation::Type::S, {qubits[0]}, {}));
-                break;
-            }
-            case Operation::Type::P:
-            {
-                result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[0]}));
-                break;
-            }
-            case Operation::Type::U:
-            case Operation::Type::U3:
-            {
-                result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[2]})); // λ
-                result.push_back(Operation(Operation::Type::SX, {qubits[0]}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[0] + M_PI})); // θ
-                result.push_back(Operation(Operation::Type::SX, {qubits[0]}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[1] + 3 * M_PI})); // φ
-
-                break;
-            }
-            case Operation::Type::U1: // u1(θ) = rz(θ)
-            {
-                result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[0]}));
-                break;
-            }
-            case Operation::Type::U2: // u2(θ, φ) = u(pi/2, φ, θ)
-            {
-                result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[1]})); // λ
-                result.push_back(Operation(Operation::Type::SX, {qubits[0]}));
-                result.push_back(Operation(Operation::Type::S, {qubits[0]}));
-                result.push_back(Operation(Operation::Type::Z, {qubits[0]}));
-                result.push_back(Operation(Operation::Type::SX, {qubits[0]}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[0] - 3 * M_PI})); // φ
-                break;
-            }
-            case Operation::Type::CY:
-            {
-                result.push_back(Operation(Operation::Type::SDG, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::S, {qubits[1]}, {}));
-                break;
-            }
-            case Operation::Type::CZ:
-            {
-                result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
-                break;
-            }
-            case Operation::Type::CH:
-            {
-                result.push_back(Operation(Operation::Type::S, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::T, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::TDG, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::SDG, {qubits[1]}, {}));
-                break;
-            }
-            case Operation::Type::CS:
-            {
-                result.push_back(Operation(Operation::Type::S, {qubits[0]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::SDG, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::S, {qubits[1]}, {}));
-                break;
-            }
-            case Operation::Type::CSDG:
-            {
-                result.push_back(Operation(Operation::Type::TDG, {qubits[0]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::T, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::TDG, {qubits[1]}, {}));
-                break;
-            }
-            case Operation::Type::CT:
-            {
-                result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {M_PI / 8}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {-M_PI / 8}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {M_PI / 8}));
-
-                break;
-            }
-            case Operation::Type::CTDG:
-            {
-                result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {-M_PI / 8}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {M_PI / 8}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {-M_PI / 8}));
-                break;
-            }
-            case Operation::Type::CSX:
-            {
+            Operation::Type type;
+            std::array<uint8_t, 2> slot;
+            double offset;
+            std::array<double, MAX_PARAMS> coeff;
 
-                result.push_back(Operation(Operation::Type::T, {qubits[0]}, {}));
-                result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::TDG, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::T, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
-                break;
-            }
-            case Operation::Type::CRX:
+            double angle(const Operation::ParamSpan &params) const
             {
-                result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[0] / 2}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {-params[0] / 2}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
-                break;
+                double value = 0.0;
+                bool first = true;
+                for (size_t k = std::min(params.size(), MAX_PARAMS); k-- > 0;)
+                {
+                    if (coeff[k] == 0.0)
+                        continue;
+                    value = first ? coeff[k] * params[k] : value + coeff[k] * params[k];
+                    first = false;
+                }
+                if (first)
+                    return offset;
+                return offset == 0.0 ? value : value + offset;
             }
-            case Operation::Type::CRY:
-            {
+        };
 
-                result.push_back(Operation(Operation::Type::SX, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[0] / 2}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {-params[0] / 2}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::SXDG, {qubits[1]}, {}));
-                break;
-            }
-            case Operation::Type::CRZ:
-            {
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[0] / 2}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {-params[0] / 2}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                break;
-            }
-            case Operation::Type::CP:
-            case Operation::Type::CU1:
-            {
-                result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[0] / 2}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {-params[0] / 2}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[0] / 2}));
-                break;
-            }
-            case Operation::Type::CU:
-            case Operation::Type::CU3:
-            {
+        struct Range
+        {
+            uint16_t begin = 0;
+            uint16_t size = 0; // 0: no template, the operation is kept
+        };
 
-                result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[3] + params[2] / 2 + params[1] / 2}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[2] / 2 - params[1] / 2}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {-params[2] / 2 - params[1] / 2}));
-                result.push_back(Operation(Operation::Type::SX, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {M_PI - params[0] / 2}));
-                result.push_back(Operation(Operation::Type::SX, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::Z, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::SX, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[0] / 2 + M_PI}));
-                result.push_back(Operation(Operation::Type::SX, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[1] + 3 * M_PI}));
-                break;
-            }
+        struct Templates
+        {
+            std::vector<TemplateGate> gates;
+            std::array<Range, Operation::NUM_TYPES> range{};
+        };
 
-            case Operation::Type::RXX:
-            {
+        /**
+         * @brief Check if an operation should be kept as-is without decomposition
+         */
+        bool should_keep_operation(const Operation &operation, const Circuit &circuit) const
+        {
+            return circuit.is_clifford_t_operation(operation.get_type()) ||
+                   (keep_ccx_ && operation.get_type() == Operation::Type::CCX);
+        }
 
-                result.push_back(Operation(Operation::Type::H, {qubits[0]}, {}));
-                result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[0]}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::H, {qubits[0]}, {}));
-                result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
-                break;
-            }
-            case Operation::Type::RYY:
-            {
+        static TemplateGate g(Operation::Type type, uint8_t a, uint8_t b = NO_SLOT)
+        {
+            return {type, {a, b}, 0.0, {}};
+        }
 
-                result.push_back(Operation(Operation::Type::SX, {qubits[0]}, {}));
-                result.push_back(Operation(Operation::Type::SX, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[0]}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::SXDG, {qubits[0]}, {}));
-                result.push_back(Operation(Operation::Type::SXDG, {qubits[1]}, {}));
-                break;
-            }
-            case Operation::Type::RZZ:
-            {
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[0]}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                break;
-            }
-            case Operation::Type::SWAP:
-            {
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[1], qubits[0]}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}));
-                break;
-            }
-            case Operation::Type::CCX:
-            {
-                result.push_back(Operation(Operation::Type::H, {qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[1], qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::TDG, {qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::T, {qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[1], qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::T, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::TDG, {qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::T, {qubits[0]}, {}));
-                result.push_back(Operation(Operation::Type::TDG, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::T, {qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::H, {qubits[2]}, {}));
+        static TemplateGate rz(uint8_t a, double offset, std::array<double, MAX_PARAMS> coeff = {})
+        {
+            return {Operation::Type::RZ, {a, NO_SLOT}, offset, coeff};
+        }
 
-                break;
-            }
-            case Operation::Type::CSWAP:
-            {
-                result.push_back(Operation(Operation::Type::CX, {qubits[2], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::H, {qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[1], qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::TDG, {qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::T, {qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[1], qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::T, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::TDG, {qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::T, {qubits[0]}, {}));
-                result.push_back(Operation(Operation::Type::TDG, {qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
-                result.push_back(Operation(Operation::Type::T, {qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::H, {qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[2], qubits[1]}, {}));
-                break;
-            }
-            case Operation::Type::RCCX:
-            {
-                result.push_back(Operation(Operation::Type::H, {qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::T, {qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[1], qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::TDG, {qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::T, {qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::CX, {qubits[1], qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::TDG, {qubits[2]}, {}));
-                result.push_back(Operation(Operation::Type::H, {qubits[2]}, {}));
-                break;
-            }
-            default:
-                // For unsupported operations, return empty vector
-                return {};
-            }
+        /**
+         * @brief Decomposition of every gate type into basis gates, built once
+         */
+        static const Templates &templates()
+        {
+            static const Templates table = build_templates();
+            return table;
+        }
 
-            return result;
+        static Templates build_templates()
+        {
+            using T = Operation::Type;
+            Templates table;
+            auto add = [&table](std::initializer_list<T> types, std::initializer_list<TemplateGate> gates)
+            {
+                Range range;
+                range.begin = static_cast<uint16_t>(table.gates.size());
+                range.size = static_cast<uint16_t>(gates.size());
+                table.gates.insert(table.gates.end(), gates);
+                for (T type : types)
+                    table.range[static_cast<size_t>(type)] = range;
+            };
+            const double h = 0.5;
+
+            add({T::RX}, {g(T::H, 0), rz(0, 0, {1}), g(T::H, 0)});
+            add({T::RY}, {g(T::SDG, 0), g(T::H, 0), rz(0, 0, {1}), g(T::H, 0), g(T::S, 0)});
+            add({T::P, T::U1}, {rz(0, 0, {1})});
+            // u(θ, φ, λ)
+            add({T::U, T::U3}, {rz(0, 0, {0, 0, 1}), g(T::SX, 0), rz(0, M_PI, {1}), g(T::SX, 0),
+                                rz(0, 3 * M_PI, {0, 1})});
+            // u2(φ, λ) = u(π/2, φ, λ)
+            add({T::U2}, {rz(0, 0, {0, 1}), g(T::SX, 0), g(T::S, 0), g(T::Z, 0), g(T::SX, 0),
+                          rz(0, -3 * M_PI, {1})});
+            add({T::CY}, {g(T::SDG, 1), g(T::CX, 0, 1), g(T::S, 1)});
+            add({T::CZ}, {g(T::H, 1), g(T::CX, 0, 1), g(T::H, 1)});
+            add({T::CH}, {g(T::S, 1), g(T::H, 1), g(T::T, 1), g(T::CX, 0, 1), g(T::TDG, 1), g(T::H, 1),
+                          g(T::SDG, 1)});
+            add({T::CS}, {g(T::S, 0), g(T::CX, 0, 1), g(T::SDG, 1), g(T::CX, 0, 1), g(T::S, 1)});
+            add({T::CSDG}, {g(T::TDG, 0), g(T::CX, 0, 1), g(T::T, 1), g(T::CX, 0, 1), g(T::TDG, 1)});
+            add({T::CT}, {rz(0, M_PI / 8), g(T::CX, 0, 1), rz(1, -M_PI / 8), g(T::CX, 0, 1), rz(1, M_PI / 8)});
+            add({T::CTDG}, {rz(0, -M_PI / 8), g(T::CX, 0, 1), rz(1, M_PI / 8), g(T::CX, 0, 1), rz(1, -M_PI / 8)});
+            add({T::CSX}, {g(T::T, 0), g(T::H, 1), g(T::CX, 0, 1), g(T::TDG, 1), g(T::CX, 0, 1), g(T::T, 1),
+                           g(T::H, 1)});
+            add({T::CRX}, {g(T::H, 1), rz(1, 0, {h}), g(T::CX, 0, 1), rz(1, 0, {-h}), g(T::CX, 0, 1), g(T::H, 1)});
+            add({T::CRY}, {g(T::SX, 1), rz(1, 0, {h}), g(T::CX, 0, 1), rz(1, 0, {-h}), g(T::CX, 0, 1),
+                           g(T::SXDG, 1)});
+            add({T::CRZ}, {rz(1, 0, {h}), g(T::CX, 0, 1), rz(1, 0, {-h}), g(T::CX, 0, 1)});
+            add({T::CP, T::CU1}, {rz(0, 0, {h}), g(T::CX, 0, 1), rz(1, 0, {-h}), g(T::CX, 0, 1), rz(1, 0, {h})});
+            // cu(θ, φ, λ, γ)
+            add({T::CU, T::CU3}, {rz(0, 0, {0, h, h, 1}), rz(1, 0, {0, -h, h}), g(T::CX, 0, 1),
+                                  rz(1, 0, {0, -h, -h}), g(T::SX, 1), rz(1, M_PI, {-h}), g(T::SX, 1), g(T::Z, 1),
+                                  g(T::CX, 0, 1), g(T::SX, 1), rz(1, M_PI, {h}), g(T::SX, 1),
+                                  rz(1, 3 * M_PI, {0, 1})});
+            add({T::RXX}, {g(T::H, 0), g(T::H, 1), g(T::CX, 0, 1), rz(1, 0, {1}), g(T::CX, 0, 1), g(T::H, 0),
+                           g(T::H, 1)});
+            add({T::RYY}, {g(T::SX, 0), g(T::SX, 1), g(T::CX, 0, 1), rz(1, 0, {1}), g(T::CX, 0, 1),
+                           g(T::SXDG, 0), g(T::SXDG, 1)});
+            add({T::RZZ}, {g(T::CX, 0, 1), rz(1, 0, {1}), g(T::CX, 0, 1)});
+            add({T::SWAP}, {g(T::CX, 0, 1), g(T::CX, 1, 0), g(T::CX, 0, 1)});
+            add({T::CCX}, {g(T::H, 2), g(T::CX, 1, 2), g(T::TDG, 2), g(T::CX, 0, 2), g(T::T, 2), g(T::CX, 1, 2),
+                           g(T::T, 1), g(T::TDG, 2), g(T::CX, 0, 2), g(T::CX, 0, 1), g(T::T, 0), g(T::TDG, 1),
+                           g(T::CX, 0, 1), g(T::T, 2), g(T::H, 2)});
+            add({T::CSWAP}, {g(T::CX, 2, 1), g(T::H, 2), g(T::CX, 1, 2), g(T::TDG, 2), g(T::CX, 0, 2), g(T::T, 2),
+                             g(T::CX, 1, 2), g(T::T, 1), g(T::TDG, 2), g(T::CX, 0, 2), g(T::CX, 0, 1), g(T::T, 0),
+                             g(T::TDG, 1), g(T::CX, 0, 1), g(T::T, 2), g(T::H, 2), g(T::CX, 2, 1)});
+            add({T::RCCX}, {g(T::H, 2), g(T::T, 2), g(T::CX, 1, 2), g(T::TDG, 2), g(T::CX, 0, 2), g(T::T, 2),
+                            g(T::CX, 1, 2), g(T::TDG, 2), g(T::H, 2)});
+            return table;
         }
 
-    private:
         bool keep_ccx_ = false;
     };
 
@@ -1,11 +1,10 @@
 #pragma once
 
-#include "nwqec/core/dag_circuit.hpp"
+#include "nwqec/core/clifford_t_reducer.hpp"
+#include "nwqec/core/single_qubit_runs.hpp"
 #include "pass_template.hpp"
 #include <vector>
 #include <cmath>
-#include <map>
-#include <set>
 
 namespace NWQEC
 {
@@ -23,57 +22,6 @@ namespace NWQEC
     private:
         const double TOLERANCE = 1e-10;
 
-        // Check if an operation is a single-qubit gate
-        bool is_single_qubit_gate(const Operation &op) const
-        {
-            return op.get_qubits().size() == 1 &&
-                   op.get_type() != Operation::Type::MEASURE &&
-                   op.get_type() != Operation::Type::RESET &&
-                   op.get_type() != Operation::Type::BARRIER;
-        }
-
-        // Check if two single-qubit gates can be combined
-        bool gates_commute_and_combine(Operation::Type gate1, Operation::Type gate2) const
-        {
-            // Pauli gates commute with themselves
-            if (gate1 == gate2 && (gate1 == Operation::Type::X ||
-                                   gate1 == Operation::Type::Y ||
-                                   gate1 == Operation::Type::Z))
-            {
-                return true;
-            }
-
-            // S and SDG cancel out
-            if ((gate1 == Operation::Type::S && gate2 == Operation::Type::SDG) ||
-                (gate1 == Operation::Type::SDG && gate2 == Operation::Type::S))
-            {
-                return true;
-            }
-
-            // T and TDG cancel out
-            if ((gate1 == Operation::Type::T && gate2 == Operation::Type::TDG) ||
-                (gate1 == Operation::Type::TDG && gate2 == Operation::Type::T))
-            {
-                return true;
-            }
-
-            // SX and SXDG cancel out
-            if ((gate1 == Operation::Type::SX && gate2 == Operation::Type::SXDG) ||
-                (gate1 == Operation::Type::SXDG && gate2 == Operation::Type::SX))
-            {
-                return true;
-            }
-
-            return false;
-        }
-
-        // Check if a gate is its own inverse (self-canceling)
-        bool is_self_inverse(Operation::Type gate) const
-        {
-            return gate == Operation::Type::X || gate == Operation::Type::Y ||
-                   gate == Operation::Type::Z || gate == Operation::Type::H;
-        }
-
         // Combine rotation gates with the same axis
         std::vector<Operation> combine_rotation_gates(const std::vector<Operation> &sequence) const
         {
@@ -171,102 +119,6 @@ namespace NWQEC
             return result;
         }
 
-        // Remove canceling gate pairs
-        std::vector<Operation> remove_canceling_gates(const std::vector<Operation> &sequence) const
-        {
-            std::vector<Operation> result;
-
-            for (size_t i = 0; i < sequence.size(); i++)
-            {
-                const Operation &current = sequence[i];
-
-                // Check for self-canceling pairs (e.g., X X = I)
-                if (i + 1 < sequence.size() && is_self_inverse(current.get_type()) &&
-                    current.get_type() == sequence[i + 1].get_type())
-                {
-                    i++; // Skip both operations
-                    continue;
-                }
-
-                // Check for inverse pairs (e.g., S SDG = I)
-                if (i + 1 < sequence.size() &&
-                    gates_commute_and_combine(current.get_type(), sequence[i + 1].get_type()))
-                {
-                    i++; // Skip both operations
-                    continue;
-                }
-
-                result.push_back(current);
-            }
-
-            return result;
-        }
-
-        // Extract consecutive single-qubit gate sequences using DAG traversal
-        std::vector<std::vector<std::pair<size_t, Operation>>> extract_consecutive_single_qubit_sequences(const DAGCircuit &dag) const
-        {
-            std::vector<std::vector<std::pair<size_t, Operation>>> sequences;
-            std::set<size_t> visited;
-            const auto &operations = dag.get_operations();
-
-            // For each operation, try to build a consecutive single-qubit sequence starting from it
-            for (size_t start_idx = 0; start_idx < operations.size(); start_idx++)
-            {
-                if (visited.count(start_idx) || !is_single_qubit_gate(operations[start_idx]))
-                {
-                    continue;
-                }
-
-                // Start building a sequence from this operation
-                std::vector<std::pair<size_t, Operation>> sequence;
-                size_t current_qubit = operations[start_idx].get_qubits()[0];
-                size_t current_idx = start_idx;
-
-                // Follow the chain of consecutive single-qubit gates on the same qubit
-                while (current_idx < operations.size() &&
-                       !visited.count(current_idx) &&
-                       is_single_qubit_gate(operations[current_idx]) &&
-                       operations[current_idx].get_qubits()[0] == current_qubit)
-                {
-                    sequence.push_back({current_idx, operations[current_idx]});
-                    visited.insert(current_idx);
-
-                    // Find the next operation on this qubit using DAG successors
-                    const auto &successors = dag.get_successors(current_idx);
-                    size_t next_idx = std::numeric_limits<size_t>::max();
-
-                    // Look for the immediate successor that operates on the same qubit
-                    for (const auto &succ : successors)
-                    {
-                        if (succ.qubit == current_qubit)
-                        {
-                            next_idx = succ.node;
-                            break;
-                        }
-                    }
-
-                    // If no valid successor found, or it's not a single-qubit gate on same qubit, break
-                    if (next_idx == std::numeric_limits<size_t>::max() ||
-                        next_idx >= operations.size() ||
-                        !is_single_qubit_gate(operations[next_idx]) ||
-                        operations[next_idx].get_qubits()[0] != current_qubit)
-                    {
-                        break;
-                    }
-
-                    current_idx = next_idx;
-                }
-
-                // Only add sequences with more than one gate (worth optimizing)
-                if (sequence.size() > 1)
-                {
-                    sequences.push_back(sequence);
-                }
-            }
-
-            return sequences;
-        }
-
     public:
         std::string get_name() const override
         {
@@ -275,100 +127,62 @@ namespace NWQEC
 
         bool run(Circuit &circuit) override
         {
-            // Convert to DAG for dependency analysis
-            DAGCircuit dag_circuit(circuit);
-
-            // Find consecutive single-qubit gate sequences
-            auto gate_sequences = extract_consecutive_single_qubit_sequences(dag_circuit);
-
-            if (gate_sequences.empty())
-                return false;
+            const auto &operations = circuit.get_operations();
+            SingleQubitRuns runs(operations, circuit.get_num_qubits());
 
+            // Optimize every run of two or more gates; apply the plan only if one changed
+            RewriteTable rewrites(operations.size());
             bool circuit_modified = false;
-            auto optimization_plan = create_optimization_plan(gate_sequences);
-
-            if (optimization_plan.has_optimizations)
+            std::vector<Operation> sequence;
+            for (size_t r = 0; r < runs.size(); ++r)
             {
-                circuit_modified = true;
-                apply_optimizations(circuit, optimization_plan);
-            }
-
-            return circuit_modified;
-        }
-
-    private:
-        struct OptimizationPlan
-        {
-            bool has_optimizations = false;
-            std::set<size_t> optimized_indices;
-            std::map<size_t, std::vector<Operation>> replacements;
-        };
-
-        /**
-         * @brief Create optimization plan for all gate sequences
-         */
-        OptimizationPlan create_optimization_plan(const std::vector<std::vector<std::pair<size_t, Operation>>> &sequences)
-        {
-            OptimizationPlan plan;
-
-            for (const auto &sequence : sequences)
-            {
-                if (sequence.size() <= 1)
-                    continue;
-
-                size_t first_index = sequence[0].first;
-
-                // Extract operations for optimization
-                std::vector<Operation> operations;
-                for (const auto &[index, operation] : sequence)
+                sequence.clear();
+                for (const size_t *it = runs.begin(r); it != runs.end(r); ++it)
                 {
-                    operations.push_back(operation);
-                    plan.optimized_indices.insert(index);
+                    // RZ_SEQ placeholders are fused as the gates they stand for
+                    if (operations[*it].get_type() == Operation::Type::RZ_SEQ)
+                        circuit.for_each_sequence_gate(operations[*it], [&sequence](Operation::Type type, size_t qubit)
+                                                       { sequence.push_back(Operation(type, {qubit})); });
+                    else
+                        sequence.push_back(operations[*it]);
                 }
+                if (sequence.size() <= 1)
+                    continue;
 
-                // Apply optimization transformations
-                auto optimized_ops = optimize_gate_sequence(operations);
-
-                // Check if optimization actually changed anything
-                if (optimized_ops.size() != operations.size() || !sequences_equal(optimized_ops, operations))
+                auto optimized_ops = optimize_gate_sequence(sequence);
+                if (!sequences_equal(optimized_ops, sequence))
                 {
-                    plan.has_optimizations = true;
+                    circuit_modified = true;
                 }
+                rewrites.replace_run(runs, r, optimized_ops);
+            }
 
-                plan.replacements[first_index] = std::move(optimized_ops);
+            if (circuit_modified)
+            {
+                apply_optimizations(circuit, rewrites);
             }
 
-            return plan;
+            return circuit_modified;
         }
 
+    private:
         /**
          * @brief Apply optimizations to the circuit
          */
-        void apply_optimizations(Circuit &circuit, const OptimizationPlan &plan)
+        void apply_optimizations(Circuit &circuit, const RewriteTable &rewrites)
         {
-            const auto &original_operations = circuit.get_operations();
+            std::vector<Operation> new_operations = rewrites.apply(circuit.get_operations());
 
             // Create new circuit and copy register information
             Circuit new_circuit;
             new_circuit.add_qreg("q", circuit.get_num_qubits());
             new_circuit.add_creg("c", circuit.get_num_bits());
+            new_circuit.set_rz_sequences(circuit.rz_sequences());
+            new_circuit.reserve_operations(new_operations.size());
 
-            for (size_t i = 0; i < original_operations.size(); ++i)
+            for (Operation &operation : new_operations)
             {
-                if (plan.replacements.count(i))
-                {
-                    // Add optimized sequence
-                    for (const auto &optimized_op : plan.replacements.at(i))
-                    {
-                        new_circuit.add_operation(optimized_op);
-                    }
-                }
-                else if (plan.optimized_indices.count(i) == 0)
-                {
-                    // Keep original operation if not part of optimized sequence
-                    new_circuit.add_operation(original_operations[i]);
-                }
-                // Skip operations that were part of optimized sequences but not the first index
+                new_circuit.add_operation(std::move(operation));
             }
 
             circuit = std::move(new_circuit);
@@ -376,12 +190,14 @@ namespace NWQEC
 
         /**
          * @brief Optimize a sequence of single-qubit gates
+         *
+         * Rotations about one axis are summed first; the Clifford+T stretches
+         * between the remaining gates are then reduced through CliffordTReducer.
          */
         std::vector<Operation> optimize_gate_sequence(const std::vector<Operation> &operations)
         {
             auto optimized = combine_rotation_gates(operations);
-            optimized = remove_canceling_gates(optimized);
-            return optimized;
+            return CliffordTReducer::reduce(optimized);
         }
 
         /**
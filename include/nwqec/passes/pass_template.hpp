@@ -7,10 +7,14 @@
 #include <memory>
 #include <string>
 #include <set>
+#include <map>
 
 
 namespace NWQEC
 {
+    // Named pass-specific measurements, e.g. the number of angles synthesized
+    using PassCounters = std::map<std::string, double>;
+
     /**
      * @brief Base class for all circuit transformation passes
      *
@@ -40,6 +44,16 @@ namespace NWQEC
          * @return The pass name
          */
         virtual std::string get_name() const = 0;
+
+        /**
+         * @brief Add the pass's own counters for its last run
+         *
+         * Only called when pass observers are registered, so passes need not
+         * track anything extra for it. The default reports nothing.
+         *
+         * @param counters Map to add entries to
+         */
+        virtual void report_counters(PassCounters &counters) const { (void)counters; }
     };
 
 } // namespace NWQEC
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "pass_template.hpp"
+#include "nwqec/tableau/clifford_frame.hpp"
 #include "nwqec/tableau/vtab.hpp"
 #include "nwqec/core/pauli_op.hpp"
 #include <iostream>
@@ -9,6 +10,7 @@
 #include <stdexcept>
 #include <cassert>
 #include <algorithm>
+#include <functional>
 
 namespace NWQEC
 {
@@ -16,31 +18,29 @@ namespace NWQEC
     {
     private:
         bool keep_cx;
+        size_t num_threads; // Tableau workers (0 = hardware concurrency)
+        bool streaming;     // Convert through stream() instead of a VTab over all rotations
 
     public:
-        PbcPass(bool keep_cx = false) : keep_cx(keep_cx) {}
+        PbcPass(bool keep_cx = false, size_t num_threads = 1, bool streaming = false)
+            : keep_cx(keep_cx), num_threads(num_threads), streaming(streaming) {}
 
         bool run(Circuit &circuit) override
         {
-            std::vector<Operation> operations = circuit.get_operations();
-            
-            // Check if circuit already contains PBC operations
-            bool has_pbc_operations = false;
-            for (const auto &op : operations) {
-                if (op.get_type() == Operation::Type::T_PAULI ||
-                    op.get_type() == Operation::Type::S_PAULI ||
-                    op.get_type() == Operation::Type::M_PAULI ||
-                    op.get_type() == Operation::Type::Z_PAULI) {
-                    has_pbc_operations = true;
-                    break;
-                }
-            }
-            
-            // If circuit already contains PBC operations, skip processing
-            if (has_pbc_operations) {
-                return false; // No modification needed
+            const std::vector<Operation> &operations = circuit.get_operations();
+            if (has_pbc_operations(operations))
+                return false; // Already in PBC form, no modification needed
+
+            if (streaming)
+            {
+                Circuit new_circuit;
+                new_circuit.add_qreg("q", circuit.get_num_qubits());
+                stream(circuit, [&](Operation &&op)
+                       { new_circuit.add_operation(std::move(op)); });
+                circuit = std::move(new_circuit);
+                return true;
             }
-            
+
             size_t n_qubits = circuit.get_num_qubits();
             size_t n_gate_stabs = 0;
             std::vector<Operation::Type> gate_types;
@@ -50,6 +50,21 @@ namespace NWQEC
             std::vector<PauliOp> pbc_stabs;
             std::vector<bool> is_t_stab;
 
+            auto add_gate = [&](Operation::Type type, size_t qubit_a, size_t qubit_b)
+            {
+                gate_types.push_back(type);
+                qubit_a_list.push_back(qubit_a);
+                qubit_b_list.push_back(qubit_b);
+                uint8_t phase = (type == Operation::Type::T) ? 0 : 1;
+                phase_bits.push_back(phase);
+
+                if (type == Operation::Type::T || type == Operation::Type::TDG)
+                {
+                    n_gate_stabs++;
+                    is_t_stab.push_back(true);
+                }
+            };
+
             // Process operations in reverse order - simpler approach without sequence optimization for now
             for (auto it = operations.rbegin(); it != operations.rend(); ++it)
             {
@@ -110,21 +125,19 @@ namespace NWQEC
                     n_gate_stabs++;
                     is_t_stab.push_back(false);
                 }
+                else if (it->get_type() == Operation::Type::RZ_SEQ)
+                {
+                    // The sequence's gates, last to first like the operations
+                    const std::vector<Operation::Type> &types = circuit.rz_sequence(*it).types;
+                    const size_t qubit = it->get_qubits()[0];
+                    for (auto type = types.rbegin(); type != types.rend(); ++type)
+                        add_gate(*type, qubit, SIZE_MAX);
+                }
                 else
                 {
                     // Add regular gate
                     auto qubits = it->get_qubits();
-                    gate_types.push_back(it->get_type());
-                    qubit_a_list.push_back(qubits[0]);
-                    qubit_b_list.push_back(qubits.size() > 1 ? qubits[1] : SIZE_MAX);
-                    uint8_t phase = (it->get_type() == Operation::Type::T) ? 0 : 1;
-                    phase_bits.push_back(phase);
-
-                    if (it->get_type() == Operation::Type::T || it->get_type() == Operation::Type::TDG)
-                    {
-                        n_gate_stabs++;
-                        is_t_stab.push_back(true);
-                    }
+                    add_gate(it->get_type(), qubits[0], qubits.size() > 1 ? qubits[1] : SIZE_MAX);
                 }
             }
 
@@ -132,27 +145,111 @@ namespace NWQEC
             assert(gate_types.size() == qubit_b_list.size());
             assert(gate_types.size() == phase_bits.size());
             // Create tableau with expanded gate list
-            VTab tableau(n_qubits, n_gate_stabs, gate_types, qubit_a_list, qubit_b_list, phase_bits, pbc_stabs);
-            std::vector<PauliOp> stabilizers = tableau.get_paili_ops();
+            VTab tableau(n_qubits, n_gate_stabs, gate_types, qubit_a_list, qubit_b_list, phase_bits, pbc_stabs, num_threads);
+            PauliTable stabilizers = tableau.get_pauli_table();
 
             update_circuit(stabilizers, circuit, is_t_stab);
             return true;
         }
 
+        // Receives each PBC operation as it is produced, in output order
+        using OperationSink = std::function<void(Operation &&)>;
+
+        /**
+         * @brief Convert circuit forwards, handing each operation to sink as it is final
+         *
+         * Produces the same operations as run(), in the same order, but keeps
+         * only a CliffordFrame of the gates seen so far instead of a tableau
+         * over every rotation: memory is O(n_qubits^2) bits whatever the gate
+         * count, and circuit is not modified.
+         *
+         * @return false (nothing emitted) if circuit already holds PBC operations
+         */
+        bool stream(const Circuit &circuit, const OperationSink &sink) const
+        {
+            const std::vector<Operation> &operations = circuit.get_operations();
+            if (has_pbc_operations(operations))
+                return false;
+
+            const size_t n_qubits = circuit.get_num_qubits();
+            CliffordFrame frame(n_qubits);
+            auto apply = [&](Operation::Type type, size_t qubit_a, size_t qubit_b)
+            {
+                if (type == Operation::Type::T || type == Operation::Type::TDG)
+                {
+                    sink(Operation(Operation::Type::T_PAULI, {}, {}, {},
+                                   frame.image_z(qubit_a, type == Operation::Type::TDG)));
+                }
+                else if (!frame.append_gate(type, qubit_a, qubit_b))
+                {
+                    std::cout << "Non-Clifford Gate!" << std::endl;
+                }
+            };
+            for (const Operation &op : operations)
+            {
+                const Operation::Type type = op.get_type();
+                if (type == Operation::Type::MEASURE ||
+                    type == Operation::Type::RESET ||
+                    type == Operation::Type::BARRIER)
+                    continue;
+
+                const Operation::QubitSpan qubits = op.get_qubits();
+                if (type == Operation::Type::CCX)
+                {
+                    // run() emits the seven rows of a CCX last to first
+                    std::vector<PauliOp> ccx_rows = PauliOp::create_ccx_ops(qubits[0], qubits[1], qubits[2], n_qubits);
+                    for (size_t i = ccx_rows.size(); i-- > 0;)
+                        sink(Operation(Operation::Type::T_PAULI, {}, {}, {}, frame.image(ccx_rows[i])));
+                }
+                else if (keep_cx && type == Operation::Type::CX)
+                {
+                    PauliOp stab(n_qubits);
+                    stab.add_z(qubits[0]);
+                    stab.add_x(qubits[1]);
+                    sink(Operation(Operation::Type::S_PAULI, {}, {}, {}, frame.image(stab)));
+                    frame.append_gate(Operation::Type::SXDG, qubits[1]);
+                    frame.append_gate(Operation::Type::SDG, qubits[0]);
+                }
+                else if (type == Operation::Type::RZ_SEQ)
+                {
+                    circuit.for_each_sequence_gate(op, [&apply](Operation::Type gate, size_t qubit)
+                                                   { apply(gate, qubit, SIZE_MAX); });
+                }
+                else
+                {
+                    apply(type, qubits[0], qubits.size() > 1 ? qubits[1] : SIZE_MAX);
+                }
+            }
+
+            for (size_t q = 0; q < n_qubits; ++q)
+                sink(Operation(Operation::Type::M_PAULI, {}, {}, {}, frame.image_z(q, false)));
+            return true;
+        }
+
         std::string get_name() const override
         {
             return "PBC Pass";
         }
 
     private:
-        void update_circuit(std::vector<PauliOp> &stabilizers, Circuit &circuit, std::vector<bool> &is_t_stab)
+        static bool has_pbc_operations(const std::vector<Operation> &operations)
         {
-            size_t n_qubits = circuit.get_num_qubits();
-            // First n stabilizers are measurement Pauli strings
-            std::vector<PauliOp> measurement_stabilizers(stabilizers.begin(), stabilizers.begin() + n_qubits);
+            for (const auto &op : operations)
+            {
+                if (op.get_type() == Operation::Type::T_PAULI ||
+                    op.get_type() == Operation::Type::S_PAULI ||
+                    op.get_type() == Operation::Type::M_PAULI ||
+                    op.get_type() == Operation::Type::Z_PAULI)
+                    return true;
+            }
+            return false;
+        }
 
-            // Remaining stabilizers are rotation Pauli strings (reverse order)
-            std::vector<PauliOp> rotation_stabilizers(stabilizers.begin() + n_qubits, stabilizers.end());
+        void update_circuit(const PauliTable &stabilizers, Circuit &circuit, std::vector<bool> &is_t_stab)
+        {
+            size_t n_qubits = circuit.get_num_qubits();
+            // First n stabilizers are measurement Pauli strings; the remaining
+            // ones are rotation Pauli strings (reverse order)
 
             // Build new circuit from stabilizers
             Circuit new_circuit;
@@ -162,27 +259,27 @@ namespace NWQEC
             std::reverse(is_t_stab.begin(), is_t_stab.end());
             size_t stab_idx = 0;
 
-            assert(rotation_stabilizers.size() == is_t_stab.size());
-            for (auto it = rotation_stabilizers.rbegin(); it != rotation_stabilizers.rend(); ++it)
+            assert(stabilizers.size() - n_qubits == is_t_stab.size());
+            for (size_t i = stabilizers.size(); i-- > n_qubits;)
             {
-                const PauliOp &pauli_op = *it;
-                
+                PauliOp pauli_op = stabilizers.to_pauli_op(i);
+
                 if (is_t_stab[stab_idx++])
                 {
                     // Add T_PAULI operation
-                    new_circuit.add_operation(Operation(Operation::Type::T_PAULI, {}, {}, {}, pauli_op));
+                    new_circuit.add_operation(Operation(Operation::Type::T_PAULI, {}, {}, {}, std::move(pauli_op)));
                 }
                 else
                 {
                     // Add S_PAULI operation
-                    new_circuit.add_operation(Operation(Operation::Type::S_PAULI, {}, {}, {}, pauli_op));
+                    new_circuit.add_operation(Operation(Operation::Type::S_PAULI, {}, {}, {}, std::move(pauli_op)));
                 }
             }
 
             // Add measurement operations
-            for (const auto &pauli_op : measurement_stabilizers)
+            for (size_t i = 0; i < n_qubits; ++i)
             {
-                new_circuit.add_operation(Operation(Operation::Type::M_PAULI, {}, {}, {}, pauli_op));
+                new_circuit.add_operation(Operation(Operation::Type::M_PAULI, {}, {}, {}, stabilizers.to_pauli_op(i)));
             }
 
             circuit = std::move(new_circuit);
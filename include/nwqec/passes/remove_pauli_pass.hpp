@@ -25,6 +25,7 @@ namespace NWQEC
 
         bool run(Circuit &circuit) override
         {
+            circuit.expand_rz_sequences(); // Sequences contain Pauli gates too
             bool circuit_modified = false;
             
             // Create new circuit and copy register information
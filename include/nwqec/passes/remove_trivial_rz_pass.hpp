@@ -1,13 +1,12 @@
 #pragma once
 
 #include "nwqec/core/circuit.hpp"
+#include "nwqec/core/angle_table.hpp"
+#include "nwqec/core/constants.hpp"
 #include "pass_template.hpp"
 #include <vector>
 #include <cmath>
 #include <string>
-#include <sstream>
-#include <iomanip>
-#include <set>
 #include <optional>
 #include <algorithm>
 
@@ -27,38 +26,6 @@ namespace NWQEC
     private:
         const double TOLERANCE = 1e-4;
 
-        /**
-         * @brief Convert angle to string with specified number of significant digits
-         * @param angle The angle to convert
-         * @param sig_digits Number of significant digits (default: 4)
-         */
-        std::string angle_to_string(double angle, int sig_digits = 4) const
-        {
-            if (angle == 0.0)
-            {
-                std::string result = "0.";
-                result.append(std::max(0, sig_digits - 1), '0');
-                return result;
-            }
-
-            // Get the order of magnitude
-            double abs_angle = std::abs(angle);
-            int order = static_cast<int>(std::floor(std::log10(abs_angle)));
-
-            // Scale to get specified significant digits
-            double scaled = abs_angle / std::pow(10, order - (sig_digits - 1));
-            int scaled_int = static_cast<int>(std::round(scaled));
-
-            // Convert back to the original scale
-            double rounded = scaled_int * std::pow(10, order - (sig_digits - 1));
-            if (angle < 0)
-                rounded = -rounded;
-
-            std::stringstream ss;
-            ss << std::fixed << std::setprecision(std::max(0, (sig_digits - 1) - order)) << rounded;
-            return ss.str();
-        }
-
     public:
         std::string get_name() const override
         {
@@ -67,6 +34,7 @@ namespace NWQEC
 
         bool run(Circuit &circuit) override
         {
+            circuit.expand_rz_sequences(); // Angle grouping indexes individual gates
             bool circuit_modified = false;
 
             // Create new circuit and copy register information
@@ -75,7 +43,7 @@ namespace NWQEC
             new_circuit.add_creg("c", circuit.get_num_bits());
 
             // Track distinct RZ angles for grouping
-            std::vector<std::string> distinct_angle_strings;
+            AngleTable angle_table;
 
             // Process each operation
             for (const auto &operation : circuit.get_operations())
@@ -87,12 +55,13 @@ namespace NWQEC
                 }
 
                 circuit_modified = true;
-                process_rz_gate(operation, new_circuit, distinct_angle_strings);
+                process_rz_gate(operation, new_circuit, angle_table);
             }
 
             // Replace circuit if modifications were made
             if (circuit_modified)
             {
+                new_circuit.distinct_rz_angles = angle_table.take_angles();
                 circuit = std::move(new_circuit);
             }
 
@@ -104,7 +73,7 @@ namespace NWQEC
          * @brief Process an RZ gate and add optimized operations to the circuit
          */
         void process_rz_gate(const Operation &operation, Circuit &new_circuit,
-                             std::vector<std::string> &distinct_angle_strings)
+                             AngleTable &angle_table)
         {
             auto params = operation.get_parameters();
             auto qubits = operation.get_qubits();
@@ -138,7 +107,7 @@ namespace NWQEC
             }
 
             // Keep as RZ gate with angle grouping
-            add_grouped_rz_gate(angle, qubits, new_circuit, distinct_angle_strings);
+            add_grouped_rz_gate(angle, qubits, new_circuit, angle_table);
         }
 
         /**
@@ -223,26 +192,16 @@ namespace NWQEC
          * @brief Add RZ gate with angle grouping for synthesis
          */
         void add_grouped_rz_gate(double angle, const std::vector<size_t> &qubits,
-                                 Circuit &new_circuit, std::vector<std::string> &distinct_angle_strings)
+                                 Circuit &new_circuit, AngleTable &angle_table)
         {
-            std::string angle_str = angle_to_string(angle);
-
-            auto it = std::find(distinct_angle_strings.begin(), distinct_angle_strings.end(), angle_str);
-            size_t angle_index;
-
-            if (it == distinct_angle_strings.end())
-            {
-                angle_index = distinct_angle_strings.size();
-                distinct_angle_strings.push_back(angle_str);
-                new_circuit.distinct_rz_angles.push_back(angle);
-            }
-            else
-            {
-                angle_index = std::distance(distinct_angle_strings.begin(), it);
-            }
+            // Group by canonical residual under the default synthesis tolerance
+            size_t angle_index = angle_table.intern(canonicalize_rz_angle(angle).residual,
+                                                    tolerance_bucket(DEFAULT_EPSILON_MULTIPLIER * std::abs(angle)));
 
             new_circuit.add_operation(Operation(Operation::Type::RZ, qubits, {angle}));
-            new_circuit.rz_angle_map[new_circuit.get_operations().size() - 1] = angle_index;
+            size_t op_index = new_circuit.get_operations().size() - 1;
+            new_circuit.rz_angle_index.resize(op_index + 1, AngleTable::NO_ANGLE);
+            new_circuit.rz_angle_index[op_index] = angle_index;
         }
     };
 
@@ -1,23 +1,125 @@
 #pragma once
 
 #include "nwqec/core/circuit.hpp"
+#include "nwqec/core/angle_table.hpp"
 #include "nwqec/gridsynth/gridsynth.hpp"
 #include "nwqec/core/constants.hpp"
+#include "nwqec/core/parallel.hpp"
+#include "nwqec/core/synthesis_backend.hpp"
+#include "nwqec/core/synthesis_cache.hpp"
+#include "nwqec/core/rz_table.hpp"
 
 #include "pass_template.hpp"
 #include <vector>
+#include <cstdint>
 #include <cmath>
+#include <limits>
 #include <chrono>
 #include <numeric>
 #include <algorithm>
 #include <iomanip>
-#include <map>
+#include <memory>
 #include <string>
 #include <sstream>
 #include <iostream>
 
 namespace NWQEC
 {
+    /**
+     * @brief Wall-clock limits (0 = unlimited) and search options for RZ synthesis
+     */
+    struct SynthesisLimits
+    {
+        int angle_timeout_ms = 0;      // Deadline for each distinct angle
+        int budget_ms = 0;             // Deadline for all synthesis in one pass run
+        bool race_diophantine = false; // See gridsynth::SynthesisContext::race_diophantine
+        size_t speculate_k = 0;        // See gridsynth::SynthesisContext::speculate_k
+        bool use_rz_table = true;      // Look angles up in RzTable::shipped() before synthesizing
+        bool defer_expansion = false;  // Emit RZ_SEQ placeholders instead of the gates of each RZ
+    };
+
+    /**
+     * @brief Gridsynth counters summed over the distinct angles of a synthesis run
+     *
+     * Times are summed over angles, so with several workers they exceed the
+     * wall-clock time of the run. The slowest angle is kept to make outliers
+     * easy to find.
+     */
+    struct SynthesisStats
+    {
+        size_t angles = 0;               // Distinct angle groups
+        size_t exact = 0;                // Multiples of pi/4, covered by the correction gates
+        size_t table_hits = 0;           // Served by the shipped RZ table
+        size_t cache_hits = 0;           // Served by the synthesis cache
+        size_t synthesized = 0;          // Sent to gridsynth
+        size_t failed = 0;               // Out of budget
+        double elapsed_ms = 0.0;
+        double to_upright_ms = 0.0;
+        double tdgp_ms = 0.0;
+        double diophantine_ms = 0.0;
+        size_t k_iterations = 0;
+        size_t tdgp_candidates = 0;
+        size_t diophantine_calls = 0;
+        size_t factoring_timeouts = 0;
+        size_t diophantine_timeouts = 0;
+        size_t boundary_rechecks = 0;
+        int max_k = 0;                   // Largest k any angle reached
+        int max_precision_bits = 0;      // Largest working MPFR precision
+        double slowest_angle = 0.0;      // Angle with the largest elapsed_ms
+        double slowest_ms = 0.0;
+
+        // Account for one angle sent to gridsynth
+        void add(double angle, const gridsynth::SynthesisResult &result)
+        {
+            ++synthesized;
+            failed += !result.success;
+            elapsed_ms += result.elapsed_ms;
+            to_upright_ms += result.to_upright_ms;
+            tdgp_ms += result.tdgp_ms;
+            diophantine_ms += result.diophantine_ms;
+            k_iterations += static_cast<size_t>(result.k_reached) + 1;
+            tdgp_candidates += static_cast<size_t>(result.tdgp_candidates);
+            diophantine_calls += static_cast<size_t>(result.diophantine_calls);
+            factoring_timeouts += static_cast<size_t>(result.factoring_timeouts);
+            diophantine_timeouts += static_cast<size_t>(result.diophantine_timeouts);
+            boundary_rechecks += static_cast<size_t>(result.boundary_rechecks);
+            max_k = std::max(max_k, result.k_reached);
+            max_precision_bits = std::max(max_precision_bits, result.precision_bits);
+            if (result.elapsed_ms > slowest_ms)
+            {
+                slowest_ms = result.elapsed_ms;
+                slowest_angle = angle;
+            }
+        }
+
+        void merge(const SynthesisStats &other)
+        {
+            angles += other.angles;
+            exact += other.exact;
+            table_hits += other.table_hits;
+            cache_hits += other.cache_hits;
+            synthesized += other.synthesized;
+            failed += other.failed;
+            elapsed_ms += other.elapsed_ms;
+            to_upright_ms += other.to_upright_ms;
+            tdgp_ms += other.tdgp_ms;
+            diophantine_ms += other.diophantine_ms;
+            k_iterations += other.k_iterations;
+            tdgp_candidates += other.tdgp_candidates;
+            diophantine_calls += other.diophantine_calls;
+            factoring_timeouts += other.factoring_timeouts;
+            diophantine_timeouts += other.diophantine_timeouts;
+            boundary_rechecks += other.boundary_rechecks;
+            max_k = std::max(max_k, other.max_k);
+            max_precision_bits = std::max(max_precision_bits, other.max_precision_bits);
+            if (other.slowest_ms > slowest_ms)
+            {
+                slowest_ms = other.slowest_ms;
+                slowest_angle = other.slowest_angle;
+            }
+        }
+    };
+
     /**
      * @brief Pass to optimize RZ gates
      *
@@ -28,21 +130,52 @@ namespace NWQEC
     private:
         const double synthesis_error_ = NWQEC::DEFAULT_EPSILON_MULTIPLIER; // Default synthesis error tolerance multiplier
         double epsilon_override_ = -1.0;                                   // If >=0, use this epsilon for all angles
+        size_t num_threads_ = 0;                                           // Synthesis workers (0 = hardware concurrency)
+        std::shared_ptr<SynthesisCache> cache_;                            // Optional persistent result cache
+        std::shared_ptr<SynthesisBackend> backend_;                        // Where missed angles go (null = in-process)
+        SynthesisLimits limits_;                                           // Per-angle and per-run deadlines
+        std::chrono::steady_clock::time_point run_deadline_;               // Deadline derived from limits_.budget_ms
+        SynthesisStats stats_;                                             // Counters of the last run
 
     public:
         SynthesizeRzPass() = default;
         explicit SynthesizeRzPass(double epsilon_override) : epsilon_override_(epsilon_override) {}
+        SynthesizeRzPass(double epsilon_override, size_t num_threads,
+                         std::shared_ptr<SynthesisCache> cache = nullptr,
+                         SynthesisLimits limits = {},
+                         std::shared_ptr<SynthesisBackend> backend = nullptr)
+            : epsilon_override_(epsilon_override), num_threads_(num_threads),
+              cache_(std::move(cache)), backend_(std::move(backend)), limits_(limits) {}
 
         std::string get_name() const override
         {
             return "Synthesize RZ Pass";
         }
 
+        // Gridsynth counters of the last run, also filled when it throws
+        const SynthesisStats &stats() const { return stats_; }
+
+        void report_counters(PassCounters &counters) const override
+        {
+            counters["angles"] = static_cast<double>(stats_.angles);
+            counters["synthesized"] = static_cast<double>(stats_.synthesized);
+            counters["table_hits"] = static_cast<double>(stats_.table_hits);
+            counters["cache_hits"] = static_cast<double>(stats_.cache_hits);
+            counters["failed"] = static_cast<double>(stats_.failed);
+            counters["tdgp_ms"] = stats_.tdgp_ms;
+            counters["diophantine_ms"] = stats_.diophantine_ms;
+            counters["diophantine_calls"] = static_cast<double>(stats_.diophantine_calls);
+            counters["slowest_ms"] = stats_.slowest_ms;
+        }
+
         bool run(Circuit &circuit) override
         {
 
             bool circuit_modified = false;
 
+            // Placeholders of an earlier run index that run's sequences
+            circuit.expand_rz_sequences();
+
             // Create new circuit and copy register information
             Circuit new_circuit;
             new_circuit.add_qreg("q", circuit.get_num_qubits());
@@ -51,11 +184,33 @@ namespace NWQEC
             // Ensure RZ angle grouping is done
             ensure_rz_angle_grouping(circuit);
 
+            run_deadline_ = std::chrono::steady_clock::time_point::max();
+            if (limits_.budget_ms > 0)
+                run_deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(limits_.budget_ms);
+
             // Pre-synthesize all distinct RZ angles
-            auto pre_synthesized_gates = synthesize_all_angles(circuit.distinct_rz_angles);
+            auto plans = plan_groups(circuit);
+            const std::vector<GateBlock> blocks = encode_sequences(synthesize_all_angles(plans));
 
-            // Process each operation
+            // Size the output from the known sequence lengths: a block plus at most
+            // two reflections and three corrections per RZ, or one placeholder
             const auto &operations = circuit.get_operations();
+            size_t output_size = 0;
+            for (size_t i = 0; i < operations.size(); ++i)
+            {
+                const size_t group = i < circuit.rz_angle_index.size() ? circuit.rz_angle_index[i] : AngleTable::NO_ANGLE;
+                if (operations[i].get_type() == Operation::Type::RZ && group < blocks.size() && !limits_.defer_expansion)
+                    output_size += blocks[group].size() + 5;
+                else
+                    output_size += 1;
+            }
+            new_circuit.reserve_operations(output_size);
+
+            std::vector<size_t> interned(limits_.defer_expansion ? blocks.size() * SEQUENCE_VARIANTS : 0, NO_SEQUENCE);
+            if (limits_.defer_expansion)
+                new_circuit.set_rz_sequences(intern_sequences(circuit, plans, blocks, interned));
+
+            // Process each operation
             for (size_t i = 0; i < operations.size(); ++i)
             {
                 const auto &operation = operations[i];
@@ -67,7 +222,10 @@ namespace NWQEC
                 }
 
                 circuit_modified = true;
-                synthesize_rz_operation(operation, i, circuit, pre_synthesized_gates, new_circuit);
+                if (limits_.defer_expansion)
+                    defer_rz_operation(operation, i, circuit, plans, blocks, interned, new_circuit);
+                else
+                    synthesize_rz_operation(operation, i, circuit, plans, blocks, new_circuit);
             }
 
             // Replace circuit if modifications were made
@@ -80,173 +238,389 @@ namespace NWQEC
         }
 
     private:
+        /**
+         * @brief What to synthesize for one angle group
+         */
+        struct GroupPlan
+        {
+            double angle = 0.0;                                   // Angle passed to gridsynth
+            double epsilon = std::numeric_limits<double>::infinity(); // Tightest member tolerance
+            bool canonical = false;                               // Members need a Clifford+T correction
+            size_t original = AngleTable::NO_ANGLE;               // Original-angle group of the first member
+        };
+
+        /**
+         * @brief Absolute synthesis tolerance for a single RZ angle
+         */
+        double angle_epsilon(double angle) const
+        {
+            return (epsilon_override_ >= 0.0) ? epsilon_override_ : synthesis_error_ * std::abs(angle);
+        }
+
         /**
          * @brief Ensure RZ angle grouping is performed if not already done
+         *
+         * Angles are grouped by canonical residual and tolerance bucket. Grouping left
+         * by RemoveTrivialRzPass assumes the default tolerance, so it is redone when an
+         * epsilon override puts every angle in the same bucket.
          */
         void ensure_rz_angle_grouping(Circuit &circuit)
         {
-            if (!circuit.distinct_rz_angles.empty())
+            if (!circuit.distinct_rz_angles.empty() && epsilon_override_ < 0.0)
                 return;
 
-            std::vector<double> distinct_angles;
-            std::vector<std::string> distinct_angle_strings;
-            std::map<size_t, size_t> rz_angle_map;
-
+            AngleTable table;
             const auto &operations = circuit.get_operations();
+            std::vector<size_t> rz_angle_index(operations.size(), AngleTable::NO_ANGLE);
+
             for (size_t i = 0; i < operations.size(); ++i)
             {
                 const auto &operation = operations[i];
                 if (operation.get_type() == Operation::Type::RZ)
                 {
-                    auto params = operation.get_parameters();
+                    const auto &params = operation.get_parameters();
                     if (!params.empty())
-                    {
-                        double angle = params[0];
-                        std::string angle_str = angle_to_string(angle);
-
-                        auto it = std::find(distinct_angle_strings.begin(), distinct_angle_strings.end(), angle_str);
-                        size_t angle_index;
-
-                        if (it == distinct_angle_strings.end())
-                        {
-                            angle_index = distinct_angle_strings.size();
-                            distinct_angle_strings.push_back(angle_str);
-                            distinct_angles.push_back(angle);
-                        }
-                        else
-                        {
-                            angle_index = std::distance(distinct_angle_strings.begin(), it);
-                        }
-
-                        rz_angle_map[i] = angle_index;
-                    }
+                        rz_angle_index[i] = table.intern(canonicalize_rz_angle(params[0]).residual,
+                                                         tolerance_bucket(angle_epsilon(params[0])));
                 }
             }
 
-            circuit.distinct_rz_angles = std::move(distinct_angles);
-            circuit.rz_angle_map = std::move(rz_angle_map);
+            circuit.distinct_rz_angles = table.take_angles();
+            circuit.rz_angle_index = std::move(rz_angle_index);
         }
 
         /**
-         * @brief Synthesize all distinct RZ angles
+         * @brief Decide the synthesis target and tolerance of each angle group
+         *
+         * A group whose members all share one original angle is synthesized directly,
+         * avoiding correction gates. A group that merged different angles is synthesized
+         * at its canonical residual, and each member is corrected exactly on expansion.
+         * Either way the group uses the tightest tolerance among its members.
          */
-        std::vector<std::string> synthesize_all_angles(const std::vector<double> &angles)
+        std::vector<GroupPlan> plan_groups(const Circuit &circuit) const
         {
-            std::vector<std::string> synthesized_gates;
-            synthesized_gates.reserve(angles.size());
+            const auto &groups = circuit.distinct_rz_angles;
+            std::vector<GroupPlan> plans(groups.size());
+            AngleTable originals;
 
-            for (const auto &angle : angles)
+            const auto &operations = circuit.get_operations();
+            size_t n = std::min(operations.size(), circuit.rz_angle_index.size());
+            for (size_t i = 0; i < n; ++i)
             {
-                synthesized_gates.push_back(synthesize_angle(angle));
+                size_t group = circuit.rz_angle_index[i];
+                if (group >= groups.size() || operations[i].get_parameters().empty())
+                    continue;
+
+                double angle = operations[i].get_parameters()[0];
+                size_t original = originals.intern(angle);
+                GroupPlan &plan = plans[group];
+                if (plan.original == AngleTable::NO_ANGLE)
+                {
+                    plan.original = original;
+                    plan.angle = angle;
+                }
+                else if (plan.original != original)
+                {
+                    plan.canonical = true;
+                }
+                plan.epsilon = std::min(plan.epsilon, angle_epsilon(angle));
             }
 
-            return synthesized_gates;
+            for (size_t g = 0; g < groups.size(); ++g)
+            {
+                if (plans[g].original == AngleTable::NO_ANGLE)
+                {
+                    plans[g].canonical = true;
+                    plans[g].epsilon = angle_epsilon(groups[g]);
+                }
+                if (plans[g].canonical)
+                    plans[g].angle = groups[g];
+            }
+            return plans;
         }
 
         /**
-         * @brief Synthesize a single RZ operation
+         * @brief Synthesize all distinct RZ angles
+         *
+         * Angles missing from the cache go to the backend, by default gridsynth_batch,
+         * which synthesizes them concurrently with per-worker solver state. Each result
+         * is written to its own slot, making the output identical to a serial run.
+         * Throws if any angle could not be synthesized within its limits, since
+         * dropping the rotation would silently change the circuit.
          */
-        void synthesize_rz_operation(const Operation &operation, size_t operation_index,
-                                     const Circuit &circuit, const std::vector<std::string> &pre_synthesized_gates,
-                                     Circuit &new_circuit)
+        std::vector<std::string> synthesize_all_angles(const std::vector<GroupPlan> &plans)
         {
-            auto qubits = operation.get_qubits();
+            std::vector<gridsynth::SynthesisResult> results(plans.size());
+            stats_ = SynthesisStats{};
+            stats_.angles = plans.size();
+
+            // Resolve zero residuals, table and cache hits; batch the rest
+            const RzTable *table = limits_.use_rz_table ? RzTable::shipped() : nullptr;
+            std::vector<size_t> pending;
+            std::vector<std::string> thetas;
+            std::vector<std::string> epsilons;
+            for (size_t i = 0; i < plans.size(); ++i)
+            {
+                // A zero residual is an exact multiple of π/4, fully covered by the correction
+                if (plans[i].angle == 0.0)
+                {
+                    results[i].success = true;
+                    ++stats_.exact;
+                    continue;
+                }
+                std::string theta = synthesis_theta_string(plans[i].angle);
+                std::string epsilon = synthesis_epsilon_string(plans[i].epsilon);
+                if (table)
+                {
+                    if (auto stored = table->lookup(theta, epsilon))
+                    {
+                        results[i].success = true;
+                        results[i].gates = std::move(*stored);
+                        ++stats_.table_hits;
+                        continue;
+                    }
+                }
+                if (cache_)
+                {
+                    if (auto cached = cache_->lookup(plans[i].angle, plans[i].epsilon, limits_.race_diophantine))
+                    {
+                        results[i].success = true;
+                        results[i].gates = std::move(*cached);
+                        ++stats_.cache_hits;
+                        continue;
+                    }
+                }
+                pending.push_back(i);
+                thetas.push_back(std::move(theta));
+                epsilons.push_back(std::move(epsilon));
+            }
 
-            auto angle_map_it = circuit.rz_angle_map.find(operation_index);
-            if (angle_map_it == circuit.rz_angle_map.end() || pre_synthesized_gates.empty())
+            gridsynth::BatchOptions options;
+            options.budget.deadline = run_deadline_;
+            options.angle_timeout_ms = limits_.angle_timeout_ms;
+            options.num_threads = num_threads_;
+            options.race_diophantine = limits_.race_diophantine;
+            options.speculate_k = limits_.speculate_k;
+
+            std::vector<gridsynth::SynthesisResult> batch;
+            try
             {
-                throw std::runtime_error("RZ gate found without corresponding pre-synthesized gate");
+                LocalSynthesisBackend local;
+                SynthesisBackend &backend = backend_ ? *backend_ : local;
+                batch = backend.synthesize(thetas, epsilons, options);
+                if (batch.size() != thetas.size())
+                    throw std::runtime_error(backend.name() + " backend returned " + std::to_string(batch.size()) +
+                                             " results for " + std::to_string(thetas.size()) + " angles");
+            }
+            catch (const std::exception &e)
+            {
+                throw std::runtime_error(std::string("Failed to synthesize RZ angles: ") + e.what());
             }
 
-            const std::string &gate_sequence = pre_synthesized_gates[angle_map_it->second];
-            add_gate_sequence_to_circuit(gate_sequence, qubits, new_circuit);
-        }
+            for (size_t j = 0; j < pending.size(); ++j)
+            {
+                const size_t i = pending[j];
+                stats_.add(plans[i].angle, batch[j]);
+                if (batch[j].success && cache_)
+                    cache_->insert(plans[i].angle, plans[i].epsilon, batch[j].gates, limits_.race_diophantine);
+                results[i] = std::move(batch[j]);
+            }
 
-        /**
-         * @brief Convert angle to string with specified number of significant digits
-         * @param angle The angle to convert
-         * @param sig_digits Number of significant digits (default: 4)
-         */
-        std::string angle_to_string(double angle, int sig_digits = 4) const
-        {
-            if (angle == 0.0)
+            std::vector<std::string> synthesized_gates;
+            synthesized_gates.reserve(results.size());
+            size_t failed = 0;
+            size_t first_failed = 0;
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                if (!results[i].success && failed++ == 0)
+                    first_failed = i;
+                synthesized_gates.push_back(std::move(results[i].gates));
+            }
+
+            if (failed > 0)
             {
-                std::string result = "0.";
-                result.append(std::max(0, sig_digits - 1), '0');
-                return result;
+                const auto &r = results[first_failed];
+                std::ostringstream msg;
+                msg << "RZ synthesis exceeded its budget for " << failed << " of " << results.size()
+                    << " distinct angles (first: angle " << plans[first_failed].angle
+                    << ", k reached " << r.k_reached
+                    << ", " << r.diophantine_calls << " diophantine calls, "
+                    << (r.timed_out ? "timed out" : "iteration limit") << ")";
+                throw std::runtime_error(msg.str());
             }
 
-            // Get the order of magnitude
-            double abs_angle = std::abs(angle);
-            int order = static_cast<int>(std::floor(std::log10(abs_angle)));
+            return synthesized_gates;
+        }
 
-            // Scale to get specified significant digits
-            double scaled = abs_angle / std::pow(10, order - (sig_digits - 1));
-            int scaled_int = static_cast<int>(std::round(scaled));
+        // Sequences per group: the block alone, or with one of 8 T^k corrections, reflected or not
+        static constexpr size_t SEQUENCE_VARIANTS = 17;
+        static constexpr size_t NO_SEQUENCE = SIZE_MAX;
 
-            // Convert back to the original scale
-            double rounded = scaled_int * std::pow(10, order - (sig_digits - 1));
-            if (angle < 0)
-                rounded = -rounded;
+        // Angle group of a synthesized RZ operation
+        static size_t group_of(size_t operation_index, const Circuit &circuit, const std::vector<GateBlock> &blocks)
+        {
+            if (operation_index >= circuit.rz_angle_index.size() ||
+                circuit.rz_angle_index[operation_index] >= blocks.size())
+            {
+                throw std::runtime_error("RZ gate found without corresponding pre-synthesized gate");
+            }
+            return circuit.rz_angle_index[operation_index];
+        }
 
-            std::stringstream ss;
-            ss << std::fixed << std::setprecision(std::max(0, (sig_digits - 1) - order)) << rounded;
-            return ss.str();
+        /**
+         * @brief Build every sequence the RZ_SEQ placeholders of circuit will index
+         *
+         * Each sequence stands for exactly the gates synthesize_rz_operation
+         * would append for its group and correction, and is added once;
+         * interned maps group and variant to its index. The table is complete
+         * before any placeholder refers to it, so circuits copied from the
+         * output share it without further changes.
+         */
+        std::shared_ptr<const std::vector<GateBlock>> intern_sequences(const Circuit &circuit,
+                                                                       const std::vector<GroupPlan> &plans,
+                                                                       const std::vector<GateBlock> &blocks,
+                                                                       std::vector<size_t> &interned) const
+        {
+            std::vector<GateBlock> sequences;
+            const auto &operations = circuit.get_operations();
+            for (size_t i = 0; i < operations.size(); ++i)
+            {
+                if (operations[i].get_type() != Operation::Type::RZ)
+                    continue;
+                CanonicalRz canonical{0.0, 0, false};
+                size_t &index = interned[sequence_slot(operations[i], i, circuit, plans, blocks, canonical)];
+                if (index != NO_SEQUENCE)
+                    continue;
+                const size_t group = group_of(i, circuit, blocks);
+                GateBlock sequence;
+                if (canonical.reflected)
+                    sequence.push_back(Operation::Type::X);
+                for (Operation::Type type : blocks[group].types)
+                    sequence.push_back(type);
+                if (canonical.reflected)
+                    sequence.push_back(Operation::Type::X);
+                if (canonical.t_count & 4u)
+                    sequence.push_back(Operation::Type::Z);
+                if (canonical.t_count & 2u)
+                    sequence.push_back(Operation::Type::S);
+                if (canonical.t_count & 1u)
+                    sequence.push_back(Operation::Type::T);
+                index = sequences.size();
+                sequences.push_back(std::move(sequence));
+            }
+            return std::make_shared<const std::vector<GateBlock>>(std::move(sequences));
         }
 
-        std::string synthesize_angle(double angle)
+        // Index into interned of an RZ operation's sequence, with its correction
+        size_t sequence_slot(const Operation &operation, size_t operation_index, const Circuit &circuit,
+                             const std::vector<GroupPlan> &plans, const std::vector<GateBlock> &blocks,
+                             CanonicalRz &canonical) const
         {
-            try
+            const size_t group = group_of(operation_index, circuit, blocks);
+            size_t variant = 0;
+            if (plans[group].canonical)
             {
-                std::string theta = std::to_string(angle);
-                // Choose epsilon: explicit override or default multiplier rule
-                double epsilon_abs = (epsilon_override_ >= 0.0) ? epsilon_override_ : synthesis_error_ * std::abs(angle);
-                // Call the gridsynth function with epsilon in scientific notation to avoid truncation
-                std::ostringstream eps_ss;
-                eps_ss.setf(std::ios::scientific);
-                eps_ss << std::setprecision(16) << epsilon_abs;
-                return gridsynth::gridsynth_gates(theta, eps_ss.str());
+                canonical = canonicalize_rz_angle(operation.get_parameters()[0]);
+                variant = 1 + canonical.t_count * 2 + (canonical.reflected ? 1 : 0);
             }
-            catch (const std::exception &e)
+            return group * SEQUENCE_VARIANTS + variant;
+        }
+
+        /**
+         * @brief Replace a single RZ operation by an RZ_SEQ placeholder
+         *
+         * The placeholder indexes the sequence intern_sequences built for it.
+         */
+        void defer_rz_operation(const Operation &operation, size_t operation_index,
+                                const Circuit &circuit, const std::vector<GroupPlan> &plans,
+                                const std::vector<GateBlock> &blocks, const std::vector<size_t> &interned,
+                                Circuit &new_circuit) const
+        {
+            CanonicalRz canonical{0.0, 0, false};
+            const size_t index = interned[sequence_slot(operation, operation_index, circuit, plans, blocks, canonical)];
+            if ((*new_circuit.rz_sequences())[index].empty())
+                return;
+            new_circuit.add_operation(Operation::rz_seq(operation.get_qubits()[0], index));
+        }
+
+        /**
+         * @brief Synthesize a single RZ operation
+         */
+        void synthesize_rz_operation(const Operation &operation, size_t operation_index,
+                                     const Circuit &circuit, const std::vector<GroupPlan> &plans,
+                                     const std::vector<GateBlock> &blocks, Circuit &new_circuit)
+        {
+            auto qubits = operation.get_qubits();
+
+            size_t group = group_of(operation_index, circuit, blocks);
+            const GateBlock &block = blocks[group];
+            if (!plans[group].canonical)
             {
-                std::cerr << "Warning: Failed to synthesize RZ angle " << angle
-                          << ": " << e.what() << std::endl;
-                std::cerr << "Falling back to identity (no gates)" << std::endl;
-                return ""; // Return empty string as fallback
+                new_circuit.append_block(block, qubits[0]);
+                return;
             }
+
+            CanonicalRz canonical = canonicalize_rz_angle(operation.get_parameters()[0]);
+
+            if (canonical.reflected)
+                new_circuit.add_operation(Operation(Operation::Type::X, qubits));
+            new_circuit.append_block(block, qubits[0]);
+            if (canonical.reflected)
+                new_circuit.add_operation(Operation(Operation::Type::X, qubits));
+
+            // Exact T^k correction, k = 4z + 2s + t
+            if (canonical.t_count & 4u)
+                new_circuit.add_operation(Operation(Operation::Type::Z, qubits));
+            if (canonical.t_count & 2u)
+                new_circuit.add_operation(Operation(Operation::Type::S, qubits));
+            if (canonical.t_count & 1u)
+                new_circuit.add_operation(Operation(Operation::Type::T, qubits));
         }
 
-        void add_gate_sequence_to_circuit(const std::string &gate_sequence, const std::vector<size_t> &qubits, Circuit &circuit)
+        /**
+         * @brief Encode each synthesized gate string once as a block of gate types
+         */
+        std::vector<GateBlock> encode_sequences(const std::vector<std::string> &gate_sequences) const
         {
-            for (const char &gate : gate_sequence)
+            std::vector<GateBlock> blocks(gate_sequences.size());
+            for (size_t g = 0; g < gate_sequences.size(); ++g)
             {
-                switch (gate)
+                GateBlock &block = blocks[g];
+                block.types.reserve(gate_sequences[g].size());
+                for (const char gate : gate_sequences[g])
                 {
-                case 'X':
-                    circuit.add_operation(Operation(Operation::Type::X, qubits));
-                    break;
-                case 'Y':
-                    circuit.add_operation(Operation(Operation::Type::Y, qubits));
-                    break;
-                case 'Z':
-                    circuit.add_operation(Operation(Operation::Type::Z, qubits));
-                    break;
-                case 'H':
-                    circuit.add_operation(Operation(Operation::Type::H, qubits));
-                    break;
-                case 'S':
-                    circuit.add_operation(Operation(Operation::Type::S, qubits));
-                    break;
-                case 'T':
-                    circuit.add_operation(Operation(Operation::Type::T, qubits));
-                    break;
-                case 'W':
-                    // Skip global phase
-                    break;
-                default:
-                    std::cerr << "Unknown gate type: " << gate << std::endl;
+                    switch (gate)
+                    {
+                    case 'X':
+                        block.push_back(Operation::Type::X);
+                        break;
+                    case 'Y':
+                        block.push_back(Operation::Type::Y);
+                        break;
+                    case 'Z':
+                        block.push_back(Operation::Type::Z);
+                        break;
+                    case 'H':
+                        block.push_back(Operation::Type::H);
+                        break;
+                    case 'S':
+                        block.push_back(Operation::Type::S);
+                        break;
+                    case 'T':
+                        block.push_back(Operation::Type::T);
+                        break;
+                    case 'W':
+                        // Skip global phase
+                        break;
+                    case 'I':
+                        // Identity: the angle is within epsilon of zero
+                        break;
+                    default:
+                        std::cerr << "Unknown gate type: " << gate << std::endl;
+                    }
                 }
             }
+            return blocks;
         }
     };
 
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "nwqec/core/circuit.hpp"
+#include "nwqec/core/debug_dump.hpp"
+#include "nwqec/core/parallel.hpp"
 #include "pass_template.hpp"
 
 #include "nwqec/tableau/htab.hpp"
+#include "nwqec/tableau/layer_index.hpp"
 
 #include <vector>
 #include <unordered_map>
@@ -14,7 +17,7 @@
 #include <chrono>
 #include <iostream>
 #include <iomanip>
-#include <fstream>
+#include <memory>
 #include <cstdlib>
 
 namespace NWQEC
@@ -24,9 +27,13 @@ namespace NWQEC
     {
     private:
         mutable size_t num_qubits_ = 0;
+        size_t num_threads_ = 1; // Workers reducing layers (0 = hardware concurrency)
+        std::shared_ptr<DumpSink> dump_sink_; // Receives the optimized circuit when set
 
     public:
         TfusePass() {}
+        explicit TfusePass(size_t num_threads, std::shared_ptr<DumpSink> dump_sink = nullptr)
+            : num_threads_(num_threads), dump_sink_(std::move(dump_sink)) {}
 
         bool run(Circuit &circuit) override
         {
@@ -34,16 +41,13 @@ namespace NWQEC
 
             const auto &operations = circuit.get_operations();
 
-            // Write original circuit before optimization
-            // write_operations_to_file(operations, num_qubits_, "original_circuit.qasm");
-
             if (!verify_pure_t_pauli_circuit(operations))
                 return false;
 
-            std::pair<std::vector<PauliOp>, std::vector<PauliOp>> pauli_rows = get_pauli_rows(operations);
+            std::pair<PauliTable, PauliTable> pauli_rows = get_pauli_rows(operations);
 
-            std::vector<PauliOp> t_pauli_rows = std::move(pauli_rows.first);
-            std::vector<PauliOp> m_pauli_rows = std::move(pauli_rows.second);
+            PauliTable t_pauli_rows = std::move(pauli_rows.first);
+            PauliTable m_pauli_rows = std::move(pauli_rows.second);
 
             // // Quick check for layering benefit
             // auto greedy_layers = create_layers_greedy(t_pauli_rows);
@@ -71,51 +75,63 @@ namespace NWQEC
 
             // std::cout << "Total M-Pauli gates: " << m_pauli_rows.size() << std::endl;
 
-            HTab m_tab(num_qubits_);
-            for (const auto &row : m_pauli_rows)
+            // Instantiate the tableau code for this circuit's row width once
+            return dispatch_pauli_width(t_pauli_rows.stride(), [&](auto width)
+                                        { return fuse<decltype(width)::value>(circuit, t_pauli_rows, m_pauli_rows); });
+        }
+
+        std::string get_name() const override
+        {
+            return "Tfuse Pass";
+        }
+
+    private:
+        template <size_t W>
+        bool fuse(Circuit &circuit, const PauliTable &t_pauli_rows, const PauliTable &m_pauli_rows)
+        {
+            BasicHTab<W> m_tab(num_qubits_);
+            for (size_t i = 0; i < m_pauli_rows.size(); ++i)
             {
                 // Add measurement Pauli rows to tableau
-                m_tab.add_stab(row);
+                m_tab.add_stab(m_pauli_rows.row(i));
             }
 
-            auto optimized_rows = optimize(t_pauli_rows);
+            auto optimized_rows = optimize<W>(t_pauli_rows);
 
-            std::vector<PauliOp> final_t_rows = std::move(optimized_rows.first);
-            std::vector<PauliOp> final_s_rows = std::move(optimized_rows.second);
+            PauliTable final_t_rows = std::move(optimized_rows.first);
+            PauliTable final_s_rows = std::move(optimized_rows.second);
 
+            // Rounds after the first only merge around the rows that changed;
+            // optimize skips every layer without a repeated Pauli string
             while (true)
             {
-                optimized_rows = optimize(final_t_rows);
+                optimized_rows = optimize<W>(final_t_rows);
 
                 final_t_rows = std::move(optimized_rows.first);
-                final_s_rows.insert(final_s_rows.end(), optimized_rows.second.begin(), optimized_rows.second.end());
+                final_s_rows.append(optimized_rows.second);
 
                 if (optimized_rows.second.empty()) // No more S-Pauli rows produced
                     break;
             }
 
-            for (const auto &s_row : final_s_rows)
-            {
-                // Multiply S-Pauli rows with measurement tableau
-                m_tab.front_multiply_pauli(s_row);
-            }
-            std::vector<PauliOp> m_tab_rows = m_tab.get_rows();
+            // Multiply S-Pauli rows with measurement tableau
+            m_tab.front_multiply_paulis(final_s_rows);
+            PauliTable m_tab_rows = m_tab.get_table();
 
             update_circuit(circuit, final_t_rows, m_tab_rows);
 
-            // Write optimized circuit after optimization
-            std::vector<Operation> optimized_operations = circuit.get_operations();
-            write_operations_to_file(optimized_operations, num_qubits_, "optimized_circuit.qasm", final_s_rows);
+            // The sink formats and writes on its own time from copies made here
+            if (dump_sink_)
+            {
+                dump_sink_->dump("optimized_circuit.qasm",
+                                 [operations = circuit.get_operations(), num_qubits = num_qubits_,
+                                  s_pauli_rows = std::move(final_s_rows)](std::ostream &os)
+                                 { write_operations(os, operations, num_qubits, s_pauli_rows); });
+            }
 
             return true;
         }
 
-        std::string get_name() const override
-        {
-            return "Tfuse Pass";
-        }
-
-    private:
         bool verify_pure_t_pauli_circuit(const std::vector<Operation> &operations) const
         {
             for (const auto &op : operations)
@@ -129,10 +145,10 @@ namespace NWQEC
             return true;
         }
 
-        std::pair<std::vector<PauliOp>, std::vector<PauliOp>> get_pauli_rows(const std::vector<Operation> &operations) const
+        std::pair<PauliTable, PauliTable> get_pauli_rows(const std::vector<Operation> &operations) const
         {
-            std::vector<PauliOp> t_pauli_rows;
-            std::vector<PauliOp> m_pauli_rows;
+            PauliTable t_pauli_rows(num_qubits_);
+            PauliTable m_pauli_rows(num_qubits_);
 
             t_pauli_rows.reserve(operations.size());
 
@@ -140,15 +156,11 @@ namespace NWQEC
             {
                 if (it->get_type() == Operation::Type::T_PAULI)
                 {
-                    PauliOp row(num_qubits_);
-                    row.from_string(it->get_pauli_string());
-                    t_pauli_rows.push_back(row);
+                    push_pauli_row(t_pauli_rows, it->get_pauli_op());
                 }
                 else if (it->get_type() == Operation::Type::M_PAULI)
                 {
-                    PauliOp row(num_qubits_);
-                    row.from_string(it->get_pauli_string());
-                    m_pauli_rows.push_back(row);
+                    push_pauli_row(m_pauli_rows, it->get_pauli_op());
                 }
                 else
                 {
@@ -156,86 +168,104 @@ namespace NWQEC
                 }
             }
 
-            return {t_pauli_rows, m_pauli_rows};
+            return {std::move(t_pauli_rows), std::move(m_pauli_rows)};
+        }
+
+        // Copy an operation's Pauli string into table as a fresh T row
+        void push_pauli_row(PauliTable &table, const PauliOp &op) const
+        {
+            if (op.get_num_qubits() == num_qubits_)
+            {
+                size_t idx = table.push_back(op);
+                table.set_rowtype(idx, RowType::T);
+                table.set_valid(idx, true);
+                return;
+            }
+            // Width differs from the circuit (e.g. parsed input): re-read the string
+            PauliOp row(num_qubits_);
+            row.from_string(op.to_string());
+            table.push_back(row);
         }
 
-        std::vector<HTab> create_layers(const std::vector<PauliOp> &t_pauli_rows)
+        // row_layers, if given, receives the layer each row was placed in
+        template <size_t W>
+        std::vector<BasicHTab<W>> create_layers(const PauliTable &t_pauli_rows,
+                                                std::vector<size_t> *row_layers = nullptr)
         {
+            if (row_layers)
+                row_layers->assign(t_pauli_rows.size(), 0);
             if (t_pauli_rows.empty())
                 return {};
 
-            std::vector<HTab> layers;
+            std::vector<BasicHTab<W>> layers;
+
+            // Finds the newest non-commuting layer without a full backward scan
+            BasicLayerIndex<W> index(num_qubits_);
 
             // Add first T_PAULI operation to create the first layer
-            HTab first_tableau(t_pauli_rows[0].get_num_qubits());
-            first_tableau.add_stab(t_pauli_rows[0]);
-            layers.push_back(first_tableau);
+            BasicHTab<W> first_tableau(t_pauli_rows.num_qubits());
+            first_tableau.add_stab(t_pauli_rows.row(0));
+            layers.push_back(std::move(first_tableau));
+            index.add_row(index.add_layer(), t_pauli_rows.row(0));
 
             // Process remaining T_PAULI operations
             for (size_t i = 1; i < t_pauli_rows.size(); i++)
             {
-                bool placed = false;
+                const PauliRowView pauli_row = t_pauli_rows.row(i);
 
-                const PauliOp &pauli_row = t_pauli_rows[i];
+                // Most recent layer (back) to oldest layer (front) that the row does not commute with
+                size_t layer_idx = index.newest_blocking_layer(pauli_row);
 
-                // Check from most recent layer (back) to oldest layer (front)
-                for (int layer_idx = static_cast<int>(layers.size()) - 1; layer_idx >= 0; --layer_idx)
+                size_t target;
+                if (layer_idx == BasicLayerIndex<W>::npos)
                 {
-                    bool commutes_with_layer = layers[layer_idx].commutes_with_all(pauli_row);
-
-                    if (!commutes_with_layer)
-                    {
-                        // Found a non-commuting layer, place in the newer layer (layer_idx + 1)
-                        if (layer_idx == static_cast<int>(layers.size()) - 1)
-                        {
-                            // Already at the newest layer, create a new one
-                            HTab new_tableau(num_qubits_);
-                            new_tableau.add_stab(pauli_row);
-                            layers.push_back(new_tableau);
-                        }
-                        else
-                        {
-                            // Add to the newer layer (layer_idx + 1)
-                            layers[layer_idx + 1].add_stab(pauli_row);
-                        }
-                        placed = true;
-                        break;
-                    }
+                    // Commutes with all layers, add to the oldest layer (front)
+                    target = 0;
                 }
-
-                if (!placed)
+                else if (layer_idx == layers.size() - 1)
                 {
-                    // Commutes with all layers, add to the oldest layer (front)
-                    layers.front().add_stab(pauli_row);
+                    // Already at the newest layer, create a new one
+                    layers.emplace_back(num_qubits_);
+                    target = index.add_layer();
                 }
+                else
+                {
+                    // Add to the newer layer (layer_idx + 1)
+                    target = layer_idx + 1;
+                }
+                layers[target].add_stab(pauli_row);
+                index.add_row(target, pauli_row);
+                if (row_layers)
+                    (*row_layers)[i] = target;
             }
 
             return layers;
         }
 
-        std::vector<HTab> create_layers_greedy(const std::vector<PauliOp> &t_pauli_rows)
+        template <size_t W>
+        std::vector<BasicHTab<W>> create_layers_greedy(const PauliTable &t_pauli_rows)
         {
             if (t_pauli_rows.empty())
                 return {};
 
-            std::vector<HTab> layers;
+            std::vector<BasicHTab<W>> layers;
 
             // Add first T_PAULI operation to create the first layer
-            HTab first_tableau(t_pauli_rows[0].get_num_qubits());
-            first_tableau.add_stab(t_pauli_rows[0]);
+            BasicHTab<W> first_tableau(t_pauli_rows.num_qubits());
+            first_tableau.add_stab(t_pauli_rows.row(0));
             layers.push_back(first_tableau);
 
             // Process remaining T_PAULI operations
             for (size_t i = 1; i < t_pauli_rows.size(); i++)
             {
-                const PauliOp &pauli_row = t_pauli_rows[i];
+                const PauliRowView pauli_row = t_pauli_rows.row(i);
 
                 bool commutes_with_layer = layers[layers.size() - 1].commutes_with_all(pauli_row); // Check only the most recent layer
 
                 if (!commutes_with_layer)
                 {
                     // Already at the newest layer, create a new one
-                    HTab new_tableau(num_qubits_);
+                    BasicHTab<W> new_tableau(num_qubits_);
                     new_tableau.add_stab(pauli_row);
                     layers.push_back(new_tableau);
                 }
@@ -249,50 +279,87 @@ namespace NWQEC
             return layers;
         }
 
-        std::pair<std::vector<PauliOp>, std::vector<PauliOp>> optimize(std::vector<PauliOp> &t_pauli_rows)
+        /**
+         * @brief Flag the rows whose X/Z bits may repeat elsewhere in rows
+         *
+         * Only such rows can merge or cancel in apply_reduction. Rows are
+         * grouped by a hash of their bits, so a collision merely flags a row
+         * that turns out to be unique.
+         */
+        static std::vector<uint8_t> repeated_rows(const PauliTable &rows)
         {
-            std::vector<HTab> layers = create_layers(t_pauli_rows);
-
-            std::vector<PauliOp> result_s_rows;
+            std::vector<uint64_t> hashes(rows.size());
+            std::unordered_map<uint64_t, uint32_t> counts;
+            counts.reserve(rows.size());
+            for (size_t i = 0; i < rows.size(); ++i)
+            {
+                hashes[i] = rows.bits_hash(i);
+                ++counts[hashes[i]];
+            }
 
-            HTab result_tab(num_qubits_);
+            std::vector<uint8_t> repeated(rows.size(), 0);
+            for (size_t i = 0; i < rows.size(); ++i)
+                repeated[i] = counts[hashes[i]] > 1 ? 1 : 0;
+            return repeated;
+        }
 
-            for (auto &layer : layers)
+        template <size_t W>
+        std::pair<PauliTable, PauliTable> optimize(const PauliTable &t_pauli_rows)
+        {
+            std::vector<size_t> row_layers;
+            std::vector<BasicHTab<W>> layers = create_layers<W>(t_pauli_rows, &row_layers);
+
+            // Worklist: a layer can only reduce if it holds two rows with the same Pauli string
+            std::vector<uint32_t> repeats_in_layer(layers.size(), 0);
+            std::vector<uint8_t> repeated = repeated_rows(t_pauli_rows);
+            for (size_t i = 0; i < t_pauli_rows.size(); ++i)
+                repeats_in_layer[row_layers[i]] += repeated[i];
+            std::vector<size_t> to_reduce;
+            for (size_t l = 0; l < layers.size(); ++l)
             {
-                layer.apply_reduction();
-                auto rows = layer.get_rows();
+                if (repeats_in_layer[l] > 1)
+                    to_reduce.push_back(l);
+            }
+
+            // Layers reduce independently of each other
+            parallel_for(to_reduce.size(), num_threads_, [&](size_t k)
+                         { layers[to_reduce[k]].apply_reduction(); });
+
+            PauliTable result_s_rows(num_qubits_);
+            PauliTable layer_s_rows(num_qubits_);
+
+            BasicHTab<W> result_tab(num_qubits_);
 
-                std::vector<PauliOp> cur_layer_t_rows;
+            for (size_t l = 0; l < layers.size(); ++l)
+            {
+                const PauliTable &rows = layers[l].table();
 
-                for (const auto &row : rows)
+                layer_s_rows.clear();
+                for (size_t i = 0; i < rows.size(); ++i)
                 {
-                    if (row.get_rowtype() == NWQEC::RowType::S)
-                    {
-                        result_tab.front_multiply_pauli(row);
-
-                        result_s_rows.push_back(row);
-                    }
-                    else
-                    {
-                        cur_layer_t_rows.push_back(row);
-                    }
+                    if (rows.is_valid(i) && rows.rowtype(i) == NWQEC::RowType::S)
+                        layer_s_rows.push_back(rows.row(i));
                 }
+                // The whole layer's S rows go through the accumulated rows in one pass
+                result_tab.front_multiply_paulis(layer_s_rows);
+                result_s_rows.append(layer_s_rows);
 
-                for (const auto &row : cur_layer_t_rows)
+                for (size_t i = 0; i < rows.size(); ++i)
                 {
-                    result_tab.add_stab(row);
+                    if (rows.is_valid(i) && rows.rowtype(i) != NWQEC::RowType::S)
+                        result_tab.add_stab(rows.row(i));
                 }
             }
 
-            std::vector<PauliOp> result_t_rows = result_tab.get_rows();
+            PauliTable result_t_rows = result_tab.get_table();
 
-            return {result_t_rows, result_s_rows};
+            return {std::move(result_t_rows), std::move(result_s_rows)};
         }
 
         void update_circuit(Circuit &circuit,
-                            std::vector<PauliOp> &t_pauli_rows,
-                            std::vector<PauliOp> &m_pauli_rows,
-                            const std::vector<PauliOp> &s_pauli_rows = {}) const
+                            const PauliTable &t_pauli_rows,
+                            const PauliTable &m_pauli_rows,
+                            const PauliTable &s_pauli_rows = PauliTable()) const
         {
 
             // Rebuild circuit
@@ -301,47 +368,40 @@ namespace NWQEC
             new_circuit.add_creg("c", circuit.get_num_bits());
 
             // Add T paulis first
-            for (auto it = t_pauli_rows.rbegin(); it != t_pauli_rows.rend(); ++it)
+            for (size_t i = t_pauli_rows.size(); i-- > 0;)
             {
-                const PauliOp &row = *it;
-
-                assert(row.get_rowtype() != NWQEC::RowType::S && row.is_valid());
-                new_circuit.add_operation(Operation(Operation::Type::T_PAULI, {}, {}, {}, row));
+                assert(t_pauli_rows.rowtype(i) != NWQEC::RowType::S && t_pauli_rows.is_valid(i));
+                new_circuit.add_operation(Operation(Operation::Type::T_PAULI, {}, {}, {}, t_pauli_rows.to_pauli_op(i)));
             }
 
             // Add S paulis if provided
-            for (auto it = s_pauli_rows.rbegin(); it != s_pauli_rows.rend(); ++it)
+            for (size_t i = s_pauli_rows.size(); i-- > 0;)
             {
-                const PauliOp &row = *it;
-
-                assert(row.get_rowtype() == NWQEC::RowType::S && row.is_valid());
-                new_circuit.add_operation(Operation(Operation::Type::S_PAULI, {}, {}, {}, row));
+                assert(s_pauli_rows.rowtype(i) == NWQEC::RowType::S && s_pauli_rows.is_valid(i));
+                new_circuit.add_operation(Operation(Operation::Type::S_PAULI, {}, {}, {}, s_pauli_rows.to_pauli_op(i)));
             }
 
             // Finally, add measurement Pauli strings
-            for (const auto &row : m_pauli_rows)
+            for (size_t i = 0; i < m_pauli_rows.size(); ++i)
             {
-                Operation m_pauli_op(Operation::Type::M_PAULI, {}, {}, {}, row);
+                Operation m_pauli_op(Operation::Type::M_PAULI, {}, {}, {}, m_pauli_rows.to_pauli_op(i));
                 new_circuit.add_operation(m_pauli_op);
             }
 
             circuit = std::move(new_circuit);
         }
 
-        void write_operations_to_file(const std::vector<Operation> &operations,
-                                      size_t num_qubits,
-                                      const std::string &filename,
-                                      const std::vector<PauliOp> &s_pauli_rows = {}) const
+        // QASM-style text of the Pauli operations, then the S-Pauli rows folded into measurements
+        static void write_operations(std::ostream &os,
+                                     const std::vector<Operation> &operations,
+                                     size_t num_qubits,
+                                     const PauliTable &s_pauli_rows)
         {
-            std::ofstream file(filename);
-            if (!file.is_open())
-                return;
-
-            file << "OPENQASM 2.0;\n";
-            file << "include \"qelib1.inc\";\n";
-            file << "\n";
-            file << "qreg q[" << num_qubits << "];\n";
-            file << "\n";
+            os << "OPENQASM 2.0;\n";
+            os << "include \"qelib1.inc\";\n";
+            os << "\n";
+            os << "qreg q[" << num_qubits << "];\n";
+            os << "\n";
 
             for (const auto &op : operations)
             {
@@ -349,21 +409,18 @@ namespace NWQEC
                     op.get_type() == Operation::Type::S_PAULI ||
                     op.get_type() == Operation::Type::M_PAULI)
                 {
-                    op.print(file);
-                    file << "\n";
+                    op.print(os);
+                    os << "\n";
                 }
             }
 
-            for (auto it = s_pauli_rows.rbegin(); it != s_pauli_rows.rend(); ++it)
+            for (size_t i = s_pauli_rows.size(); i-- > 0;)
             {
-                const PauliOp &row = *it;
-                if (row.is_valid() && row.get_rowtype() == NWQEC::RowType::S)
+                if (s_pauli_rows.is_valid(i) && s_pauli_rows.rowtype(i) == NWQEC::RowType::S)
                 {
-                    file << "s_pauli " << row.to_string() << ";\n";
+                    os << "s_pauli " << s_pauli_rows.row(i).to_string() << ";\n";
                 }
             }
-
-            file.close();
         }
     };
 
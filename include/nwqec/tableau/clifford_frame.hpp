@@ -0,0 +1,204 @@
+#pragma once
+
+#include "nwqec/core/operation.hpp"
+#include "nwqec/core/pauli_kernels.hpp"
+#include "nwqec/core/pauli_op.hpp"
+#include "vtab.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace NWQEC
+{
+    /**
+     * @brief Heisenberg-picture image of the Clifford prefix of a circuit
+     *
+     * Walking a circuit forwards, the frame holds the map that the VTab
+     * replay would apply to a row created at the current position: the
+     * Cliffords seen so far, newest first. Since conjugation is a group
+     * homomorphism the map is fixed by the images of the 2n generators X_q
+     * and Z_q, so a rotation's final Pauli string is available as soon as
+     * the rotation is reached, and appending a gate only rewrites the images
+     * of the generators on its qubits.
+     *
+     * Images are stored as i^k X^x Z^z with k mod 4, which keeps products
+     * exact; PauliOps going in and out use the Hermitian (x, z, r)
+     * convention of VTab, where x = z = 1 on a qubit means Y. Memory is
+     * 2n rows of n bits, independent of how many gates are appended.
+     */
+    class CliffordFrame
+    {
+    public:
+        explicit CliffordFrame(size_t n_qubits)
+            : n_qubits_(n_qubits), words_(PauliOp(n_qubits).num_words()),
+              x_(2 * n_qubits * words_, 0), z_(2 * n_qubits * words_, 0), k_(2 * n_qubits, 0),
+              scratch_x_(4 * words_), scratch_z_(4 * words_)
+        {
+            for (size_t q = 0; q < n_qubits; ++q)
+            {
+                x_[gen_x(q) * words_ + q / 64] |= 1ULL << (q % 64);
+                z_[gen_z(q) * words_ + q / 64] |= 1ULL << (q % 64);
+            }
+        }
+
+        size_t num_qubits() const { return n_qubits_; }
+
+        /**
+         * @brief Compose gate after the Cliffords appended so far
+         * @return false (frame unchanged) if gate is not a supported Clifford
+         */
+        bool append_gate(Operation::Type gate, size_t a, size_t b = SIZE_MAX)
+        {
+            if (gate == Operation::Type::CX)
+            {
+                assert(b != SIZE_MAX && a != b);
+                // Images of X_a, Z_a, X_b, Z_b under the row update of apply_cx
+                const Generator gens[4] = {{true, false, false, false, false}, {false, true, false, false, false},
+                                           {false, false, true, false, false}, {false, false, false, true, false}};
+                for (size_t g = 0; g < 4; ++g)
+                {
+                    Generator img = gens[g];
+                    img.r = img.xa && img.zb && !(img.xb != img.za);
+                    img.xb = img.xb != img.xa;
+                    img.za = img.za != img.zb;
+                    compose(img, a, b, g);
+                }
+                store(gen_x(a), 0);
+                store(gen_z(a), 1);
+                store(gen_x(b), 2);
+                store(gen_z(b), 3);
+                return true;
+            }
+
+            CliffordColumnOp op;
+            if (!CliffordColumnOp::from_gate(gate, op))
+                return false;
+            compose({op.xx, op.zx, false, false, op.flip_x}, a, a, 0);
+            compose({op.xz, op.zz, false, false, op.flip_z}, a, a, 1);
+            store(gen_x(a), 0);
+            store(gen_z(a), 1);
+            return true;
+        }
+
+        // Final Pauli string of a rotation on Z_qubit with sign phase
+        PauliOp image_z(size_t qubit, bool phase) const
+        {
+            return to_pauli_op(gen_z(qubit), phase);
+        }
+
+        // Final Pauli string of a rotation on pauli
+        PauliOp image(const PauliOp &pauli) const
+        {
+            const uint64_t *px = pauli.x_words();
+            const uint64_t *pz = pauli.z_words();
+            std::vector<uint64_t> x(words_, 0), z(words_, 0);
+            unsigned k = pauli.r() ? 2 : 0;
+            for (size_t w = 0; w < words_; ++w)
+                k += static_cast<unsigned>(popcount_u64(px[w] & pz[w]));
+
+            // X^x Z^z: all X generators first, then all Z generators
+            for (int plane = 0; plane < 2; ++plane)
+            {
+                const uint64_t *bits = plane == 0 ? px : pz;
+                for (size_t w = 0; w < words_; ++w)
+                {
+                    uint64_t word = bits[w];
+                    while (word)
+                    {
+                        size_t q = w * 64 + static_cast<size_t>(ctz_u64(word));
+                        word &= word - 1;
+                        size_t row = plane == 0 ? gen_x(q) : gen_z(q);
+                        k = multiply_into(x.data(), z.data(), k, row);
+                    }
+                }
+            }
+            return make_pauli_op(x.data(), z.data(), k);
+        }
+
+    private:
+        // Local image of a generator on qubits a and b, Hermitian convention
+        struct Generator
+        {
+            bool xa, za, xb, zb;
+            bool r;
+        };
+
+        size_t gen_x(size_t q) const { return q; }
+        size_t gen_z(size_t q) const { return n_qubits_ + q; }
+        const uint64_t *row_x(size_t row) const { return x_.data() + row * words_; }
+        const uint64_t *row_z(size_t row) const { return z_.data() + row * words_; }
+
+        // (x, z, k) *= image row; returns the new k
+        unsigned multiply_into(uint64_t *x, uint64_t *z, unsigned k, size_t row) const
+        {
+            const uint64_t *rx = row_x(row);
+            const uint64_t *rz = row_z(row);
+            // Z^z X^x' = (-1)^{|z & x'|} X^x' Z^z
+            unsigned swaps = 0;
+            for (size_t w = 0; w < words_; ++w)
+            {
+                swaps += static_cast<unsigned>(popcount_u64(z[w] & rx[w]));
+                x[w] ^= rx[w];
+                z[w] ^= rz[w];
+            }
+            return (k + k_[row] + 2 * swaps) & 3;
+        }
+
+        // Image of a local generator under the current frame, into scratch slot
+        void compose(const Generator &img, size_t a, size_t b, size_t slot)
+        {
+            uint64_t *x = scratch_x_.data() + slot * words_;
+            uint64_t *z = scratch_z_.data() + slot * words_;
+            std::fill(x, x + words_, 0);
+            std::fill(z, z + words_, 0);
+            unsigned k = (img.r ? 2 : 0) + (img.xa && img.za) + (img.xb && img.zb);
+            if (img.xa)
+                k = multiply_into(x, z, k, gen_x(a));
+            if (img.xb)
+                k = multiply_into(x, z, k, gen_x(b));
+            if (img.za)
+                k = multiply_into(x, z, k, gen_z(a));
+            if (img.zb)
+                k = multiply_into(x, z, k, gen_z(b));
+            scratch_k_[slot] = static_cast<uint8_t>(k & 3);
+        }
+
+        void store(size_t row, size_t slot)
+        {
+            std::copy(scratch_x_.begin() + slot * words_, scratch_x_.begin() + (slot + 1) * words_,
+                      x_.begin() + row * words_);
+            std::copy(scratch_z_.begin() + slot * words_, scratch_z_.begin() + (slot + 1) * words_,
+                      z_.begin() + row * words_);
+            k_[row] = scratch_k_[slot];
+        }
+
+        PauliOp to_pauli_op(size_t row, bool phase) const
+        {
+            return make_pauli_op(row_x(row), row_z(row), (k_[row] + (phase ? 2u : 0u)) & 3);
+        }
+
+        // Hermitian row for i^k X^x Z^z; k - |x & z| is even for a Hermitian image
+        PauliOp make_pauli_op(const uint64_t *x, const uint64_t *z, unsigned k) const
+        {
+            unsigned ys = 0;
+            for (size_t w = 0; w < words_; ++w)
+                ys += static_cast<unsigned>(popcount_u64(x[w] & z[w]));
+            const unsigned sign = (k + 4 - (ys & 3)) & 3;
+            assert((sign & 1) == 0);
+            PauliOp op(n_qubits_);
+            op.assign_words(x, z);
+            op.set_r(sign == 2);
+            return op;
+        }
+
+        size_t n_qubits_;
+        size_t words_;
+        std::vector<uint64_t> x_, z_; // Rows 0..n-1 image X_q, rows n..2n-1 image Z_q
+        std::vector<uint8_t> k_;      // Power of i of each image
+        std::vector<uint64_t> scratch_x_, scratch_z_;
+        uint8_t scratch_k_[4] = {};
+    };
+
+} // namespace NWQEC
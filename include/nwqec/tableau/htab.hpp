@@ -3,6 +3,7 @@
 #include "nwqec/core/circuit.hpp"
 #include "nwqec/core/pauli_op.hpp"
 
+#include "pauli_table.hpp"
 #include "vtab.hpp"
 
 #include <iostream>
@@ -13,52 +14,54 @@
 #include <iomanip>
 #include <memory>
 #include <array>
-
-#if defined(_MSC_VER) && !defined(__clang__)
-#    include <intrin.h>
-#endif
+#include <algorithm>
 
 namespace NWQEC
 {
-    class HTab
+    /**
+     * @brief Pauli rotation tableau used by the T-fusion pass
+     *
+     * Rows are stored in a PauliTable, so the commutation scans and the
+     * front multiplication walk contiguous X/Z slabs rather than chasing one
+     * heap allocation per row.
+     *
+     * Words is the table stride fixed at compile time (1, 2, 4 or 8), which
+     * turns the per-row kernels into unrolled branch-free code; 0 keeps the
+     * runtime width and the dispatched SIMD kernels. Use
+     * dispatch_pauli_width(PauliTable(n).stride(), ...) to pick it.
+     */
+    template <size_t Words = 0>
+    class BasicHTab
     {
     public:
 
-        HTab(size_t n_qubits) : n_qubits(n_qubits)
-        {
-            // rows.reserve(50);
-        }
-
-        size_t num_qubits() const { return n_qubits; }
-        size_t num_rows() const
+        BasicHTab(size_t n_qubits) : n_qubits(n_qubits), rows(n_qubits)
         {
-            size_t count = 0;
-            for (const auto &row : rows)
+            if constexpr (Words != 0)
             {
-                if (row.is_valid())
-                    count++;
+                if (rows.stride() != Words)
+                    throw std::invalid_argument("HTab: fixed width does not match the qubit count");
+                for (size_t w = 0; w < Words; ++w)
+                {
+                    if (n_qubits >= (w + 1) * 64)
+                        qubit_mask[w] = ~0ULL;
+                    else if (n_qubits > w * 64)
+                        qubit_mask[w] = (1ULL << (n_qubits % 64)) - 1;
+                }
             }
-            return count;
         }
 
-        void add_stab(const PauliOp &pauli_op)
+        size_t num_qubits() const { return n_qubits; }
+        size_t num_rows() const { return rows.count_valid(); }
+
+        void add_stab(const PauliRowView &pauli_op)
         {
             rows.push_back(pauli_op);
         }
 
         std::vector<PauliOp> get_stabs() const
         {
-            std::vector<PauliOp> stabs;
-            stabs.reserve(rows.size());
-
-            for (const auto &row : rows)
-            {
-                if (!row.is_valid())
-                    continue;
-                stabs.push_back(row);
-            }
-
-            return stabs;
+            return rows.to_pauli_ops();
         }
 
         std::vector<std::string> get_str() const
@@ -66,257 +69,312 @@ namespace NWQEC
             std::vector<std::string> stabs;
             stabs.reserve(rows.size());
 
-            for (const auto &row : rows)
+            for (size_t i = 0; i < rows.size(); ++i)
             {
-                if (!row.is_valid())
+                if (!rows.is_valid(i))
                     continue;
-                stabs.push_back(row.to_string());
+                stabs.push_back(rows.row(i).to_string());
             }
 
             return stabs;
         }
 
-    static inline int popcount64(uint64_t value)
-    {
-#if defined(_MSC_VER) && !defined(__clang__)
-        return static_cast<int>(__popcnt64(static_cast<unsigned __int64>(value)));
-#else
-        return __builtin_popcountll(static_cast<unsigned long long>(value));
-#endif
-    }
-
-        bool commutes_with_all(const PauliOp &pauli_op) const
+    static inline int popcount64(uint64_t value) { return popcount_u64(value); }
+
+        bool commutes_with_all(const PauliRowView &pauli_op) const
         {
-            for (const auto &tableau_row : rows)
+            if constexpr (Words != 0)
             {
-                if (!tableau_row.is_valid())
-                    continue;
+                PaddedRowWords<kPadWords> p(pauli_op);
+                for (size_t i = 0; i < rows.size(); ++i)
+                {
+                    if (rows.is_valid(i) && Fixed::anticommutes(p.x, p.z, rows.x(i), rows.z(i)))
+                        return false;
+                }
+                return true;
+            }
+
+            const size_t words = rows.num_words();
+            assert(pauli_op.num_words() == words);
 
-                if (!commutes(pauli_op, tableau_row))
+            if (words == 1)
+            {
+                // Ultra-fast path for ≤64 qubits - single popcount per row over packed words
+                const uint64_t px = pauli_op.x()[0];
+                const uint64_t pz = pauli_op.z()[0];
+                for (size_t i = 0; i < rows.size(); ++i)
                 {
-                    return false;
+                    if (!rows.is_valid(i))
+                        continue;
+                    uint64_t anti_commute_word = (px & rows.z(i)[0]) ^ (pz & rows.x(i)[0]);
+                    if (popcount64(anti_commute_word) & 1)
+                        return false;
                 }
+                return true;
+            }
+
+            const PauliKernels &kernels = pauli_kernels();
+            for (size_t i = 0; i < rows.size(); ++i)
+            {
+                if (!rows.is_valid(i))
+                    continue;
+                if (kernels.anticommutes(pauli_op.x(), pauli_op.z(), rows.x(i), rows.z(i), words))
+                    return false;
             }
             return true;
         }
 
-        void front_multiply_pauli(const PauliOp &new_pauli)
+        void front_multiply_pauli(const PauliRowView &new_pauli)
         {
-            for (auto &row : rows)
+            if constexpr (Words != 0)
+            {
+                PaddedRowWords<kPadWords> p(new_pauli);
+                for (size_t i = 0; i < rows.size(); ++i)
+                {
+                    if (!rows.is_valid(i))
+                        continue;
+                    uint64_t *row_x = rows.x(i);
+                    uint64_t *row_z = rows.z(i);
+                    // Only anticommuting rows change, so the phase sum is skipped for the rest
+                    if (!Fixed::anticommutes_masked(p.x, p.z, row_x, row_z, qubit_mask.data()))
+                        continue;
+                    int g_val = Fixed::g_sum_masked(p.x, p.z, row_x, row_z, qubit_mask.data()) + 1;
+                    Fixed::xor_into(row_x, row_z, p.x, p.z);
+                    rows.set_phase(i, rows.phase(i) ^ new_pauli.phase() ^ ((g_val >> 1) & 1));
+                }
+                return;
+            }
+
+            const size_t words = rows.num_words();
+            assert(new_pauli.num_words() == words);
+            const PauliKernels &kernels = pauli_kernels();
+
+            for (size_t i = 0; i < rows.size(); ++i)
             {
-                if (!row.is_valid())
+                if (!rows.is_valid(i))
                     continue;
 
+                uint64_t *row_x = rows.x(i);
+                uint64_t *row_z = rows.z(i);
+
                 // Compute g_function for phase calculation
-                int g_val = compute_g_function(new_pauli, row);
+                int g_val = pauli_g_words(new_pauli.x(), new_pauli.z(), row_x, row_z, words, n_qubits);
                 bool anti_commute = (g_val & 1) != 0;
 
-                if (anti_commute)
-                {
-                    // Adjust g_val for anti-commuting case (matches Python line 517)
-                    g_val += 1;
-                }
-
-                // Update X and Z bits (XOR operation)
                 // Python line 521-523: stab1_expand = np.outer(mask, new_pauli_mtx[:2*self.qubits])
                 // stab_new = stab1_expand^stab2
                 // This means: if anti_commute, XOR with new_pauli; if commute, XOR with zeros (no change)
-                if (row.is_small())
+                if (!anti_commute)
+                    continue;
+
+                // Adjust g_val for anti-commuting case (matches Python line 517)
+                g_val += 1;
+
+                // Update X and Z bits (XOR operation)
+                if (words == 1)
                 {
-                    if (anti_commute)
-                    {
-                        row.get_x_bits_small() ^= new_pauli.get_x_bits_small();
-                        row.get_z_bits_small() ^= new_pauli.get_z_bits_small();
-                    }
-                    // If they commute, no change to X and Z bits
+                    row_x[0] ^= new_pauli.x()[0];
+                    row_z[0] ^= new_pauli.z()[0];
                 }
                 else
                 {
-                    if (anti_commute)
-                    {
-                        for (size_t i = 0; i < row.get_x_bits_large().size(); ++i)
-                        {
-                            row.get_x_bits_large()[i] ^= new_pauli.get_x_bits_large()[i];
-                            row.get_z_bits_large()[i] ^= new_pauli.get_z_bits_large()[i];
-                        }
-                    }
-                    // If they commute, no change to X and Z bits
+                    kernels.xor_into(row_x, row_z, new_pauli.x(), new_pauli.z(), words);
                 }
 
                 // Update phase only for anti-commuting pairs (matches Python line 524)
-                if (anti_commute)
-                {
-                    row.set_phase(row.get_phase() ^ new_pauli.get_phase() ^ ((g_val >> 1) & 1));
-                }
+                rows.set_phase(i, rows.phase(i) ^ new_pauli.phase() ^ ((g_val >> 1) & 1));
             }
         }
 
-        bool apply_reduction()
+        /**
+         * @brief Front-multiply by every row of paulis, in order
+         *
+         * Same result as calling front_multiply_pauli once per row of paulis,
+         * but each tableau row is loaded once and run through the whole batch,
+         * rather than the tableau being walked once per Pauli.
+         */
+        void front_multiply_paulis(const PauliTable &paulis)
         {
-            bool reduced = false;
-            for (size_t i = 0; i < rows.size(); ++i)
-            {
-                if (!rows[i].is_valid())
-                    continue;
+            if (paulis.empty())
+                return;
+            if (paulis.num_words() != rows.num_words())
+                throw std::invalid_argument("HTab: Pauli batch width does not match tableau");
 
-                for (size_t j = i + 1; j < rows.size(); ++j)
+            if constexpr (Words != 0)
+            {
+                for (size_t i = 0; i < rows.size(); ++i)
                 {
-                    if (!rows[j].is_valid())
-                        continue;
-
-                    // Only check pairs if they are the same type
-                    if (rows[i].get_rowtype() != rows[j].get_rowtype())
+                    if (!rows.is_valid(i))
                         continue;
-
-                    if (same_pauli_bits(rows[i], rows[j]))
+                    std::array<uint64_t, Words> row_x, row_z;
+                    std::copy(rows.x(i), rows.x(i) + Words, row_x.begin());
+                    std::copy(rows.z(i), rows.z(i) + Words, row_z.begin());
+                    bool phase = rows.phase(i);
+                    for (size_t j = 0; j < paulis.size(); ++j)
                     {
-                        reduced = true;
-
-                        if (rows[i].get_phase() != rows[j].get_phase())
+                        const uint64_t *px = paulis.x(j);
+                        const uint64_t *pz = paulis.z(j);
+                        const bool anti = Fixed::anticommutes_masked(px, pz, row_x.data(), row_z.data(), qubit_mask.data());
+                        if constexpr (Words <= 2)
                         {
-                            // Opposite phases cancel out
-                            rows[i].set_valid(false);
-                            rows[j].set_valid(false);
+                            // Narrow rows: the phase sum is cheaper than a mispredicted branch
+                            const int g_val = Fixed::g_sum_masked(px, pz, row_x.data(), row_z.data(), qubit_mask.data()) + 1;
+                            const uint64_t select = 0 - static_cast<uint64_t>(anti);
+                            for (size_t w = 0; w < Words; ++w)
+                            {
+                                row_x[w] ^= px[w] & select;
+                                row_z[w] ^= pz[w] & select;
+                            }
+                            phase ^= anti & (paulis.phase(j) ^ (((g_val >> 1) & 1) != 0));
                         }
                         else
                         {
-                            // Same phase merge: T merges to S, S merges to Z
-                            if (rows[i].get_rowtype() == RowType::T)
-                            {
-                                rows[i].set_rowtype(RowType::S); // T + T -> S
-                            }
-                            else if (rows[i].get_rowtype() == RowType::S)
-                            {
-                                rows[i].set_rowtype(RowType::Z); // S + S -> Z
-                            }
-
-                            rows[i].set_valid(true);  // Keep row I valid
-                            rows[j].set_valid(false); // Mark row J as invalid
+                            if (!anti)
+                                continue;
+                            const int g_val = Fixed::g_sum_masked(px, pz, row_x.data(), row_z.data(), qubit_mask.data()) + 1;
+                            Fixed::xor_into(row_x.data(), row_z.data(), px, pz);
+                            phase ^= paulis.phase(j) ^ (((g_val >> 1) & 1) != 0);
                         }
-
-                        break;
                     }
+                    std::copy(row_x.begin(), row_x.end(), rows.x(i));
+                    std::copy(row_z.begin(), row_z.end(), rows.z(i));
+                    rows.set_phase(i, phase);
                 }
+                return;
             }
-            return reduced;
-        }
-
-        std::vector<PauliOp> get_rows() const
-        {
-            std::vector<PauliOp> resulting_rows;
 
-            for (const auto &row : rows)
+            const size_t words = rows.num_words();
+            for (size_t i = 0; i < rows.size(); ++i)
             {
-                if (row.is_valid())
+                if (!rows.is_valid(i))
+                    continue;
+                uint64_t *row_x = rows.x(i);
+                uint64_t *row_z = rows.z(i);
+                bool phase = rows.phase(i);
+                for (size_t j = 0; j < paulis.size(); ++j)
                 {
-                    resulting_rows.push_back(row);
+                    int g_val = pauli_g_words(paulis.x(j), paulis.z(j), row_x, row_z, words, n_qubits);
+                    if ((g_val & 1) == 0)
+                        continue;
+                    g_val += 1;
+                    for (size_t w = 0; w < words; ++w)
+                    {
+                        row_x[w] ^= paulis.x(j)[w];
+                        row_z[w] ^= paulis.z(j)[w];
+                    }
+                    phase ^= paulis.phase(j) ^ (((g_val >> 1) & 1) != 0);
                 }
+                rows.set_phase(i, phase);
             }
-
-            return resulting_rows;
         }
 
-    private:
-        int compute_g_function(const PauliOp &pauli1, const PauliOp &pauli2) const
+        /**
+         * @brief Merge rows with identical Pauli strings and row type
+         *
+         * Scanning rows in order, each valid row pairs with the next valid row
+         * of the same string and type: opposite phases cancel both, equal
+         * phases keep the first one step up (T + T -> S, S + S -> Z). Rows are
+         * bucketed by a hash of their bits, so only the rows of a bucket are
+         * compared rather than every pair.
+         *
+         * @return true if any rows were merged or cancelled
+         */
+        bool apply_reduction()
         {
-            int g_val = 0;
-
-            if (pauli1.is_small())
+            bucket_.clear();
+            for (size_t i = 0; i < rows.size(); ++i)
             {
-                // Fast path for ≤64 qubits
-                for (size_t q = 0; q < n_qubits; ++q)
-                {
-                    uint64_t mask = 1ULL << q;
-                    bool x1 = pauli1.get_x_bits_small() & mask;
-                    bool z1 = pauli1.get_z_bits_small() & mask;
-                    bool x2 = pauli2.get_x_bits_small() & mask;
-                    bool z2 = pauli2.get_z_bits_small() & mask;
-
-                    g_val += (x1 & z1) * (z2 - x2) +
-                             (x1 & !z1) * z2 * (2 * x2 - 1) +
-                             (!x1 & z1) * x2 * (1 - 2 * z2);
-                }
+                if (rows.is_valid(i))
+                    bucket_.emplace_back(rows.bits_hash(i) ^ static_cast<uint64_t>(rows.rowtype(i)), static_cast<uint32_t>(i));
             }
-            else
+            // Sorting (hash, index) keeps each bucket in row order
+            std::sort(bucket_.begin(), bucket_.end());
+
+            bool reduced = false;
+            for (size_t begin = 0; begin < bucket_.size();)
             {
-                // Large circuit path
-                for (size_t q = 0; q < n_qubits; ++q)
-                {
-                    size_t word_idx = q / 64;
-                    size_t bit_idx = q % 64;
-                    uint64_t mask = 1ULL << bit_idx;
-
-                    bool x1 = pauli1.get_x_bits_large()[word_idx] & mask;
-                    bool z1 = pauli1.get_z_bits_large()[word_idx] & mask;
-                    bool x2 = pauli2.get_x_bits_large()[word_idx] & mask;
-                    bool z2 = pauli2.get_z_bits_large()[word_idx] & mask;
-
-                    g_val += (x1 & z1) * (z2 - x2) +
-                             (x1 & !z1) * z2 * (2 * x2 - 1) +
-                             (!x1 & z1) * x2 * (1 - 2 * z2);
-                }
+                size_t end = begin + 1;
+                while (end < bucket_.size() && bucket_[end].first == bucket_[begin].first)
+                    ++end;
+                if (end - begin > 1)
+                    reduced |= reduce_bucket(begin, end);
+                begin = end;
             }
+            return reduced;
+        }
 
-            return g_val & 3;
+        std::vector<PauliOp> get_rows() const
+        {
+            return rows.to_pauli_ops();
         }
 
-        bool same_pauli_bits(const PauliOp &row1, const PauliOp &row2) const
+        // Valid rows, in order, without materializing PauliOp objects
+        PauliTable get_table() const
         {
-            if (row1.is_small())
-            {
-                return row1.get_x_bits_small() == row2.get_x_bits_small() &&
-                       row1.get_z_bits_small() == row2.get_z_bits_small();
-            }
-            else
-            {
-                return row1.get_x_bits_large() == row2.get_x_bits_large() &&
-                       row1.get_z_bits_large() == row2.get_z_bits_large();
-            }
+            return rows.compacted();
         }
 
-        bool commutes(const PauliOp &row1, const PauliOp &row2) const
+        // Underlying storage, including rows invalidated by apply_reduction
+        const PauliTable &table() const { return rows; }
+
+    private:
+        using Fixed = FixedWidthPauliKernels<Words == 0 ? 1 : Words>;
+        static constexpr size_t kPadWords = Words == 0 ? 1 : Words;
+
+        bool same_pauli_bits(size_t row1, size_t row2) const
         {
-            if (row1.is_small())
-            {
-                // Ultra-fast path for ≤64 qubits - single popcount operation!
-                uint64_t anti_commute_word = (row1.get_x_bits_small() & row2.get_z_bits_small()) ^
-                                             (row1.get_z_bits_small() & row2.get_x_bits_small());
-                return (popcount64(anti_commute_word) & 1) == 0;
-            }
-            else
-            {
-                // Large circuit path with loop unrolling
-                size_t anti_commuting_pairs = 0;
-                size_t num_words = row1.get_x_bits_large().size();
-                size_t i = 0;
+            if constexpr (Words != 0)
+                return Fixed::equal(rows.x(row1), rows.z(row1), rows.x(row2), rows.z(row2));
+            const size_t words = rows.num_words();
+            return std::equal(rows.x(row1), rows.x(row1) + words, rows.x(row2)) &&
+                   std::equal(rows.z(row1), rows.z(row1) + words, rows.z(row2));
+        }
 
-                // Process 4 words at a time when possible
-                for (; i + 3 < num_words; i += 4)
+        // Pair up the rows of bucket_[begin, end), which share a hash
+        bool reduce_bucket(size_t begin, size_t end)
+        {
+            bool reduced = false;
+            pending_.clear(); // Earlier rows still waiting for a partner, one per distinct string
+            for (size_t k = begin; k < end; ++k)
+            {
+                const size_t j = bucket_[k].second;
+                auto partner = std::find_if(pending_.begin(), pending_.end(), [&](uint32_t i)
+                                            { return rows.rowtype(i) == rows.rowtype(j) && same_pauli_bits(i, j); });
+                if (partner == pending_.end())
                 {
-                    // Unroll 4 iterations for better instruction-level parallelism
-                    uint64_t ac0 = (row1.get_x_bits_large()[i] & row2.get_z_bits_large()[i]) ^ (row1.get_z_bits_large()[i] & row2.get_x_bits_large()[i]);
-                    uint64_t ac1 = (row1.get_x_bits_large()[i + 1] & row2.get_z_bits_large()[i + 1]) ^ (row1.get_z_bits_large()[i + 1] & row2.get_x_bits_large()[i + 1]);
-                    uint64_t ac2 = (row1.get_x_bits_large()[i + 2] & row2.get_z_bits_large()[i + 2]) ^ (row1.get_z_bits_large()[i + 2] & row2.get_x_bits_large()[i + 2]);
-                    uint64_t ac3 = (row1.get_x_bits_large()[i + 3] & row2.get_z_bits_large()[i + 3]) ^ (row1.get_z_bits_large()[i + 3] & row2.get_x_bits_large()[i + 3]);
-
-                    anti_commuting_pairs += popcount64(ac0) + popcount64(ac1) +
-                                            popcount64(ac2) + popcount64(ac3);
+                    pending_.push_back(static_cast<uint32_t>(j));
+                    continue;
                 }
+                const size_t i = *partner;
+                pending_.erase(partner);
+                reduced = true;
 
-                // Handle remaining words
-                for (; i < num_words; ++i)
+                if (rows.phase(i) != rows.phase(j))
                 {
-                    uint64_t anti_commute_word = (row1.get_x_bits_large()[i] & row2.get_z_bits_large()[i]) ^
-                                                 (row1.get_z_bits_large()[i] & row2.get_x_bits_large()[i]);
-                    anti_commuting_pairs += popcount64(anti_commute_word);
+                    // Opposite phases cancel out
+                    rows.set_valid(i, false);
+                    rows.set_valid(j, false);
+                }
+                else
+                {
+                    // Same phase merge: T merges to S, S merges to Z
+                    if (rows.rowtype(i) == RowType::T)
+                        rows.set_rowtype(i, RowType::S);
+                    else if (rows.rowtype(i) == RowType::S)
+                        rows.set_rowtype(i, RowType::Z);
+                    rows.set_valid(j, false);
                 }
-
-                return (anti_commuting_pairs & 1) == 0;
             }
+            return reduced;
         }
 
         size_t n_qubits;
-        std::vector<PauliOp> rows;
+        PauliTable rows;
+        std::array<uint64_t, kPadWords> qubit_mask{}; // Bits below n_qubits, fixed widths only
+        std::vector<std::pair<uint64_t, uint32_t>> bucket_; // Scratch: (hash, row) of valid rows
+        std::vector<uint32_t> pending_;                     // Scratch: unpaired rows of one bucket
     };
 
-} // namespace NWQEC
\ No newline at end of file
+    using HTab = BasicHTab<>;
+
+} // namespace NWQEC
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "nwqec/core/pauli_kernels.hpp"
+#include "pauli_table.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace NWQEC
+{
+    /**
+     * @brief Commutation index over a growing list of Pauli layers
+     *
+     * Answers "which is the newest layer holding a row that anticommutes with
+     * this one" without testing every layer against every row:
+     *
+     * - Two rows with disjoint support always commute, so only layers whose
+     *   support meets the query are tested. Each qubit keeps the sorted list
+     *   of layers touching it; sparse queries merge those lists, dense ones
+     *   scan the per-layer support bitmaps below the newest layer touching
+     *   any of their qubits.
+     * - The symplectic product is bilinear, so a row commutes with a whole
+     *   layer exactly when it commutes with a GF(2) basis of the layer's
+     *   span. Each layer keeps such a basis, reduced incrementally as rows
+     *   arrive; since a layer's rows commute pairwise the basis never
+     *   exceeds n_qubits rows, however large the layer grows.
+     *
+     * Layers may only grow: rows are never removed or rewritten. Words is the
+     * PauliTable stride fixed at compile time, or 0 for the runtime width, as
+     * for BasicHTab.
+     */
+    template <size_t Words = 0>
+    class BasicLayerIndex
+    {
+    public:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        // Queries with at most this many qubits use the per-qubit layer lists
+        static constexpr size_t kSparseSupport = 32;
+
+        explicit BasicLayerIndex(size_t n_qubits)
+            : n_qubits_(n_qubits), words_(PauliTable(n_qubits).num_words()),
+              qubit_layers_(words_ * 64) {}
+
+        size_t num_layers() const { return layers_.size(); }
+
+        // Rank of the span of layer's rows
+        size_t basis_size(size_t layer) const { return layers_[layer].basis.size(); }
+
+        // Append an empty layer and return its index
+        size_t add_layer()
+        {
+            layers_.emplace_back(n_qubits_);
+            support_.resize(support_.size() + words_, 0);
+            return layers_.size() - 1;
+        }
+
+        // Record that row was added to layer
+        void add_row(size_t layer, const PauliRowView &row)
+        {
+            uint64_t *support = support_.data() + layer * words_;
+            for (size_t w = 0; w < words_; ++w)
+            {
+                uint64_t fresh = (row.x()[w] | row.z()[w]) & ~support[w];
+                support[w] |= fresh;
+                while (fresh)
+                {
+                    size_t qubit = w * 64 + static_cast<size_t>(ctz_u64(fresh));
+                    fresh &= fresh - 1;
+                    std::vector<uint32_t> &list = qubit_layers_[qubit];
+                    // Rows usually land in the newest layer, so this is almost always an append
+                    auto it = std::lower_bound(list.begin(), list.end(), static_cast<uint32_t>(layer));
+                    list.insert(it, static_cast<uint32_t>(layer));
+                }
+            }
+            extend_basis(layers_[layer], row);
+        }
+
+        // True when row anticommutes with some row of layer
+        bool blocks(size_t layer, const PauliRowView &row) const
+        {
+            const Layer &l = layers_[layer];
+            if constexpr (Words != 0)
+            {
+                PaddedRowWords<Words> p(row);
+                for (size_t i = 0; i < l.basis.size(); ++i)
+                {
+                    if (FixedWidthPauliKernels<Words>::anticommutes(p.x, p.z, l.basis.x(i), l.basis.z(i)))
+                        return true;
+                }
+                return false;
+            }
+            const PauliKernels &kernels = pauli_kernels();
+            for (size_t i = 0; i < l.basis.size(); ++i)
+            {
+                if (kernels.anticommutes(row.x(), row.z(), l.basis.x(i), l.basis.z(i), words_))
+                    return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief Newest layer holding a row that anticommutes with row, or npos
+         *
+         * Same answer as testing every layer from the newest down.
+         */
+        size_t newest_blocking_layer(const PauliRowView &row)
+        {
+            qubits_.clear();
+            for (size_t w = 0; w < words_; ++w)
+            {
+                uint64_t bits = row.x()[w] | row.z()[w];
+                while (bits)
+                {
+                    qubits_.push_back(static_cast<uint32_t>(w * 64 + static_cast<size_t>(ctz_u64(bits))));
+                    bits &= bits - 1;
+                }
+            }
+            if (qubits_.size() <= kSparseSupport)
+                return merge_lists(row);
+            return scan_supports(row);
+        }
+
+    private:
+        struct Layer
+        {
+            explicit Layer(size_t n_qubits) : basis(n_qubits) {}
+
+            PauliTable basis;            // Reduced rows spanning the layer
+            std::vector<uint32_t> pivot; // Pivot bit of each basis row (z bits offset by 64 * words)
+        };
+
+        bool get_bit(const uint64_t *x, const uint64_t *z, uint32_t bit) const
+        {
+            const size_t plane = words_ * 64;
+            const uint64_t *words = bit < plane ? x : z;
+            const size_t b = bit < plane ? bit : bit - plane;
+            return (words[b / 64] >> (b % 64)) & 1ULL;
+        }
+
+        void extend_basis(Layer &l, const PauliRowView &row)
+        {
+            reduced_x_.assign(row.x(), row.x() + words_);
+            reduced_z_.assign(row.z(), row.z() + words_);
+            for (size_t i = 0; i < l.basis.size(); ++i)
+            {
+                if (!get_bit(reduced_x_.data(), reduced_z_.data(), l.pivot[i]))
+                    continue;
+                const uint64_t *bx = l.basis.x(i);
+                const uint64_t *bz = l.basis.z(i);
+                for (size_t w = 0; w < words_; ++w)
+                {
+                    reduced_x_[w] ^= bx[w];
+                    reduced_z_[w] ^= bz[w];
+                }
+            }
+
+            for (size_t w = 0; w < 2 * words_; ++w)
+            {
+                const uint64_t word = w < words_ ? reduced_x_[w] : reduced_z_[w - words_];
+                if (word == 0)
+                    continue;
+                // Independent of the basis so far: keep it with its lowest set bit as pivot
+                size_t idx = l.basis.push_back_identity();
+                std::copy(reduced_x_.begin(), reduced_x_.end(), l.basis.x(idx));
+                std::copy(reduced_z_.begin(), reduced_z_.end(), l.basis.z(idx));
+                l.pivot.push_back(static_cast<uint32_t>(w * 64 + static_cast<size_t>(ctz_u64(word))));
+                return;
+            }
+        }
+
+        size_t merge_lists(const PauliRowView &row)
+        {
+            // Max-heap of per-qubit cursors, each walking its list from the newest layer
+            heap_.clear();
+            for (uint32_t q : qubits_)
+            {
+                const std::vector<uint32_t> &list = qubit_layers_[q];
+                if (!list.empty())
+                    heap_.push_back({list.back(), q, static_cast<uint32_t>(list.size() - 1)});
+            }
+            std::make_heap(heap_.begin(), heap_.end());
+
+            while (!heap_.empty())
+            {
+                const uint32_t layer = heap_.front().layer;
+                // Advance every cursor sitting on this layer
+                while (!heap_.empty() && heap_.front().layer == layer)
+                {
+                    std::pop_heap(heap_.begin(), heap_.end());
+                    Cursor &c = heap_.back();
+                    if (c.pos == 0)
+                    {
+                        heap_.pop_back();
+                        continue;
+                    }
+                    c.layer = qubit_layers_[c.qubit][--c.pos];
+                    std::push_heap(heap_.begin(), heap_.end());
+                }
+                if (blocks(layer, row))
+                    return layer;
+            }
+            return npos;
+        }
+
+        size_t scan_supports(const PauliRowView &row)
+        {
+            size_t top = npos;
+            for (uint32_t q : qubits_)
+            {
+                const std::vector<uint32_t> &list = qubit_layers_[q];
+                if (!list.empty() && (top == npos || list.back() > top))
+                    top = list.back();
+            }
+            if (top == npos)
+                return npos;
+
+            for (size_t layer = top + 1; layer-- > 0;)
+            {
+                const uint64_t *support = support_.data() + layer * words_;
+                uint64_t overlap = 0;
+                for (size_t w = 0; w < words_; ++w)
+                    overlap |= (row.x()[w] | row.z()[w]) & support[w];
+                if (overlap != 0 && blocks(layer, row))
+                    return layer;
+            }
+            return npos;
+        }
+
+        struct Cursor
+        {
+            uint32_t layer;
+            uint32_t qubit;
+            uint32_t pos;
+            bool operator<(const Cursor &other) const { return layer < other.layer; }
+        };
+
+        size_t n_qubits_;
+        size_t words_;
+        std::vector<Layer> layers_;
+        std::vector<uint64_t> support_;                   // layers x words_ support bitmaps
+        std::vector<std::vector<uint32_t>> qubit_layers_; // Sorted layers touching each qubit
+        std::vector<uint32_t> qubits_;                    // Scratch: support of the current query
+        std::vector<Cursor> heap_;                        // Scratch: merge cursors
+        std::vector<uint64_t> reduced_x_, reduced_z_;     // Scratch: row being reduced
+    };
+
+} // namespace NWQEC
@@ -0,0 +1,311 @@
+#pragma once
+
+#include "nwqec/core/pauli_op.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace NWQEC
+{
+    namespace detail
+    {
+        /**
+         * @brief Minimal allocator returning Alignment-byte aligned storage
+         */
+        template <typename T, size_t Alignment>
+        struct AlignedAllocator
+        {
+            using value_type = T;
+
+            template <typename U>
+            struct rebind
+            {
+                using other = AlignedAllocator<U, Alignment>;
+            };
+
+            AlignedAllocator() noexcept = default;
+            template <typename U>
+            AlignedAllocator(const AlignedAllocator<U, Alignment> &) noexcept {}
+
+            T *allocate(size_t n)
+            {
+                void *ptr = ::operator new(n * sizeof(T), std::align_val_t(Alignment));
+                return static_cast<T *>(ptr);
+            }
+
+            void deallocate(T *ptr, size_t) noexcept
+            {
+                ::operator delete(ptr, std::align_val_t(Alignment));
+            }
+
+            template <typename U>
+            bool operator==(const AlignedAllocator<U, Alignment> &) const noexcept { return true; }
+            template <typename U>
+            bool operator!=(const AlignedAllocator<U, Alignment> &) const noexcept { return false; }
+        };
+    } // namespace detail
+
+    /**
+     * @brief Read-only view of one Pauli row: X/Z words plus row metadata
+     *
+     * Views point either into a PauliTable or into a PauliOp and are only
+     * valid while that storage is alive and not resized. padded_words() is
+     * the number of words that may be read (the table stride for table rows);
+     * words past num_words() are zero.
+     */
+    class PauliRowView
+    {
+    public:
+        PauliRowView(const uint64_t *x, const uint64_t *z, size_t words, size_t n_qubits,
+                     bool phase, RowType rowtype, bool valid = true, size_t padded_words = 0)
+            : x_(x), z_(z), words_(words), padded_words_(padded_words > words ? padded_words : words),
+              n_qubits_(n_qubits), phase_(phase), rowtype_(rowtype), valid_(valid) {}
+
+        // Implicit so PauliOp can be passed wherever a row view is accepted
+        PauliRowView(const PauliOp &op)
+            : PauliRowView(op.x_words(), op.z_words(), op.num_words(), op.get_num_qubits(),
+                           op.get_phase(), op.get_rowtype(), op.is_valid()) {}
+
+        const uint64_t *x() const { return x_; }
+        const uint64_t *z() const { return z_; }
+        size_t num_words() const { return words_; }
+        size_t padded_words() const { return padded_words_; }
+        size_t num_qubits() const { return n_qubits_; }
+        bool phase() const { return phase_; }
+        RowType rowtype() const { return rowtype_; }
+        bool is_valid() const { return valid_; }
+
+        PauliOp to_pauli_op() const
+        {
+            PauliOp op(n_qubits_);
+            op.assign_words(x_, z_);
+            op.set_phase(phase_);
+            op.set_rowtype(rowtype_);
+            op.set_valid(valid_);
+            return op;
+        }
+
+        std::string to_string() const { return to_pauli_op().to_string(); }
+
+    private:
+        const uint64_t *x_;
+        const uint64_t *z_;
+        size_t words_;
+        size_t padded_words_;
+        size_t n_qubits_;
+        bool phase_;
+        RowType rowtype_;
+        bool valid_;
+    };
+
+    /**
+     * @brief Pointers to N readable words of a row, copying narrower rows into zero padding
+     */
+    template <size_t N>
+    struct PaddedRowWords
+    {
+        explicit PaddedRowWords(const PauliRowView &row)
+        {
+            if (row.padded_words() >= N)
+            {
+                x = row.x();
+                z = row.z();
+                return;
+            }
+            std::copy(row.x(), row.x() + row.num_words(), x_buf.begin());
+            std::copy(row.z(), row.z() + row.num_words(), z_buf.begin());
+            x = x_buf.data();
+            z = z_buf.data();
+        }
+        PaddedRowWords(const PaddedRowWords &) = delete;
+        PaddedRowWords &operator=(const PaddedRowWords &) = delete;
+
+        const uint64_t *x = nullptr;
+        const uint64_t *z = nullptr;
+        std::array<uint64_t, N> x_buf{};
+        std::array<uint64_t, N> z_buf{};
+    };
+
+    /**
+     * @brief Structure-of-arrays storage for a list of Pauli rows
+     *
+     * All X words live in one 64-byte aligned slab and all Z words in another,
+     * row i starting at i * stride(). Phases, row types and validity flags are
+     * kept in parallel arrays. The stride is the word count rounded up to a
+     * power of two (a multiple of 8 beyond 8 words), so a row never straddles
+     * more cache lines than it needs while single-word rows stay packed.
+     */
+    class PauliTable
+    {
+    public:
+        using WordVector = std::vector<uint64_t, detail::AlignedAllocator<uint64_t, 64>>;
+
+        explicit PauliTable(size_t n_qubits = 0)
+            : n_qubits_(n_qubits),
+              words_(n_qubits <= 64 ? 1 : (n_qubits + 63) / 64),
+              stride_(compute_stride(words_)) {}
+
+        size_t num_qubits() const { return n_qubits_; }
+        size_t num_words() const { return words_; }
+        size_t stride() const { return stride_; }
+        size_t size() const { return rows_; }
+        bool empty() const { return rows_ == 0; }
+
+        void reserve(size_t rows)
+        {
+            x_.reserve(rows * stride_);
+            z_.reserve(rows * stride_);
+            phase_.reserve(rows);
+            rowtype_.reserve(rows);
+            valid_.reserve(rows);
+        }
+
+        void clear()
+        {
+            x_.clear();
+            z_.clear();
+            phase_.clear();
+            rowtype_.clear();
+            valid_.clear();
+            rows_ = 0;
+        }
+
+        /**
+         * @brief Append an identity row and return its index
+         */
+        size_t push_back_identity(bool phase = false, RowType rowtype = RowType::T, bool valid = true)
+        {
+            x_.resize(x_.size() + stride_, 0);
+            z_.resize(z_.size() + stride_, 0);
+            phase_.push_back(phase ? 1 : 0);
+            rowtype_.push_back(rowtype);
+            valid_.push_back(valid ? 1 : 0);
+            return rows_++;
+        }
+
+        /**
+         * @brief Append a copy of row and return its index
+         * @throws std::invalid_argument if the row has a different word count
+         */
+        size_t push_back(const PauliRowView &row)
+        {
+            if (row.num_words() != words_)
+                throw std::invalid_argument("PauliTable: row width does not match table");
+            // A view into this table would dangle once the slabs grow
+            const bool aliased = !x_.empty() && row.x() >= x_.data() && row.x() < x_.data() + x_.size();
+            const size_t src = aliased ? static_cast<size_t>(row.x() - x_.data()) / stride_ : 0;
+            size_t idx = push_back_identity(row.phase(), row.rowtype(), row.is_valid());
+            const uint64_t *src_x = aliased ? x(src) : row.x();
+            const uint64_t *src_z = aliased ? z(src) : row.z();
+            std::copy(src_x, src_x + words_, x(idx));
+            std::copy(src_z, src_z + words_, z(idx));
+            return idx;
+        }
+
+        uint64_t *x(size_t row) { return x_.data() + row * stride_; }
+        uint64_t *z(size_t row) { return z_.data() + row * stride_; }
+        const uint64_t *x(size_t row) const { return x_.data() + row * stride_; }
+        const uint64_t *z(size_t row) const { return z_.data() + row * stride_; }
+
+        bool phase(size_t row) const { return phase_[row] != 0; }
+        void set_phase(size_t row, bool p) { phase_[row] = p ? 1 : 0; }
+        RowType rowtype(size_t row) const { return rowtype_[row]; }
+        void set_rowtype(size_t row, RowType type) { rowtype_[row] = type; }
+        bool is_valid(size_t row) const { return valid_[row] != 0; }
+        void set_valid(size_t row, bool v) { valid_[row] = v ? 1 : 0; }
+
+        void set_x_bit(size_t row, size_t qubit) { x(row)[qubit / 64] |= 1ULL << (qubit % 64); }
+        void set_z_bit(size_t row, size_t qubit) { z(row)[qubit / 64] |= 1ULL << (qubit % 64); }
+
+        PauliRowView row(size_t idx) const
+        {
+            return PauliRowView(x(idx), z(idx), words_, n_qubits_,
+                                phase(idx), rowtype(idx), is_valid(idx), stride_);
+        }
+
+        PauliOp to_pauli_op(size_t idx) const { return row(idx).to_pauli_op(); }
+
+        // Hash of a row's X/Z bits; phase, row type and validity are ignored
+        uint64_t bits_hash(size_t idx) const
+        {
+            uint64_t h = 0xcbf29ce484222325ULL;
+            for (size_t w = 0; w < words_; ++w)
+            {
+                h = (h ^ x(idx)[w]) * 0x100000001b3ULL;
+                h = (h ^ z(idx)[w]) * 0x100000001b3ULL;
+                h ^= h >> 29;
+            }
+            return h;
+        }
+
+        size_t count_valid() const
+        {
+            size_t count = 0;
+            for (uint8_t v : valid_)
+                count += v;
+            return count;
+        }
+
+        // Copy of the table holding only the valid rows, in order
+        PauliTable compacted() const
+        {
+            PauliTable out(n_qubits_);
+            out.reserve(count_valid());
+            for (size_t i = 0; i < rows_; ++i)
+            {
+                if (is_valid(i))
+                    out.push_back(row(i));
+            }
+            return out;
+        }
+
+        // Append every row of other (validity preserved)
+        void append(const PauliTable &other)
+        {
+            reserve(rows_ + other.rows_);
+            for (size_t i = 0; i < other.rows_; ++i)
+                push_back(other.row(i));
+        }
+
+        std::vector<PauliOp> to_pauli_ops(bool valid_only = true) const
+        {
+            std::vector<PauliOp> ops;
+            ops.reserve(valid_only ? count_valid() : rows_);
+            for (size_t i = 0; i < rows_; ++i)
+            {
+                if (!valid_only || is_valid(i))
+                    ops.push_back(to_pauli_op(i));
+            }
+            return ops;
+        }
+
+    private:
+        static size_t compute_stride(size_t words)
+        {
+            if (words > 8)
+                return (words + 7) & ~static_cast<size_t>(7);
+            size_t stride = 1;
+            while (stride < words)
+                stride <<= 1;
+            return stride;
+        }
+
+        size_t n_qubits_;
+        size_t words_;
+        size_t stride_;
+        size_t rows_ = 0;
+        WordVector x_;
+        WordVector z_;
+        std::vector<uint8_t> phase_;
+        std::vector<RowType> rowtype_;
+        std::vector<uint8_t> valid_;
+    };
+
+} // namespace NWQEC
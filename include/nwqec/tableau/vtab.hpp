@@ -1,7 +1,10 @@
 #pragma once
 
 #include "nwqec/core/circuit.hpp"
+#include "nwqec/core/parallel.hpp"
 #include "nwqec/core/pauli_op.hpp"
+#include "pauli_table.hpp"
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <string>
@@ -39,18 +42,191 @@ namespace NWQEC
         {
             return (vec[elem] & (static_cast<packed_t>(1) << bit)) != 0;
         }
+
+        // Bits kept in place by each swap stage of the 64x64 transpose, for block sizes 32..1
+        inline constexpr packed_t TRANSPOSE_MASKS[6] = {
+            0x00000000FFFFFFFFULL, 0x0000FFFF0000FFFFULL, 0x00FF00FF00FF00FFULL,
+            0x0F0F0F0F0F0F0F0FULL, 0x3333333333333333ULL, 0x5555555555555555ULL};
+
+        /**
+         * @brief Transpose a 64x64 bit matrix in place: bit j of word i swaps with bit i of word j
+         *
+         * Six stages, each swapping the off-diagonal s x s blocks of every
+         * 2s x 2s block with one shift, xor and mask per word pair.
+         */
+        inline void transpose_64x64_scalar(packed_t *m)
+        {
+            for (size_t stage = 0, s = 32; stage < 6; ++stage, s >>= 1)
+            {
+                const packed_t mask = TRANSPOSE_MASKS[stage];
+                for (size_t base = 0; base < 64; base += 2 * s)
+                {
+                    for (size_t k = base; k < base + s; ++k)
+                    {
+                        const packed_t t = ((m[k] >> s) ^ m[k + s]) & mask;
+                        m[k] ^= t << s;
+                        m[k + s] ^= t;
+                    }
+                }
+            }
+        }
+
+#if defined(NWQEC_SIMD_X86)
+        // The four stages with s >= 4 swap four word pairs per instruction; the last two are scalar
+        __attribute__((target("avx2"))) inline void transpose_64x64_avx2(packed_t *m)
+        {
+            for (size_t stage = 0, s = 32; stage < 4; ++stage, s >>= 1)
+            {
+                const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(TRANSPOSE_MASKS[stage]));
+                const __m128i shift = _mm_set_epi64x(0, static_cast<long long>(s));
+                for (size_t base = 0; base < 64; base += 2 * s)
+                {
+                    for (size_t k = base; k < base + s; k += 4)
+                    {
+                        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(m + k));
+                        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(m + k + s));
+                        const __m256i t = _mm256_and_si256(_mm256_xor_si256(_mm256_srl_epi64(lo, shift), hi), mask);
+                        lo = _mm256_xor_si256(lo, _mm256_sll_epi64(t, shift));
+                        hi = _mm256_xor_si256(hi, t);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(m + k), lo);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(m + k + s), hi);
+                    }
+                }
+            }
+            for (size_t stage = 4, s = 2; stage < 6; ++stage, s >>= 1)
+            {
+                const packed_t mask = TRANSPOSE_MASKS[stage];
+                for (size_t base = 0; base < 64; base += 2 * s)
+                {
+                    for (size_t k = base; k < base + s; ++k)
+                    {
+                        const packed_t t = ((m[k] >> s) ^ m[k + s]) & mask;
+                        m[k] ^= t << s;
+                        m[k + s] ^= t;
+                    }
+                }
+            }
+        }
+#endif
+
+        // Widest transpose the selected Pauli kernels' ISA allows
+        inline void transpose_64x64(packed_t *m)
+        {
+#if defined(NWQEC_SIMD_X86)
+            static const bool use_avx2 = pauli_kernels().isa == SimdIsa::AVX2 || pauli_kernels().isa == SimdIsa::AVX512;
+            if (use_avx2)
+                return transpose_64x64_avx2(m);
+#endif
+            transpose_64x64_scalar(m);
+        }
     }
 
+    /**
+     * @brief A single-qubit Clifford as its action on one tableau column
+     *
+     * A row's local Pauli (x, z) becomes (xx&x ^ xz&z, zx&x ^ zz&z), and the
+     * row's phase flips if the local Pauli was X, Y or Z per flip_x, flip_y
+     * and flip_z. Composing two such maps gives another, so a run of gates
+     * on one qubit collapses into a single column update.
+     */
+    struct CliffordColumnOp
+    {
+        bool xx = true, xz = false, zx = false, zz = true;
+        bool flip_x = false, flip_y = false, flip_z = false;
+
+        // The column update of a single-qubit Clifford gate; false if gate is not one
+        static bool from_gate(Operation::Type gate, CliffordColumnOp &op)
+        {
+            op = CliffordColumnOp();
+            switch (gate)
+            {
+            case Operation::Type::H:
+                op.xx = op.zz = false;
+                op.xz = op.zx = true;
+                op.flip_y = true;
+                break;
+            case Operation::Type::S:
+                op.zx = true;
+                op.flip_y = true;
+                break;
+            case Operation::Type::SDG:
+                op.zx = true;
+                op.flip_x = true;
+                break;
+            case Operation::Type::SX:
+                op.xz = true;
+                op.flip_z = true;
+                break;
+            case Operation::Type::SXDG:
+                op.xz = true;
+                op.flip_y = true;
+                break;
+            case Operation::Type::X:
+                op.flip_y = op.flip_z = true;
+                break;
+            case Operation::Type::Y:
+                op.flip_x = op.flip_z = true;
+                break;
+            case Operation::Type::Z:
+                op.flip_x = op.flip_y = true;
+                break;
+            default:
+                return false;
+            }
+            return true;
+        }
+
+        // This update followed by next
+        CliffordColumnOp then(const CliffordColumnOp &next) const
+        {
+            CliffordColumnOp out;
+            out.xx = (next.xx && xx) != (next.xz && zx);
+            out.xz = (next.xx && xz) != (next.xz && zz);
+            out.zx = (next.zx && xx) != (next.zz && zx);
+            out.zz = (next.zx && xz) != (next.zz && zz);
+            out.flip_x = flip_x != next.flips(xx, zx);
+            out.flip_z = flip_z != next.flips(xz, zz);
+            out.flip_y = flip_y != next.flips(xx != xz, zx != zz);
+            return out;
+        }
+
+        // Whether a row whose local Pauli is (x, z) has its phase flipped
+        bool flips(bool x, bool z) const
+        {
+            if (x && z)
+                return flip_y;
+            return x ? flip_x : (z && flip_z);
+        }
+
+        bool is_identity() const
+        {
+            return xx && !xz && !zx && zz && !flip_x && !flip_y && !flip_z;
+        }
+    };
+
+    /**
+     * @brief Column-packed stabilizer tableau used by the PBC pass
+     *
+     * Each qubit's X and Z bits, and the phase bits, are stored as columns
+     * of packed words, one bit per row. Clifford gates act on every word of
+     * a column independently, so the gate list is applied in tiles of
+     * consecutive words small enough to stay in cache, one tile per worker.
+     * Runs of single-qubit Cliffords are fused into one column update first.
+     */
     class VTab
     {
     public:
+        // Approximate bytes of tableau a tile of words may span
+        static constexpr size_t kTileBytes = 256 * 1024;
+
         // Constructor with gates and parameters
         VTab(size_t n_qubits, size_t n_gate_stabs,
              const std::vector<Operation::Type> &gates = {},
              const std::vector<size_t> &qa = {},
              const std::vector<size_t> &qb = {},
              const std::vector<uint8_t> &phases = {},
-             const std::vector<PauliOp> &stab_rows = {})
+             const std::vector<PauliOp> &stab_rows = {},
+             size_t num_threads = 1)
             : n_qubits(n_qubits)
         {
             str_len = static_cast<int>(n_qubits + 1);
@@ -58,7 +234,7 @@ namespace NWQEC
 
             init_structure(n_qubits + n_gate_stabs);
             init_identity();
-            process_gates(gates, qa, qb, phases, stab_rows);
+            process_gates(gates, qa, qb, phases, stab_rows, num_threads);
         }
 
         size_t num_qubits() const { return n_qubits; }
@@ -93,32 +269,37 @@ namespace NWQEC
             local_rows++;
         }
 
-        std::vector<PauliOp> get_paili_ops()
+        std::vector<PauliOp> get_paili_ops() const
         {
-            std::vector<PauliOp> stabs;
-            stabs.reserve(local_rows);
+            return get_pauli_table().to_pauli_ops(false);
+        }
+
+        /**
+         * @brief Stabilizer rows in the same order as get_paili_ops, as a PauliTable
+         *
+         * Each 64-row by 64-qubit block of a bit plane is gathered from the
+         * columns, transposed as a bit matrix and stored as one word of each
+         * of its 64 rows, so the conversion is word-level on both sides.
+         */
+        PauliTable get_pauli_table() const
+        {
+            PauliTable table(n_qubits);
+            table.reserve(local_rows);
+            for (size_t row = 0; row < local_rows; row++)
+                table.push_back_identity(Utils::get_bit(r, row / packed_size, row % packed_size));
 
+            alignas(64) packed_t block[packed_size];
             for (size_t i = 0; i < cur_elements; i++)
             {
-                for (size_t j = 0; j < packed_size; j++)
+                const size_t first_row = i * packed_size;
+                const size_t rows = std::min(packed_size, local_rows - first_row);
+                for (size_t w = 0; w < table.num_words(); w++)
                 {
-                    if (stabs.size() >= local_rows)
-                        break;
-                    PauliOp row(n_qubits);
-                    row.set_r(Utils::get_bit(r, i, j));
-
-                    // Build sparse representation by checking each qubit
-                    for (size_t k = 0; k < n_qubits; k++)
-                    {
-                        if (Utils::get_bit(x[k], i, j))
-                            row.add_x(k);
-                        if (Utils::get_bit(z[k], i, j))
-                            row.add_z(k);
-                    }
-                    stabs.push_back(row);
+                    transpose_block(x, i, w, block, table.x(first_row) + w, rows, table.stride());
+                    transpose_block(z, i, w, block, table.z(first_row) + w, rows, table.stride());
                 }
             }
-            return stabs;
+            return table;
         }
 
         void apply_s_from_start(const std::vector<size_t> &qubits)
@@ -172,6 +353,26 @@ namespace NWQEC
         }
 
     private:
+        // Word w of rows elem*64.. of one bit plane, written every stride words from out
+        void transpose_block(const std::vector<std::vector<packed_t>> &plane, size_t elem, size_t w,
+                             packed_t *block, packed_t *out, size_t rows, size_t stride) const
+        {
+            const size_t first_qubit = w * packed_size;
+            const size_t qubits = std::min(packed_size, n_qubits - first_qubit);
+            packed_t any = 0;
+            for (size_t b = 0; b < qubits; b++)
+            {
+                block[b] = plane[first_qubit + b][elem];
+                any |= block[b];
+            }
+            if (any == 0)
+                return; // Rows start as identity
+            std::fill(block + qubits, block + packed_size, 0);
+            Utils::transpose_64x64(block);
+            for (size_t b = 0; b < rows; b++)
+                out[b * stride] = block[b];
+        }
+
         void init_structure(size_t total_rows)
         {
             size_t elements = Utils::calc_elements(total_rows);
@@ -197,129 +398,240 @@ namespace NWQEC
             next_rank = 0;
         }
 
-        void process_gates(const std::vector<Operation::Type> &gates,
-                           const std::vector<size_t> &qa,
-                           const std::vector<size_t> &qb,
-                           const std::vector<uint8_t> &phases,
-                           const std::vector<PauliOp> &stab_rows = {})
+        // Words per tile: a multiple of 8 whose columns for every qubit fit in kTileBytes
+        size_t tile_words() const
+        {
+            const size_t column_bytes = (2 * n_qubits + 1) * sizeof(packed_t);
+            size_t words = kTileBytes / column_bytes;
+            words -= words % 8;
+            return std::max<size_t>(words, 8);
+        }
+
+        // One pass over the tableau: add a row, or apply a fused gate
+        struct Step
+        {
+            enum class Kind : uint8_t
+            {
+                TRow,     // Z rotation row on qubit a with phase
+                StabRow,  // Rotation row stab_rows[a]
+                Clifford, // Single-qubit update op on qubit a
+                CX        // Control a, target b
+            };
+            Step(Kind kind, size_t a, size_t b = 0) : kind(kind), a(a), b(b) {}
+
+            Kind kind;
+            uint8_t phase = 0;
+            size_t a;
+            size_t b;
+            CliffordColumnOp op;
+
+            bool adds_row() const { return kind == Kind::TRow || kind == Kind::StabRow; }
+        };
+
+        /**
+         * @brief Translate the gate list into tableau steps, fusing single-qubit runs
+         *
+         * A single-qubit Clifford on q is held back until the next gate or row
+         * that involves q. That is exact: the gates skipped over act on other
+         * columns, and the rows added meanwhile are identity on q, which every
+         * single-qubit Clifford on q leaves unchanged.
+         */
+        std::vector<Step> compile_steps(const std::vector<Operation::Type> &gates,
+                                        const std::vector<size_t> &qa,
+                                        const std::vector<size_t> &qb,
+                                        const std::vector<uint8_t> &phases,
+                                        const std::vector<PauliOp> &stab_rows) const
         {
+            std::vector<Step> steps;
+            steps.reserve(gates.size());
+            std::vector<CliffordColumnOp> pending(n_qubits);
+            std::vector<uint8_t> has_pending(n_qubits, 0);
+
+            auto flush = [&](size_t q)
+            {
+                if (!has_pending[q])
+                    return;
+                has_pending[q] = 0;
+                if (!pending[q].is_identity())
+                {
+                    steps.emplace_back(Step::Kind::Clifford, q);
+                    steps.back().op = pending[q];
+                }
+                pending[q] = CliffordColumnOp();
+            };
+
             size_t stab_idx = 0;
             for (size_t i = 0; i < gates.size(); i++)
             {
+                CliffordColumnOp op;
                 if (gates[i] == Operation::Type::T || gates[i] == Operation::Type::TDG)
-                    add_t_stab(qa[i], phases[i]);
+                {
+                    flush(qa[i]);
+                    steps.emplace_back(Step::Kind::TRow, qa[i]);
+                    steps.back().phase = phases[i];
+                }
                 else if (gates[i] == Operation::Type::T_PAULI || gates[i] == Operation::Type::S_PAULI)
                 {
                     assert(stab_idx < stab_rows.size());
-
-                    add_stab(stab_rows[stab_idx++]);
+                    const PauliOp &row = stab_rows[stab_idx];
+                    for (size_t w = 0; w < row.num_words(); ++w)
+                    {
+                        for (packed_t bits = row.x_words()[w] | row.z_words()[w]; bits; bits &= bits - 1)
+                            flush(w * packed_size + static_cast<size_t>(ctz_u64(bits)));
+                    }
+                    steps.emplace_back(Step::Kind::StabRow, stab_idx++);
+                }
+                else if (gates[i] == Operation::Type::CX)
+                {
+                    flush(qa[i]);
+                    flush(qb[i]);
+                    steps.emplace_back(Step::Kind::CX, qa[i], qb[i]);
+                }
+                else if (CliffordColumnOp::from_gate(gates[i], op))
+                {
+                    pending[qa[i]] = pending[qa[i]].then(op);
+                    has_pending[qa[i]] = 1;
                 }
                 else
-                    apply_gate(gates[i], qa[i], qb[i]);
+                {
+                    std::cout << "Non-Clifford Gate!" << std::endl;
+                }
             }
+            for (size_t q = 0; q < n_qubits; q++)
+                flush(q);
+            return steps;
         }
 
-        void apply_gate(Operation::Type gate, size_t a, size_t b = SIZE_MAX)
+        // Where replaying the steps for one tile begins
+        struct TileStart
         {
-            switch (gate)
-            {
-            case Operation::Type::H:
-                apply_h(a);
-                break;
-            case Operation::Type::S:
-                apply_s(a);
-                break;
-            case Operation::Type::SDG:
-                apply_sdg(a);
-                break;
-            case Operation::Type::SX:
-                apply_sx(a);
-                break;
-            case Operation::Type::SXDG:
-                apply_sxdg(a);
-                break;
-            case Operation::Type::CX:
-                apply_cx(a, b);
-                break;
-            case Operation::Type::X:
-            case Operation::Type::Y:
-            case Operation::Type::Z:
-                apply_pauli(gate, a);
-                break;
-            default:
-                std::cout << "Non-Clifford Gate!" << std::endl;
-            }
-        }
-
-        void apply_h(size_t q)
+            size_t step = 0; // First step that can touch the tile
+            size_t row = 0;  // Rows added before that step
+        };
+
+        /**
+         * @brief Add the rotation rows and apply the Clifford gates, in gate order
+         *
+         * A gate acts on each packed word independently, and rows that do not
+         * exist yet are all zero, which every Clifford leaves unchanged. So
+         * the words can be cut into tiles, and each tile replays the steps
+         * from the one that adds its first row. The result matches applying
+         * every gate to the whole tableau in turn, but a tile stays in cache
+         * across consecutive steps and tiles run on separate workers.
+         */
+        void process_gates(const std::vector<Operation::Type> &gates,
+                           const std::vector<size_t> &qa,
+                           const std::vector<size_t> &qb,
+                           const std::vector<uint8_t> &phases,
+                           const std::vector<PauliOp> &stab_rows = {},
+                           size_t num_threads = 1)
         {
-            for (size_t i = 0; i < cur_elements; i++)
+            const std::vector<Step> steps = compile_steps(gates, qa, qb, phases, stab_rows);
+            const size_t tile = tile_words();
+            const size_t tile_rows = tile * packed_size;
+
+            // Tiles holding identity rows see every step
+            std::vector<TileStart> starts(local_rows == 0 ? 1 : (local_rows - 1) / tile_rows + 1);
+            for (TileStart &start : starts)
+                start.row = local_rows;
+            size_t row = local_rows;
+            for (size_t i = 0; i < steps.size(); i++)
             {
-                r[i] ^= (x[q][i] & z[q][i]);
-                std::swap(x[q][i], z[q][i]);
+                if (!steps[i].adds_row())
+                    continue;
+                if (row % tile_rows == 0 && row / tile_rows == starts.size())
+                    starts.push_back({i, row});
+                row++;
             }
+
+            local_rows = row;
+            cur_elements = Utils::calc_elements(local_rows);
+            starts.resize((cur_elements + tile - 1) / tile);
+
+            parallel_for(starts.size(), num_threads, [&](size_t t)
+                         { replay_tile(t * tile, std::min((t + 1) * tile, cur_elements), starts[t], steps, stab_rows); });
         }
 
-        void apply_s(size_t q)
+        void replay_tile(size_t begin, size_t end, const TileStart &start,
+                         const std::vector<Step> &steps, const std::vector<PauliOp> &stab_rows)
         {
-            for (size_t i = 0; i < cur_elements; i++)
+            const size_t end_row = end * packed_size;
+            size_t row = start.row;
+            for (size_t i = start.step; i < steps.size(); i++)
             {
-                r[i] ^= (x[q][i] & z[q][i]);
-                z[q][i] ^= x[q][i];
+                const Step &step = steps[i];
+                if (step.adds_row())
+                {
+                    if (row < end_row)
+                    {
+                        if (step.kind == Step::Kind::TRow)
+                            set_t_row(row, step.a, step.phase);
+                        else
+                            set_row(row, stab_rows[step.a]);
+                    }
+                    row++;
+                    continue;
+                }
+                // Words past the last row added so far are still zero
+                const size_t live_end = std::min(end, Utils::calc_elements(row));
+                if (step.kind == Step::Kind::CX)
+                    apply_cx(step.a, step.b, begin, live_end);
+                else
+                    apply_clifford(step.a, step.op, begin, live_end);
             }
         }
 
-        void apply_sdg(size_t q)
+        void set_t_row(size_t row, size_t qubit, uint8_t phase)
         {
-            for (size_t i = 0; i < cur_elements; i++)
-            {
-                r[i] ^= x[q][i] ^ (x[q][i] & z[q][i]);
-                z[q][i] ^= x[q][i];
-            }
+            Utils::set_bit(r, row / packed_size, row % packed_size, phase != 0);
+            Utils::set_bit(z[qubit], row / packed_size, row % packed_size, true);
         }
 
-        void apply_sx(size_t q)
+        void set_row(size_t row, const PauliOp &op)
         {
-            for (size_t i = 0; i < cur_elements; i++)
+            const size_t elem = row / packed_size;
+            const size_t bit = row % packed_size;
+            Utils::set_bit(r, elem, bit, op.r());
+            const size_t words = op.num_words();
+            for (size_t w = 0; w < words; ++w)
             {
-                r[i] ^= (x[q][i] & z[q][i]) ^ z[q][i];
-                x[q][i] ^= z[q][i];
+                for (packed_t bits = op.x_words()[w]; bits; bits &= bits - 1)
+                    Utils::set_bit(x[w * packed_size + static_cast<size_t>(ctz_u64(bits))], elem, bit, true);
+                for (packed_t bits = op.z_words()[w]; bits; bits &= bits - 1)
+                    Utils::set_bit(z[w * packed_size + static_cast<size_t>(ctz_u64(bits))], elem, bit, true);
             }
         }
 
-        void apply_sxdg(size_t q)
+        // Apply a fused single-qubit update to words [begin, end) of column q
+        void apply_clifford(size_t q, const CliffordColumnOp &op, size_t begin, size_t end)
         {
-            for (size_t i = 0; i < cur_elements; i++)
+            auto mask = [](bool bit)
+            { return bit ? MAX_PACKED : static_cast<packed_t>(0); };
+            const packed_t xx = mask(op.xx), xz = mask(op.xz), zx = mask(op.zx), zz = mask(op.zz);
+            const packed_t fx = mask(op.flip_x), fy = mask(op.flip_y), fz = mask(op.flip_z);
+            packed_t *xq = x[q].data(), *zq = z[q].data(), *rr = r.data();
+            for (size_t i = begin; i < end; i++)
             {
-                r[i] ^= (x[q][i] & z[q][i]);
-                x[q][i] ^= z[q][i];
+                const packed_t x0 = xq[i], z0 = zq[i];
+                rr[i] ^= (x0 & z0 & fy) | (x0 & ~z0 & fx) | (~x0 & z0 & fz);
+                xq[i] = (x0 & xx) ^ (z0 & xz);
+                zq[i] = (x0 & zx) ^ (z0 & zz);
             }
         }
 
-        void apply_cx(size_t ctrl, size_t targ)
+        void apply_cx(size_t ctrl, size_t targ, size_t begin, size_t end)
         {
             assert(targ != SIZE_MAX);
-            for (size_t i = 0; i < cur_elements; i++)
+            packed_t *xc = x[ctrl].data(), *zc = z[ctrl].data();
+            packed_t *xt = x[targ].data(), *zt = z[targ].data(), *rr = r.data();
+            for (size_t i = begin; i < end; i++)
             {
-                r[i] ^= ((x[ctrl][i] & z[targ][i]) & (x[targ][i] ^ z[ctrl][i] ^ MAX_PACKED));
-                x[targ][i] ^= x[ctrl][i];
-                z[ctrl][i] ^= z[targ][i];
+                rr[i] ^= ((xc[i] & zt[i]) & (xt[i] ^ zc[i] ^ MAX_PACKED));
+                xt[i] ^= xc[i];
+                zc[i] ^= zt[i];
             }
         }
 
-        void apply_pauli(Operation::Type gate, size_t q)
-        {
-            if (gate == Operation::Type::X)
-                for (size_t i = 0; i < cur_elements; i++)
-                    r[i] ^= z[q][i];
-            else if (gate == Operation::Type::Y)
-                for (size_t i = 0; i < cur_elements; i++)
-                    r[i] ^= (x[q][i] ^ z[q][i]);
-            else if (gate == Operation::Type::Z)
-                for (size_t i = 0; i < cur_elements; i++)
-                    r[i] ^= x[q][i];
-        }
-
         size_t n_qubits, local_rows, cur_elements, start_row_index;
         int next_rank, str_len;
 
@@ -7,6 +7,12 @@ try:
 except _metadata.PackageNotFoundError:  # pragma: no cover - happens in local dev
     __version__ = "0.1.1-dev"
 
+# Wheels ship the precomputed RZ table next to the extension; read when first needed
+import os as _os
+_rz_table = _os.path.join(_os.path.dirname(__file__), "rz_table.nwqt")
+if _os.path.exists(_rz_table):
+    _os.environ.setdefault("NWQEC_RZ_TABLE", _rz_table)
+
 from ._core import *  # type: ignore[F401,F403]
 
 # Platform-specific gridsynth availability
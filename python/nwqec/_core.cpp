@@ -7,12 +7,20 @@
 #include <fstream>
 #include <cmath>
 #include <iomanip>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "nwqec/parser/qasm_parser.hpp"
+#include "nwqec/parser/circuit_binary.hpp"
+#include "nwqec/core/circuit_arrays.hpp"
 #include "nwqec/core/operation.hpp"
 #include "nwqec/core/pauli_op.hpp"
 #include "nwqec/core/constants.hpp"
 
+#include "nwqec/core/parallel.hpp"
+#include "nwqec/core/socket_synthesis_backend.hpp"
 #include "nwqec/core/transpiler.hpp"
 
 namespace py = pybind11;
@@ -74,6 +82,175 @@ namespace
         return false;
     }
 
+    /**
+     * One field of a CircuitArrays, exported read-only through the buffer protocol
+     *
+     * Keeps the arrays alive, so NumPy views of it stay valid after the
+     * Circuit they were taken from changes or is deleted.
+     */
+    struct ArrayView
+    {
+        std::shared_ptr<const NWQEC::CircuitArrays> owner;
+        const void *data;
+        py::ssize_t itemsize;
+        std::string format;
+        std::vector<py::ssize_t> shape;
+    };
+
+    template <typename T>
+    ArrayView array_view(std::shared_ptr<const NWQEC::CircuitArrays> owner, const std::vector<T> &values,
+                         std::vector<py::ssize_t> shape)
+    {
+        // Empty buffers still need a non-null address
+        static const T empty{};
+        const void *data = values.empty() ? static_cast<const void *>(&empty) : static_cast<const void *>(values.data());
+        return {std::move(owner), data, static_cast<py::ssize_t>(sizeof(T)), py::format_descriptor<T>::format(),
+                std::move(shape)};
+    }
+
+    // Process-wide RZ synthesis settings, applied to every transform call.
+    // Read and written only while holding the GIL.
+    struct SynthesisSettings
+    {
+        std::string cache_path;
+        uint64_t cache_max_bytes = NWQEC::DEFAULT_SYNTHESIS_CACHE_MAX_BYTES;
+        int angle_timeout_ms = 0;
+        int budget_ms = 0;
+        bool race_diophantine = false;
+        size_t speculate_k = 0;
+        bool use_rz_table = true;
+        std::shared_ptr<NWQEC::SynthesisBackend> backend;
+    };
+
+    SynthesisSettings &synthesis_settings()
+    {
+        static SynthesisSettings settings;
+        return settings;
+    }
+
+    void apply_synthesis_settings(NWQEC::PassConfig &config)
+    {
+        const auto &settings = synthesis_settings();
+        config.synthesis_cache_path = settings.cache_path;
+        config.synthesis_cache_max_bytes = settings.cache_max_bytes;
+        config.synthesis_angle_timeout_ms = settings.angle_timeout_ms;
+        config.synthesis_budget_ms = settings.budget_ms;
+        config.synthesis_race_diophantine = settings.race_diophantine;
+        config.synthesis_speculate_k = settings.speculate_k;
+        config.use_rz_table = settings.use_rz_table;
+        config.synthesis_backend = settings.backend;
+    }
+
+    // Synthesis counters of the calling thread's most recent transform, kept when it throws
+    NWQEC::SynthesisStats &last_synthesis_stats()
+    {
+        static thread_local NWQEC::SynthesisStats stats;
+        return stats;
+    }
+
+    // Process-wide pass trace, appended to by every transform call (null = off).
+    // The pointer is read and replaced while holding the GIL; the observer locks itself.
+    std::shared_ptr<NWQEC::ChromeTraceObserver> &pass_trace()
+    {
+        static std::shared_ptr<NWQEC::ChromeTraceObserver> trace;
+        return trace;
+    }
+
+    std::unique_ptr<NWQEC::Circuit> run_passes(std::unique_ptr<NWQEC::Circuit> circuit,
+                                               const std::vector<NWQEC::PassType> &passes,
+                                               NWQEC::PassConfig config)
+    {
+        const auto trace = pass_trace();
+        if (trace)
+            config.observers.push_back(trace);
+
+        // The C++ run touches no Python state, so other Python threads proceed meanwhile
+        py::gil_scoped_release release;
+        NWQEC::Transpiler transpiler;
+        try
+        {
+            circuit = transpiler.execute_passes(std::move(circuit), passes, config);
+        }
+        catch (...)
+        {
+            last_synthesis_stats() = transpiler.synthesis_stats();
+            if (trace)
+                trace->flush();
+            throw;
+        }
+        last_synthesis_stats() = transpiler.synthesis_stats();
+        if (trace)
+            trace->flush();
+        return circuit;
+    }
+
+    // Pass sequence of a transpile_many target, named after the single-circuit transform
+    std::vector<NWQEC::PassType> target_passes(const std::string &target, bool optimize_t_count)
+    {
+        if (target == "clifford_t")
+            return NWQEC::PassSequences::TO_CLIFFORD_T;
+        if (target == "pbc")
+            return optimize_t_count ? NWQEC::PassSequences::TO_PBC_OPTIMIZED : NWQEC::PassSequences::TO_PBC;
+        if (target == "clifford_reduction")
+            return NWQEC::PassSequences::TO_CLIFFORD_REDUCTION;
+        if (target == "fuse_t")
+            return NWQEC::PassSequences::T_OPTIMIZATION_ONLY;
+        throw py::value_error("Unknown target '" + target +
+                              "' (expected 'clifford_t', 'pbc', 'clifford_reduction' or 'fuse_t')");
+    }
+
+    // Run one pass sequence over a batch of circuits, several circuits at a time
+    std::vector<std::unique_ptr<NWQEC::Circuit>> run_batch(std::vector<std::unique_ptr<NWQEC::Circuit>> batch,
+                                                           const std::vector<NWQEC::PassType> &passes,
+                                                           NWQEC::PassConfig config,
+                                                           size_t num_threads)
+    {
+        const auto trace = pass_trace();
+        if (trace)
+            config.observers.push_back(trace);
+
+        // Parallelism goes to whole circuits; a single circuit keeps the
+        // threads for its own synthesis and PBC work
+        const size_t workers = std::min(NWQEC::resolve_num_threads(num_threads), batch.size());
+        config.num_threads = workers > 1 ? 1 : num_threads;
+
+        std::vector<NWQEC::SynthesisStats> stats(batch.size());
+        auto record = [&stats, &trace]()
+        {
+            NWQEC::SynthesisStats total;
+            for (const auto &s : stats)
+                total.merge(s);
+            last_synthesis_stats() = total;
+            if (trace)
+                trace->flush();
+        };
+
+        py::gil_scoped_release release;
+        try
+        {
+            NWQEC::parallel_for(batch.size(), workers, [&](size_t i)
+                                {
+                NWQEC::Transpiler transpiler;
+                try
+                {
+                    batch[i] = transpiler.execute_passes(std::move(batch[i]), passes, config);
+                }
+                catch (...)
+                {
+                    stats[i] = transpiler.synthesis_stats();
+                    throw;
+                }
+                stats[i] = transpiler.synthesis_stats(); });
+        }
+        catch (...)
+        {
+            record();
+            throw;
+        }
+        record();
+        return batch;
+    }
+
     // Helper to run transforms using the Transpiler
     std::unique_ptr<NWQEC::Circuit> apply_transforms(const NWQEC::Circuit &circuit,
                                                      bool to_pbc,
@@ -85,12 +262,12 @@ namespace
                                                      bool silent,
                                                      double epsilon_override = -1.0)
     {
-        NWQEC::Transpiler transpiler;
         NWQEC::PassConfig config;
         config.keep_ccx = keep_ccx;
         config.keep_cx = keep_cx;
         config.epsilon_override = epsilon_override;
         config.silent = silent;
+        apply_synthesis_settings(config);
         
         auto circuit_copy = std::make_unique<NWQEC::Circuit>(circuit);
         
@@ -114,7 +291,7 @@ namespace
             passes.push_back(NWQEC::PassType::REMOVE_PAULI);
         }
         
-        return transpiler.execute_passes(std::move(circuit_copy), passes, config);
+        return run_passes(std::move(circuit_copy), passes, config);
     }
 }
 
@@ -233,7 +410,68 @@ PYBIND11_MODULE(_core, m)
         .def("to_qasm", &circuit_to_qasm)
         .def("to_qasm_str", &circuit_to_qasm)
         .def("save_qasm", &circuit_save_qasm, py::arg("path"))
-        .def("to_qasm_file", &circuit_save_qasm, py::arg("filename"));
+        .def("to_qasm_file", &circuit_save_qasm, py::arg("filename"))
+        .def("save_binary", &NWQEC::save_binary, py::arg("path"))
+        .def("arrays", [](const NWQEC::Circuit &c)
+             { return std::make_shared<NWQEC::CircuitArrays>(NWQEC::CircuitArrays::from(c)); },
+             "Snapshot the operations as flat arrays (see CircuitArrays) for NumPy.");
+
+    py::class_<ArrayView>(m, "ArrayView", py::buffer_protocol())
+        .def_buffer([](const ArrayView &v)
+                    {
+            std::vector<py::ssize_t> strides(v.shape.size());
+            py::ssize_t stride = v.itemsize;
+            for (size_t i = v.shape.size(); i-- > 0;)
+            {
+                strides[i] = stride;
+                stride *= v.shape[i];
+            }
+            return py::buffer_info(const_cast<void *>(v.data), v.itemsize, v.format,
+                                   static_cast<py::ssize_t>(v.shape.size()), v.shape, strides, /*readonly=*/true); });
+
+    // Flat arrays of one circuit; each array property is a zero-copy buffer (numpy.asarray(...))
+    using ArraysPtr = std::shared_ptr<NWQEC::CircuitArrays>;
+    auto n_ops = [](const NWQEC::CircuitArrays &a)
+    { return static_cast<py::ssize_t>(a.num_operations()); };
+    auto n_rows = [](const NWQEC::CircuitArrays &a)
+    { return static_cast<py::ssize_t>(a.num_pauli_rows()); };
+    py::class_<NWQEC::CircuitArrays, ArraysPtr>(m, "CircuitArrays")
+        .def_readonly("num_qubits", &NWQEC::CircuitArrays::num_qubits)
+        .def_readonly("pauli_words", &NWQEC::CircuitArrays::pauli_words)
+        .def_property_readonly("num_operations", &NWQEC::CircuitArrays::num_operations)
+        .def_property_readonly("num_pauli_rows", &NWQEC::CircuitArrays::num_pauli_rows)
+        .def_property_readonly("types", [n_ops](const ArraysPtr &a)
+                               { return array_view(a, a->types, {n_ops(*a)}); },
+                               "uint8 Operation type of each operation; names in operation_type_names()")
+        .def_property_readonly("qubit_offsets", [n_ops](const ArraysPtr &a)
+                               { return array_view(a, a->qubit_offsets, {n_ops(*a) + 1}); },
+                               "uint64; operation i acts on qubits[qubit_offsets[i]:qubit_offsets[i + 1]]")
+        .def_property_readonly("qubits", [](const ArraysPtr &a)
+                               { return array_view(a, a->qubits, {static_cast<py::ssize_t>(a->qubits.size())}); },
+                               "uint32 qubit indices of all operations, concatenated")
+        .def_property_readonly("pauli_rows", [n_ops](const ArraysPtr &a)
+                               { return array_view(a, a->pauli_rows, {n_ops(*a)}); },
+                               "int64 row of each operation in x_words/z_words/phases, -1 if it has no Pauli string")
+        .def_property_readonly("x_words", [n_rows](const ArraysPtr &a)
+                               { return array_view(a, a->x_words, {n_rows(*a), static_cast<py::ssize_t>(a->pauli_words)}); },
+                               "uint64 (rows, pauli_words) packed X bits; qubit q is bit q % 64 of word q // 64")
+        .def_property_readonly("z_words", [n_rows](const ArraysPtr &a)
+                               { return array_view(a, a->z_words, {n_rows(*a), static_cast<py::ssize_t>(a->pauli_words)}); },
+                               "uint64 (rows, pauli_words) packed Z bits, laid out as x_words")
+        .def_property_readonly("phases", [n_rows](const ArraysPtr &a)
+                               { return array_view(a, a->phases, {n_rows(*a)}); },
+                               "uint8 sign of each Pauli row (1 = negative)");
+
+    m.def(
+        "operation_type_names",
+        []()
+        {
+            py::list names;
+            for (size_t i = 0; i < NWQEC::Operation::NUM_TYPES; ++i)
+                names.append(NWQEC::Operation::get_type_name(static_cast<NWQEC::Operation::Type>(i)));
+            return names;
+        },
+        "Gate name of each operation type code, as used in CircuitArrays.types.");
 
     // Module-level transforms: clean entrypoints
     m.def(
@@ -266,16 +504,16 @@ PYBIND11_MODULE(_core, m)
             
             // Use optimized PBC pipeline if T-optimization is requested
             if (optimize_t_count) {
-                NWQEC::Transpiler transpiler;
                 NWQEC::PassConfig config;
                 config.keep_cx = keep_cx;
                 config.epsilon_override = eps_override;
                 config.silent = true;
+                apply_synthesis_settings(config);
                 
                 auto circuit_copy = std::make_unique<NWQEC::Circuit>(circuit);
                 auto passes = NWQEC::PassSequences::TO_PBC_OPTIMIZED;
                 
-                return transpiler.execute_passes(std::move(circuit_copy), passes, config);
+                return run_passes(std::move(circuit_copy), passes, config);
             } else {
                 return apply_transforms(circuit,
                                         /*to_pbc=*/true,
@@ -341,12 +579,191 @@ PYBIND11_MODULE(_core, m)
         "Optimize the number of T rotations within a Pauli-Based Circuit (PBC) and return a new Circuit.\n"
         "- epsilon: optional absolute tolerance for any RZ synthesis still required");
 
+    m.def(
+        "set_synthesis_cache",
+        [](py::object path, uint64_t max_mb)
+        {
+            // Larger sizes would wrap around when converted to bytes
+            if (max_mb > std::numeric_limits<uint64_t>::max() >> 20)
+                throw py::value_error("max_mb must be at most " + std::to_string(std::numeric_limits<uint64_t>::max() >> 20));
+            auto &settings = synthesis_settings();
+            settings.cache_path = path.is_none() ? std::string() : path.cast<std::string>();
+            settings.cache_max_bytes = max_mb << 20;
+        },
+        py::arg("path"),
+        py::arg("max_mb") = NWQEC::DEFAULT_SYNTHESIS_CACHE_MAX_BYTES >> 20,
+        "Persist RZ synthesis results in the given file and reuse them in later transforms.\n"
+        "- path: cache file location, or None to disable the cache\n"
+        "- max_mb: size cap for the cache file in megabytes (0 = unlimited)");
+
+    m.def(
+        "set_synthesis_limits",
+        [](py::object angle_timeout_ms, py::object budget_ms)
+        {
+            // 0 already means no limit, so a negative value can only be a mistake
+            auto milliseconds = [](py::object value, const char *name)
+            {
+                const int ms = value.is_none() ? 0 : value.cast<int>();
+                if (ms < 0)
+                    throw py::value_error(std::string(name) + " must not be negative");
+                return ms;
+            };
+            const int angle_timeout = milliseconds(angle_timeout_ms, "angle_timeout_ms");
+            const int budget = milliseconds(budget_ms, "budget_ms");
+            auto &settings = synthesis_settings();
+            settings.angle_timeout_ms = angle_timeout;
+            settings.budget_ms = budget;
+        },
+        py::arg("angle_timeout_ms") = py::none(),
+        py::arg("budget_ms") = py::none(),
+        "Bound the wall-clock time spent on RZ synthesis in subsequent transforms.\n"
+        "- angle_timeout_ms: limit per distinct angle, or None for no limit\n"
+        "- budget_ms: limit for all synthesis in one transform, or None for no limit\n"
+        "A transform raises RuntimeError if any angle cannot be synthesized in time.");
+
+    m.def(
+        "set_synthesis_race",
+        [](bool enabled)
+        { synthesis_settings().race_diophantine = enabled; },
+        py::arg("enabled"),
+        "Solve the diophantine candidates of each RZ angle concurrently in subsequent transforms.\n"
+        "Results are deterministic and valid but can differ from the serial search.");
+
+    m.def(
+        "set_synthesis_lookahead",
+        [](size_t levels)
+        { synthesis_settings().speculate_k = levels; },
+        py::arg("levels"),
+        "Solve TDGP for this many further k levels ahead of the current one in subsequent transforms\n"
+        "(0 = off). Results are identical to the serial search.");
+
+    m.def(
+        "set_rz_table",
+        [](bool enabled)
+        { synthesis_settings().use_rz_table = enabled; },
+        py::arg("enabled"),
+        "Take dyadic RZ angles from the shipped table of precomputed sequences in subsequent transforms\n"
+        "(default on). Table entries are what synthesis would return.");
+
+    m.def(
+        "set_synthesis_workers",
+        [](py::object workers, size_t chunk_angles)
+        {
+            std::vector<std::string> endpoints;
+            if (py::isinstance<py::str>(workers))
+                endpoints = NWQEC::SocketSynthesisBackend::parse_endpoints(workers.cast<std::string>());
+            else if (!workers.is_none())
+                endpoints = workers.cast<std::vector<std::string>>();
+            synthesis_settings().backend =
+                endpoints.empty() ? nullptr
+                                  : std::make_shared<NWQEC::SocketSynthesisBackend>(std::move(endpoints), chunk_angles);
+        },
+        py::arg("workers"),
+        py::arg("chunk_angles") = NWQEC::SocketSynthesisBackend::DEFAULT_CHUNK_ANGLES,
+        "Send the RZ angles of subsequent transforms to nwqec-synth-worker processes.\n"
+        "- workers: list of \"host:port\" strings or one comma-separated string, or None for in-process synthesis\n"
+        "- chunk_angles: angles per request; workers take chunks as they finish the previous one\n"
+        "Results are identical to in-process synthesis and fill the synthesis cache as usual.\n"
+        "A transform raises RuntimeError once no worker can be reached, or when a worker reports an error.");
+
+    m.def(
+        "set_trace_file",
+        [](py::object path)
+        {
+            pass_trace() = path.is_none() ? nullptr
+                                          : std::make_shared<NWQEC::ChromeTraceObserver>(path.cast<std::string>());
+        },
+        py::arg("path"),
+        "Record every pass of subsequent transforms as a Chrome trace (JSON) in the given file.\n"
+        "Each transform appends its passes to the file, one track per thread, and it loads in\n"
+        "chrome://tracing or Perfetto. Pass None to stop tracing.");
+
+    m.def(
+        "last_synthesis_stats",
+        []()
+        {
+            const NWQEC::SynthesisStats &s = last_synthesis_stats();
+            py::dict d;
+            d["angles"] = s.angles;
+            d["exact"] = s.exact;
+            d["table_hits"] = s.table_hits;
+            d["cache_hits"] = s.cache_hits;
+            d["synthesized"] = s.synthesized;
+            d["failed"] = s.failed;
+            d["elapsed_ms"] = s.elapsed_ms;
+            d["to_upright_ms"] = s.to_upright_ms;
+            d["tdgp_ms"] = s.tdgp_ms;
+            d["diophantine_ms"] = s.diophantine_ms;
+            d["k_iterations"] = s.k_iterations;
+            d["tdgp_candidates"] = s.tdgp_candidates;
+            d["diophantine_calls"] = s.diophantine_calls;
+            d["factoring_timeouts"] = s.factoring_timeouts;
+            d["diophantine_timeouts"] = s.diophantine_timeouts;
+            d["boundary_rechecks"] = s.boundary_rechecks;
+            d["max_k"] = s.max_k;
+            d["max_precision_bits"] = s.max_precision_bits;
+            d["slowest_angle"] = s.slowest_angle;
+            d["slowest_ms"] = s.slowest_ms;
+            return d;
+        },
+        "Return the RZ synthesis counters of the most recent transform as a dict.\n"
+        "Times are in milliseconds and summed over distinct angles. The counters\n"
+        "are also recorded when a transform raises, e.g. after running out of budget.");
+
+    m.def(
+        "transpile_many",
+        [](py::sequence circuits, const std::string &target, bool keep_ccx, bool keep_cx,
+           bool optimize_t_count, py::object epsilon, size_t num_threads)
+        {
+            const auto passes = target_passes(target, optimize_t_count);
+
+            NWQEC::PassConfig config;
+            config.keep_ccx = keep_ccx && target == "clifford_t";
+            config.keep_cx = keep_cx && target == "pbc";
+            config.epsilon_override = epsilon.is_none() ? -1.0 : epsilon.cast<double>();
+            config.silent = true;
+            apply_synthesis_settings(config);
+
+            std::vector<std::unique_ptr<NWQEC::Circuit>> batch;
+            batch.reserve(circuits.size());
+            for (const auto &circuit : circuits)
+                batch.push_back(std::make_unique<NWQEC::Circuit>(circuit.cast<const NWQEC::Circuit &>()));
+
+            batch = run_batch(std::move(batch), passes, config, num_threads);
+
+            py::list out;
+            for (auto &circuit : batch)
+                out.append(py::cast(std::move(circuit)));
+            return out;
+        },
+        py::arg("circuits"),
+        py::arg("target") = "clifford_t",
+        py::arg("keep_ccx") = false,
+        py::arg("keep_cx") = false,
+        py::arg("optimize_t_count") = false,
+        py::arg("epsilon") = py::none(),
+        py::arg("num_threads") = 0,
+        "Transpile a batch of circuits on native threads and return the new Circuits in order.\n"
+        "- target: 'clifford_t', 'pbc', 'clifford_reduction' or 'fuse_t', as the single-circuit transforms\n"
+        "- keep_ccx, keep_cx, optimize_t_count, epsilon: as for those transforms\n"
+        "- num_threads: circuits transpiled at a time (0 = all cores)\n"
+        "Each result is identical to the corresponding single-circuit call. last_synthesis_stats()\n"
+        "afterwards sums the counters of the whole batch.");
+
     m.def("load_qasm", [](const std::string &filename)
           {
-        NWQEC::QASMParser p;
-        if (!p.parse_file(filename))
+        std::unique_ptr<NWQEC::Circuit> circuit;
         {
-            throw std::runtime_error("Failed to parse QASM: " + p.get_error_message());
+            py::gil_scoped_release release;
+            NWQEC::QASMParser p;
+            if (!p.stream_file(filename))
+            {
+                throw std::runtime_error("Failed to parse QASM: " + p.get_error_message());
+            }
+            circuit = p.get_circuit();
         }
-        return p.get_circuit(); }, py::arg("filename"));
+        return circuit; }, py::arg("filename"));
+
+    m.def("load_binary", &NWQEC::load_binary, py::arg("path"), py::call_guard<py::gil_scoped_release>(),
+          "Load a circuit written by Circuit.save_binary or nwqec-cli --binary.");
 }
@@ -0,0 +1,162 @@
+// Checks that AngleTable groups angles exactly as their rounded decimal renderings do, and keeps tolerance buckets apart
+#include "nwqec/core/angle_table.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // The rendering angles were grouped by before AngleTable
+    std::string angle_to_string(double angle, int sig_digits)
+    {
+        if (angle == 0.0)
+        {
+            std::string result = "0.";
+            result.append(std::max(0, sig_digits - 1), '0');
+            return result;
+        }
+        double abs_angle = std::abs(angle);
+        int order = static_cast<int>(std::floor(std::log10(abs_angle)));
+        double scaled = abs_angle / std::pow(10, order - (sig_digits - 1));
+        int scaled_int = static_cast<int>(std::round(scaled));
+        double rounded = scaled_int * std::pow(10, order - (sig_digits - 1));
+        if (angle < 0)
+            rounded = -rounded;
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(std::max(0, (sig_digits - 1) - order)) << rounded;
+        return ss.str();
+    }
+
+    // Groups must be in one-to-one correspondence with renderings
+    size_t check_against_strings(const std::vector<double> &angles, int sig_digits)
+    {
+        NWQEC::AngleTable table(sig_digits);
+        std::map<std::string, size_t> group_of_string;
+        std::map<size_t, std::string> string_of_group;
+        size_t mismatches = 0;
+        for (double angle : angles)
+        {
+            const std::string s = angle_to_string(angle, sig_digits);
+            const size_t group = table.intern(angle);
+            auto [s_it, s_new] = group_of_string.emplace(s, group);
+            auto [g_it, g_new] = string_of_group.emplace(group, s);
+            if (s_it->second != group || g_it->second != s)
+            {
+                if (mismatches < 10)
+                    std::fprintf(stderr, "%d digits, %.17g ('%s'): group %zu, '%s' is group %zu\n", sig_digits, angle,
+                                 s.c_str(), group, g_it->second.c_str(), s_it->second);
+                ++mismatches;
+            }
+        }
+        if (table.size() != group_of_string.size())
+        {
+            std::fprintf(stderr, "%d digits: %zu groups for %zu renderings\n", sig_digits, table.size(),
+                         group_of_string.size());
+            ++mismatches;
+        }
+        return mismatches;
+    }
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+
+    // Random angles over many orders of magnitude, their neighbours, and rounding edges
+    std::mt19937_64 rng(3);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    std::uniform_int_distribution<int> order(-8, 6);
+    std::vector<double> angles = {0.0, -0.0, 1.0, -1.0, 10.0, 9.9995, 9.99949, 0.99995, 0.0099995, 99995.0, 99994.9,
+                                  12345.0, 12350.0, 1.2345e-7, M_PI, -M_PI, M_PI_4, 2 * M_PI};
+    for (int i = 0; i < 20000; ++i)
+    {
+        const double angle = unit(rng) * std::pow(10.0, order(rng));
+        angles.push_back(angle);
+        angles.push_back(std::nextafter(angle, 1e300));
+        angles.push_back(angle * (1 + 1e-6));
+    }
+    // Every half-digit boundary of the 4-digit rendering near 0.1 and 1
+    for (int d = 1000; d < 1100; ++d)
+    {
+        for (double scale : {1e-4, 1e-3})
+        {
+            const double edge = (d + 0.5) * scale;
+            angles.push_back(edge);
+            angles.push_back(std::nextafter(edge, 0.0));
+            angles.push_back(std::nextafter(edge, 1.0));
+            angles.push_back(-edge);
+        }
+    }
+    for (int sig_digits : {4, 2, 6})
+        failures += check_against_strings(angles, sig_digits);
+
+    // Angles inside one rounding bucket share a group; the neighbouring bucket does not
+    {
+        NWQEC::AngleTable table;
+        std::uniform_int_distribution<int> digits(1001, 9998);
+        for (int i = 0; i < 2000; ++i)
+        {
+            const double step = std::pow(10.0, order(rng) - 3);
+            const double center = digits(rng) * step;
+            const size_t group = table.intern(center);
+            bool ok = true;
+            for (double offset : {-0.45, -0.2, 0.2, 0.45})
+                ok = ok && table.intern(center + offset * step) == group;
+            ok = ok && table.intern(center + step) != group && table.intern(center - step) != group &&
+                 table.intern(-center) != group;
+            if (!ok)
+            {
+                std::fprintf(stderr, "bucket of %.6g: members split or neighbours merged\n", center);
+                ++failures;
+            }
+        }
+    }
+
+    // Tolerance buckets keep otherwise equal angles apart
+    {
+        NWQEC::AngleTable table;
+        const int tight = NWQEC::tolerance_bucket(1e-10);
+        const size_t group = table.intern(0.3, tight);
+        const bool same_bucket = NWQEC::tolerance_bucket(1.1e-10) == tight &&
+                                 table.intern(0.30001, NWQEC::tolerance_bucket(1.1e-10)) == group;
+        const bool neighbour_apart = NWQEC::tolerance_bucket(1e-10 / 2) == tight - 1 &&
+                                     NWQEC::tolerance_bucket(1e-10 * 2) == tight + 1 &&
+                                     table.intern(0.3, tight - 1) != group && table.intern(0.3, tight + 1) != group;
+        if (!same_bucket || !neighbour_apart || table.size() != 3)
+        {
+            std::fprintf(stderr, "tolerance buckets: %zu groups\n", table.size());
+            ++failures;
+        }
+        // The first member stays the representative
+        if (table.angles()[group] != 0.3)
+        {
+            std::fprintf(stderr, "tolerance buckets: representative %.17g\n", table.angles()[group]);
+            ++failures;
+        }
+    }
+
+    // Non-finite angles group only with themselves
+    {
+        NWQEC::AngleTable table;
+        const double inf = std::numeric_limits<double>::infinity();
+        const size_t pos = table.intern(inf);
+        if (table.intern(inf) != pos || table.intern(-inf) == pos || table.intern(1e308) == pos ||
+            table.intern(std::nan("")) == pos)
+        {
+            std::fprintf(stderr, "non-finite angles grouped with other values\n");
+            ++failures;
+        }
+    }
+
+    if (failures != 0)
+        return 1;
+    std::printf("angle table checks passed\n");
+    return 0;
+}
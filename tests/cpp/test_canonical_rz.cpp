@@ -0,0 +1,119 @@
+// Checks that canonicalize_rz_angle splits RZ(θ) into T powers, X conjugation and a residual in [0, π/8]
+#include "nwqec/core/angle_table.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Complex = std::complex<double>;
+
+    struct Mat2
+    {
+        Complex a, b, c, d; // [[a, b], [c, d]]
+
+        Mat2 operator*(const Mat2 &o) const
+        {
+            return {a * o.a + b * o.c, a * o.b + b * o.d, c * o.a + d * o.c, c * o.b + d * o.d};
+        }
+    };
+
+    Mat2 rz(double theta)
+    {
+        return {std::polar(1.0, -theta / 2), 0.0, 0.0, std::polar(1.0, theta / 2)};
+    }
+
+    const Mat2 T = {1.0, 0.0, 0.0, std::polar(1.0, M_PI_4)};
+    const Mat2 X = {0.0, 1.0, 1.0, 0.0};
+
+    // Largest entry of A - e^{iφ} B, with the global phase φ taken from tr(A† B)
+    double phase_distance(const Mat2 &A, const Mat2 &B)
+    {
+        const Complex trace = std::conj(A.a) * B.a + std::conj(A.c) * B.c + std::conj(A.b) * B.b + std::conj(A.d) * B.d;
+        const Complex phase = std::abs(trace) > 0 ? std::conj(trace) / std::abs(trace) : 1.0;
+        return std::max({std::abs(A.a - phase * B.a), std::abs(A.b - phase * B.b), std::abs(A.c - phase * B.c),
+                         std::abs(A.d - phase * B.d)});
+    }
+
+    // The gates the canonical form stands for, in circuit-matrix order
+    Mat2 rebuild(const NWQEC::CanonicalRz &c)
+    {
+        Mat2 u = {1.0, 0.0, 0.0, 1.0};
+        for (unsigned i = 0; i < c.t_count; ++i)
+            u = u * T;
+        return c.reflected ? u * X * rz(c.residual) * X : u * rz(c.residual);
+    }
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+
+    std::vector<double> angles = {0.0, -0.0, 1e-300, -1e-300, 1e-12, -1e-12};
+    // Every octant edge in (-6π, 6π], each multiple of 2π among them, and their floating-point neighbours
+    for (int k = -48; k <= 48; ++k)
+    {
+        const double edge = k * M_PI / 8;
+        angles.push_back(edge);
+        angles.push_back(std::nextafter(edge, 1e9));
+        angles.push_back(std::nextafter(edge, -1e9));
+        angles.push_back(edge + 1e-9);
+        angles.push_back(edge - 1e-9);
+    }
+    std::mt19937_64 rng(4);
+    std::uniform_real_distribution<double> wide(-50.0, 50.0);
+    for (int i = 0; i < 2000; ++i)
+        angles.push_back(wide(rng));
+
+    for (double theta : angles)
+    {
+        const NWQEC::CanonicalRz c = NWQEC::canonicalize_rz_angle(theta);
+        if (!(c.residual >= 0.0 && c.residual <= M_PI / 8) || c.t_count >= 8)
+        {
+            std::fprintf(stderr, "%.17g: residual %.17g, t_count %u out of range\n", theta, c.residual, c.t_count);
+            ++failures;
+            continue;
+        }
+        const double distance = phase_distance(rz(theta), rebuild(c));
+        if (!(distance < 1e-9))
+        {
+            std::fprintf(stderr, "%.17g: T^%u %s RZ(%.17g) is off by %.3g\n", theta, c.t_count,
+                         c.reflected ? "X" : "", c.residual, distance);
+            ++failures;
+        }
+    }
+
+    // Angles one π/4 step or a sign apart share a residual
+    for (double theta : {0.1, 0.3, 0.7, 2.0})
+    {
+        const double r = NWQEC::canonicalize_rz_angle(theta).residual;
+        for (double other : {theta + M_PI_4, theta - 3 * M_PI_4, -theta, theta + 2 * M_PI})
+        {
+            if (std::abs(NWQEC::canonicalize_rz_angle(other).residual - r) > 1e-12)
+            {
+                std::fprintf(stderr, "%.6g and %.6g: residuals differ\n", theta, other);
+                ++failures;
+            }
+        }
+    }
+
+    // Exact Clifford+T angles leave no residual
+    for (int k = -16; k <= 16; ++k)
+    {
+        const NWQEC::CanonicalRz c = NWQEC::canonicalize_rz_angle(k * M_PI_4);
+        if (c.residual > 1e-12 || c.t_count != static_cast<unsigned>(((k % 8) + 8) % 8))
+        {
+            std::fprintf(stderr, "%d·π/4: residual %.3g, t_count %u\n", k, c.residual, c.t_count);
+            ++failures;
+        }
+    }
+
+    if (failures != 0)
+        return 1;
+    std::printf("canonical rz checks passed\n");
+    return 0;
+}
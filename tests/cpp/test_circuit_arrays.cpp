@@ -0,0 +1,118 @@
+// Checks CircuitArrays against the operations it flattens, for gate, PBC and placeholder circuits
+#include "nwqec/core/circuit_arrays.hpp"
+#include "nwqec/core/transpiler.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    using Type = NWQEC::Operation::Type;
+
+    std::unique_ptr<NWQEC::Circuit> source(size_t n_qubits)
+    {
+        auto circuit = std::make_unique<NWQEC::Circuit>();
+        circuit->add_qreg("q", n_qubits);
+        for (size_t q = 0; q + 1 < n_qubits; ++q)
+        {
+            circuit->add_operation(NWQEC::Operation(Type::H, {q}));
+            circuit->add_operation(NWQEC::Operation(Type::RZ, {q}, {0.3 + 0.1 * static_cast<double>(q)}));
+            circuit->add_operation(NWQEC::Operation(Type::CX, {q, q + 1}));
+            circuit->add_operation(NWQEC::Operation(Type::T, {q + 1}));
+        }
+        circuit->add_operation(NWQEC::Operation(Type::CCX, {0, 1, n_qubits - 1}));
+        return circuit;
+    }
+
+    // Mismatches between the arrays and a circuit without placeholders
+    size_t check(const NWQEC::Circuit &circuit)
+    {
+        const NWQEC::CircuitArrays a = NWQEC::CircuitArrays::from(circuit);
+        const auto &ops = circuit.get_operations();
+        size_t bad = a.num_operations() != ops.size() || a.qubit_offsets.size() != ops.size() + 1 ||
+                     a.x_words.size() != a.num_pauli_rows() * a.pauli_words ||
+                     a.z_words.size() != a.x_words.size();
+        if (bad)
+            return bad;
+        for (size_t i = 0; i < ops.size(); ++i)
+        {
+            const auto qubits = ops[i].get_qubits();
+            bad += a.types[i] != static_cast<uint8_t>(ops[i].get_type());
+            bad += a.qubit_offsets[i + 1] - a.qubit_offsets[i] != qubits.size();
+            for (size_t k = 0; k < qubits.size() && a.qubit_offsets[i] + k < a.qubits.size(); ++k)
+                bad += a.qubits[a.qubit_offsets[i] + k] != qubits[k];
+
+            const NWQEC::PauliOp &pauli = ops[i].get_pauli_op();
+            if (pauli.get_num_qubits() == 0)
+            {
+                bad += a.pauli_rows[i] != -1;
+                continue;
+            }
+            const auto row = static_cast<size_t>(a.pauli_rows[i]);
+            bad += a.phases[row] != (pauli.get_phase() ? 1 : 0);
+            for (size_t w = 0; w < pauli.num_words(); ++w)
+            {
+                bad += a.x_words[row * a.pauli_words + w] != pauli.x_words()[w];
+                bad += a.z_words[row * a.pauli_words + w] != pauli.z_words()[w];
+            }
+        }
+        return bad;
+    }
+
+    bool same(const NWQEC::CircuitArrays &a, const NWQEC::CircuitArrays &b)
+    {
+        return a.types == b.types && a.qubit_offsets == b.qubit_offsets && a.qubits == b.qubits &&
+               a.pauli_rows == b.pauli_rows && a.x_words == b.x_words && a.z_words == b.z_words &&
+               a.phases == b.phases;
+    }
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+
+    NWQEC::PassConfig config;
+    config.silent = true;
+    config.num_threads = 1;
+    config.use_rz_table = false;
+
+    for (size_t n_qubits : {4, 70})
+    {
+        NWQEC::Transpiler transpiler;
+        auto pbc = transpiler.execute_passes(source(n_qubits), NWQEC::PassSequences::TO_PBC, config);
+        const NWQEC::CircuitArrays a = NWQEC::CircuitArrays::from(*pbc);
+        if (size_t bad = check(*pbc); bad != 0 || a.num_pauli_rows() == 0 || a.pauli_words != (n_qubits + 63) / 64)
+        {
+            std::fprintf(stderr, "pbc n=%zu: %zu mismatches, %zu Pauli rows\n", n_qubits, bad, a.num_pauli_rows());
+            ++failures;
+        }
+    }
+
+    // Placeholders come out as the gates they stand for
+    NWQEC::Circuit deferred;
+    deferred.add_qreg("q", 2);
+    for (double angle : {0.3, -0.7, 0.3, 1.1})
+    {
+        deferred.add_operation(NWQEC::Operation(Type::RZ, {0}, {angle}));
+        deferred.add_operation(NWQEC::Operation(Type::CX, {0, 1}));
+    }
+    NWQEC::SynthesisLimits limits;
+    limits.use_rz_table = false;
+    limits.defer_expansion = true;
+    NWQEC::SynthesizeRzPass(1e-3, 1, nullptr, limits).run(deferred);
+    NWQEC::Circuit expanded = deferred;
+    expanded.expand_rz_sequences();
+    if (!deferred.has_rz_sequences() || check(expanded) != 0 ||
+        !same(NWQEC::CircuitArrays::from(deferred), NWQEC::CircuitArrays::from(expanded)))
+    {
+        std::fprintf(stderr, "clifford+t: arrays differ from the expanded circuit\n");
+        ++failures;
+    }
+
+    if (failures != 0)
+        return 1;
+    std::printf("circuit array checks passed\n");
+    return 0;
+}
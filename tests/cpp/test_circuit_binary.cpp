@@ -0,0 +1,205 @@
+// Checks that binary circuit files round-trip every operation field and reject malformed input
+#include "nwqec/parser/circuit_binary.hpp"
+
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Type = NWQEC::Operation::Type;
+
+    NWQEC::Circuit random_circuit(size_t n_qubits, size_t n_ops, std::mt19937_64 &rng)
+    {
+        const Type types[] = {Type::H, Type::CX, Type::RZ, Type::P4, Type::P8, Type::MEASURE,
+                              Type::T_PAULI, Type::S_PAULI, Type::M_PAULI, Type::BARRIER, Type::U3};
+        std::uniform_int_distribution<size_t> pick(0, sizeof(types) / sizeof(types[0]) - 1);
+        std::uniform_int_distribution<size_t> qubit(0, n_qubits - 1);
+        std::uniform_real_distribution<double> angle(-7.0, 7.0);
+
+        NWQEC::Circuit circuit;
+        circuit.add_qreg("q", n_qubits);
+        circuit.add_creg("c", 3);
+        for (size_t i = 0; i < n_ops; ++i)
+        {
+            const Type type = types[pick(rng)];
+            switch (type)
+            {
+            case Type::CX:
+                circuit.add_operation(NWQEC::Operation(type, {qubit(rng), (i % (n_qubits - 1)) + 1}));
+                break;
+            case Type::RZ:
+                circuit.add_operation(NWQEC::Operation(type, {qubit(rng)}, {angle(rng)}));
+                break;
+            case Type::U3:
+                circuit.add_operation(NWQEC::Operation(type, {qubit(rng)}, {angle(rng), 1e-300, -0.0}));
+                break;
+            case Type::P4:
+            case Type::P8:
+                circuit.add_operation(NWQEC::Operation(type, {qubit(rng)}, {}, {}, NWQEC::PauliOp(),
+                                                       (rng() & 1) != 0, (rng() & 1) != 0));
+                break;
+            case Type::MEASURE:
+                circuit.add_operation(NWQEC::Operation(type, {qubit(rng)}, {}, {i % 3}));
+                break;
+            case Type::BARRIER:
+                circuit.add_operation(NWQEC::Operation(type, {0, 1, qubit(rng), n_qubits - 1}));
+                break;
+            case Type::T_PAULI:
+            case Type::S_PAULI:
+            case Type::M_PAULI:
+            {
+                NWQEC::PauliOp pauli(n_qubits);
+                for (int k = 0; k < 5; ++k)
+                {
+                    pauli.add_x(qubit(rng));
+                    pauli.add_z(qubit(rng));
+                }
+                pauli.set_phase((rng() & 1) != 0);
+                // M_PAULI names its qubits explicitly; the others take the Pauli support
+                if (type == Type::M_PAULI)
+                    circuit.add_operation(NWQEC::Operation(type, {qubit(rng)}, {}, {}, pauli));
+                else
+                    circuit.add_operation(NWQEC::Operation(type, {}, {}, {}, pauli));
+                break;
+            }
+            default:
+                circuit.add_operation(NWQEC::Operation(type, {qubit(rng)}));
+                break;
+            }
+        }
+        return circuit;
+    }
+
+    std::string describe(const NWQEC::Circuit &circuit)
+    {
+        std::ostringstream os;
+        circuit.print(os);
+        for (const NWQEC::Operation &op : circuit.get_operations())
+        {
+            for (double p : op.get_parameters())
+                os << p << ' ';
+            for (size_t q : op.get_qubits())
+                os << q << ' ';
+            os << op.get_pauli_op().get_phase();
+        }
+        return os.str();
+    }
+
+    std::string encode(const NWQEC::Circuit &circuit)
+    {
+        std::ostringstream os;
+        NWQEC::write_binary(circuit, os);
+        return os.str();
+    }
+
+    bool rejects(const std::string &bytes)
+    {
+        try
+        {
+            NWQEC::read_binary(bytes);
+            return false;
+        }
+        catch (const std::runtime_error &)
+        {
+            return true;
+        }
+    }
+} // namespace
+
+int main()
+{
+    std::mt19937_64 rng(5);
+    size_t failures = 0;
+
+    for (size_t n_qubits : {2, 64, 65, 300})
+    {
+        const NWQEC::Circuit circuit = random_circuit(n_qubits, 3000, rng);
+        const std::string bytes = encode(circuit);
+        const NWQEC::Circuit loaded = NWQEC::read_binary(bytes);
+        if (describe(loaded) != describe(circuit) || encode(loaded) != bytes ||
+            loaded.count_ops() != circuit.count_ops() || loaded.is_clifford_t() != circuit.is_clifford_t())
+        {
+            std::fprintf(stderr, "n=%zu: round trip differs\n", n_qubits);
+            ++failures;
+        }
+
+        // Every strict prefix is truncated, and corrupt headers are refused
+        for (size_t cut : {size_t(0), size_t(3), size_t(31), bytes.size() / 2, bytes.size() - 1})
+            failures += !rejects(bytes.substr(0, cut));
+        std::string bad_version = bytes, bad_type = bytes;
+        bad_version[4] = 9;
+        bad_type[32] = static_cast<char>(0xFE);
+        failures += !rejects(bad_version) + !rejects(bad_type) + !rejects(bytes + '\0');
+    }
+
+    // Files written by save_binary load through the mapping
+    const std::string path = "test_circuit_binary.nwqc";
+    const NWQEC::Circuit circuit = random_circuit(100, 500, rng);
+    NWQEC::save_binary(circuit, path);
+    failures += !NWQEC::is_binary_circuit_file(path);
+    failures += describe(*NWQEC::load_binary(path)) != describe(circuit);
+    std::remove(path.c_str());
+
+    // Qubit and bit indices past the header's register sizes are refused
+    {
+        NWQEC::Circuit small;
+        small.add_qreg("q", 3);
+        small.add_creg("c", 3);
+        small.add_operation(NWQEC::Operation(Type::CX, {1, 2}));
+        small.add_operation(NWQEC::Operation(Type::MEASURE, {0}, {}, {2}));
+        const std::string bytes = encode(small);
+        std::string few_qubits = bytes, few_bits = bytes;
+        few_qubits[8] = 2;
+        few_bits[16] = 2;
+        failures += rejects(bytes) + !rejects(few_qubits) + !rejects(few_bits);
+    }
+
+    // Operations whose qubit, bit or Pauli operands do not fit their type or the header are refused
+    {
+        auto with = [](size_t n_qubits, NWQEC::Operation op)
+        {
+            NWQEC::Circuit circuit;
+            circuit.add_qreg("q", n_qubits);
+            circuit.add_creg("c", 1);
+            circuit.add_operation(std::move(op));
+            return encode(circuit);
+        };
+        NWQEC::PauliOp narrow(3), wide(6), fits(4);
+        narrow.add_x(0);
+        wide.add_x(1);
+        fits.add_z(2);
+        const std::string malformed[] = {
+            with(4, NWQEC::Operation(Type::CX, {})),
+            with(4, NWQEC::Operation(Type::CX, {1})),
+            with(4, NWQEC::Operation(Type::H, {0, 1})),
+            with(4, NWQEC::Operation(Type::CCX, {0, 1})),
+            with(4, NWQEC::Operation(Type::MEASURE, {0})),
+            with(4, NWQEC::Operation(Type::RESET, {0}, {}, {0})),
+            with(4, NWQEC::Operation(Type::T_PAULI, {}, {}, {}, narrow)),
+            with(4, NWQEC::Operation(Type::T_PAULI, {}, {}, {}, wide)),
+            with(4, NWQEC::Operation(Type::H, {0}, {}, {}, fits)),
+            with(4, NWQEC::Operation(Type::S_PAULI, {0})),
+        };
+        for (const std::string &bytes : malformed)
+            failures += !rejects(bytes);
+
+        std::string stray = with(4, NWQEC::Operation(Type::T_PAULI, {}, {}, {}, fits));
+        failures += rejects(stray);
+        stray[37] = static_cast<char>(0x80); // X on qubit 7 of the 4-qubit string
+        failures += !rejects(stray);
+    }
+
+    NWQEC::Circuit empty;
+    failures += describe(NWQEC::read_binary(encode(empty))) != describe(empty);
+
+    if (failures != 0)
+    {
+        std::fprintf(stderr, "%zu binary circuit checks failed\n", failures);
+        return 1;
+    }
+    std::printf("Binary circuit checks passed\n");
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Checks Circuit's running operation counters and cached depth/duration against a recount
+#include "nwqec/core/circuit.hpp"
+
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    using Type = NWQEC::Operation::Type;
+
+    size_t compare(const NWQEC::Circuit &circuit)
+    {
+        std::unordered_map<std::string, size_t> expected;
+        std::vector<size_t> by_type(NWQEC::Operation::NUM_TYPES, 0);
+        for (const NWQEC::Operation &op : circuit.get_operations())
+        {
+            expected[op.get_type_name()]++;
+            by_type[static_cast<size_t>(op.get_type())]++;
+        }
+
+        // Depth and duration from scratch, one qubit frontier per map entry
+        std::map<size_t, size_t> depth;
+        std::map<size_t, double> duration;
+        size_t max_depth = 0;
+        double max_duration = 0.0;
+        for (const NWQEC::Operation &op : circuit.get_operations())
+        {
+            size_t d = 0;
+            double t = 0.0;
+            for (size_t q : op.get_qubits())
+            {
+                d = std::max(d, depth[q]);
+                t = std::max(t, duration[q]);
+            }
+            t += circuit.get_gate_duration(op.get_type(), 7.0);
+            for (size_t q : op.get_qubits())
+            {
+                depth[q] = d + 1;
+                duration[q] = t;
+                max_depth = std::max(max_depth, d + 1);
+                max_duration = std::max(max_duration, t);
+            }
+        }
+
+        size_t mismatches = circuit.count_ops() != expected;
+        // Twice, so the second call reads the cached value
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            mismatches += circuit.depth() != max_depth;
+            mismatches += circuit.duration(7.0) != max_duration;
+        }
+        for (size_t t = 0; t < NWQEC::Operation::NUM_TYPES; ++t)
+            mismatches += circuit.get_operation_count(static_cast<Type>(t)) != by_type[t];
+        return mismatches;
+    }
+} // namespace
+
+int main()
+{
+    std::mt19937_64 rng(11);
+    const Type types[] = {Type::H, Type::S, Type::T, Type::TDG, Type::CX, Type::RZ,
+                          Type::P4, Type::P8, Type::P16, Type::MEASURE, Type::T_PAULI};
+    std::uniform_int_distribution<size_t> pick(0, sizeof(types) / sizeof(types[0]) - 1);
+    size_t failures = 0;
+
+    NWQEC::Circuit circuit;
+    circuit.add_qreg("q", 4);
+    std::vector<NWQEC::Operation> ops;
+    for (int i = 0; i < 2000; ++i)
+    {
+        const Type type = types[pick(rng)];
+        std::vector<size_t> qubits{static_cast<size_t>(i % 4)};
+        if (type == Type::CX)
+            qubits.push_back((qubits[0] + 1) % 4);
+        // P4/P8/P16 print as t, tdg, rx(pi/4), rz(-pi/8), ... depending on sign and axis
+        ops.emplace_back(type, qubits, std::vector<double>{}, std::vector<size_t>{}, NWQEC::PauliOp(),
+                         (rng() & 1) != 0, (rng() & 1) != 0);
+        circuit.add_operation(ops.back());
+        if (i % 250 == 0)
+            failures += compare(circuit);
+    }
+    failures += compare(circuit);
+
+    // Counters restart when the operation list is replaced, and survive copies
+    ops.erase(ops.begin() + static_cast<std::ptrdiff_t>(ops.size() / 3), ops.end());
+    circuit.set_operations_list(ops);
+    failures += compare(circuit);
+    NWQEC::Circuit copy = circuit;
+    copy.add_operation(NWQEC::Operation(Type::H, {0}));
+    failures += compare(copy) + compare(circuit);
+    failures += copy.get_operation_count(Type::H) != circuit.get_operation_count(Type::H) + 1;
+
+    // A bulk block appends the same operations and counts as gate-by-gate adds
+    NWQEC::GateBlock block;
+    for (Type type : {Type::H, Type::T, Type::S, Type::X, Type::H, Type::Z})
+        block.push_back(type);
+    NWQEC::Circuit bulk = circuit, single = circuit;
+    bulk.append_block(block, 5);
+    for (Type type : block.types)
+        single.add_operation(NWQEC::Operation(type, {5}));
+    failures += compare(bulk);
+    failures += bulk.get_operations().size() != single.get_operations().size();
+    for (size_t i = circuit.get_operations().size(); i < bulk.get_operations().size(); ++i)
+    {
+        const NWQEC::Operation &a = bulk.get_operations()[i], &b = single.get_operations()[i];
+        failures += a.get_type() != b.get_type() || a.get_qubits() != b.get_qubits();
+    }
+    failures += bulk.get_num_qubits() != single.get_num_qubits() || bulk.is_clifford_t() != single.is_clifford_t();
+
+    if (failures != 0)
+    {
+        std::fprintf(stderr, "%zu operation count mismatches\n", failures);
+        return 1;
+    }
+    std::printf("Operation count checks passed\n");
+    return 0;
+}
@@ -0,0 +1,154 @@
+// Checks CliffordTReducer output against 2x2 unitaries of random single-qubit runs
+#include "nwqec/core/clifford_t_reducer.hpp"
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Type = NWQEC::Operation::Type;
+    using Complex = std::complex<double>;
+    using Matrix = std::array<Complex, 4>; // Row-major
+
+    Matrix gate_matrix(const NWQEC::Operation &op)
+    {
+        const double r = 1 / std::sqrt(2.0);
+        const Complex i(0, 1), w = std::polar(1.0, M_PI / 4);
+        switch (op.get_type())
+        {
+        case Type::X:
+            return {0, 1, 1, 0};
+        case Type::Y:
+            return {0, -i, i, 0};
+        case Type::Z:
+            return {1, 0, 0, -1};
+        case Type::H:
+            return {r, r, r, -r};
+        case Type::S:
+            return {1, 0, 0, i};
+        case Type::SDG:
+            return {1, 0, 0, -i};
+        case Type::SX:
+            return {(1.0 + i) / 2.0, (1.0 - i) / 2.0, (1.0 - i) / 2.0, (1.0 + i) / 2.0};
+        case Type::SXDG:
+            return {(1.0 - i) / 2.0, (1.0 + i) / 2.0, (1.0 + i) / 2.0, (1.0 - i) / 2.0};
+        case Type::T:
+            return {1, 0, 0, w};
+        case Type::TDG:
+            return {1, 0, 0, std::conj(w)};
+        case Type::RZ:
+        {
+            const double theta = op.get_parameters()[0];
+            return {std::polar(1.0, -theta / 2), 0, 0, std::polar(1.0, theta / 2)};
+        }
+        default:
+            return {1, 0, 0, 1};
+        }
+    }
+
+    // Product of the run's gates, last gate leftmost
+    Matrix run_matrix(const std::vector<NWQEC::Operation> &run)
+    {
+        Matrix m = {1, 0, 0, 1};
+        for (const NWQEC::Operation &op : run)
+        {
+            const Matrix g = gate_matrix(op);
+            m = {g[0] * m[0] + g[1] * m[2], g[0] * m[1] + g[1] * m[3],
+                 g[2] * m[0] + g[3] * m[2], g[2] * m[1] + g[3] * m[3]};
+        }
+        return m;
+    }
+
+    // |tr(A^dagger B)| = 2 exactly when A and B agree up to phase
+    bool equal_up_to_phase(const Matrix &a, const Matrix &b)
+    {
+        Complex trace = 0;
+        for (size_t k = 0; k < 4; ++k)
+            trace += std::conj(a[k]) * b[k];
+        return std::abs(std::abs(trace) - 2) < 1e-9;
+    }
+
+    size_t t_count(const std::vector<NWQEC::Operation> &run)
+    {
+        size_t n = 0;
+        for (const NWQEC::Operation &op : run)
+            n += op.get_type() == Type::T || op.get_type() == Type::TDG;
+        return n;
+    }
+
+    bool same_types(const std::vector<NWQEC::Operation> &a, const std::vector<NWQEC::Operation> &b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t k = 0; k < a.size(); ++k)
+        {
+            if (a[k].get_type() != b[k].get_type())
+                return false;
+        }
+        return true;
+    }
+} // namespace
+
+int main()
+{
+    std::mt19937_64 rng(29);
+    const Type gates[] = {Type::X, Type::Y, Type::Z, Type::H, Type::S, Type::SDG,
+                          Type::SX, Type::SXDG, Type::ID, Type::T, Type::TDG, Type::T, Type::TDG};
+    std::uniform_int_distribution<size_t> pick(0, sizeof(gates) / sizeof(gates[0]));
+    std::uniform_int_distribution<size_t> length(0, 60);
+    size_t failures = 0;
+
+    for (size_t trial = 0; trial < 5000; ++trial)
+    {
+        std::vector<NWQEC::Operation> run;
+        for (size_t n = length(rng); n > 0; --n)
+        {
+            size_t g = pick(rng);
+            if (g == sizeof(gates) / sizeof(gates[0]))
+                run.push_back(NWQEC::Operation(Type::RZ, {3}, {0.1 * static_cast<double>(n)}));
+            else
+                run.push_back(NWQEC::Operation(gates[g], {3}));
+        }
+
+        std::vector<NWQEC::Operation> reduced = NWQEC::CliffordTReducer::reduce(run);
+        bool ok = equal_up_to_phase(run_matrix(run), run_matrix(reduced)) && t_count(reduced) <= t_count(run) &&
+                  reduced.size() <= run.size() && same_types(NWQEC::CliffordTReducer::reduce(reduced), reduced);
+        for (const NWQEC::Operation &op : reduced)
+            ok = ok && op.get_qubits().size() == 1 && op.get_qubits()[0] == 3;
+        if (!ok)
+        {
+            std::fprintf(stderr, "trial %zu: %zu gates reduced to %zu, not equivalent or not stable\n", trial,
+                         run.size(), reduced.size());
+            ++failures;
+        }
+    }
+
+    // T T fuses to S
+    std::vector<NWQEC::Operation> tt = {NWQEC::Operation(Type::T, {0}), NWQEC::Operation(Type::T, {0})};
+    std::vector<NWQEC::Operation> fused = NWQEC::CliffordTReducer::reduce(tt);
+    if (fused.size() != 1 || fused[0].get_type() != Type::S)
+    {
+        std::fprintf(stderr, "t t: expected s\n");
+        ++failures;
+    }
+    // T H S S H T = T X T: the X between the rotations turns the second into the inverse of the first
+    std::vector<NWQEC::Operation> flip = {NWQEC::Operation(Type::T, {0}), NWQEC::Operation(Type::H, {0}),
+                                          NWQEC::Operation(Type::S, {0}), NWQEC::Operation(Type::S, {0}),
+                                          NWQEC::Operation(Type::H, {0}), NWQEC::Operation(Type::T, {0})};
+    std::vector<NWQEC::Operation> flipped = NWQEC::CliffordTReducer::reduce(flip);
+    if (t_count(flipped) != 0 || flipped.size() > 1 ||
+        !equal_up_to_phase(run_matrix(flip), run_matrix(flipped)))
+    {
+        std::fprintf(stderr, "t h s s h t: expected a single Clifford, got %zu gates\n", flipped.size());
+        ++failures;
+    }
+
+    if (failures != 0)
+        return 1;
+    std::printf("Clifford+T reducer checks passed\n");
+    return 0;
+}
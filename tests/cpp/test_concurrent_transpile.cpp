@@ -0,0 +1,101 @@
+// Checks that transpiles running on several threads at once match running them one by one
+#include "nwqec/core/parallel.hpp"
+#include "nwqec/core/transpiler.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Type = NWQEC::Operation::Type;
+
+    // Each circuit has its own angles, so concurrent runs synthesize different requests
+    std::unique_ptr<NWQEC::Circuit> rz_circuit(size_t seed)
+    {
+        auto circuit = std::make_unique<NWQEC::Circuit>();
+        circuit->add_qreg("q", 3);
+        for (size_t i = 0; i < 4; ++i)
+        {
+            const size_t q = i % 3;
+            circuit->add_operation(NWQEC::Operation(Type::H, {q}));
+            circuit->add_operation(NWQEC::Operation(Type::RZ, {q}, {0.1 + 0.37 * static_cast<double>(seed * 4 + i)}));
+            circuit->add_operation(NWQEC::Operation(Type::CX, {q, (q + 1) % 3}));
+        }
+        return circuit;
+    }
+
+    std::string transpile(size_t seed, const std::vector<NWQEC::PassType> &passes, const NWQEC::PassConfig &config)
+    {
+        NWQEC::Transpiler transpiler;
+        auto circuit = transpiler.execute_passes(rz_circuit(seed), passes, config);
+        std::ostringstream os;
+        circuit->print(os);
+        return os.str();
+    }
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+    const size_t n = 6;
+
+    const std::string cache_path = "concurrent_transpile_cache.txt";
+    std::remove(cache_path.c_str());
+
+    NWQEC::PassConfig config;
+    config.silent = true;
+    config.num_threads = 1;
+    config.use_rz_table = false;
+    config.synthesis_cache_path = cache_path;
+
+    for (const auto *passes : {&NWQEC::PassSequences::TO_CLIFFORD_T, &NWQEC::PassSequences::TO_PBC})
+    {
+        std::vector<std::string> serial(n), concurrent(n);
+        for (size_t i = 0; i < n; ++i)
+            serial[i] = transpile(i, *passes, config);
+        NWQEC::parallel_for(n, n, [&](size_t i)
+                            { concurrent[i] = transpile(i, *passes, config); });
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (concurrent[i] != serial[i])
+            {
+                std::fprintf(stderr, "circuit %zu: concurrent output differs from serial\n", i);
+                ++failures;
+            }
+        }
+    }
+
+    // Concurrent transforms share one cache per file, and its lines stay whole
+    auto a = NWQEC::SynthesisCache::shared(cache_path);
+    auto b = NWQEC::SynthesisCache::shared(cache_path);
+    if (a != b || a->size() != 4 * n)
+    {
+        std::fprintf(stderr, "cache: shared %d, %zu entries for %zu angles\n", a == b, a->size(), 4 * n);
+        ++failures;
+    }
+    a.reset();
+    b.reset();
+
+    // Every angle missing from the cache, so all workers append at once
+    std::remove(cache_path.c_str());
+
+    std::vector<std::string> concurrent(n);
+    NWQEC::parallel_for(n, n, [&](size_t i)
+                        { concurrent[i] = transpile(i, NWQEC::PassSequences::TO_CLIFFORD_T, config); });
+    NWQEC::SynthesisCache reopened(cache_path);
+    if (reopened.size() != 4 * n)
+    {
+        std::fprintf(stderr, "cache: %zu entries readable after concurrent appends\n", reopened.size());
+        ++failures;
+    }
+    std::remove(cache_path.c_str());
+
+    if (failures != 0)
+        return 1;
+    std::printf("concurrent transpile checks passed\n");
+    return 0;
+}
@@ -0,0 +1,158 @@
+// Checks that TfusePass dumps only through a configured sink, and AsyncFileDumpSink output
+#include "nwqec/core/debug_dump.hpp"
+#include "nwqec/passes/tfuse_pass.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Type = NWQEC::Operation::Type;
+
+    struct RecordingSink : NWQEC::DumpSink
+    {
+        std::vector<std::pair<std::string, std::string>> dumps;
+
+        void dump(const std::string &name, Writer write) override
+        {
+            std::ostringstream text;
+            write(text);
+            dumps.emplace_back(name, text.str());
+        }
+    };
+
+    // t_pauli +ZII twice, t_pauli +IXI, m_pauli +ZZZ: the two Z rotations fuse into an S rotation
+    NWQEC::Circuit pbc_circuit()
+    {
+        NWQEC::Circuit circuit;
+        circuit.add_qreg("q", 3);
+        circuit.add_creg("c", 1);
+        for (const char *pauli : {"+ZII", "+ZII", "+IXI"})
+        {
+            NWQEC::PauliOp op(3);
+            op.from_string(pauli);
+            circuit.add_operation(NWQEC::Operation(Type::T_PAULI, {}, {}, {}, op));
+        }
+        NWQEC::PauliOp m(3);
+        m.from_string("+ZZZ");
+        circuit.add_operation(NWQEC::Operation(Type::M_PAULI, {}, {}, {0}, m));
+        return circuit;
+    }
+
+    std::string read_file(const std::filesystem::path &path)
+    {
+        std::ifstream file(path);
+        std::ostringstream text;
+        text << file.rdbuf();
+        return text.str();
+    }
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "nwqec_test_debug_dump";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const std::filesystem::path cwd = std::filesystem::current_path();
+    std::filesystem::current_path(dir);
+
+    // Without a sink nothing is written
+    NWQEC::Circuit plain = pbc_circuit();
+    NWQEC::TfusePass(1).run(plain);
+    if (!std::filesystem::is_empty(dir))
+    {
+        std::fprintf(stderr, "no sink: TfusePass wrote into the working directory\n");
+        ++failures;
+    }
+
+    auto sink = std::make_shared<RecordingSink>();
+    NWQEC::Circuit dumped = pbc_circuit();
+    NWQEC::TfusePass(1, sink).run(dumped);
+    if (sink->dumps.size() != 1 || sink->dumps[0].first != "optimized_circuit.qasm" ||
+        sink->dumps[0].second.find("qreg q[3];") == std::string::npos ||
+        sink->dumps[0].second.find("t_pauli") == std::string::npos ||
+        sink->dumps[0].second.find("s_pauli") == std::string::npos ||
+        dumped.get_operations().size() != plain.get_operations().size())
+    {
+        std::fprintf(stderr, "recording sink: expected one optimized_circuit.qasm dump\n");
+        ++failures;
+    }
+    std::filesystem::current_path(cwd);
+
+    // The sink creates its directory; one that cannot be created is an error
+    const std::filesystem::path nested = dir / "new" / "dumps";
+    {
+        NWQEC::AsyncFileDumpSink files(nested.string());
+        files.dump("a.txt", [](std::ostream &os)
+                   { os << "a\n"; });
+        files.dump("missing/b.txt", [](std::ostream &os)
+                   { os << "b\n"; });
+        const bool all_written = files.flush();
+        const std::vector<std::string> failed = files.failed();
+        if (read_file(nested / "a.txt") != "a\n" || all_written || files.written() != 1 || failed.size() != 1 ||
+            failed[0] != (nested / "missing/b.txt").string())
+        {
+            std::fprintf(stderr, "async sink: created directory or failed dump not reported\n");
+            ++failures;
+        }
+    }
+    {
+        bool threw = false;
+        try
+        {
+            NWQEC::AsyncFileDumpSink files((nested / "a.txt" / "sub").string());
+        }
+        catch (const std::runtime_error &)
+        {
+            threw = true;
+        }
+        if (!threw)
+        {
+            std::fprintf(stderr, "async sink: directory under a file accepted\n");
+            ++failures;
+        }
+    }
+
+    {
+        NWQEC::AsyncFileDumpSink files(dir.string());
+        for (int i = 0; i < 3; ++i)
+            files.dump("dump" + std::to_string(i) + ".txt", [i](std::ostream &os)
+                       { os << "dump " << i << "\n"; });
+        if (!files.flush() || files.written() != 3)
+        {
+            std::fprintf(stderr, "async sink: flush reported a failure\n");
+            ++failures;
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            if (read_file(dir / ("dump" + std::to_string(i) + ".txt")) != "dump " + std::to_string(i) + "\n")
+            {
+                std::fprintf(stderr, "async sink: dump%d.txt missing after flush\n", i);
+                ++failures;
+            }
+        }
+        // Written by the destructor at the latest
+        files.dump("last.txt", [](std::ostream &os)
+                   { os << "last\n"; });
+        files.dump("missing/dir.txt", [](std::ostream &os)
+                   { os << "skipped\n"; });
+    }
+    if (read_file(dir / "last.txt") != "last\n")
+    {
+        std::fprintf(stderr, "async sink: pending dump lost on destruction\n");
+        ++failures;
+    }
+    std::filesystem::remove_all(dir);
+
+    if (failures != 0)
+        return 1;
+    std::printf("debug dump checks passed\n");
+    return 0;
+}
@@ -0,0 +1,444 @@
+// Checks that DecomposePass expands every gate type bit-for-bit as the hand-written per-gate decompositions did
+#include "nwqec/passes/decompose_pass.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using NWQEC::Operation;
+    using Type = Operation::Type;
+
+    /**
+     * The per-gate decomposition the template table replaced, kept as written
+     * (an empty result keeps the operation)
+     */
+    std::vector<Operation> reference_decompose(const Operation &op)
+    {
+        std::vector<Operation> result;
+        auto type = op.get_type();
+        auto qubits = op.get_qubits();
+        auto params = op.get_parameters();
+
+        switch (type)
+        {
+        case Operation::Type::RX:
+        {
+            result.push_back(Operation(Operation::Type::H, {qubits[0]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[0]}));
+            result.push_back(Operation(Operation::Type::H, {qubits[0]}, {}));
+            break;
+        }
+        case Operation::Type::RY:
+        {
+            result.push_back(Operation(Operation::Type::SDG, {qubits[0]}, {}));
+            result.push_back(Operation(Operation::Type::H, {qubits[0]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[0]}));
+            result.push_back(Operation(Operation::Type::H, {qubits[0]}, {}));
+            result.push_back(Operation(Operation::Type::S, {qubits[0]}, {}));
+            break;
+        }
+        case Operation::Type::P:
+        {
+            result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[0]}));
+            break;
+        }
+        case Operation::Type::U:
+        case Operation::Type::U3:
+        {
+            result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[2]})); // λ
+            result.push_back(Operation(Operation::Type::SX, {qubits[0]}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[0] + M_PI})); // θ
+            result.push_back(Operation(Operation::Type::SX, {qubits[0]}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[1] + 3 * M_PI})); // φ
+
+            break;
+        }
+        case Operation::Type::U1: // u1(θ) = rz(θ)
+        {
+            result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[0]}));
+            break;
+        }
+        case Operation::Type::U2: // u2(θ, φ) = u(pi/2, φ, θ)
+        {
+            result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[1]})); // λ
+            result.push_back(Operation(Operation::Type::SX, {qubits[0]}));
+            result.push_back(Operation(Operation::Type::S, {qubits[0]}));
+            result.push_back(Operation(Operation::Type::Z, {qubits[0]}));
+            result.push_back(Operation(Operation::Type::SX, {qubits[0]}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[0] - 3 * M_PI})); // φ
+            break;
+        }
+        case Operation::Type::CY:
+        {
+            result.push_back(Operation(Operation::Type::SDG, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::S, {qubits[1]}, {}));
+            break;
+        }
+        case Operation::Type::CZ:
+        {
+            result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
+            break;
+        }
+        case Operation::Type::CH:
+        {
+            result.push_back(Operation(Operation::Type::S, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::T, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::TDG, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::SDG, {qubits[1]}, {}));
+            break;
+        }
+        case Operation::Type::CS:
+        {
+            result.push_back(Operation(Operation::Type::S, {qubits[0]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::SDG, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::S, {qubits[1]}, {}));
+            break;
+        }
+        case Operation::Type::CSDG:
+        {
+            result.push_back(Operation(Operation::Type::TDG, {qubits[0]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::T, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::TDG, {qubits[1]}, {}));
+            break;
+        }
+        case Operation::Type::CT:
+        {
+            result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {M_PI / 8}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {-M_PI / 8}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {M_PI / 8}));
+
+            break;
+        }
+        case Operation::Type::CTDG:
+        {
+            result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {-M_PI / 8}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {M_PI / 8}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {-M_PI / 8}));
+            break;
+        }
+        case Operation::Type::CSX:
+        {
+            result.push_back(Operation(Operation::Type::T, {qubits[0]}, {}));
+            result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::TDG, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::T, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
+            break;
+        }
+        case Operation::Type::CRX:
+        {
+            result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[0] / 2}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {-params[0] / 2}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
+            break;
+        }
+        case Operation::Type::CRY:
+        {
+            result.push_back(Operation(Operation::Type::SX, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[0] / 2}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {-params[0] / 2}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::SXDG, {qubits[1]}, {}));
+            break;
+        }
+        case Operation::Type::CRZ:
+        {
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[0] / 2}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {-params[0] / 2}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            break;
+        }
+        case Operation::Type::CP:
+        case Operation::Type::CU1:
+        {
+            result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[0] / 2}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {-params[0] / 2}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[0] / 2}));
+            break;
+        }
+        case Operation::Type::CU:
+        case Operation::Type::CU3:
+        {
+            result.push_back(Operation(Operation::Type::RZ, {qubits[0]}, {params[3] + params[2] / 2 + params[1] / 2}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[2] / 2 - params[1] / 2}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {-params[2] / 2 - params[1] / 2}));
+            result.push_back(Operation(Operation::Type::SX, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {M_PI - params[0] / 2}));
+            result.push_back(Operation(Operation::Type::SX, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::Z, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::SX, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[0] / 2 + M_PI}));
+            result.push_back(Operation(Operation::Type::SX, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[1] + 3 * M_PI}));
+            break;
+        }
+
+        case Operation::Type::RXX:
+        {
+            result.push_back(Operation(Operation::Type::H, {qubits[0]}, {}));
+            result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[0]}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::H, {qubits[0]}, {}));
+            result.push_back(Operation(Operation::Type::H, {qubits[1]}, {}));
+            break;
+        }
+        case Operation::Type::RYY:
+        {
+            result.push_back(Operation(Operation::Type::SX, {qubits[0]}, {}));
+            result.push_back(Operation(Operation::Type::SX, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[0]}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::SXDG, {qubits[0]}, {}));
+            result.push_back(Operation(Operation::Type::SXDG, {qubits[1]}, {}));
+            break;
+        }
+        case Operation::Type::RZZ:
+        {
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::RZ, {qubits[1]}, {params[0]}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            break;
+        }
+        case Operation::Type::SWAP:
+        {
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[1], qubits[0]}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}));
+            break;
+        }
+        case Operation::Type::CCX:
+        {
+            result.push_back(Operation(Operation::Type::H, {qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[1], qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::TDG, {qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::T, {qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[1], qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::T, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::TDG, {qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::T, {qubits[0]}, {}));
+            result.push_back(Operation(Operation::Type::TDG, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::T, {qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::H, {qubits[2]}, {}));
+
+            break;
+        }
+        case Operation::Type::CSWAP:
+        {
+            result.push_back(Operation(Operation::Type::CX, {qubits[2], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::H, {qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[1], qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::TDG, {qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::T, {qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[1], qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::T, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::TDG, {qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::T, {qubits[0]}, {}));
+            result.push_back(Operation(Operation::Type::TDG, {qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[1]}, {}));
+            result.push_back(Operation(Operation::Type::T, {qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::H, {qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[2], qubits[1]}, {}));
+            break;
+        }
+        case Operation::Type::RCCX:
+        {
+            result.push_back(Operation(Operation::Type::H, {qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::T, {qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[1], qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::TDG, {qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[0], qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::T, {qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::CX, {qubits[1], qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::TDG, {qubits[2]}, {}));
+            result.push_back(Operation(Operation::Type::H, {qubits[2]}, {}));
+            break;
+        }
+        default:
+            // For unsupported operations, return empty vector
+            return {};
+        }
+
+        return result;
+    }
+
+    // What the pass did before the template table, on a whole circuit
+    bool reference_run(NWQEC::Circuit &circuit, bool keep_ccx)
+    {
+        bool modified = false;
+        NWQEC::Circuit out;
+        out.add_qreg("q", circuit.get_num_qubits());
+        out.add_creg("c", circuit.get_num_bits());
+        for (const auto &op : circuit.get_operations())
+        {
+            std::vector<Operation> expanded;
+            if (!circuit.is_clifford_t_operation(op.get_type()) && !(keep_ccx && op.get_type() == Type::CCX))
+                expanded = reference_decompose(op);
+            if (expanded.empty())
+                out.add_operation(op);
+            for (const auto &e : expanded)
+                out.add_operation(e);
+            modified = modified || !expanded.empty();
+        }
+        if (modified)
+            circuit = std::move(out);
+        return modified;
+    }
+
+    size_t arity(Type type)
+    {
+        if (type < Type::CX)
+            return 1;
+        return type < Type::CCX ? 2 : 3;
+    }
+
+    // Index of the first operation that differs in type, operands or parameter bits
+    size_t first_difference(const NWQEC::Circuit &a, const NWQEC::Circuit &b)
+    {
+        const auto &x = a.get_operations();
+        const auto &y = b.get_operations();
+        const size_t n = std::min(x.size(), y.size());
+        for (size_t i = 0; i < n; ++i)
+        {
+            const auto xq = x[i].get_qubits(), yq = y[i].get_qubits();
+            const auto xp = x[i].get_parameters(), yp = y[i].get_parameters();
+            bool same = x[i].get_type() == y[i].get_type() && xq.size() == yq.size() && xp.size() == yp.size();
+            for (size_t k = 0; same && k < xq.size(); ++k)
+                same = xq[k] == yq[k];
+            for (size_t k = 0; same && k < xp.size(); ++k)
+            {
+                const double u = xp[k], v = yp[k];
+                same = std::memcmp(&u, &v, sizeof(double)) == 0;
+            }
+            if (!same)
+                return i;
+        }
+        return x.size() == y.size() ? std::numeric_limits<size_t>::max() : n;
+    }
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+    std::mt19937_64 rng(30);
+    std::uniform_real_distribution<double> wide(-10.0, 10.0);
+    std::uniform_int_distribution<int> exponent(-300, 300);
+    auto random_param = [&]() -> double
+    {
+        switch (rng() % 8)
+        {
+        case 0:
+            return std::ldexp(wide(rng), exponent(rng) / 4); // Far from unit scale
+        case 1:
+            return M_PI * static_cast<double>(static_cast<int>(rng() % 17) - 8) / 4; // Multiples of pi/4
+        case 2:
+            return std::nextafter(M_PI, rng() & 1 ? 10.0 : -10.0);
+        default:
+            return wide(rng);
+        }
+    };
+
+    for (size_t t = static_cast<size_t>(Type::X); t <= static_cast<size_t>(Type::RCCX); ++t)
+    {
+        const Type type = static_cast<Type>(t);
+        NWQEC::Circuit circuit;
+        circuit.add_qreg("q", 5);
+        for (int i = 0; i < 200; ++i)
+        {
+            std::vector<size_t> qubits;
+            while (qubits.size() < arity(type))
+            {
+                const size_t q = rng() % 5;
+                if (std::find(qubits.begin(), qubits.end(), q) == qubits.end())
+                    qubits.push_back(q);
+            }
+            // cu3 also comes with three parameters; its missing fourth reads as zero
+            const size_t num_params = type == Type::CU3 && i % 2 == 1 ? 3 : 4;
+            std::vector<double> params;
+            for (size_t k = 0; k < num_params; ++k)
+                params.push_back(random_param());
+            Operation op(type, qubits, params);
+            circuit.add_operation(op);
+            circuit.add_operation(Operation(Type::CX, {qubits[0], (qubits[0] + 1) % 5}));
+        }
+
+        for (bool keep_ccx : {false, true})
+        {
+            NWQEC::Circuit expected = circuit;
+            if (type == Type::CU3)
+            {
+                // The reference reads params[3]: give the three-parameter gates an explicit zero
+                NWQEC::Circuit padded;
+                padded.add_qreg("q", 5);
+                for (const auto &op : circuit.get_operations())
+                {
+                    const auto p = op.get_parameters();
+                    std::vector<double> params(p.begin(), p.end());
+                    if (op.get_type() == Type::CU3 && params.size() == 3)
+                        params.push_back(0.0);
+                    const auto q = op.get_qubits();
+                    padded.add_operation(Operation(op.get_type(), std::vector<size_t>(q.begin(), q.end()), params));
+                }
+                expected = std::move(padded);
+            }
+            const bool expected_modified = reference_run(expected, keep_ccx);
+
+            NWQEC::Circuit actual = circuit;
+            NWQEC::DecomposePass pass(keep_ccx);
+            const bool modified = pass.run(actual);
+            const size_t diff = first_difference(actual, expected);
+            if (modified != expected_modified || diff != std::numeric_limits<size_t>::max())
+            {
+                std::fprintf(stderr, "type %zu%s: modified %d (expected %d), first difference at op %zu of %zu\n", t,
+                             keep_ccx ? " keeping ccx" : "", modified ? 1 : 0, expected_modified ? 1 : 0, diff,
+                             expected.get_operations().size());
+                ++failures;
+            }
+        }
+    }
+
+    if (failures != 0)
+        return 1;
+    std::printf("decompose template checks passed\n");
+    return 0;
+}
@@ -0,0 +1,91 @@
+// Checks DependencyGraph edges against the adjacency lists DAGCircuit builds
+#include "nwqec/core/dag_circuit.hpp"
+#include "nwqec/core/dependency_graph.hpp"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Type = NWQEC::Operation::Type;
+
+    size_t check_circuit(size_t n_qubits, size_t n_ops, std::mt19937_64 &rng)
+    {
+        std::uniform_int_distribution<size_t> qubit(0, n_qubits - 1);
+        std::uniform_int_distribution<int> arity(0, 9);
+
+        NWQEC::DAGCircuit dag;
+        dag.add_qreg("q", n_qubits);
+        for (size_t i = 0; i < n_ops; ++i)
+        {
+            int a = arity(rng);
+            size_t q0 = qubit(rng), q1 = qubit(rng), q2 = qubit(rng);
+            if (a == 0 && n_qubits >= 3 && q0 != q1 && q1 != q2 && q0 != q2)
+                dag.add_operation(NWQEC::Operation(Type::CCX, {q0, q1, q2}));
+            else if (a < 4 && n_qubits >= 2 && q0 != q1)
+                dag.add_operation(NWQEC::Operation(Type::CX, {q0, q1}));
+            else if (a == 4)
+                dag.add_operation(NWQEC::Operation(Type::BARRIER, {}));
+            else
+                dag.add_operation(NWQEC::Operation(a % 2 ? Type::H : Type::T, {q0}));
+        }
+
+        const std::vector<NWQEC::Operation> &ops = dag.get_operations();
+        NWQEC::DependencyGraph graph(ops, n_qubits);
+        size_t mismatches = graph.num_operations() != ops.size();
+        for (size_t i = 0; i < ops.size(); ++i)
+        {
+            const NWQEC::Operation::QubitSpan qubits = ops[i].get_qubits();
+            for (size_t k = 0; k < qubits.size(); ++k)
+            {
+                size_t next = NWQEC::DependencyGraph::NONE, prev = NWQEC::DependencyGraph::NONE;
+                for (const NWQEC::OperationDependency &dep : dag.get_successors(i))
+                    if (dep.qubit == qubits[k])
+                        next = dep.node;
+                for (const NWQEC::OperationDependency &dep : dag.get_predecessors(i))
+                    if (dep.qubit == qubits[k])
+                        prev = dep.node;
+                mismatches += graph.successor(i, k) != next || graph.next_on_qubit(i, qubits[k]) != next;
+                mismatches += graph.predecessor(i, k) != prev || graph.prev_on_qubit(i, qubits[k]) != prev;
+            }
+            mismatches += graph.is_root(i) != dag.get_predecessors(i).empty();
+            mismatches += graph.is_leaf(i) != dag.get_successors(i).empty();
+            mismatches += graph.next_on_qubit(i, n_qubits) != NWQEC::DependencyGraph::NONE;
+        }
+        return mismatches;
+    }
+} // namespace
+
+int main()
+{
+    std::mt19937_64 rng(27);
+    size_t failures = 0;
+
+    const size_t sizes[][2] = {{1, 50}, {2, 500}, {3, 1000}, {17, 5000}, {200, 20000}};
+    for (const auto &size : sizes)
+    {
+        size_t bad = check_circuit(size[0], size[1], rng);
+        if (bad != 0)
+        {
+            std::fprintf(stderr, "n=%zu ops=%zu: %zu mismatched edges\n", size[0], size[1], bad);
+            ++failures;
+        }
+    }
+
+    // Qubits beyond the expected count grow the per-qubit arrays
+    std::vector<NWQEC::Operation> ops = {NWQEC::Operation(Type::H, {5}), NWQEC::Operation(Type::CX, {5, 9}),
+                                         NWQEC::Operation(Type::T, {9})};
+    NWQEC::DependencyGraph graph(ops);
+    if (graph.next_on_qubit(0, 5) != 1 || graph.next_on_qubit(1, 9) != 2 || graph.prev_on_qubit(2, 9) != 1 ||
+        !graph.is_root(0) || graph.is_root(1) || !graph.is_leaf(2))
+    {
+        std::fprintf(stderr, "unsized graph: wrong edges\n");
+        ++failures;
+    }
+
+    if (failures != 0)
+        return 1;
+    std::printf("DependencyGraph checks passed\n");
+    return 0;
+}
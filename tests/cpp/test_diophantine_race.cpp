@@ -0,0 +1,73 @@
+// Checks that racing diophantine candidates gives valid gates that do not depend on the worker count
+#include "nwqec/gridsynth/gridsynth.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+    gridsynth::SynthesisResult synthesize(const std::string &theta, const std::string &epsilon, size_t race_threads)
+    {
+        gridsynth::SynthesisContext context;
+        if (race_threads > 0)
+            context.race_diophantine(race_threads);
+        gridsynth::seed_rng(gridsynth::synthesis_seed(theta, epsilon));
+        return gridsynth::gridsynth_gates_budgeted(context, theta, epsilon, gridsynth::SynthesisBudget{});
+    }
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+    const std::vector<std::string> thetas = {"0.3", "1.1", "-2.0", "0.7"};
+    const std::string epsilon = "1e-6";
+
+    for (const std::string &theta : thetas)
+    {
+        const gridsynth::SynthesisResult two = synthesize(theta, epsilon, 2);
+        const gridsynth::SynthesisResult four = synthesize(theta, epsilon, 4);
+        if (!two.success || two.gates != four.gates || two.diophantine_calls != four.diophantine_calls)
+        {
+            std::fprintf(stderr, "race %s: results differ between 2 and 4 workers\n", theta.c_str());
+            ++failures;
+            continue;
+        }
+        if (std::stod(gridsynth::error(theta, two.gates)) > std::stod(epsilon))
+        {
+            std::fprintf(stderr, "race %s: error above epsilon\n", theta.c_str());
+            ++failures;
+        }
+
+        // The serial search is still what a plain context runs
+        const gridsynth::SynthesisResult serial = synthesize(theta, epsilon, 0);
+        gridsynth::seed_rng(gridsynth::synthesis_seed(theta, epsilon));
+        const std::string reference = gridsynth::gridsynth_gates(theta, epsilon);
+        if (!serial.success || serial.gates != reference)
+        {
+            std::fprintf(stderr, "serial %s: differs from gridsynth_gates\n", theta.c_str());
+            ++failures;
+        }
+    }
+
+    // A batch with racing gives each angle the same gates at any thread count
+    gridsynth::BatchOptions options;
+    options.race_diophantine = true;
+    options.num_threads = 1;
+    const auto serial_batch = gridsynth::gridsynth_batch(thetas, epsilon, options);
+    options.num_threads = 8;
+    const auto wide_batch = gridsynth::gridsynth_batch(thetas, epsilon, options);
+    for (size_t i = 0; i < thetas.size(); ++i)
+    {
+        if (!serial_batch[i].success || serial_batch[i].gates != wide_batch[i].gates)
+        {
+            std::fprintf(stderr, "batch %s: results differ between 1 and 8 workers\n", thetas[i].c_str());
+            ++failures;
+        }
+    }
+
+    if (failures != 0)
+        return 1;
+    std::printf("diophantine race checks passed\n");
+    return 0;
+}
@@ -0,0 +1,303 @@
+// Checks every GMPInteger operator against plain mpz arithmetic around the long long overflow boundaries
+#include "nwqec/gridsynth/gmp_integer.hpp"
+
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using gridsynth::GMPInteger;
+
+    // Owns an mpz_t for the reference side
+    struct Ref
+    {
+        mpz_t z;
+        Ref() { mpz_init(z); }
+        explicit Ref(const std::string &s) { mpz_init_set_str(z, s.c_str(), 10); }
+        Ref(const Ref &other) { mpz_init_set(z, other.z); }
+        Ref &operator=(const Ref &) = delete;
+        ~Ref() { mpz_clear(z); }
+
+        std::string str() const
+        {
+            char *s = mpz_get_str(nullptr, 10, z);
+            std::string out(s);
+            std::free(s);
+            return out;
+        }
+        bool fits() const { return mpz_fits_slong_p(z) != 0; }
+        long long get() const { return static_cast<long long>(mpz_get_si(z)); }
+    };
+
+    std::string str(const GMPInteger &x)
+    {
+        std::ostringstream os;
+        os << x;
+        return os.str();
+    }
+
+    // Inline when the value fits, as every operator leaves it
+    GMPInteger canonical(const Ref &r)
+    {
+        GMPInteger x;
+        mpz_set(x.get_mpz_t(), r.z);
+        return GMPInteger(x); // The copy demotes
+    }
+
+    // GMP storage even for values that fit
+    GMPInteger forced_big(const Ref &r)
+    {
+        GMPInteger x;
+        mpz_set(x.get_mpz_t(), r.z);
+        return x;
+    }
+
+    std::vector<Ref> boundary_values()
+    {
+        std::vector<std::string> text = {
+            "0", "1", "-1", "2", "-2", "3", "-3", "7",
+            "2147483647", "2147483648", "-2147483648", "-2147483649", "4294967296", "-4294967296",
+            "3037000499", "3037000500", "-3037000500",         // floor(sqrt(LLONG_MAX)) and neighbours
+            "4611686018427387904", "-4611686018427387904",     // 2^62
+            "9223372036854775806", "9223372036854775807",      // LLONG_MAX - 1, LLONG_MAX
+            "-9223372036854775807", "-9223372036854775808",    // -LLONG_MAX, LLONG_MIN
+            "9223372036854775808", "-9223372036854775809",     // one past either end
+            "18446744073709551615", "18446744073709551616", "-18446744073709551616",
+            "717897987691852588770249",                        // 3^50
+            "-1267650600228229401496703205369",                // -(2^100) + 7
+        };
+        std::vector<Ref> values;
+        for (const auto &t : text)
+            values.emplace_back(t);
+
+        std::mt19937_64 rng(6);
+        for (int i = 0; i < 16; ++i)
+        {
+            Ref r;
+            mpz_set_ui(r.z, rng() >> (rng() % 64));
+            if (i % 4 == 3)
+            {
+                mpz_mul_2exp(r.z, r.z, 5 + rng() % 60);
+                mpz_add_ui(r.z, r.z, rng() % 1000);
+            }
+            if (rng() & 1)
+                mpz_neg(r.z, r.z);
+            values.push_back(r);
+        }
+        return values;
+    }
+
+    size_t failures = 0;
+
+    void check(const char *what, const std::string &a, const std::string &b, const GMPInteger &got, const Ref &want)
+    {
+        const std::string g = str(got);
+        if (g != want.str())
+        {
+            if (failures < 20)
+                std::fprintf(stderr, "%s(%s, %s): got %s, expected %s\n", what, a.c_str(), b.c_str(), g.c_str(),
+                             want.str().c_str());
+            ++failures;
+        }
+        else if (got.is_small() != want.fits())
+        {
+            if (failures < 20)
+                std::fprintf(stderr, "%s(%s, %s) = %s: stored %s\n", what, a.c_str(), b.c_str(), g.c_str(),
+                             got.is_small() ? "inline although it does not fit" : "in GMP although it fits");
+            ++failures;
+        }
+    }
+
+    void check_bool(const char *what, const std::string &a, const std::string &b, bool got, bool want)
+    {
+        if (got != want)
+        {
+            if (failures < 20)
+                std::fprintf(stderr, "%s(%s, %s): got %d\n", what, a.c_str(), b.c_str(), got ? 1 : 0);
+            ++failures;
+        }
+    }
+
+    void binary_ops(const Ref &ra, const Ref &rb, const GMPInteger &a, const GMPInteger &b)
+    {
+        const std::string sa = ra.str(), sb = rb.str();
+        Ref want;
+
+        mpz_add(want.z, ra.z, rb.z);
+        check("+", sa, sb, a + b, want);
+        GMPInteger c = a;
+        check("+=", sa, sb, c += b, want);
+        mpz_sub(want.z, ra.z, rb.z);
+        check("-", sa, sb, a - b, want);
+        c = a;
+        check("-=", sa, sb, c -= b, want);
+        mpz_mul(want.z, ra.z, rb.z);
+        check("*", sa, sb, a * b, want);
+        c = a;
+        check("*=", sa, sb, c *= b, want);
+
+        if (mpz_sgn(rb.z) != 0)
+        {
+            mpz_tdiv_q(want.z, ra.z, rb.z);
+            check("/", sa, sb, a / b, want);
+            c = a;
+            check("/=", sa, sb, c /= b, want);
+            mpz_tdiv_r(want.z, ra.z, rb.z);
+            check("%", sa, sb, a % b, want);
+            c = a;
+            check("%=", sa, sb, c %= b, want);
+        }
+
+        mpz_and(want.z, ra.z, rb.z);
+        check("&", sa, sb, a & b, want);
+        c = a;
+        check("&=", sa, sb, c &= b, want);
+        mpz_ior(want.z, ra.z, rb.z);
+        check("|", sa, sb, a | b, want);
+        mpz_xor(want.z, ra.z, rb.z);
+        check("^", sa, sb, a ^ b, want);
+
+        const int cmp = mpz_cmp(ra.z, rb.z);
+        check_bool("==", sa, sb, a == b, cmp == 0);
+        check_bool("!=", sa, sb, a != b, cmp != 0);
+        check_bool("<", sa, sb, a < b, cmp < 0);
+        check_bool("<=", sa, sb, a <= b, cmp <= 0);
+        check_bool(">", sa, sb, a > b, cmp > 0);
+        check_bool(">=", sa, sb, a >= b, cmp >= 0);
+
+        // Built-in right-hand sides take their own overflow checks
+        if (!rb.fits())
+            return;
+        const long long n = rb.get();
+        mpz_add(want.z, ra.z, rb.z);
+        check("+ ll", sa, sb, a + n, want);
+        c = a;
+        check("+= ll", sa, sb, c += n, want);
+        mpz_sub(want.z, ra.z, rb.z);
+        check("- ll", sa, sb, a - n, want);
+        c = a;
+        check("-= ll", sa, sb, c -= n, want);
+        mpz_mul(want.z, ra.z, rb.z);
+        check("* ll", sa, sb, a * n, want);
+        c = a;
+        check("*= ll", sa, sb, c *= n, want);
+        if (n != 0)
+        {
+            mpz_tdiv_q(want.z, ra.z, rb.z);
+            check("/ ll", sa, sb, a / n, want);
+            mpz_tdiv_r(want.z, ra.z, rb.z);
+            check("% ll", sa, sb, a % n, want);
+        }
+        check_bool("== ll", sa, sb, a == n, cmp == 0);
+        check_bool("< ll", sa, sb, a < n, cmp < 0);
+        check_bool("> ll", sa, sb, a > n, cmp > 0);
+
+        // Built-in left-hand sides
+        mpz_sub(want.z, rb.z, ra.z);
+        check("ll -", sb, sa, n - a, want);
+        mpz_add(want.z, rb.z, ra.z);
+        check("ll +", sb, sa, n + a, want);
+        mpz_mul(want.z, rb.z, ra.z);
+        check("ll *", sb, sa, n * a, want);
+        if (mpz_sgn(ra.z) != 0)
+        {
+            mpz_tdiv_q(want.z, rb.z, ra.z);
+            check("ll /", sb, sa, n / a, want);
+            mpz_tdiv_r(want.z, rb.z, ra.z);
+            check("ll %", sb, sa, n % a, want);
+        }
+    }
+
+    void unary_ops(const Ref &ra, const GMPInteger &a)
+    {
+        const std::string sa = ra.str();
+        Ref want;
+
+        mpz_neg(want.z, ra.z);
+        check("neg", sa, "", -a, want);
+        mpz_add_ui(want.z, ra.z, 1);
+        GMPInteger c = a;
+        check("++", sa, "", ++c, want);
+        check_bool("is_odd", sa, "", a.is_odd(), mpz_odd_p(ra.z) != 0);
+        check_bool("bool", sa, "", static_cast<bool>(a), mpz_sgn(ra.z) != 0);
+        if (ra.fits())
+            check_bool("long long", sa, "", static_cast<long long>(a) == ra.get(), true);
+        if (mpz_sgn(ra.z) >= 0)
+        {
+            mpz_sqrt(want.z, ra.z);
+            check("floorsqrt", sa, "", a.floorsqrt(), want);
+        }
+
+        for (int shift : {0, 1, 2, 30, 31, 32, 33, 61, 62, 63, 64, 65, 100})
+        {
+            const std::string ss = std::to_string(shift);
+            mpz_mul_2exp(want.z, ra.z, static_cast<mp_bitcnt_t>(shift));
+            check("<<", sa, ss, a << shift, want);
+            c = a;
+            check("<<=", sa, ss, c <<= shift, want);
+            mpz_tdiv_q_2exp(want.z, ra.z, static_cast<mp_bitcnt_t>(shift));
+            check(">>", sa, ss, a >> shift, want);
+            c = a;
+            check(">>=", sa, ss, c >>= shift, want);
+        }
+    }
+} // namespace
+
+int main()
+{
+    const std::vector<Ref> values = boundary_values();
+    std::vector<GMPInteger> small, big;
+    for (const Ref &r : values)
+    {
+        small.push_back(canonical(r));
+        big.push_back(forced_big(r));
+        if (small.back().is_small() != r.fits())
+        {
+            std::fprintf(stderr, "copy of %s did not demote\n", r.str().c_str());
+            ++failures;
+        }
+    }
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        unary_ops(values[i], small[i]);
+        unary_ops(values[i], big[i]);
+        for (size_t j = 0; j < values.size(); ++j)
+        {
+            binary_ops(values[i], values[j], small[i], small[j]);
+            binary_ops(values[i], values[j], big[i], small[j]);
+            binary_ops(values[i], values[j], small[i], big[j]);
+            binary_ops(values[i], values[j], big[i], big[j]);
+        }
+    }
+
+    // Division by zero is rejected by the built-in operand overloads
+    bool threw = false;
+    try
+    {
+        GMPInteger x(5);
+        x /= 0LL;
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    if (!threw)
+    {
+        std::fprintf(stderr, "/= 0 did not throw\n");
+        ++failures;
+    }
+
+    if (failures != 0)
+    {
+        std::fprintf(stderr, "%zu mismatches\n", failures);
+        return 1;
+    }
+    std::printf("gmp integer checks passed\n");
+    return 0;
+}
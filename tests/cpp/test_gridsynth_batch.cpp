@@ -0,0 +1,104 @@
+// Checks that gridsynth_batch gives each angle the serial gridsynth_gates result, at any worker count and order
+#include "nwqec/gridsynth/gridsynth.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // What one angle synthesized on its own gives
+    std::string serial(const std::string &theta, const std::string &epsilon)
+    {
+        gridsynth::seed_rng(gridsynth::synthesis_seed(theta, epsilon));
+        return gridsynth::gridsynth_gates(theta, epsilon);
+    }
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+    // The last four find different gates under different RNG seeds
+    const std::vector<std::string> thetas = {"0.3", "1.1", "-2.0", "0.7", "0.3", "3.0", "-0.05",
+                                             "2.5", "1.1", "0.9", "2.32", "1.92", "3.90", "2.91"};
+    const std::vector<std::string> epsilons = {"1e-5", "1e-5", "1e-6", "1e-4", "1e-6", "1e-5", "1e-7",
+                                               "1e-5", "1e-3", "1e-6", "1e-15", "1e-10", "1e-10", "1e-20"};
+
+    std::vector<std::string> reference;
+    for (size_t i = 0; i < thetas.size(); ++i)
+    {
+        reference.push_back(serial(thetas[i], epsilons[i]));
+        if (std::stod(gridsynth::error(thetas[i], reference[i])) > std::stod(epsilons[i]))
+        {
+            std::fprintf(stderr, "%s at %s: serial error above epsilon\n", thetas[i].c_str(), epsilons[i].c_str());
+            ++failures;
+        }
+    }
+
+    // The caller's RNG state does not leak into the batch, and a worker taking a tight
+    // epsilon after a loose one searches at the tight one's precision
+    gridsynth::seed_rng(12345);
+    for (size_t threads : {1, 2, 3, 8, 0})
+    {
+        gridsynth::BatchOptions options;
+        options.num_threads = threads;
+        options.angle_timeout_ms = 30000; // A search gone wrong fails instead of hanging
+        const auto results = gridsynth::gridsynth_batch(thetas, epsilons, options);
+        for (size_t i = 0; i < thetas.size(); ++i)
+        {
+            if (!results[i].success || results[i].gates != reference[i])
+            {
+                std::fprintf(stderr, "%zu workers, %s at %s: differs from gridsynth_gates\n", threads,
+                             thetas[i].c_str(), epsilons[i].c_str());
+                ++failures;
+            }
+        }
+    }
+
+    // Neither the order of the angles nor the other angles a worker took change a result
+    std::vector<size_t> order(thetas.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::mt19937_64 rng(9);
+    for (int round = 0; round < 3; ++round)
+    {
+        std::shuffle(order.begin(), order.end(), rng);
+        std::vector<std::string> shuffled_thetas, shuffled_epsilons;
+        for (size_t i : order)
+        {
+            shuffled_thetas.push_back(thetas[i]);
+            shuffled_epsilons.push_back(epsilons[i]);
+        }
+        gridsynth::BatchOptions options;
+        options.num_threads = 1 + static_cast<size_t>(round);
+        options.angle_timeout_ms = 30000;
+        const auto results = gridsynth::gridsynth_batch(shuffled_thetas, shuffled_epsilons, options);
+        for (size_t j = 0; j < order.size(); ++j)
+        {
+            if (results[j].gates != reference[order[j]])
+            {
+                std::fprintf(stderr, "shuffled %d, %s at %s: differs from gridsynth_gates\n", round,
+                             shuffled_thetas[j].c_str(), shuffled_epsilons[j].c_str());
+                ++failures;
+            }
+        }
+    }
+
+    // One shared tolerance is the same as repeating it per angle
+    const auto shared = gridsynth::gridsynth_batch(thetas, std::string("1e-5"));
+    for (size_t i = 0; i < thetas.size(); ++i)
+    {
+        if (shared[i].gates != serial(thetas[i], "1e-5"))
+        {
+            std::fprintf(stderr, "shared epsilon, %s: differs from gridsynth_gates\n", thetas[i].c_str());
+            ++failures;
+        }
+    }
+
+    if (failures != 0)
+        return 1;
+    std::printf("gridsynth batch checks passed\n");
+    return 0;
+}
@@ -0,0 +1,102 @@
+// Checks BasicLayerIndex placements against a full backward scan over the layers
+#include "nwqec/tableau/htab.hpp"
+#include "nwqec/tableau/layer_index.hpp"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    NWQEC::PauliOp random_pauli(size_t n_qubits, size_t weight, std::mt19937_64 &rng)
+    {
+        std::uniform_int_distribution<size_t> qubit(0, n_qubits - 1);
+        std::uniform_int_distribution<int> kind(0, 2);
+        NWQEC::PauliOp p(n_qubits);
+        for (size_t i = 0; i < weight; ++i)
+        {
+            size_t q = qubit(rng);
+            int k = kind(rng);
+            if (k != 1)
+                p.add_x(q);
+            if (k != 0)
+                p.add_z(q);
+        }
+        return p;
+    }
+
+    // Layer each row the way TfusePass does, with and without the index; count mismatches
+    template <size_t W>
+    size_t compare_layering(const NWQEC::PauliTable &rows)
+    {
+        const size_t n = rows.num_qubits();
+        std::vector<NWQEC::BasicHTab<W>> layers;
+        NWQEC::BasicLayerIndex<W> index(n);
+        size_t mismatches = 0;
+
+        for (size_t i = 0; i < rows.size(); ++i)
+        {
+            const NWQEC::PauliRowView row = rows.row(i);
+            size_t expected = NWQEC::BasicLayerIndex<W>::npos;
+            for (size_t l = layers.size(); l-- > 0;)
+            {
+                if (!layers[l].commutes_with_all(row))
+                {
+                    expected = l;
+                    break;
+                }
+            }
+            size_t actual = layers.empty() ? NWQEC::BasicLayerIndex<W>::npos : index.newest_blocking_layer(row);
+            if (actual != expected)
+                ++mismatches;
+
+            size_t target = expected == NWQEC::BasicLayerIndex<W>::npos ? 0 : expected + 1;
+            if (layers.empty() || target == layers.size())
+            {
+                layers.emplace_back(n);
+                index.add_layer();
+                target = layers.size() - 1;
+            }
+            layers[target].add_stab(row);
+            index.add_row(target, row);
+            if (index.basis_size(target) > n)
+                ++mismatches; // A commuting layer never spans more than n dimensions
+        }
+        return mismatches;
+    }
+} // namespace
+
+int main()
+{
+    std::mt19937_64 rng(77);
+    const size_t sizes[] = {3, 10, 64, 100, 200, 300};
+    const size_t weights[] = {1, 3, 12, 40, 400};
+    size_t failures = 0;
+    size_t checks = 0;
+
+    for (size_t n : sizes)
+    {
+        for (size_t weight : weights)
+        {
+            NWQEC::PauliTable rows(n);
+            for (int i = 0; i < 400; ++i)
+                rows.push_back(random_pauli(n, std::min(weight, 2 * n), rng));
+
+            size_t runtime = compare_layering<0>(rows);
+            size_t fixed = NWQEC::dispatch_pauli_width(rows.stride(), [&](auto width)
+                                                       { return compare_layering<decltype(width)::value>(rows); });
+            checks += 2;
+            if ((runtime != 0 || fixed != 0) && failures++ < 10)
+                std::fprintf(stderr, "n=%zu weight=%zu: %zu runtime / %zu fixed-width mismatches\n",
+                             n, weight, runtime, fixed);
+        }
+    }
+
+    if (failures != 0)
+    {
+        std::fprintf(stderr, "%zu of %zu layer index checks failed\n", failures, checks);
+        return 1;
+    }
+    std::printf("%zu layer index checks passed\n", checks);
+    return 0;
+}
@@ -0,0 +1,159 @@
+// Checks the thread-local mpz/mpfr free lists: the capacity cap, reuse, per-thread pools and release after the pool is gone
+#include "nwqec/gridsynth/gmp_float.hpp"
+#include "nwqec/gridsynth/gmp_integer.hpp"
+#include "nwqec/gridsynth/mp_pool.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using gridsynth::detail::MpfrFreeList;
+    using gridsynth::detail::MpzFreeList;
+
+    std::atomic<size_t> failures{0};
+
+    void fail(const char *what)
+    {
+        std::fprintf(stderr, "%s\n", what);
+        ++failures;
+    }
+
+    // Values the calling thread's mpz pool holds, emptying it
+    size_t drain_mpz()
+    {
+        size_t n = 0;
+        __mpz_struct z;
+        while (MpzFreeList::instance()->pop(z))
+        {
+            mpz_clear(&z);
+            ++n;
+        }
+        return n;
+    }
+
+    size_t drain_mpfr()
+    {
+        size_t n = 0;
+        __mpfr_struct x;
+        while (MpfrFreeList::instance()->pop(x))
+        {
+            mpfr_clear(&x);
+            ++n;
+        }
+        return n;
+    }
+
+    // Releases more values than the cap and checks what the pools keep
+    void check_cap()
+    {
+        drain_mpz();
+        drain_mpfr();
+        std::vector<__mpz_struct> zs(MpzFreeList::kCapacity + 44);
+        std::vector<__mpfr_struct> xs(MpfrFreeList::kCapacity + 44);
+        for (auto &z : zs)
+            gridsynth::pooled_mpz_init(&z);
+        for (auto &x : xs)
+            gridsynth::pooled_mpfr_init2(&x, 128);
+        for (auto &z : zs)
+            gridsynth::pooled_mpz_clear(&z);
+        for (auto &x : xs)
+            gridsynth::pooled_mpfr_clear(&x);
+        if (drain_mpz() != MpzFreeList::kCapacity || drain_mpfr() != MpfrFreeList::kCapacity)
+            fail("cap: pools did not keep exactly kCapacity values");
+    }
+
+    // A released value's storage is handed out again, reset
+    void check_reuse()
+    {
+        drain_mpz();
+        drain_mpfr();
+        mpz_t z;
+        gridsynth::pooled_mpz_init(z);
+        mpz_set_str(z, "123456789012345678901234567890", 10);
+        const mp_limb_t *limbs = z[0]._mp_d;
+        gridsynth::pooled_mpz_clear(z);
+        gridsynth::pooled_mpz_init(z);
+        if (z[0]._mp_d != limbs || mpz_sgn(z) != 0)
+            fail("reuse: mpz storage not recycled as zero");
+        gridsynth::pooled_mpz_clear(z);
+
+        mpfr_t x;
+        gridsynth::pooled_mpfr_init2(x, 512);
+        mpfr_set_ui(x, 7, MPFR_RNDN);
+        const mp_limb_t *mantissa = x[0]._mpfr_d;
+        gridsynth::pooled_mpfr_clear(x);
+        gridsynth::pooled_mpfr_init2(x, 256); // Fits in the old limbs
+        if (x[0]._mpfr_d != mantissa || mpfr_get_prec(x) != 256 || !mpfr_nan_p(x))
+            fail("reuse: mpfr storage not recycled as NaN at the requested precision");
+        gridsynth::pooled_mpfr_clear(x);
+        gridsynth::pooled_mpfr_init2(x, 4096); // Needs more limbs
+        if (mpfr_get_prec(x) != 4096 || !mpfr_nan_p(x))
+            fail("reuse: grown mpfr value has the wrong precision");
+        gridsynth::pooled_mpfr_clear(x);
+    }
+
+    // Constructed before the thread's pools, so destroyed after them
+    struct LateRelease
+    {
+        std::optional<gridsynth::GMPInteger> integer;
+        std::optional<gridsynth::GMPFloat> real;
+
+        ~LateRelease()
+        {
+            if (MpzFreeList::alive() || MpfrFreeList::alive())
+                fail("late release: pools still marked alive after their destruction");
+            integer.reset();
+            real.reset();
+            if (MpzFreeList::instance() || MpfrFreeList::instance())
+                fail("late release: a pool was handed out after its destruction");
+        }
+    };
+} // namespace
+
+int main()
+{
+    check_cap();
+    check_reuse();
+
+    // Each thread gets pools of its own, fresh even after other threads have exited
+    for (int round = 0; round < 3; ++round)
+    {
+        std::thread worker([]()
+                           {
+            if (!MpzFreeList::alive() || !MpfrFreeList::alive() || drain_mpz() != 0 || drain_mpfr() != 0)
+                fail("thread: pools not fresh");
+            check_cap();
+            check_reuse();
+            // Values in use when the thread exits are released normally
+            static thread_local gridsynth::GMPFloat kept = gridsynth::GMPFloat(1.25) * gridsynth::GMPFloat(3.0);
+            (void)kept; });
+        worker.join();
+    }
+    if (!MpzFreeList::alive() || MpzFreeList::instance() == nullptr)
+        fail("main thread: pool was torn down by another thread's exit");
+    check_reuse();
+
+    // Values released by thread-local objects destroyed after the pools are cleared directly
+    std::thread late([]()
+                     {
+        static thread_local LateRelease holder;
+        drain_mpz(); // Creates both pools after holder
+        drain_mpfr();
+        holder.integer.emplace(gridsynth::GMPInteger(1) << 200);
+        holder.real.emplace(2.5);
+        // Fill the pools so their destructors have values to clear
+        gridsynth::GMPInteger a = *holder.integer * *holder.integer;
+        gridsynth::GMPFloat b = *holder.real * *holder.real;
+        (void)a;
+        (void)b; });
+    late.join();
+
+    if (failures != 0)
+        return 1;
+    std::printf("mp pool checks passed\n");
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Checks the compact Operation storage: inline and spilled operands, Pauli payloads and copies
+#include "nwqec/core/operation.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using NWQEC::Operation;
+    using Type = Operation::Type;
+
+    size_t failures = 0;
+
+    void expect(bool ok, const char *what)
+    {
+        if (!ok)
+        {
+            std::fprintf(stderr, "failed: %s\n", what);
+            ++failures;
+        }
+    }
+
+    std::string qasm(const Operation &op)
+    {
+        std::ostringstream os;
+        op.print(os);
+        return os.str();
+    }
+} // namespace
+
+int main()
+{
+    expect(sizeof(Operation) <= 48, "plain gates fit in 48 bytes");
+
+    Operation h(Type::H, {7});
+    expect(h.get_qubits().size() == 1 && h.get_qubits()[0] == 7, "single qubit inline");
+    expect(h.get_parameters().empty() && h.get_bits().empty(), "no parameters or bits");
+    expect(h.get_pauli_op().get_num_qubits() == 0, "no Pauli payload");
+
+    Operation ccx(Type::CCX, {0, 5, 2});
+    expect(ccx.get_qubits().to_vector() == std::vector<size_t>({0, 5, 2}), "three qubits inline");
+
+    std::vector<size_t> many = {9, 3, 4, 1, 8};
+    Operation barrier(Type::BARRIER, many);
+    expect(std::vector<size_t>(barrier.get_qubits()) == many, "spilled qubit list");
+    expect(qasm(barrier) == "barrier q[9],q[3],q[4],q[1],q[8];", "spilled qubits print");
+
+    Operation u3(Type::U3, {2}, {0.5, -1.25, 3.0});
+    expect(u3.get_parameters().size() == 3 && u3.get_parameters()[1] == -1.25, "spilled parameters");
+    Operation rz(Type::RZ, {1}, {0.25});
+    expect(rz.get_parameters().size() == 1 && rz.get_parameters()[0] == 0.25, "inline parameter");
+
+    Operation measure(Type::MEASURE, {3}, {}, {6});
+    expect(qasm(measure) == "measure q[3] -> c[6];", "inline bit");
+    Operation wide_measure(Type::MEASURE, {3, 4}, {}, {6, 7});
+    expect(wide_measure.get_bits().to_vector() == std::vector<size_t>({6, 7}), "spilled bits");
+
+    // Operands taken from another operation's spans
+    Operation retyped(Type::RX, u3.get_qubits(), rz.get_parameters(), measure.get_bits());
+    expect(retyped.get_qubits() == u3.get_qubits() && retyped.get_parameters()[0] == 0.25 &&
+               retyped.get_bits()[0] == 6,
+           "operands copied from spans");
+
+    // PBC operations list the qubits their Pauli string touches, across word boundaries
+    NWQEC::PauliOp pauli(130);
+    pauli.add_x(129);
+    pauli.add_z(3);
+    pauli.add_x(64);
+    pauli.add_z(64);
+    Operation t_pauli(Type::T_PAULI, {}, {}, {}, pauli);
+    expect(t_pauli.get_qubits().to_vector() == std::vector<size_t>({3, 64, 129}), "active qubits of a Pauli");
+    expect(t_pauli.get_pauli_string() == pauli.to_string(), "Pauli payload kept");
+
+    // Copies own their spilled storage
+    Operation copy = barrier;
+    Operation assigned(Type::X, {0});
+    assigned = t_pauli;
+    barrier = Operation(Type::H, {1});
+    t_pauli = h;
+    expect(std::vector<size_t>(copy.get_qubits()) == many, "copy keeps spilled qubits");
+    expect(assigned.get_pauli_string() == pauli.to_string() && assigned.get_qubits().size() == 3,
+           "assignment keeps Pauli payload");
+    Operation moved = std::move(copy);
+    expect(moved.get_qubits().size() == many.size(), "move keeps spilled qubits");
+
+    // Indices past the 32-bit storage are rejected instead of truncated
+    if (sizeof(size_t) > sizeof(uint32_t))
+    {
+        const size_t too_big = size_t(UINT32_MAX) + 1;
+        auto rejects = [](auto make)
+        {
+            try
+            {
+                make();
+            }
+            catch (const std::out_of_range &)
+            {
+                return true;
+            }
+            return false;
+        };
+        expect(rejects([&]() { Operation(Type::H, {too_big}); }), "inline qubit past 32 bits");
+        expect(rejects([&]() { Operation(Type::BARRIER, {0, 1, 2, 3, too_big}); }), "spilled qubit past 32 bits");
+        expect(rejects([&]() { Operation(Type::MEASURE, {0}, {}, {too_big}); }), "bit past 32 bits");
+        expect(Operation(Type::H, {size_t(UINT32_MAX)}).get_qubits()[0] == UINT32_MAX, "largest 32-bit qubit kept");
+    }
+
+    if (failures != 0)
+        return 1;
+    std::printf("Operation storage checks passed\n");
+    return 0;
+}
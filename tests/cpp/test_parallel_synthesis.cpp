@@ -0,0 +1,156 @@
+// Checks that SynthesizeRzPass gives the same circuit on one worker and on several, and that worker errors reach the caller
+#include "nwqec/core/parallel.hpp"
+#include "nwqec/core/transpiler.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Type = NWQEC::Operation::Type;
+
+    // Distinct angles, repeats, negations and exact multiples of pi/4
+    NWQEC::Circuit rz_circuit()
+    {
+        NWQEC::Circuit circuit;
+        circuit.add_qreg("q", 4);
+        for (size_t i = 0; i < 40; ++i)
+        {
+            const size_t q = i % 4;
+            const double angle = 0.05 + 0.173 * static_cast<double>(i % 29);
+            circuit.add_operation(NWQEC::Operation(Type::H, {q}));
+            circuit.add_operation(NWQEC::Operation(Type::RZ, {q}, {i % 7 == 3 ? -angle : angle}));
+            if (i % 9 == 0)
+                circuit.add_operation(NWQEC::Operation(Type::RZ, {q}, {M_PI_4 * static_cast<double>(i % 8)}));
+            circuit.add_operation(NWQEC::Operation(Type::CX, {q, (q + 1) % 4}));
+        }
+        return circuit;
+    }
+
+    std::string synthesize(size_t threads, NWQEC::SynthesisStats &stats)
+    {
+        NWQEC::SynthesisLimits limits;
+        limits.use_rz_table = false;
+        NWQEC::SynthesizeRzPass pass(1e-4, threads, nullptr, limits);
+        NWQEC::Circuit circuit = rz_circuit();
+        pass.run(circuit);
+        stats = pass.stats();
+        std::ostringstream os;
+        circuit.print(os);
+        return os.str();
+    }
+
+    // The counters that do not depend on timing
+    std::string counters(const NWQEC::SynthesisStats &s)
+    {
+        std::ostringstream os;
+        os << s.angles << ' ' << s.exact << ' ' << s.synthesized << ' ' << s.failed << ' ' << s.k_iterations << ' '
+           << s.tdgp_candidates << ' ' << s.diophantine_calls << ' ' << s.max_k;
+        return os.str();
+    }
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+
+    NWQEC::SynthesisStats serial_stats;
+    const std::string serial = synthesize(1, serial_stats);
+    if (serial_stats.synthesized < 20)
+    {
+        std::fprintf(stderr, "only %zu angles synthesized\n", serial_stats.synthesized);
+        return 1;
+    }
+    for (size_t threads : {2, 3, 8, 0})
+    {
+        NWQEC::SynthesisStats stats;
+        if (synthesize(threads, stats) != serial)
+        {
+            std::fprintf(stderr, "%zu workers: circuit differs from one worker\n", threads);
+            ++failures;
+        }
+        if (counters(stats) != counters(serial_stats))
+        {
+            std::fprintf(stderr, "%zu workers: counters %s, one worker %s\n", threads, counters(stats).c_str(),
+                         counters(serial_stats).c_str());
+            ++failures;
+        }
+    }
+
+    // Every index is visited exactly once, whatever the worker count
+    for (size_t threads : {1, 3, 16})
+    {
+        std::vector<std::atomic<int>> visits(1000);
+        NWQEC::parallel_for(visits.size(), threads, [&](size_t i)
+                            { ++visits[i]; });
+        for (size_t i = 0; i < visits.size(); ++i)
+        {
+            if (visits[i] != 1)
+            {
+                std::fprintf(stderr, "%zu workers: index %zu visited %d times\n", threads, i, visits[i].load());
+                ++failures;
+                break;
+            }
+        }
+    }
+
+    // An exception thrown on a spawned worker is rethrown on the calling thread
+    const std::thread::id caller = std::this_thread::get_id();
+    for (size_t threads : {2, 4})
+    {
+        std::string error;
+        try
+        {
+            NWQEC::parallel_for_with_state(
+                100, threads, [&]()
+                {
+                    if (std::this_thread::get_id() != caller)
+                        throw std::runtime_error("worker state failed");
+                    return 0; },
+                [](int &, size_t) {});
+        }
+        catch (const std::runtime_error &e)
+        {
+            error = e.what();
+        }
+        if (error != "worker state failed")
+        {
+            std::fprintf(stderr, "%zu workers: worker exception not propagated, got '%s'\n", threads, error.c_str());
+            ++failures;
+        }
+    }
+
+    // A throwing item abandons the rest and the first error wins
+    for (size_t threads : {1, 3})
+    {
+        std::atomic<size_t> calls{0};
+        std::string error;
+        try
+        {
+            NWQEC::parallel_for(100000, threads, [&](size_t i)
+                                {
+                ++calls;
+                if (i == 5)
+                    throw std::runtime_error("item 5 failed"); });
+        }
+        catch (const std::runtime_error &e)
+        {
+            error = e.what();
+        }
+        if (error != "item 5 failed" || calls == 100000)
+        {
+            std::fprintf(stderr, "%zu workers: got '%s' after %zu calls\n", threads, error.c_str(), calls.load());
+            ++failures;
+        }
+    }
+
+    if (failures != 0)
+        return 1;
+    std::printf("parallel synthesis checks passed\n");
+    return 0;
+}
@@ -0,0 +1,177 @@
+// Checks the PassObserver callbacks of Transpiler::execute_passes and ChromeTraceObserver output
+#include "nwqec/core/transpiler.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Type = NWQEC::Operation::Type;
+
+    struct RecordingObserver : NWQEC::PassObserver
+    {
+        std::vector<std::string> calls;
+        std::vector<NWQEC::PassEvent> ends;
+
+        void on_pass_begin(const NWQEC::PassEvent &event) override
+        {
+            calls.push_back("begin " + event.name);
+        }
+
+        void on_pass_end(const NWQEC::PassEvent &event) override
+        {
+            calls.push_back("end " + event.name);
+            ends.push_back(event);
+        }
+    };
+
+    // ccx q0,q1,q2; rz(0.3) q0
+    std::unique_ptr<NWQEC::Circuit> small_circuit()
+    {
+        auto circuit = std::make_unique<NWQEC::Circuit>();
+        circuit->add_qreg("q", 3);
+        circuit->add_creg("c", 3);
+        circuit->add_operation(NWQEC::Operation(Type::CCX, {0, 1, 2}));
+        circuit->add_operation(NWQEC::Operation(Type::RZ, {0}, {0.3}));
+        return circuit;
+    }
+
+    std::string read_file(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::ostringstream text;
+        text << file.rdbuf();
+        return text.str();
+    }
+
+    size_t occurrences(const std::string &text, const std::string &what)
+    {
+        size_t n = 0;
+        for (size_t pos = text.find(what); pos != std::string::npos; pos = text.find(what, pos + 1))
+            ++n;
+        return n;
+    }
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+
+    auto recorder = std::make_shared<RecordingObserver>();
+    auto trace = std::make_shared<NWQEC::ChromeTraceObserver>("unused.json");
+    NWQEC::PassConfig config;
+    config.epsilon_override = 1e-3;
+    config.num_threads = 1;
+    config.silent = true;
+    config.observers = {recorder, trace};
+
+    const std::vector<NWQEC::PassType> passes = {NWQEC::PassType::DECOMPOSE, NWQEC::PassType::SYNTHESIZE_RZ};
+    NWQEC::Transpiler transpiler;
+    auto result = transpiler.execute_passes(small_circuit(), passes, config);
+
+    const std::vector<std::string> expected = {"begin DECOMPOSE", "end DECOMPOSE", "begin SYNTHESIZE_RZ", "end SYNTHESIZE_RZ"};
+    if (recorder->calls != expected)
+    {
+        std::fprintf(stderr, "observer: %zu callbacks in the wrong order\n", recorder->calls.size());
+        ++failures;
+    }
+    else
+    {
+        const NWQEC::PassEvent &decompose = recorder->ends[0];
+        const NWQEC::PassEvent &synthesis = recorder->ends[1];
+        bool ok = decompose.index == 0 && decompose.ops_before == 2 && decompose.modified && !decompose.failed &&
+                  decompose.ops_after == synthesis.ops_before && synthesis.ops_after == result->gate_count() &&
+                  decompose.wall_ms >= 0.0 && decompose.counters.empty() && synthesis.index == 1 &&
+                  synthesis.counters.count("synthesized") == 1 && synthesis.counters.at("synthesized") == 1.0;
+        if (!ok)
+        {
+            std::fprintf(stderr, "observer: wrong event fields\n");
+            ++failures;
+        }
+    }
+
+    std::ostringstream json;
+    trace->write(json);
+    const std::string text = json.str();
+    if (text.find("\"name\":\"DECOMPOSE\"") == std::string::npos ||
+        text.find("\"name\":\"SYNTHESIZE_RZ\"") == std::string::npos ||
+        text.find("\"ph\":\"X\"") == std::string::npos || text.find("\"synthesized\":1") == std::string::npos)
+    {
+        std::fprintf(stderr, "trace: unexpected JSON\n%s", text.c_str());
+        ++failures;
+    }
+
+    // A pass that throws still reports its end, marked failed
+    NWQEC::PassConfig strict = config;
+    strict.observers = {recorder};
+    strict.epsilon_override = 1e-30;
+    strict.synthesis_budget_ms = 1;
+    recorder->calls.clear();
+    recorder->ends.clear();
+    bool threw = false;
+    try
+    {
+        auto rz = std::make_unique<NWQEC::Circuit>();
+        rz->add_qreg("q", 1);
+        for (double angle : {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8})
+            rz->add_operation(NWQEC::Operation(Type::RZ, {0}, {angle}));
+        transpiler.execute_passes(std::move(rz), {NWQEC::PassType::SYNTHESIZE_RZ}, strict);
+    }
+    catch (const std::exception &)
+    {
+        threw = true;
+    }
+    if (threw && (recorder->ends.size() != 1 || !recorder->ends[0].failed))
+    {
+        std::fprintf(stderr, "observer: failed pass not reported\n");
+        ++failures;
+    }
+
+    // Each flush appends to a complete file; pipelines on other threads get their own track
+    if (!trace->flush() || occurrences(read_file("unused.json"), "\"ph\":\"X\"") != 2)
+    {
+        std::fprintf(stderr, "trace: first flush did not write both passes\n");
+        ++failures;
+    }
+    {
+        NWQEC::PassConfig traced = config;
+        traced.observers = {trace};
+        auto run = [&]()
+        { NWQEC::Transpiler().execute_passes(small_circuit(), passes, traced); };
+        std::thread first(run), second(run);
+        first.join();
+        second.join();
+    }
+    NWQEC::PassEvent odd;
+    odd.name = "ODD";
+    odd.start = std::chrono::steady_clock::now();
+    odd.counters = {{"nan", std::nan("")}, {"inf", HUGE_VAL}};
+    trace->on_pass_end(odd);
+    trace->flush();
+    const std::string file = read_file("unused.json");
+    std::ostringstream whole;
+    trace->write(whole);
+    if (file != whole.str() || occurrences(file, "\"ph\":\"X\"") != 7 || occurrences(file, "\"tid\":1,") != 3 ||
+        occurrences(file, "\"tid\":2,") != 2 || occurrences(file, "\"tid\":3,") != 2 ||
+        file.find("\"inf\":null,\"nan\":null") == std::string::npos ||
+        file.compare(file.size() - 4, 4, "\n]}\n") != 0)
+    {
+        std::fprintf(stderr, "trace: appended file is not the whole trace\n%s", file.c_str());
+        ++failures;
+    }
+
+    trace.reset();
+    std::remove("unused.json");
+
+    if (failures != 0)
+        return 1;
+    std::printf("pass observer checks passed\n");
+    return 0;
+}
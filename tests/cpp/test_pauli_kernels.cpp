@@ -0,0 +1,118 @@
+// Checks every Pauli word kernel this CPU supports against the scalar version
+#include "nwqec/core/pauli_kernels.hpp"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    template <size_t W>
+    bool check_fixed(const std::vector<uint64_t> &x1, const std::vector<uint64_t> &z1,
+                     const std::vector<uint64_t> &x2, const std::vector<uint64_t> &z2,
+                     const std::vector<uint64_t> &mask, bool anti, long long g,
+                     const std::vector<uint64_t> &ex, const std::vector<uint64_t> &ez)
+    {
+        using K = NWQEC::FixedWidthPauliKernels<W>;
+        std::vector<uint64_t> ax = x1, az = z1;
+        K::xor_into(ax.data(), az.data(), x2.data(), z2.data());
+        return K::anticommutes(x1.data(), z1.data(), x2.data(), z2.data()) == anti &&
+               K::anticommutes_masked(x1.data(), z1.data(), x2.data(), z2.data(), mask.data()) == anti &&
+               K::g_sum_masked(x1.data(), z1.data(), x2.data(), z2.data(), mask.data()) == static_cast<int>(g & 3) &&
+               K::equal(x1.data(), z1.data(), x1.data(), z1.data()) &&
+               K::equal(ax.data(), az.data(), x1.data(), z1.data()) == (ex == x1 && ez == z1) &&
+               ax == ex && az == ez;
+    }
+
+    // Compile-time-width kernels against the scalar results for the same row
+    bool check_fixed_width(size_t words, const std::vector<uint64_t> &x1, const std::vector<uint64_t> &z1,
+                           const std::vector<uint64_t> &x2, const std::vector<uint64_t> &z2,
+                           const std::vector<uint64_t> &mask, bool anti, long long g,
+                           const std::vector<uint64_t> &ex, const std::vector<uint64_t> &ez)
+    {
+        return NWQEC::dispatch_pauli_width(words, [&](auto width)
+        {
+            constexpr size_t W = decltype(width)::value;
+            if constexpr (W == 0)
+                return false;
+            else
+                return check_fixed<W>(x1, z1, x2, z2, mask, anti, g, ex, ez);
+        });
+    }
+} // namespace
+
+int main()
+{
+    using NWQEC::PauliKernels;
+    using NWQEC::SimdIsa;
+
+    const PauliKernels *scalar = NWQEC::pauli_kernels_for(SimdIsa::Scalar);
+    std::vector<const PauliKernels *> candidates;
+    for (SimdIsa isa : {SimdIsa::AVX2, SimdIsa::AVX512, SimdIsa::NEON})
+        if (const PauliKernels *k = NWQEC::pauli_kernels_for(isa))
+            candidates.push_back(k);
+    std::printf("selected: %s\n", NWQEC::pauli_kernels().name);
+
+    std::mt19937_64 rng(2024);
+    size_t failures = 0;
+    size_t checks = 0;
+    auto fail = [&](const PauliKernels *k, const char *what, size_t words)
+    {
+        if (failures++ < 10)
+            std::fprintf(stderr, "%s: %s mismatch at %zu words\n", k->name, what, words);
+    };
+
+    for (size_t words = 0; words <= 37; ++words)
+    {
+        for (int trial = 0; trial < 50; ++trial)
+        {
+            // Sparse and dense rows both matter: sparse ones keep g sums small
+            const uint64_t keep = (trial % 3 == 0) ? rng() & rng() & rng() : ~0ULL;
+            std::vector<uint64_t> x1(words), z1(words), x2(words), z2(words);
+            for (size_t i = 0; i < words; ++i)
+            {
+                x1[i] = rng() & keep;
+                z1[i] = rng() & keep;
+                x2[i] = rng() & keep;
+                z2[i] = rng() & keep;
+            }
+
+            const bool anti = scalar->anticommutes(x1.data(), z1.data(), x2.data(), z2.data(), words);
+            const long long g = scalar->g_sum(x1.data(), z1.data(), x2.data(), z2.data(), words);
+            const size_t support = scalar->support(x1.data(), z1.data(), words);
+            std::vector<uint64_t> ex = x1, ez = z1;
+            scalar->xor_into(ex.data(), ez.data(), x2.data(), z2.data(), words);
+
+            for (const PauliKernels *k : candidates)
+            {
+                ++checks;
+                if (k->anticommutes(x1.data(), z1.data(), x2.data(), z2.data(), words) != anti)
+                    fail(k, "anticommutes", words);
+                if (k->g_sum(x1.data(), z1.data(), x2.data(), z2.data(), words) != g)
+                    fail(k, "g_sum", words);
+                if (k->support(x1.data(), z1.data(), words) != support)
+                    fail(k, "support", words);
+                std::vector<uint64_t> ax = x1, az = z1;
+                k->xor_into(ax.data(), az.data(), x2.data(), z2.data(), words);
+                if (ax != ex || az != ez)
+                    fail(k, "xor_into", words);
+            }
+
+            if (words == 1 || words == 2 || words == 4 || words == 8)
+            {
+                ++checks;
+                std::vector<uint64_t> all_ones(words, ~0ULL);
+                if (!check_fixed_width(words, x1, z1, x2, z2, all_ones, anti, g, ex, ez))
+                    fail(scalar, "fixed-width", words);
+            }
+        }
+    }
+
+    if (failures != 0)
+    {
+        std::fprintf(stderr, "%zu of %zu kernel checks failed\n", failures, checks);
+        return 1;
+    }
+    std::printf("%zu kernel checks passed across %zu SIMD variants\n", checks, candidates.size());
+    return 0;
+}
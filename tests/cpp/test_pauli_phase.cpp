@@ -0,0 +1,80 @@
+// Checks the word-level Pauli phase function against the per-qubit formula
+#include "nwqec/core/pauli_op.hpp"
+
+#include <cstdio>
+#include <random>
+
+namespace
+{
+    bool get_bit(const NWQEC::PauliOp &p, bool x, size_t q)
+    {
+        if (p.is_small())
+            return ((x ? p.get_x_bits_small() : p.get_z_bits_small()) >> q) & 1ULL;
+        const auto &words = x ? p.get_x_bits_large() : p.get_z_bits_large();
+        return (words[q / 64] >> (q % 64)) & 1ULL;
+    }
+
+    // Per-qubit reference, as HTab computed it before the word-level kernel
+    int reference_g(const NWQEC::PauliOp &p1, const NWQEC::PauliOp &p2, size_t n_qubits)
+    {
+        int g_val = 0;
+        for (size_t q = 0; q < n_qubits; ++q)
+        {
+            bool x1 = get_bit(p1, true, q), z1 = get_bit(p1, false, q);
+            bool x2 = get_bit(p2, true, q), z2 = get_bit(p2, false, q);
+            g_val += (x1 & z1) * (z2 - x2) +
+                     (x1 & !z1) * z2 * (2 * x2 - 1) +
+                     (!x1 & z1) * x2 * (1 - 2 * z2);
+        }
+        return g_val & 3;
+    }
+
+    NWQEC::PauliOp random_pauli(size_t n_qubits, std::mt19937_64 &rng, double density)
+    {
+        std::bernoulli_distribution bit(density);
+        NWQEC::PauliOp p(n_qubits);
+        for (size_t q = 0; q < n_qubits; ++q)
+        {
+            if (bit(rng))
+                p.add_x(q);
+            if (bit(rng))
+                p.add_z(q);
+        }
+        return p;
+    }
+} // namespace
+
+int main()
+{
+    std::mt19937_64 rng(12345);
+    const size_t sizes[] = {1, 2, 7, 63, 64, 65, 100, 127, 128, 129, 200, 257};
+    const double densities[] = {0.05, 0.5, 0.95};
+    size_t failures = 0;
+    size_t checks = 0;
+
+    for (size_t n : sizes)
+    {
+        for (double density : densities)
+        {
+            for (int trial = 0; trial < 200; ++trial)
+            {
+                NWQEC::PauliOp p1 = random_pauli(n, rng, density);
+                NWQEC::PauliOp p2 = random_pauli(n, rng, density);
+                int expected = reference_g(p1, p2, n);
+                int actual = NWQEC::pauli_g_function(p1, p2, n);
+                ++checks;
+                if (expected != actual && failures++ < 10)
+                    std::fprintf(stderr, "mismatch: n=%zu density=%.2f expected %d got %d\n",
+                                 n, density, expected, actual);
+            }
+        }
+    }
+
+    if (failures != 0)
+    {
+        std::fprintf(stderr, "%zu of %zu phase checks failed\n", failures, checks);
+        return 1;
+    }
+    std::printf("%zu phase checks passed\n", checks);
+    return 0;
+}
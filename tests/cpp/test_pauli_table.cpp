@@ -0,0 +1,221 @@
+// Checks PauliTable storage and the HTab operations built on it against PauliOp
+#include "nwqec/tableau/htab.hpp"
+#include "nwqec/tableau/pauli_table.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+
+namespace
+{
+    size_t failures = 0;
+
+    void check(bool ok, const char *what, size_t n)
+    {
+        if (!ok && failures++ < 10)
+            std::fprintf(stderr, "failed: %s (n=%zu)\n", what, n);
+    }
+
+    NWQEC::PauliOp random_pauli(size_t n_qubits, std::mt19937_64 &rng)
+    {
+        std::bernoulli_distribution bit(0.3);
+        NWQEC::PauliOp p(n_qubits);
+        p.set_phase(bit(rng));
+        for (size_t q = 0; q < n_qubits; ++q)
+        {
+            if (bit(rng))
+                p.add_x(q);
+            if (bit(rng))
+                p.add_z(q);
+        }
+        return p;
+    }
+
+    // Element-wise front multiplication on PauliOp, as HTab did before PauliTable
+    void reference_front_multiply(std::vector<NWQEC::PauliOp> &rows, const NWQEC::PauliOp &p, size_t n)
+    {
+        for (auto &row : rows)
+        {
+            int g_val = NWQEC::pauli_g_function(p, row, n);
+            if ((g_val & 1) == 0)
+                continue;
+            g_val += 1;
+            NWQEC::PauliOp product(n);
+            std::vector<uint64_t> x(row.x_words(), row.x_words() + row.num_words());
+            std::vector<uint64_t> z(row.z_words(), row.z_words() + row.num_words());
+            for (size_t w = 0; w < x.size(); ++w)
+            {
+                x[w] ^= p.x_words()[w];
+                z[w] ^= p.z_words()[w];
+            }
+            product.assign_words(x.data(), z.data());
+            product.set_phase(row.get_phase() ^ p.get_phase() ^ ((g_val >> 1) & 1));
+            row = product;
+        }
+    }
+    // Pairwise reduction over every row pair, as HTab::apply_reduction did before bucketing
+    void reference_reduction(NWQEC::PauliTable &rows)
+    {
+        const size_t words = rows.num_words();
+        for (size_t i = 0; i < rows.size(); ++i)
+        {
+            if (!rows.is_valid(i))
+                continue;
+            for (size_t j = i + 1; j < rows.size(); ++j)
+            {
+                if (!rows.is_valid(j) || rows.rowtype(i) != rows.rowtype(j) ||
+                    !std::equal(rows.x(i), rows.x(i) + words, rows.x(j)) ||
+                    !std::equal(rows.z(i), rows.z(i) + words, rows.z(j)))
+                    continue;
+                if (rows.phase(i) != rows.phase(j))
+                {
+                    rows.set_valid(i, false);
+                    rows.set_valid(j, false);
+                }
+                else
+                {
+                    if (rows.rowtype(i) == NWQEC::RowType::T)
+                        rows.set_rowtype(i, NWQEC::RowType::S);
+                    else if (rows.rowtype(i) == NWQEC::RowType::S)
+                        rows.set_rowtype(i, NWQEC::RowType::Z);
+                    rows.set_valid(j, false);
+                }
+                break;
+            }
+        }
+    }
+
+    std::string describe(const NWQEC::PauliTable &rows)
+    {
+        std::string out;
+        for (size_t i = 0; i < rows.size(); ++i)
+        {
+            out += rows.is_valid(i) ? "v" : "-";
+            out += std::to_string(static_cast<int>(rows.rowtype(i)));
+            out += rows.row(i).to_string() + ";";
+        }
+        return out;
+    }
+} // namespace
+
+int main()
+{
+    std::mt19937_64 rng(2024);
+    const size_t sizes[] = {1, 5, 64, 65, 130, 300, 600};
+
+    for (size_t n : sizes)
+    {
+        NWQEC::PauliTable table(n);
+        std::vector<NWQEC::PauliOp> ops;
+        for (int i = 0; i < 40; ++i)
+        {
+            ops.push_back(random_pauli(n, rng));
+            table.push_back(ops.back());
+        }
+
+        check(table.size() == ops.size(), "size", n);
+        check(table.stride() >= table.num_words(), "stride", n);
+        check(reinterpret_cast<uintptr_t>(table.x(0)) % 64 == 0, "slab alignment", n);
+        for (size_t i = 0; i < ops.size(); ++i)
+            check(table.to_pauli_op(i).to_string() == ops[i].to_string(), "round trip", n);
+
+        // Appending a view of the table itself must survive reallocation
+        for (int i = 0; i < 100; ++i)
+            table.push_back(table.row(static_cast<size_t>(i)));
+        check(table.row(139).to_string() == table.row(99).to_string(), "self append", n);
+
+        table.set_valid(3, false);
+        NWQEC::PauliTable packed = table.compacted();
+        check(packed.size() == table.size() - 1, "compacted size", n);
+        check(packed.row(3).to_string() == ops[4].to_string(), "compacted order", n);
+
+        // HTab commutation and front multiplication against the PauliOp reference
+        NWQEC::HTab tab(n);
+        for (const auto &op : ops)
+            tab.add_stab(op);
+        NWQEC::PauliOp probe = random_pauli(n, rng);
+        bool expected_commutes = true;
+        for (const auto &op : ops)
+            expected_commutes &= (NWQEC::pauli_g_function(probe, op, n) & 1) == 0;
+        check(tab.commutes_with_all(probe) == expected_commutes, "commutes_with_all", n);
+
+        tab.front_multiply_pauli(probe);
+        reference_front_multiply(ops, probe, n);
+        std::vector<NWQEC::PauliOp> rows = tab.get_rows();
+        for (size_t i = 0; i < ops.size(); ++i)
+            check(rows[i].to_string() == ops[i].to_string(), "front_multiply_pauli", n);
+
+        // A batch must match one front multiplication per row, in order
+        NWQEC::PauliTable batch(n);
+        for (int i = 0; i < 6; ++i)
+            batch.push_back(random_pauli(n, rng));
+        NWQEC::HTab sequential(n);
+        NWQEC::HTab batched(n);
+        for (size_t i = 0; i < 40; ++i)
+        {
+            sequential.add_stab(table.row(i));
+            batched.add_stab(table.row(i));
+        }
+        for (size_t i = 0; i < batch.size(); ++i)
+            sequential.front_multiply_pauli(batch.row(i));
+        batched.front_multiply_paulis(batch);
+        check(sequential.get_str() == batched.get_str(), "front_multiply_paulis", n);
+
+        // The fixed-width instantiation picked for this size must agree with the runtime one
+        auto exercise = [&](auto &htab)
+        {
+            for (size_t i = 0; i < 40; ++i)
+                htab.add_stab(table.row(i));
+            std::vector<bool> commutes;
+            for (size_t i = 0; i < 40; ++i)
+                commutes.push_back(htab.commutes_with_all(table.row(i)));
+            htab.front_multiply_pauli(probe);
+            htab.front_multiply_paulis(batch);
+            htab.add_stab(htab.table().row(0));
+            htab.apply_reduction();
+            std::vector<std::string> out = htab.get_str();
+            for (bool c : commutes)
+                out.push_back(c ? "c" : "a");
+            return out;
+        };
+        NWQEC::HTab dynamic(n);
+        std::vector<std::string> expected = exercise(dynamic);
+        std::vector<std::string> actual = NWQEC::dispatch_pauli_width(table.stride(), [&](auto width)
+        {
+            NWQEC::BasicHTab<decltype(width)::value> fixed(n);
+            return exercise(fixed);
+        });
+        check(expected == actual, "fixed width matches runtime width", n);
+
+        // Bucketed reduction against the pairwise scan, on rows drawn from a small pool
+        std::uniform_int_distribution<size_t> pick(0, 7);
+        std::uniform_int_distribution<int> type(0, 2);
+        NWQEC::PauliTable pool(n);
+        for (int i = 0; i < 8; ++i)
+            pool.push_back(random_pauli(n, rng));
+        NWQEC::HTab reducing(n);
+        NWQEC::PauliTable reference(n);
+        for (int i = 0; i < 200; ++i)
+        {
+            NWQEC::PauliOp row = pool.to_pauli_op(pick(rng));
+            row.set_phase(pick(rng) < 3);
+            row.set_rowtype(static_cast<NWQEC::RowType>(type(rng)));
+            row.set_valid(pick(rng) != 0);
+            reducing.add_stab(row);
+            reference.push_back(row);
+        }
+        reducing.apply_reduction();
+        reference_reduction(reference);
+        check(describe(reducing.table()) == describe(reference), "apply_reduction", n);
+    }
+
+    if (failures != 0)
+    {
+        std::fprintf(stderr, "%zu PauliTable checks failed\n", failures);
+        return 1;
+    }
+    std::printf("PauliTable checks passed\n");
+    return 0;
+}
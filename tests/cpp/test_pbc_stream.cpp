@@ -0,0 +1,113 @@
+// Checks that streaming PBC conversion reproduces the VTab-based PbcPass output
+#include "nwqec/passes/pbc_pass.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Type = NWQEC::Operation::Type;
+
+    NWQEC::Circuit random_circuit(size_t n_qubits, size_t n_gates, std::mt19937_64 &rng)
+    {
+        const Type gates[] = {Type::H, Type::S, Type::SDG, Type::SX, Type::SXDG, Type::X, Type::Y, Type::Z,
+                              Type::CX, Type::CX, Type::T, Type::TDG, Type::CCX, Type::MEASURE};
+        std::uniform_int_distribution<size_t> qubit(0, n_qubits - 1);
+        std::uniform_int_distribution<size_t> pick(0, sizeof(gates) / sizeof(gates[0]) - 1);
+
+        NWQEC::Circuit circuit;
+        circuit.add_qreg("q", n_qubits);
+        circuit.add_creg("c", n_qubits);
+        for (size_t i = 0; i < n_gates; ++i)
+        {
+            Type gate = gates[pick(rng)];
+            size_t a = qubit(rng);
+            if (gate == Type::MEASURE)
+            {
+                circuit.add_operation(NWQEC::Operation(gate, {a}, {}, {a}));
+                continue;
+            }
+            const size_t arity = gate == Type::CCX ? 3 : gate == Type::CX ? 2 : 1;
+            if (arity > n_qubits)
+                gate = Type::H;
+            std::vector<size_t> qubits{a};
+            while (qubits.size() < (gate == Type::H ? 1 : arity))
+            {
+                size_t q = qubit(rng);
+                if (std::find(qubits.begin(), qubits.end(), q) == qubits.end())
+                    qubits.push_back(q);
+            }
+            circuit.add_operation(NWQEC::Operation(gate, qubits));
+        }
+        return circuit;
+    }
+
+    std::string describe(const NWQEC::Operation &op)
+    {
+        return std::to_string(static_cast<int>(op.get_type())) + op.get_pauli_op().to_string();
+    }
+
+    size_t check_circuit(const NWQEC::Circuit &circuit, bool keep_cx)
+    {
+        NWQEC::Circuit expected = circuit;
+        NWQEC::PbcPass(keep_cx).run(expected);
+
+        std::vector<NWQEC::Operation> streamed;
+        NWQEC::PbcPass(keep_cx).stream(circuit, [&](NWQEC::Operation &&op)
+                                       { streamed.push_back(std::move(op)); });
+
+        NWQEC::Circuit converted = circuit;
+        NWQEC::PbcPass(keep_cx, 1, true).run(converted);
+
+        const std::vector<NWQEC::Operation> &ops = expected.get_operations();
+        if (streamed.size() != ops.size() || converted.get_operations().size() != ops.size())
+            return ops.size() + 1;
+        size_t mismatches = 0;
+        for (size_t i = 0; i < ops.size(); ++i)
+        {
+            mismatches += describe(streamed[i]) != describe(ops[i]);
+            mismatches += describe(converted.get_operations()[i]) != describe(ops[i]);
+        }
+        // Converting a PBC circuit again is a no-op in both modes
+        size_t emitted = 0;
+        if (NWQEC::PbcPass(keep_cx).stream(expected, [&](NWQEC::Operation &&)
+                                          { ++emitted; }) || emitted != 0)
+            ++mismatches;
+        return mismatches;
+    }
+} // namespace
+
+int main()
+{
+    std::mt19937_64 rng(2024);
+    size_t failures = 0;
+    size_t checks = 0;
+
+    // Sizes straddle the single-word and multi-word PauliOp layouts
+    const size_t sizes[] = {1, 2, 3, 17, 64, 65, 130};
+    for (size_t n : sizes)
+    {
+        for (int rep = 0; rep < 3; ++rep)
+        {
+            NWQEC::Circuit circuit = random_circuit(n, 40 * n + 200, rng);
+            for (bool keep_cx : {false, true})
+            {
+                ++checks;
+                size_t bad = check_circuit(circuit, keep_cx);
+                if (bad != 0 && failures++ < 10)
+                    std::fprintf(stderr, "n=%zu keep_cx=%d: %zu mismatched operations\n", n, keep_cx ? 1 : 0, bad);
+            }
+        }
+    }
+
+    if (failures != 0)
+    {
+        std::fprintf(stderr, "%zu of %zu streaming PBC checks failed\n", failures, checks);
+        return 1;
+    }
+    std::printf("%zu streaming PBC checks passed\n", checks);
+    return 0;
+}
@@ -0,0 +1,60 @@
+// Checks the small-prime sieve and the memoized primality and modular-root helpers of the diophantine solver
+#include "nwqec/gridsynth/diophantine.hpp"
+
+#include <cstdio>
+
+int main()
+{
+    using gridsynth::Integer;
+    size_t failures = 0;
+
+    if (gridsynth::small_primes().size() != 564 || gridsynth::small_primes().back() != 4093)
+    {
+        std::fprintf(stderr, "sieve: %zu primes below %lu\n", gridsynth::small_primes().size(), gridsynth::SMALL_PRIME_LIMIT);
+        ++failures;
+    }
+
+    // 4097 = 17 * 241 is found by the gcd, without Pollard-Brent
+    auto small = gridsynth::_find_factor(Integer(4097LL), 1000);
+    if (!small || *small != 17 || gridsynth::_find_factor(Integer(4093LL), 1000))
+    {
+        std::fprintf(stderr, "find_factor: wrong small factor\n");
+        ++failures;
+    }
+
+    const Integer m61 = (Integer(1) << 61) - 1; // Mersenne prime
+    const Integer m31 = (Integer(1) << 31) - 1;
+    bool primes_ok = gridsynth::_is_prime(m61) && gridsynth::_is_prime(Integer(4093LL)) &&
+                     !gridsynth::_is_prime(m61 * m31) && !gridsynth::_is_prime(Integer(561LL)) && // 561 is a Carmichael number
+                     !gridsynth::_is_prime(Integer(1LL)) && gridsynth::_is_prime(Integer(2LL));
+    if (!primes_ok)
+    {
+        std::fprintf(stderr, "is_prime: wrong answer\n");
+        ++failures;
+    }
+
+    // p = 1 (mod 4): h^2 = -1, and a second lookup is a cache hit with the same root
+    const Integer p1(998244353LL);
+    const size_t hits = gridsynth::prime_cache().sqrt_negative_one.hits();
+    auto h = gridsynth::_sqrt_negative_one(p1);
+    auto again = gridsynth::_sqrt_negative_one(p1);
+    if (!h || (*h * *h + 1) % p1 != 0 || !again || *again != *h || gridsynth::prime_cache().sqrt_negative_one.hits() != hits + 1)
+    {
+        std::fprintf(stderr, "sqrt_negative_one: wrong or uncached root\n");
+        ++failures;
+    }
+
+    // p = 3 (mod 8): -2 is a square; p = 5 (mod 8): 2 is not
+    const Integer p3(1000003LL);
+    auto r = gridsynth::_root_mod(Integer(-2LL), p3);
+    if (!r || (*r * *r + 2) % p3 != 0 || gridsynth::_root_mod(Integer(2LL), Integer(1000037LL)))
+    {
+        std::fprintf(stderr, "root_mod: wrong root\n");
+        ++failures;
+    }
+
+    if (failures != 0)
+        return 1;
+    std::printf("prime cache checks passed\n");
+    return 0;
+}
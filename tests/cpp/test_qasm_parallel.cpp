@@ -0,0 +1,131 @@
+// Checks that multi-threaded streaming of large flat QASM bodies matches the serial parser
+#include "nwqec/parser/qasm_parser.hpp"
+
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    const char *const kHeader = R"(OPENQASM 2.0;
+include "qelib1.inc";
+gate rot(theta) a { rz(theta) a; h a; }
+qreg q[6];
+creg c[6];
+)";
+
+    // Statements cycled through the body: comments, blank lines and a
+    // statement split over two lines land next to chunk boundaries
+    const char *const kBody[] = {
+        "h q[0];\n",
+        "cx q[0],q[1];\n",
+        "rz(pi/7) q[2]; // comment; with a semicolon\n",
+        "// whole-line comment;\n",
+        "\n",
+        "rot(0.25) q[3];\n",
+        "u3(0.1, -pi/4,\n   2*pi - 1e-3) q[4];\n",
+        "t_pauli -XZIYII;\n",
+        "barrier q[0], q[5];\n",
+        "measure q[5] -> c[5];\n",
+        "ccx q[0],q[1],q[2];\n",
+        "\t sdg q[1] ;  \r\n",
+    };
+
+    std::string body(size_t bytes, const std::string &every_500 = "")
+    {
+        std::string out;
+        for (size_t i = 0; out.size() < bytes; ++i)
+        {
+            out += kBody[i % (sizeof(kBody) / sizeof(kBody[0]))];
+            if (!every_500.empty() && i % 500 == 499)
+                out += every_500;
+        }
+        return out;
+    }
+
+    struct Result
+    {
+        bool ok = false;
+        std::string error;
+        std::string diagnostics;
+        std::string circuit;
+    };
+
+    Result run(const std::string &source, size_t threads)
+    {
+        Result result;
+        NWQEC::QASMParser parser;
+        parser.set_num_threads(threads);
+
+        std::ostringstream diagnostics;
+        std::streambuf *saved = std::cerr.rdbuf(diagnostics.rdbuf());
+        result.ok = parser.stream_string(source);
+        std::cerr.rdbuf(saved);
+        result.diagnostics = diagnostics.str();
+        result.error = parser.get_error_message();
+
+        if (std::unique_ptr<NWQEC::Circuit> circuit = parser.get_circuit())
+        {
+            std::ostringstream os;
+            circuit->print(os);
+            os << circuit->get_num_qubits() << " qubits, " << circuit->get_num_bits() << " bits, clifford+t "
+               << circuit->is_clifford_t() << "\n";
+            const auto unordered = circuit->count_ops();
+            std::map<std::string, size_t> counts(unordered.begin(), unordered.end());
+            for (const auto &[name, count] : counts)
+                os << name << " " << count << "\n";
+            result.circuit = os.str();
+        }
+        return result;
+    }
+
+    size_t compare(const std::string &source, const std::string &label)
+    {
+        const Result serial = run(source, 1);
+        size_t failures = 0;
+        for (size_t threads : {2, 5})
+        {
+            const Result parallel = run(source, threads);
+            if (serial.ok != parallel.ok || serial.error != parallel.error)
+            {
+                std::fprintf(stderr, "%s, %zu threads: status %d/%d, errors '%s' / '%s'\n", label.c_str(), threads,
+                             serial.ok, parallel.ok, serial.error.c_str(), parallel.error.c_str());
+                ++failures;
+            }
+            if (serial.diagnostics != parallel.diagnostics)
+            {
+                std::fprintf(stderr, "%s, %zu threads: diagnostics differ\n", label.c_str(), threads);
+                ++failures;
+            }
+            if (serial.circuit != parallel.circuit)
+            {
+                std::fprintf(stderr, "%s, %zu threads: circuits differ\n", label.c_str(), threads);
+                ++failures;
+            }
+        }
+        return failures;
+    }
+} // namespace
+
+int main()
+{
+    const size_t size = size_t(3) << 19;
+    size_t failures = 0;
+
+    failures += compare(kHeader + body(size), "flat body");
+    failures += compare(std::string(kHeader) + "h q[0];" + body(size), "body on the header's last line");
+    failures += compare(kHeader + body(size, "cx q[0] q[1];\n"), "skipped statements");
+    failures += compare(kHeader + body(size) + "h r[0];\n" + body(size), "conversion error");
+    failures += compare(kHeader + body(size, "h r[0];\n") + "x q[0] # lexical error\n", "first of several errors");
+    failures += compare(kHeader + body(size) + "x q[0] # lexical error\n" + body(size), "lexical error");
+    failures += compare(kHeader + body(size) + "qreg r[2];\nh r[1];\n" + body(size), "register in body");
+    failures += compare(kHeader + body(size) + "gate g a { x a; }\ng q[1];\n" + body(size), "gate in body");
+    failures += compare(kHeader + body(size) + "include \"more.inc\";\n" + body(size), "string in body");
+
+    if (failures != 0)
+        return 1;
+    std::printf("parallel QASM checks passed\n");
+    return 0;
+}
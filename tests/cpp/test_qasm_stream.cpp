@@ -0,0 +1,102 @@
+// Checks the streaming QASM parser against the full AST parser, from strings and mapped files
+#include "nwqec/parser/qasm_parser.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    const char *const kProgram = R"(OPENQASM 2.0;
+include "qelib1.inc";
+// user gates, register broadcasts and expressions
+gate majority a,b,c { cx c,b; cx c,a; ccx a,b,c; }
+gate rot(theta) a { rz(theta) a; h a; }
+qreg q[4];
+qreg anc[2];
+creg c[4];
+h q;
+cx q[0],anc[1];
+majority q[0],q[1],anc[0];
+rot(pi/3) q[2];
+u3(0.1234567890123456789, -pi/4, 2*pi - 1e-3) q[3];
+rz(-(pi^2)/7.5E1) anc;
+barrier q, anc[0];
+reset anc[1];
+t_pauli -XZIYII;
+m_pauli +ZZIIII;
+measure q -> c;
+)";
+
+    std::string print(NWQEC::QASMParser &parser)
+    {
+        std::unique_ptr<NWQEC::Circuit> circuit = parser.get_circuit();
+        if (!circuit)
+            return "<no circuit: " + parser.get_error_message() + ">";
+        std::ostringstream os;
+        circuit->print(os);
+        os << circuit->get_num_qubits() << " qubits, " << circuit->get_num_bits() << " bits\n";
+        return os.str();
+    }
+
+    size_t compare(const std::string &source, const std::string &label)
+    {
+        NWQEC::QASMParser full, streamed;
+        const bool full_ok = full.parse_string(source);
+        const bool stream_ok = streamed.stream_string(source);
+        size_t failures = 0;
+        if (full_ok != stream_ok || full.get_error_message() != streamed.get_error_message())
+        {
+            std::fprintf(stderr, "%s: status %d/%d, errors '%s' / '%s'\n", label.c_str(), full_ok, stream_ok,
+                         full.get_error_message().c_str(), streamed.get_error_message().c_str());
+            ++failures;
+        }
+        if (full_ok && stream_ok && print(full) != print(streamed))
+        {
+            std::fprintf(stderr, "%s: circuits differ\n", label.c_str());
+            ++failures;
+        }
+        return failures;
+    }
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+    failures += compare(kProgram, "program");
+    failures += compare("", "empty");
+    failures += compare("qreg q[2];\nh q[0];\ncx q[0] q[1];\nx q[1];\n", "parse error");
+    failures += compare("qreg q[2];\nh q[0];\nx q[1] # comment\n", "lexical error");
+    failures += compare("qreg q[1];\nrz(1e999) q[0];\n", "real out of range");
+
+    // Mapped file: the same circuit as the in-memory source
+    const std::string path = "test_qasm_stream.qasm";
+    {
+        std::ofstream out(path, std::ios::binary);
+        for (int i = 0; i < 2000; ++i)
+            out << (i == 0 ? kProgram : "rz(0.5) q[1];\ncx q[1],q[3];\n");
+    }
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    NWQEC::QASMParser from_string, from_file, streamed_file;
+    from_string.parse_string(buffer.str());
+    from_file.parse_file(path);
+    streamed_file.stream_file(path);
+    const std::string expected = print(from_string);
+    failures += print(from_file) != expected;
+    failures += print(streamed_file) != expected;
+    std::remove(path.c_str());
+
+    NWQEC::QASMParser missing;
+    failures += missing.stream_file("does_not_exist.qasm") || missing.get_error_message().empty();
+
+    if (failures != 0)
+    {
+        std::fprintf(stderr, "%zu streaming parser checks failed\n", failures);
+        return 1;
+    }
+    std::printf("Streaming parser checks passed\n");
+    return 0;
+}
@@ -0,0 +1,153 @@
+// Checks that RZ_SEQ placeholders behave like the gates they stand for in stats, output and later passes
+#include "nwqec/core/transpiler.hpp"
+#include "nwqec/parser/circuit_binary.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    using Type = NWQEC::Operation::Type;
+
+    // Repeated angles, angles merged into one canonical group, and gates in between
+    NWQEC::Circuit rz_circuit()
+    {
+        NWQEC::Circuit circuit;
+        circuit.add_qreg("q", 3);
+        circuit.add_creg("c", 3);
+        for (double angle : {0.3, 0.3 + M_PI_4, -0.3, 0.3 + 3 * M_PI_4, 1.1, 0.3})
+        {
+            circuit.add_operation(NWQEC::Operation(Type::RZ, {0}, {angle}));
+            circuit.add_operation(NWQEC::Operation(Type::H, {0}));
+        }
+        circuit.add_operation(NWQEC::Operation(Type::RZ, {1}, {1.1}));
+        circuit.add_operation(NWQEC::Operation(Type::RZ, {1}, {-0.3}));
+        circuit.add_operation(NWQEC::Operation(Type::CX, {0, 1}));
+        circuit.add_operation(NWQEC::Operation(Type::RZ, {2}, {M_PI / 3}));
+        circuit.add_operation(NWQEC::Operation(Type::MEASURE, {2}, {}, {2}));
+        return circuit;
+    }
+
+    NWQEC::Circuit synthesized(bool defer)
+    {
+        NWQEC::SynthesisLimits limits;
+        limits.use_rz_table = false;
+        limits.defer_expansion = defer;
+        NWQEC::SynthesizeRzPass pass(1e-3, 1, nullptr, limits);
+        NWQEC::Circuit circuit = rz_circuit();
+        pass.run(circuit);
+        return circuit;
+    }
+
+    std::string qasm(const NWQEC::Circuit &circuit)
+    {
+        std::ostringstream os;
+        circuit.print(os);
+        return os.str();
+    }
+
+    std::string binary(const NWQEC::Circuit &circuit)
+    {
+        std::ostringstream os;
+        NWQEC::write_binary(circuit, os);
+        return os.str();
+    }
+
+    std::string after(NWQEC::Pass &&pass, NWQEC::Circuit circuit)
+    {
+        pass.run(circuit);
+        return qasm(circuit);
+    }
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+
+    const NWQEC::Circuit eager = synthesized(false);
+    const NWQEC::Circuit deferred = synthesized(true);
+    if (!deferred.has_rz_sequences() || eager.has_rz_sequences() ||
+        deferred.get_operations().size() >= eager.get_operations().size())
+    {
+        std::fprintf(stderr, "defer: %zu operations deferred, %zu expanded\n",
+                     deferred.get_operations().size(), eager.get_operations().size());
+        ++failures;
+    }
+
+    bool stats_ok = deferred.gate_count() == eager.get_operations().size() && deferred.count_ops() == eager.count_ops() &&
+                    deferred.depth() == eager.depth() && deferred.duration(7.0) == eager.duration(7.0) &&
+                    deferred.is_clifford_t() == eager.is_clifford_t() &&
+                    deferred.get_operation_count(Type::T) == eager.get_operation_count(Type::T) &&
+                    deferred.get_operation_count(Type::RZ_SEQ) == 0;
+    if (!stats_ok)
+    {
+        std::fprintf(stderr, "stats: gate count %zu vs %zu, depth %zu vs %zu\n", deferred.gate_count(),
+                     eager.get_operations().size(), deferred.depth(), eager.depth());
+        ++failures;
+    }
+
+    if (qasm(deferred) != qasm(eager) || binary(deferred) != binary(eager))
+    {
+        std::fprintf(stderr, "output: placeholders not written as their gates\n");
+        ++failures;
+    }
+
+    // Placeholders hold no parameter and index a table copies share; later passes add no entries
+    {
+        const auto table = deferred.rz_sequences();
+        const size_t entries = table ? table->size() : 0;
+        bool indexed = table && entries > 0;
+        for (const auto &op : deferred.get_operations())
+        {
+            if (op.get_type() == Type::RZ_SEQ)
+                indexed = indexed && op.get_parameters().empty() && op.get_sequence_index() < entries &&
+                          !deferred.rz_sequence(op).types.empty();
+        }
+        NWQEC::Circuit copy = deferred;
+        NWQEC::GateFusionPass().run(copy);
+        if (!indexed || copy.rz_sequences() != table || table->size() != entries)
+        {
+            std::fprintf(stderr, "table: placeholders misindexed or the shared table changed\n");
+            ++failures;
+        }
+    }
+
+    NWQEC::Circuit expanded = deferred;
+    expanded.expand_rz_sequences();
+    if (expanded.has_rz_sequences() || expanded.get_operations().size() != eager.get_operations().size() ||
+        qasm(expanded) != qasm(eager) || expanded.count_ops() != eager.count_ops())
+    {
+        std::fprintf(stderr, "expand: differs from synthesizing without placeholders\n");
+        ++failures;
+    }
+
+    // Passes after synthesis give the same result either way
+    struct
+    {
+        const char *name;
+        std::string deferred, eager;
+    } passes[] = {
+        {"pbc", after(NWQEC::PbcPass(), deferred), after(NWQEC::PbcPass(), eager)},
+        {"pbc keep_cx", after(NWQEC::PbcPass(true), deferred), after(NWQEC::PbcPass(true), eager)},
+        {"pbc stream", after(NWQEC::PbcPass(false, 1, true), deferred), after(NWQEC::PbcPass(false, 1, true), eager)},
+        {"cr", after(NWQEC::CRPass(), deferred), after(NWQEC::CRPass(), eager)},
+        {"gate fusion", after(NWQEC::GateFusionPass(), deferred), after(NWQEC::GateFusionPass(), eager)},
+        {"remove pauli", after(NWQEC::RemovePauliPass(), deferred), after(NWQEC::RemovePauliPass(), eager)},
+    };
+    for (const auto &pass : passes)
+    {
+        if (pass.deferred != pass.eager)
+        {
+            std::fprintf(stderr, "%s: output differs with placeholders\n", pass.name);
+            ++failures;
+        }
+    }
+
+    if (failures != 0)
+        return 1;
+    std::printf("rz sequence checks passed\n");
+    return 0;
+}
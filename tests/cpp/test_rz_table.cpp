@@ -0,0 +1,140 @@
+// Checks RzTable files and SynthesizeRzPass lookups in the shipped table
+#include "nwqec/core/rz_table.hpp"
+#include "nwqec/core/transpiler.hpp"
+#include "nwqec/gridsynth/gridsynth.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Type = NWQEC::Operation::Type;
+
+    // rz(π/8), rz(-π/16), rz(3π/64) and a non-dyadic angle
+    std::unique_ptr<NWQEC::Circuit> rz_circuit()
+    {
+        auto circuit = std::make_unique<NWQEC::Circuit>();
+        circuit->add_qreg("q", 1);
+        for (double angle : {M_PI / 8, -M_PI / 16, 3 * M_PI / 64, 0.3})
+            circuit->add_operation(NWQEC::Operation(Type::RZ, {0}, {angle}));
+        return circuit;
+    }
+
+    std::string gates_of(const NWQEC::Circuit &circuit)
+    {
+        std::string out;
+        for (const auto &operation : circuit.get_operations())
+            out += operation.get_type_name() + ";";
+        return out;
+    }
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+    const std::string path = "test_rz_table.nwqt";
+    setenv("NWQEC_RZ_TABLE", path.c_str(), 1); // Read once, by the first RzTable::shipped()
+
+    // Round trip, including an odd gate count that leaves a padding nibble
+    const std::string pi8 = NWQEC::synthesis_theta_string(M_PI / 8);
+    const std::string eps = NWQEC::synthesis_epsilon_string(1e-3);
+    std::vector<NWQEC::RzTable::Entry> entries = {
+        {pi8, eps, "HTSHTHTW"},
+        {NWQEC::synthesis_theta_string(M_PI / 16), eps, "SHTHXYZ"},
+        {pi8, NWQEC::synthesis_epsilon_string(1e-4), "T"},
+    };
+    NWQEC::RzTable table;
+    if (!NWQEC::RzTable::write(path, entries) || !table.open(path) || table.size() != 3)
+    {
+        std::fprintf(stderr, "write/open: table not readable\n");
+        ++failures;
+    }
+    else
+    {
+        for (const auto &entry : entries)
+        {
+            auto gates = table.lookup(entry.theta, entry.epsilon);
+            if (!gates || *gates != entry.gates)
+            {
+                std::fprintf(stderr, "lookup: wrong gates for %s at %s\n", entry.theta.c_str(), entry.epsilon.c_str());
+                ++failures;
+            }
+        }
+        if (table.lookup(pi8, NWQEC::synthesis_epsilon_string(1e-5)) || table.lookup("0.300000", eps))
+        {
+            std::fprintf(stderr, "lookup: hit for a missing entry\n");
+            ++failures;
+        }
+    }
+
+    if (NWQEC::RzTable::write(path, {{pi8, eps, "HTQ"}}))
+    {
+        std::fprintf(stderr, "write: accepted an unknown gate\n");
+        ++failures;
+    }
+
+    // Files of another format are refused
+    {
+        std::ofstream bad(path, std::ios::binary | std::ios::trunc);
+        bad << "NWQRZTAX" << std::string(8, '\0');
+    }
+    NWQEC::RzTable rejected;
+    if (rejected.open(path) || rejected.open("no_such_table.nwqt"))
+    {
+        std::fprintf(stderr, "open: accepted an invalid file\n");
+        ++failures;
+    }
+
+    // The pass serves dyadic angles from the table and matches synthesis exactly
+    NWQEC::PassConfig config;
+    config.epsilon_override = 1e-3;
+    config.num_threads = 1;
+    config.silent = true;
+    config.use_rz_table = false;
+    NWQEC::Transpiler transpiler;
+    auto reference = transpiler.execute_passes(rz_circuit(), {NWQEC::PassType::SYNTHESIZE_RZ}, config);
+    if (transpiler.synthesis_stats().table_hits != 0)
+    {
+        std::fprintf(stderr, "pass: table used although disabled\n");
+        ++failures;
+    }
+
+    // Entries made the way nwqec-rz-table makes them
+    std::vector<std::string> thetas, epsilons;
+    for (double angle : {M_PI / 8, -M_PI / 16, 3 * M_PI / 64})
+    {
+        thetas.push_back(NWQEC::synthesis_theta_string(angle));
+        epsilons.push_back(eps);
+    }
+    auto results = gridsynth::gridsynth_batch(thetas, epsilons, gridsynth::BatchOptions{});
+    std::vector<NWQEC::RzTable::Entry> generated;
+    for (size_t i = 0; i < results.size(); ++i)
+        generated.push_back({thetas[i], epsilons[i], results[i].gates});
+    if (!NWQEC::RzTable::write(path, generated) || !NWQEC::RzTable::shipped())
+    {
+        std::fprintf(stderr, "shipped: $NWQEC_RZ_TABLE not opened\n");
+        return 1;
+    }
+
+    config.use_rz_table = true;
+    auto from_table = transpiler.execute_passes(rz_circuit(), {NWQEC::PassType::SYNTHESIZE_RZ}, config);
+    const NWQEC::SynthesisStats &s = transpiler.synthesis_stats();
+    if (s.table_hits != 3 || s.synthesized != 1 || gates_of(*from_table) != gates_of(*reference))
+    {
+        std::fprintf(stderr, "pass: %zu table hits, %zu synthesized, output %s\n", s.table_hits, s.synthesized,
+                     gates_of(*from_table) == gates_of(*reference) ? "identical" : "different");
+        ++failures;
+    }
+
+    std::remove(path.c_str());
+
+    if (failures != 0)
+        return 1;
+    std::printf("rz table checks passed\n");
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Checks SingleQubitRuns against chains followed through DependencyGraph, and RewriteTable output
+#include "nwqec/core/dependency_graph.hpp"
+#include "nwqec/core/single_qubit_runs.hpp"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Type = NWQEC::Operation::Type;
+
+    std::vector<NWQEC::Operation> random_ops(size_t n_qubits, size_t n_ops, std::mt19937_64 &rng)
+    {
+        std::uniform_int_distribution<size_t> qubit(0, n_qubits - 1);
+        std::uniform_int_distribution<int> kind(0, 11);
+        std::vector<NWQEC::Operation> ops;
+        for (size_t i = 0; i < n_ops; ++i)
+        {
+            size_t a = qubit(rng), b = qubit(rng);
+            switch (kind(rng))
+            {
+            case 0:
+                ops.push_back(a != b ? NWQEC::Operation(Type::CX, {a, b}) : NWQEC::Operation(Type::H, {a}));
+                break;
+            case 1:
+                ops.push_back(NWQEC::Operation(Type::MEASURE, {a}, {}, {0}));
+                break;
+            case 2:
+                ops.push_back(NWQEC::Operation(Type::BARRIER, {a}));
+                break;
+            case 3:
+                ops.push_back(NWQEC::Operation(Type::RESET, {a}));
+                break;
+            default:
+                ops.push_back(NWQEC::Operation(kind(rng) % 2 ? Type::T : Type::S, {a}));
+                break;
+            }
+        }
+        return ops;
+    }
+
+    // Runs as the passes used to find them: from each unvisited gate, follow the qubit's successors
+    std::vector<std::vector<size_t>> chains(const std::vector<NWQEC::Operation> &ops)
+    {
+        NWQEC::DependencyGraph graph(ops);
+        std::vector<char> visited(ops.size(), 0);
+        std::vector<std::vector<size_t>> result;
+        for (size_t start = 0; start < ops.size(); ++start)
+        {
+            if (visited[start] || !NWQEC::SingleQubitRuns::is_run_gate(ops[start]))
+                continue;
+            std::vector<size_t> chain;
+            size_t qubit = ops[start].get_qubits()[0];
+            for (size_t i = start; i != NWQEC::DependencyGraph::NONE && NWQEC::SingleQubitRuns::is_run_gate(ops[i]);
+                 i = graph.next_on_qubit(i, qubit))
+            {
+                chain.push_back(i);
+                visited[i] = 1;
+            }
+            result.push_back(chain);
+        }
+        return result;
+    }
+} // namespace
+
+int main()
+{
+    std::mt19937_64 rng(28);
+    size_t failures = 0;
+
+    const size_t sizes[][2] = {{1, 100}, {2, 1000}, {5, 5000}, {64, 20000}};
+    for (const auto &size : sizes)
+    {
+        std::vector<NWQEC::Operation> ops = random_ops(size[0], size[1], rng);
+        NWQEC::SingleQubitRuns runs(ops, size[0]);
+        std::vector<std::vector<size_t>> expected = chains(ops);
+
+        size_t bad = runs.size() != expected.size();
+        for (size_t r = 0; r < runs.size() && r < expected.size(); ++r)
+        {
+            bad += std::vector<size_t>(runs.begin(r), runs.end(r)) != expected[r];
+            for (size_t i : expected[r])
+                bad += runs.run_of(i) != r;
+        }
+        if (bad != 0)
+        {
+            std::fprintf(stderr, "n=%zu ops=%zu: %zu mismatched runs\n", size[0], size[1], bad);
+            ++failures;
+        }
+    }
+
+    // h q0; t q1; cx q0,q1; s q0; t q0 with the run {s q0, t q0} replaced and the CX dropped
+    std::vector<NWQEC::Operation> ops = {NWQEC::Operation(Type::H, {0}), NWQEC::Operation(Type::T, {1}),
+                                         NWQEC::Operation(Type::CX, {0, 1}), NWQEC::Operation(Type::S, {0}),
+                                         NWQEC::Operation(Type::T, {0})};
+    NWQEC::SingleQubitRuns runs(ops);
+    NWQEC::RewriteTable rewrites(ops.size());
+    rewrites.drop(2);
+    rewrites.replace_run(runs, runs.run_of(3), {NWQEC::Operation(Type::Z, {0}), NWQEC::Operation(Type::SX, {0})});
+    std::vector<NWQEC::Operation> result = rewrites.apply(ops);
+    const Type expected[] = {Type::H, Type::T, Type::Z, Type::SX};
+    bool ok = runs.size() == 3 && result.size() == 4;
+    for (size_t i = 0; ok && i < result.size(); ++i)
+        ok = result[i].get_type() == expected[i];
+    if (!ok)
+    {
+        std::fprintf(stderr, "rewrite table: wrong output\n");
+        ++failures;
+    }
+
+    if (failures != 0)
+        return 1;
+    std::printf("single-qubit run checks passed\n");
+    return 0;
+}
@@ -0,0 +1,62 @@
+// Checks that solving TDGP levels ahead leaves gridsynth's results unchanged
+#include "nwqec/gridsynth/gridsynth.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+    gridsynth::SynthesisResult synthesize(const std::string &theta, const std::string &epsilon, size_t levels,
+                                          const gridsynth::SynthesisBudget &budget = {})
+    {
+        gridsynth::SynthesisContext context;
+        if (levels > 0)
+            context.speculate_k(levels, 4);
+        gridsynth::seed_rng(gridsynth::synthesis_seed(theta, epsilon));
+        return gridsynth::gridsynth_gates_budgeted(context, theta, epsilon, budget);
+    }
+
+    bool same(const gridsynth::SynthesisResult &a, const gridsynth::SynthesisResult &b)
+    {
+        return a.success == b.success && a.gates == b.gates && a.k_reached == b.k_reached &&
+               a.tdgp_candidates == b.tdgp_candidates && a.diophantine_calls == b.diophantine_calls;
+    }
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+
+    for (const char *theta : {"0.3", "1.1", "-2.0", "0.7"})
+    {
+        for (const char *epsilon : {"1e-4", "1e-15"})
+        {
+            const gridsynth::SynthesisResult serial = synthesize(theta, epsilon, 0);
+            for (size_t levels : {1, 3})
+            {
+                if (!same(serial, synthesize(theta, epsilon, levels)))
+                {
+                    std::fprintf(stderr, "%s at %s: %zu look-ahead levels changed the result\n",
+                                 theta, epsilon, levels);
+                    ++failures;
+                }
+            }
+        }
+    }
+
+    // The window never reaches past max_k
+    gridsynth::SynthesisBudget budget;
+    budget.max_k = 2;
+    const gridsynth::SynthesisResult capped = synthesize("0.3", "1e-15", 3, budget);
+    if (!same(capped, synthesize("0.3", "1e-15", 0, budget)) || capped.success || capped.k_reached != 2)
+    {
+        std::fprintf(stderr, "max_k: k_reached %d with look-ahead\n", capped.k_reached);
+        ++failures;
+    }
+
+    if (failures != 0)
+        return 1;
+    std::printf("speculative k checks passed\n");
+    return 0;
+}
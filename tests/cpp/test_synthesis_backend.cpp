@@ -0,0 +1,354 @@
+// Checks that RZ synthesis sent to a backend, local or over sockets, gives the in-process result
+#include "nwqec/core/socket_synthesis_backend.hpp"
+#include "nwqec/core/transpiler.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    using Type = NWQEC::Operation::Type;
+
+    NWQEC::Circuit rz_circuit()
+    {
+        NWQEC::Circuit circuit;
+        circuit.add_qreg("q", 3);
+        for (size_t i = 0; i < 9; ++i)
+        {
+            const size_t q = i % 3;
+            circuit.add_operation(NWQEC::Operation(Type::H, {q}));
+            circuit.add_operation(NWQEC::Operation(Type::RZ, {q}, {0.13 + 0.29 * static_cast<double>(i)}));
+            circuit.add_operation(NWQEC::Operation(Type::CX, {q, (q + 1) % 3}));
+        }
+        return circuit;
+    }
+
+    std::string synthesize(std::shared_ptr<NWQEC::SynthesisBackend> backend,
+                           std::shared_ptr<NWQEC::SynthesisCache> cache = nullptr,
+                           NWQEC::SynthesisStats *stats = nullptr, int budget_ms = 0)
+    {
+        NWQEC::SynthesisLimits limits;
+        limits.use_rz_table = false;
+        limits.budget_ms = budget_ms;
+        NWQEC::SynthesizeRzPass pass(1e-3, 2, std::move(cache), limits, std::move(backend));
+        NWQEC::Circuit circuit = rz_circuit();
+        pass.run(circuit);
+        if (stats)
+            *stats = pass.stats();
+        std::ostringstream os;
+        circuit.print(os);
+        return os.str();
+    }
+
+    // How a TestServer answers each batch
+    enum class Mode
+    {
+        Serve,  // serve_connection
+        Error,  // "ERR busy", as when gridsynth throws
+        HangUp, // close the connection
+        Silent, // never reply
+        Flood,  // a reply line that never ends
+        Garble, // a well-formed result naming gates gridsynth never emits
+    };
+
+    // Serves every connection on its own thread
+    class TestServer
+    {
+    public:
+        explicit TestServer(Mode mode = Mode::Serve)
+        {
+            listener_ = NWQEC::synthesis_protocol::listen_on("127.0.0.1", 0, port_);
+            if (listener_ < 0)
+                return;
+            accept_thread_ = std::thread([this, mode]()
+                                         {
+                int client;
+                while ((client = ::accept(listener_, nullptr, nullptr)) >= 0)
+                {
+                    ++connections;
+                    if (mode == Mode::Serve)
+                        clients_.emplace_back(NWQEC::synthesis_protocol::serve_connection, client, size_t(1));
+                    else
+                        clients_.emplace_back([client, mode]()
+                                              {
+                            NWQEC::synthesis_protocol::LineSocket socket(client);
+                            std::string line;
+                            while (socket.read_line(line))
+                            {
+                                if (line.compare(0, 6, "NWQSYN") != 0)
+                                    continue;
+                                if (mode == Mode::HangUp)
+                                    return;
+                                if (mode == Mode::Error)
+                                    socket.write(std::string("ERR busy\n"));
+                                if (mode == Mode::Garble)
+                                {
+                                    std::istringstream header(line);
+                                    std::string magic;
+                                    size_t count = 0;
+                                    header >> magic >> magic >> count;
+                                    for (size_t i = 0; i < count; ++i)
+                                        socket.read_line(line);
+                                    socket.write("NWQSYN 1 " + std::to_string(count) + "\n");
+                                    for (size_t i = 0; i < count; ++i)
+                                        socket.write(std::string("1 0 1 1 0.000 64 0 0.000 0.000 0.000 1 0 0 HTxQ\n"));
+                                }
+                                if (mode == Mode::Flood)
+                                {
+                                    const std::string chunk(1 << 16, 'H');
+                                    for (size_t sent = 0; sent <= 2 * NWQEC::synthesis_protocol::kMaxLineBytes;
+                                         sent += chunk.size())
+                                        if (!socket.write(chunk))
+                                            return;
+                                }
+                            } });
+                } });
+        }
+
+        ~TestServer()
+        {
+            if (listener_ < 0)
+                return;
+            ::shutdown(listener_, SHUT_RDWR);
+            accept_thread_.join();
+            ::close(listener_);
+            for (auto &client : clients_)
+                client.join();
+        }
+
+        bool ok() const { return listener_ >= 0; }
+        std::string endpoint() const { return "127.0.0.1:" + std::to_string(port_); }
+
+        std::atomic<int> connections{0};
+
+    private:
+        int listener_ = -1;
+        int port_ = 0;
+        std::thread accept_thread_;
+        std::vector<std::thread> clients_;
+    };
+
+    // A port nothing listens on
+    std::string dead_endpoint()
+    {
+        int port = 0;
+        const int fd = NWQEC::synthesis_protocol::listen_on("127.0.0.1", 0, port);
+        ::close(fd);
+        return "127.0.0.1:" + std::to_string(port);
+    }
+
+    class CountingBackend : public NWQEC::SynthesisBackend
+    {
+    public:
+        std::string name() const override { return "counting"; }
+
+        std::vector<gridsynth::SynthesisResult> synthesize(const std::vector<std::string> &thetas,
+                                                           const std::vector<std::string> &epsilons,
+                                                           const gridsynth::BatchOptions &options) override
+        {
+            angles += thetas.size();
+            return local.synthesize(thetas, epsilons, options);
+        }
+
+        size_t angles = 0;
+        NWQEC::LocalSynthesisBackend local;
+    };
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+    const std::string expected = synthesize(nullptr);
+
+    auto counting = std::make_shared<CountingBackend>();
+    NWQEC::SynthesisStats stats;
+    if (synthesize(counting, nullptr, &stats) != expected || counting->angles != stats.synthesized ||
+        counting->angles == 0)
+    {
+        std::fprintf(stderr, "custom backend: %zu angles sent, %zu synthesized\n", counting->angles, stats.synthesized);
+        ++failures;
+    }
+
+    TestServer server, erroring(Mode::Error), hanging_up(Mode::HangUp), silent(Mode::Silent), flooding(Mode::Flood),
+        garbling(Mode::Garble);
+    if (!server.ok() || !erroring.ok() || !hanging_up.ok() || !silent.ok() || !flooding.ok() || !garbling.ok())
+    {
+        std::fprintf(stderr, "cannot listen on a local port\n");
+        return 1;
+    }
+
+    // Chunks of two angles, spread over two connections to the same worker
+    const std::vector<std::string> workers = {server.endpoint(), server.endpoint()};
+    if (synthesize(std::make_shared<NWQEC::SocketSynthesisBackend>(workers, 2)) != expected)
+    {
+        std::fprintf(stderr, "socket: output differs from in-process synthesis\n");
+        ++failures;
+    }
+
+    // An oversized batch is refused without taking the worker down
+    {
+        NWQEC::synthesis_protocol::LineSocket socket(NWQEC::synthesis_protocol::connect_to(server.endpoint()));
+        std::string reply;
+        if (!socket.write(std::string("NWQSYN 1 99999999999999999 0 0 0 0\n")) || !socket.read_line(reply) ||
+            reply.compare(0, 4, "ERR ") != 0)
+        {
+            std::fprintf(stderr, "oversized batch: expected an ERR reply, got '%s'\n", reply.c_str());
+            ++failures;
+        }
+    }
+    if (synthesize(std::make_shared<NWQEC::SocketSynthesisBackend>(std::vector<std::string>{server.endpoint()})) !=
+        expected)
+    {
+        std::fprintf(stderr, "oversized batch: worker stopped serving\n");
+        ++failures;
+    }
+
+    // Workers that are down or drop the connection leave the work to the others
+    const std::vector<std::string> flaky = {dead_endpoint(), hanging_up.endpoint(), server.endpoint()};
+    if (synthesize(std::make_shared<NWQEC::SocketSynthesisBackend>(flaky, 2)) != expected ||
+        hanging_up.connections == 0)
+    {
+        std::fprintf(stderr, "failover: output differs with failing workers\n");
+        ++failures;
+    }
+
+    std::string error;
+    try
+    {
+        synthesize(std::make_shared<NWQEC::SocketSynthesisBackend>(
+            std::vector<std::string>{dead_endpoint(), hanging_up.endpoint()}, 2));
+    }
+    catch (const std::runtime_error &e)
+    {
+        error = e.what();
+    }
+    if (error.find("No synthesis worker reachable") == std::string::npos)
+    {
+        std::fprintf(stderr, "no worker: got '%s'\n", error.c_str());
+        ++failures;
+    }
+
+    // A reply line past the length limit drops that worker instead of filling memory
+    if (synthesize(std::make_shared<NWQEC::SocketSynthesisBackend>(
+            std::vector<std::string>{flooding.endpoint(), server.endpoint()}, 2)) != expected ||
+        flooding.connections == 0)
+    {
+        std::fprintf(stderr, "endless line: output differs with a flooding worker\n");
+        ++failures;
+    }
+    error.clear();
+    try
+    {
+        synthesize(std::make_shared<NWQEC::SocketSynthesisBackend>(std::vector<std::string>{flooding.endpoint()}));
+    }
+    catch (const std::runtime_error &e)
+    {
+        error = e.what();
+    }
+    if (error.find("reply line longer than") == std::string::npos)
+    {
+        std::fprintf(stderr, "endless line: got '%s'\n", error.c_str());
+        ++failures;
+    }
+
+    // Gates outside gridsynth's alphabet are a malformed result, never cached
+    error.clear();
+    try
+    {
+        synthesize(std::make_shared<NWQEC::SocketSynthesisBackend>(std::vector<std::string>{garbling.endpoint()}));
+    }
+    catch (const std::runtime_error &e)
+    {
+        error = e.what();
+    }
+    if (error.find("malformed result") == std::string::npos)
+    {
+        std::fprintf(stderr, "bad gates: got '%s'\n", error.c_str());
+        ++failures;
+    }
+
+    // An ERR reply is a synthesis failure, reported as such instead of trying every worker
+    error.clear();
+    try
+    {
+        synthesize(std::make_shared<NWQEC::SocketSynthesisBackend>(
+            std::vector<std::string>{erroring.endpoint(), erroring.endpoint()}, 2));
+    }
+    catch (const std::runtime_error &e)
+    {
+        error = e.what();
+    }
+    if (error.find("busy") == std::string::npos || error.find("No synthesis worker reachable") != std::string::npos)
+    {
+        std::fprintf(stderr, "worker error: got '%s'\n", error.c_str());
+        ++failures;
+    }
+
+    // A worker that never answers gives up the pass after its budget
+    error.clear();
+    const auto start = std::chrono::steady_clock::now();
+    try
+    {
+        synthesize(std::make_shared<NWQEC::SocketSynthesisBackend>(std::vector<std::string>{silent.endpoint()}),
+                   nullptr, nullptr, 200);
+    }
+    catch (const std::runtime_error &e)
+    {
+        error = e.what();
+    }
+    const double waited_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (error.find("no reply") == std::string::npos || waited_s > 30.0)
+    {
+        std::fprintf(stderr, "silent worker: got '%s' after %.1f s\n", error.c_str(), waited_s);
+        ++failures;
+    }
+
+    try
+    {
+        NWQEC::SocketSynthesisBackend::parse_endpoints("localhost:7733,node2");
+        std::fprintf(stderr, "parse_endpoints: accepted an endpoint without a port\n");
+        ++failures;
+    }
+    catch (const std::invalid_argument &)
+    {
+    }
+
+    // Remote results fill the cache; the next run needs no worker at all
+    const std::string cache_path =
+        (std::filesystem::temp_directory_path() / ("nwqec_backend_cache_" + std::to_string(::getpid()))).string();
+    std::filesystem::remove(cache_path);
+    auto remote = std::make_shared<NWQEC::SocketSynthesisBackend>(std::vector<std::string>{server.endpoint()}, 4);
+    synthesize(remote, std::make_shared<NWQEC::SynthesisCache>(cache_path));
+    NWQEC::SynthesisStats cached;
+    auto unreachable = std::make_shared<NWQEC::SocketSynthesisBackend>(std::vector<std::string>{dead_endpoint()});
+    try
+    {
+        if (synthesize(unreachable, std::make_shared<NWQEC::SynthesisCache>(cache_path), &cached) != expected ||
+            cached.synthesized != 0)
+        {
+            std::fprintf(stderr, "cache: %zu angles synthesized again\n", cached.synthesized);
+            ++failures;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::fprintf(stderr, "cache: %s\n", e.what());
+        ++failures;
+    }
+    std::filesystem::remove(cache_path);
+
+    if (failures != 0)
+        return 1;
+    std::printf("synthesis backend checks passed\n");
+    return 0;
+}
@@ -0,0 +1,177 @@
+// Checks that deadlines, max_k and max_diophantine_calls stop gridsynth and that SynthesizeRzPass reports it
+#include "nwqec/core/transpiler.hpp"
+#include "nwqec/gridsynth/gridsynth.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using Type = NWQEC::Operation::Type;
+
+    // Needs k far above 0
+    const std::string kTheta = "0.3";
+    const std::string kEpsilon = "1e-10";
+
+    // Seeded as gridsynth_batch does, so runs with enough budget agree
+    gridsynth::SynthesisResult run(const gridsynth::SynthesisBudget &budget,
+                                   const std::string &epsilon = kEpsilon)
+    {
+        gridsynth::seed_rng(gridsynth::synthesis_seed(kTheta, epsilon));
+        return gridsynth::gridsynth_gates_budgeted(kTheta, epsilon, budget);
+    }
+
+    bool stopped(const char *what, const gridsynth::SynthesisResult &r, bool timed_out)
+    {
+        if (r.success || !r.gates.empty() || r.timed_out != timed_out)
+        {
+            std::fprintf(stderr, "%s: success %d, timed_out %d, %zu gates\n", what, r.success ? 1 : 0,
+                         r.timed_out ? 1 : 0, r.gates.size());
+            return false;
+        }
+        return true;
+    }
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+
+    const gridsynth::SynthesisResult full = run(gridsynth::SynthesisBudget{});
+    gridsynth::seed_rng(gridsynth::synthesis_seed(kTheta, kEpsilon));
+    if (!full.success || full.timed_out || full.gates != gridsynth::gridsynth_gates(kTheta, kEpsilon) ||
+        full.k_reached < 2 || full.diophantine_calls < 1)
+    {
+        std::fprintf(stderr, "unlimited: success %d, k %d, %d diophantine calls\n", full.success ? 1 : 0,
+                     full.k_reached, full.diophantine_calls);
+        return 1;
+    }
+
+    // A deadline that has passed stops the search before the first k
+    gridsynth::SynthesisBudget past;
+    past.deadline = Clock::now() - std::chrono::milliseconds(1);
+    failures += !stopped("past deadline", run(past), true);
+
+    // A short deadline stops a search that would take far longer
+    {
+        const auto start = Clock::now();
+        const auto r = run(gridsynth::SynthesisBudget::with_timeout_ms(20), "1e-60");
+        const double waited_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        failures += !stopped("20 ms deadline", r, true);
+        if (waited_ms > 5000.0)
+        {
+            std::fprintf(stderr, "20 ms deadline: returned after %.0f ms\n", waited_ms);
+            ++failures;
+        }
+    }
+
+    // max_k bounds the denominator exponent
+    gridsynth::SynthesisBudget low_k;
+    low_k.max_k = full.k_reached - 1;
+    {
+        const auto r = run(low_k);
+        failures += !stopped("max_k", r, false);
+        if (r.k_reached > low_k.max_k)
+        {
+            std::fprintf(stderr, "max_k %d: reached k %d\n", low_k.max_k, r.k_reached);
+            ++failures;
+        }
+    }
+    gridsynth::SynthesisBudget enough_k;
+    enough_k.max_k = full.k_reached;
+    if (run(enough_k).gates != full.gates)
+    {
+        std::fprintf(stderr, "max_k %d: the solution at that k was not accepted\n", enough_k.max_k);
+        ++failures;
+    }
+
+    // max_diophantine_calls bounds the equations attempted
+    std::vector<int> call_limits = {0};
+    if (full.diophantine_calls > 1)
+        call_limits.push_back(full.diophantine_calls - 1);
+    for (int calls : call_limits)
+    {
+        gridsynth::SynthesisBudget budget;
+        budget.max_diophantine_calls = calls;
+        const auto r = run(budget);
+        const std::string what = "max_diophantine_calls " + std::to_string(calls);
+        failures += !stopped(what.c_str(), r, false);
+        if (r.diophantine_calls > calls)
+        {
+            std::fprintf(stderr, "%s: made %d calls\n", what.c_str(), r.diophantine_calls);
+            ++failures;
+        }
+    }
+    gridsynth::SynthesisBudget enough_calls;
+    enough_calls.max_diophantine_calls = full.diophantine_calls;
+    if (run(enough_calls).gates != full.gates)
+    {
+        std::fprintf(stderr, "max_diophantine_calls %d: solution not reached\n", full.diophantine_calls);
+        ++failures;
+    }
+
+    // Batch: the shared deadline and the per-angle timeout mark every angle timed out
+    {
+        const std::vector<std::string> thetas = {"0.3", "0.7", "1.1"};
+        const std::vector<std::string> epsilons(thetas.size(), "1e-60");
+        gridsynth::BatchOptions shared;
+        shared.budget = past;
+        shared.num_threads = 2;
+        gridsynth::BatchOptions per_angle;
+        per_angle.angle_timeout_ms = 10;
+        per_angle.num_threads = 2;
+        for (const auto *options : {&shared, &per_angle})
+        {
+            for (const auto &r : gridsynth::gridsynth_batch(thetas, epsilons, *options))
+                failures += !stopped(options == &shared ? "batch deadline" : "batch angle timeout", r, true);
+        }
+    }
+
+    // The pass throws once its budget is used up, with the counters recorded
+    {
+        NWQEC::Circuit circuit;
+        circuit.add_qreg("q", 1);
+        for (double angle : {0.3, 0.7, 1.1, 1.9})
+            circuit.add_operation(NWQEC::Operation(Type::RZ, {0}, {angle}));
+        const size_t before = circuit.get_operations().size();
+
+        for (bool per_angle : {false, true})
+        {
+            NWQEC::SynthesisLimits limits;
+            limits.use_rz_table = false;
+            (per_angle ? limits.angle_timeout_ms : limits.budget_ms) = 10;
+            NWQEC::SynthesizeRzPass pass(1e-60, 2, nullptr, limits);
+            NWQEC::Circuit copy = circuit;
+            std::string error;
+            try
+            {
+                pass.run(copy);
+            }
+            catch (const std::runtime_error &e)
+            {
+                error = e.what();
+            }
+            const char *what = per_angle ? "pass angle timeout" : "pass budget";
+            if (error.find("exceeded its budget") == std::string::npos || error.find("timed out") == std::string::npos ||
+                pass.stats().failed != 4 || pass.stats().synthesized != 4)
+            {
+                std::fprintf(stderr, "%s: '%s', %zu of %zu failed\n", what, error.c_str(), pass.stats().failed,
+                             pass.stats().synthesized);
+                ++failures;
+            }
+            if (copy.get_operations().size() != before)
+            {
+                std::fprintf(stderr, "%s: circuit changed although synthesis failed\n", what);
+                ++failures;
+            }
+        }
+    }
+
+    if (failures != 0)
+        return 1;
+    std::printf("synthesis budget checks passed\n");
+    return 0;
+}
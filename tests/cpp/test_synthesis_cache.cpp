@@ -0,0 +1,236 @@
+// Checks SynthesisCache persistence: round trip, search modes, damaged lines, the size cap and instances sharing a file
+#include "nwqec/core/synthesis_cache.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::string gates_for(size_t seed, size_t length)
+    {
+        static const char alphabet[] = "HSTXW";
+        std::mt19937_64 rng(seed);
+        std::string gates(length, 'H');
+        for (char &c : gates)
+            c = alphabet[rng() % 5];
+        return gates;
+    }
+
+    std::string read_file(const std::filesystem::path &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::ostringstream text;
+        text << file.rdbuf();
+        return text.str();
+    }
+
+    void write_file(const std::filesystem::path &path, const std::string &text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    // The line insert() writes for (angle, epsilon)
+    std::string entry_line(double angle, double epsilon, const std::string &gates)
+    {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "nwqec_test_cache_line";
+        std::filesystem::remove(path);
+        NWQEC::SynthesisCache(path.string(), 0).insert(angle, epsilon, gates);
+        const std::string line = read_file(path);
+        std::filesystem::remove(path);
+        return line;
+    }
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "nwqec_test_synthesis_cache";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    // Round trip, keyed by exact bit patterns
+    {
+        const std::string path = (dir / "round_trip").string();
+        {
+            NWQEC::SynthesisCache cache(path);
+            cache.insert(0.3, 1e-3, "HTSHT");
+            cache.insert(0.3, 1e-4, "HTHTSHTX");
+            cache.insert(-0.0, 1e-3, "");
+            cache.insert(std::nextafter(0.3, 1.0), 1e-3, "SHTH");
+            cache.insert(0.3, 1e-3, "XXXX"); // First result for a key is kept
+        }
+        NWQEC::SynthesisCache cache(path);
+        const bool ok = cache.size() == 4 && cache.lookup(0.3, 1e-3) == std::optional<std::string>("HTSHT") &&
+                        cache.lookup(0.3, 1e-4) == std::optional<std::string>("HTHTSHTX") &&
+                        cache.lookup(-0.0, 1e-3) == std::optional<std::string>("") &&
+                        cache.lookup(std::nextafter(0.3, 1.0), 1e-3) == std::optional<std::string>("SHTH") &&
+                        !cache.lookup(0.0, 1e-3) && !cache.lookup(0.3, 2e-3) && cache.hits() == 4 &&
+                        cache.misses() == 2;
+        if (!ok)
+        {
+            std::fprintf(stderr, "round trip: %zu entries, %zu hits, %zu misses\n", cache.size(), cache.hits(),
+                         cache.misses());
+            ++failures;
+        }
+    }
+
+    // Raced and serial results for the same request are separate entries
+    {
+        const std::string path = (dir / "search_modes").string();
+        {
+            NWQEC::SynthesisCache cache(path);
+            cache.insert(0.3, 1e-3, "HTSHT");
+            cache.insert(0.4, 1e-3, "SHTHT", true);
+        }
+        NWQEC::SynthesisCache cache(path);
+        const bool ok = cache.size() == 2 && cache.lookup(0.3, 1e-3) == std::optional<std::string>("HTSHT") &&
+                        !cache.lookup(0.3, 1e-3, true) &&
+                        cache.lookup(0.4, 1e-3, true) == std::optional<std::string>("SHTHT") &&
+                        !cache.lookup(0.4, 1e-3);
+        if (!ok)
+        {
+            std::fprintf(stderr, "search modes: %zu entries, raced and serial results mixed\n", cache.size());
+            ++failures;
+        }
+    }
+
+    // Damaged lines are skipped and a torn final line is not merged into the next append
+    {
+        const std::filesystem::path path = dir / "damaged";
+        const std::string good = entry_line(0.5, 1e-3, "HTSHT");
+        const std::string other = entry_line(0.7, 1e-3, "THTH");
+        std::string truncated = entry_line(0.9, 1e-3, "HTHTHT");
+        truncated.erase(truncated.size() - 3, 2);                               // Count says 6, 4 gates left
+        std::string upper = entry_line(1.1, 1e-3, "HT");
+        for (size_t i = 0; i < 16; ++i)
+            upper[i] = static_cast<char>(std::toupper(static_cast<unsigned char>(upper[i]))); // Hex must be lowercase
+        std::string bad_gate = entry_line(1.3, 1e-3, "HTQ");                   // Q is not a gate
+        std::string bad_count = entry_line(1.5, 1e-3, "HT");
+        bad_count[34] = 'x';
+        std::string bad_separator = entry_line(1.7, 1e-3, "HT");
+        bad_separator[16] = '_';
+        std::string torn = entry_line(1.9, 1e-3, "HTHTS");
+        torn.erase(torn.size() - 3); // No trailing newline, count mismatch
+        write_file(path, good + truncated + "\n" + upper + bad_gate + bad_count + bad_separator + "garbage\n" +
+                             other + torn);
+
+        size_t file_size = std::filesystem::file_size(path);
+        {
+            NWQEC::SynthesisCache cache(path.string());
+            if (cache.size() != 2 || cache.lookup(0.5, 1e-3) != std::optional<std::string>("HTSHT") ||
+                cache.lookup(0.7, 1e-3) != std::optional<std::string>("THTH") || cache.lookup(0.9, 1e-3) ||
+                cache.lookup(1.1, 1e-3) || cache.lookup(1.3, 1e-3) || cache.lookup(1.5, 1e-3) ||
+                cache.lookup(1.7, 1e-3) || cache.lookup(1.9, 1e-3))
+            {
+                std::fprintf(stderr, "damaged: %zu entries loaded, expected 2\n", cache.size());
+                ++failures;
+            }
+            cache.insert(2.1, 1e-3, "SSS");
+        }
+        NWQEC::SynthesisCache reopened(path.string());
+        if (reopened.size() != 3 || reopened.lookup(2.1, 1e-3) != std::optional<std::string>("SSS") ||
+            std::filesystem::file_size(path) != file_size + 1 + entry_line(2.1, 1e-3, "SSS").size())
+        {
+            std::fprintf(stderr, "damaged: entry appended after a torn line was lost\n");
+            ++failures;
+        }
+    }
+
+    // Size cap: entries past it are served for the run but not persisted
+    {
+        const std::string path = (dir / "capped").string();
+        const size_t line_size = entry_line(0.1, 1e-3, gates_for(0, 40)).size();
+        {
+            NWQEC::SynthesisCache cache(path, 2 * line_size + line_size / 2);
+            for (size_t i = 0; i < 5; ++i)
+                cache.insert(0.1 * static_cast<double>(i + 1), 1e-3, gates_for(i, 40));
+            for (size_t i = 0; i < 5; ++i)
+            {
+                if (cache.lookup(0.1 * static_cast<double>(i + 1), 1e-3) != std::optional<std::string>(gates_for(i, 40)))
+                {
+                    std::fprintf(stderr, "cap: entry %zu not served from memory\n", i);
+                    ++failures;
+                }
+            }
+        }
+        NWQEC::SynthesisCache reopened(path, 2 * line_size + line_size / 2);
+        if (std::filesystem::file_size(path) != 2 * line_size || reopened.size() != 2 ||
+            !reopened.lookup(0.1, 1e-3) || !reopened.lookup(0.2, 1e-3))
+        {
+            std::fprintf(stderr, "cap: file holds %zu bytes and %zu entries, expected %zu bytes and 2\n",
+                         static_cast<size_t>(std::filesystem::file_size(path)), reopened.size(), 2 * line_size);
+            ++failures;
+        }
+        // A newly opened instance counts the existing bytes against its cap
+        reopened.insert(0.9, 1e-3, gates_for(9, 40));
+        if (std::filesystem::file_size(path) != 2 * line_size)
+        {
+            std::fprintf(stderr, "cap: reopened cache wrote past its cap\n");
+            ++failures;
+        }
+    }
+
+    // Concurrent writers on one path, as transforms from several processes or threads do
+    {
+        const std::string path = (dir / "concurrent").string();
+        constexpr size_t per_writer = 150;
+        NWQEC::SynthesisCache a(path, 0), b(path, 0);
+        auto shared = NWQEC::SynthesisCache::shared(path, 0);
+        std::vector<std::thread> writers;
+        NWQEC::SynthesisCache *caches[] = {&a, &b, shared.get(), shared.get()};
+        for (size_t w = 0; w < 4; ++w)
+            writers.emplace_back([w, &caches]()
+                                 {
+                for (size_t i = 0; i < per_writer; ++i)
+                {
+                    const size_t id = w * per_writer + i;
+                    // Long sequences span several stream buffers
+                    caches[w]->insert(static_cast<double>(id), 1e-3, gates_for(id, 3000 + 10 * (id % 700)));
+                } });
+        for (auto &writer : writers)
+            writer.join();
+
+        NWQEC::SynthesisCache reopened(path, 0);
+        size_t missing = 0;
+        for (size_t id = 0; id < 4 * per_writer; ++id)
+            if (reopened.lookup(static_cast<double>(id), 1e-3) != std::optional<std::string>(gates_for(id, 3000 + 10 * (id % 700))))
+                ++missing;
+        if (reopened.size() != 4 * per_writer || missing != 0)
+        {
+            std::fprintf(stderr, "concurrent: %zu entries read back, %zu missing or damaged\n", reopened.size(), missing);
+            ++failures;
+        }
+    }
+
+    // shared() hands out one instance per path while it is in use
+    {
+        const std::string path = (dir / "registry").string();
+        auto first = NWQEC::SynthesisCache::shared(path);
+        auto second = NWQEC::SynthesisCache::shared(path);
+        auto other = NWQEC::SynthesisCache::shared((dir / "registry_other").string());
+        first->insert(0.25, 1e-3, "HT");
+        const bool same = first == second && first != other && second->lookup(0.25, 1e-3);
+        first.reset();
+        second.reset();
+        auto reopened = NWQEC::SynthesisCache::shared(path);
+        if (!same || !reopened->lookup(0.25, 1e-3))
+        {
+            std::fprintf(stderr, "shared: instances not shared per path\n");
+            ++failures;
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+    if (failures != 0)
+        return 1;
+    std::printf("synthesis cache checks passed\n");
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Checks the gridsynth counters SynthesizeRzPass and Transpiler report for a small circuit
+#include "nwqec/core/transpiler.hpp"
+
+#include <cstdio>
+#include <memory>
+
+namespace
+{
+    using Type = NWQEC::Operation::Type;
+
+    // Four distinct angles, two of them repeated
+    std::unique_ptr<NWQEC::Circuit> rz_circuit()
+    {
+        auto circuit = std::make_unique<NWQEC::Circuit>();
+        circuit->add_qreg("q", 2);
+        circuit->add_creg("c", 2);
+        for (double angle : {0.3, 1.1, 0.3, -2.0, 0.7})
+            circuit->add_operation(NWQEC::Operation(Type::RZ, {0}, {angle}));
+        circuit->add_operation(NWQEC::Operation(Type::RZ, {1}, {1.1}));
+        return circuit;
+    }
+
+    bool consistent(const NWQEC::SynthesisStats &s)
+    {
+        return s.angles == s.exact + s.table_hits + s.cache_hits + s.synthesized && s.failed == 0 &&
+               s.tdgp_candidates >= s.diophantine_calls && s.k_iterations >= s.synthesized &&
+               s.elapsed_ms >= s.slowest_ms && s.max_precision_bits > 0;
+    }
+} // namespace
+
+int main()
+{
+    size_t failures = 0;
+
+    auto circuit = rz_circuit();
+    NWQEC::SynthesizeRzPass pass(1e-3, 1);
+    pass.run(*circuit);
+    const NWQEC::SynthesisStats &s = pass.stats();
+    if (s.angles != 4 || s.synthesized + s.exact != 4 || !consistent(s) || s.diophantine_calls == 0)
+    {
+        std::fprintf(stderr, "pass: %zu angles, %zu synthesized, %zu exact, %zu candidates, %zu diophantine calls\n",
+                     s.angles, s.synthesized, s.exact, s.tdgp_candidates, s.diophantine_calls);
+        ++failures;
+    }
+
+    NWQEC::Transpiler transpiler;
+    NWQEC::PassConfig config;
+    config.epsilon_override = 1e-3;
+    config.num_threads = 1;
+    config.silent = true;
+    transpiler.execute_passes(rz_circuit(), {NWQEC::PassType::SYNTHESIZE_RZ}, config);
+    const NWQEC::SynthesisStats &t = transpiler.synthesis_stats();
+    if (t.synthesized != s.synthesized || t.diophantine_calls != s.diophantine_calls || !consistent(t))
+    {
+        std::fprintf(stderr, "transpiler: %zu synthesized, %zu diophantine calls\n", t.synthesized, t.diophantine_calls);
+        ++failures;
+    }
+
+    // Stats are per call: a run without synthesis leaves them empty
+    transpiler.execute_passes(rz_circuit(), {NWQEC::PassType::DECOMPOSE}, config);
+    if (transpiler.synthesis_stats().angles != 0)
+    {
+        std::fprintf(stderr, "transpiler: stats not reset between calls\n");
+        ++failures;
+    }
+
+    if (failures != 0)
+        return 1;
+    std::printf("synthesis stats checks passed\n");
+    return 0;
+}
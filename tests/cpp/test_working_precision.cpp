@@ -0,0 +1,181 @@
+// Checks that ScopedPrecision restores the working precision however its scope ends, and how working_precision picks it
+#include "nwqec/gridsynth/gridsynth.hpp"
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace
+{
+    using gridsynth::Float;
+    using gridsynth::GMPFloat;
+    using gridsynth::ScopedPrecision;
+
+    size_t failures = 0;
+
+    void expect_precision(const char *what, mpfr_prec_t want)
+    {
+        if (GMPFloat::get_default_precision() != want)
+        {
+            std::fprintf(stderr, "%s: precision %ld, expected %ld\n", what,
+                         static_cast<long>(GMPFloat::get_default_precision()), static_cast<long>(want));
+            ++failures;
+        }
+    }
+
+    // Returns from inside nested scopes
+    mpfr_prec_t nested(mpfr_prec_t outer, mpfr_prec_t inner)
+    {
+        ScopedPrecision a(outer);
+        {
+            ScopedPrecision b(inner);
+            const Float x(1.5);
+            if (x.precision() != inner || (x * x + Float(2.0)).precision() != inner)
+                ++failures;
+        }
+        expect_precision("after the inner scope", outer);
+        return (Float(1.0) / Float(3.0)).precision();
+    }
+
+    void throws_inside(mpfr_prec_t prec)
+    {
+        ScopedPrecision scope(prec);
+        throw std::runtime_error("thrown at " + std::to_string(prec) + " bits");
+    }
+} // namespace
+
+int main()
+{
+    const mpfr_prec_t initial = GMPFloat::get_default_precision();
+
+    // Restored on return, with values and results at the scope's precision meanwhile
+    const Float before(0.25);
+    if (nested(512, 1024) != 512)
+    {
+        std::fprintf(stderr, "arithmetic in the outer scope did not use its precision\n");
+        ++failures;
+    }
+    expect_precision("after return", initial);
+    if (before.precision() != initial)
+    {
+        std::fprintf(stderr, "a value from outside the scope changed precision\n");
+        ++failures;
+    }
+
+    // Restored when the scope is left by an exception, also from a nested one
+    for (mpfr_prec_t prec : {64, 4096})
+    {
+        try
+        {
+            ScopedPrecision outer(192);
+            throws_inside(prec);
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+        expect_precision("after an exception", initial);
+    }
+
+    // The working precision belongs to the calling thread
+    {
+        ScopedPrecision scope(768);
+        mpfr_prec_t seen = 0;
+        std::thread other([&]()
+                          {
+            ScopedPrecision theirs(128);
+            seen = GMPFloat::get_default_precision(); });
+        other.join();
+        expect_precision("after another thread's scope", 768);
+        if (seen != 128)
+        {
+            std::fprintf(stderr, "other thread saw %ld bits\n", static_cast<long>(seen));
+            ++failures;
+        }
+    }
+
+    // 15 + 2.5 * ceil(log10(1/epsilon)) digits plus k/2 bits, in whole limbs
+    struct Case
+    {
+        const char *epsilon;
+        long long k;
+        mpfr_prec_t bits;
+    };
+    const Case cases[] = {
+        {"1", 0, 64},        // 15 digits: 50 bits
+        {"0.5", 0, 64},      // 17.5 digits: 59 bits
+        {"1e-3", 0, 128},    // 22.5 digits: 75 bits
+        {"3e-7", 0, 128},    // ceil(6.52) = 7: 32.5 digits: 108 bits
+        {"1e-10", 0, 192},   // 40 digits: 133 bits
+        {"1e-10", 1, 192},   // One odd k adds nothing
+        {"1e-10", 118, 192}, // 133 + 59 = 192 still fits three limbs
+        {"1e-10", 120, 256}, // 133 + 60 spills into a fourth
+        {"1e-20", 0, 256},   // 65 digits: 216 bits
+        {"1e-60", 0, 576},   // 165 digits: 549 bits
+        {"1e-60", -5, 576},  // Negative k adds nothing
+    };
+    for (const Case &c : cases)
+    {
+        const mpfr_prec_t got = gridsynth::working_precision(Float(c.epsilon), c.k);
+        if (got != c.bits)
+        {
+            std::fprintf(stderr, "working_precision(%s, %lld) = %ld, expected %ld\n", c.epsilon, c.k,
+                         static_cast<long>(got), static_cast<long>(c.bits));
+            ++failures;
+        }
+    }
+
+    // Whole limbs, never less for a tighter epsilon or a larger k
+    mpfr_prec_t last = 0;
+    for (int digits = 0; digits <= 120; ++digits)
+    {
+        const Float epsilon("1e-" + std::to_string(digits));
+        mpfr_prec_t last_k = 0;
+        for (long long k = 0; k <= 400; k += 7)
+        {
+            const mpfr_prec_t p = gridsynth::working_precision(epsilon, k);
+            if (p % GMP_NUMB_BITS != 0 || p < last_k || (k == 0 && p < last))
+            {
+                std::fprintf(stderr, "working_precision(1e-%d, %lld) = %ld breaks monotonicity\n", digits, k,
+                             static_cast<long>(p));
+                ++failures;
+            }
+            last_k = p;
+        }
+        last = gridsynth::working_precision(epsilon);
+    }
+
+    // Without a usable epsilon the current precision is kept
+    {
+        ScopedPrecision scope(320);
+        if (gridsynth::working_precision(Float(0.0)) != 320 || gridsynth::working_precision(Float(-1e-3)) != 320)
+        {
+            std::fprintf(stderr, "working_precision of a non-positive epsilon changed the precision\n");
+            ++failures;
+        }
+    }
+
+    // Synthesis runs at the precision its epsilon and final k ask for, and restores the caller's
+    for (const char *epsilon : {"1e-3", "1e-10", "1e-25"})
+    {
+        const gridsynth::SynthesisResult r =
+            gridsynth::gridsynth_gates_budgeted("0.7", epsilon, gridsynth::SynthesisBudget{});
+        const mpfr_prec_t want = gridsynth::working_precision(Float(epsilon), r.k_reached);
+        if (!r.success || r.precision_bits != static_cast<int>(want))
+        {
+            std::fprintf(stderr, "synthesis at %s: ended at %d bits after k %d, expected %ld\n", epsilon,
+                         r.precision_bits, r.k_reached, static_cast<long>(want));
+            ++failures;
+        }
+        expect_precision("after synthesis", initial);
+    }
+    gridsynth::SynthesisBudget expired;
+    expired.deadline = std::chrono::steady_clock::now();
+    gridsynth::gridsynth_gates_budgeted("0.7", "1e-40", expired);
+    expect_precision("after a timed-out synthesis", initial);
+
+    if (failures != 0)
+        return 1;
+    std::printf("working precision checks passed\n");
+    return 0;
+}
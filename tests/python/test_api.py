@@ -39,3 +39,25 @@ def test_load_and_stats(tmp_path):
     out_file = tmp_path / "out.qasm"
     clifford.to_qasm_file(str(out_file))
     assert out_file.exists()
+
+
+def test_synthesis_cache_size_bounds(tmp_path):
+    _require_nwqec()
+    import nwqec
+
+    with pytest.raises(ValueError):
+        nwqec.set_synthesis_cache(str(tmp_path / "cache.bin"), max_mb=(1 << 44))
+    nwqec.set_synthesis_cache(str(tmp_path / "cache.bin"), max_mb=(1 << 44) - 1)
+    nwqec.set_synthesis_cache(None)
+
+
+def test_synthesis_limits_reject_negative():
+    _require_nwqec()
+    import nwqec
+
+    with pytest.raises(ValueError):
+        nwqec.set_synthesis_limits(angle_timeout_ms=-1)
+    with pytest.raises(ValueError):
+        nwqec.set_synthesis_limits(budget_ms=-500)
+    nwqec.set_synthesis_limits(angle_timeout_ms=0, budget_ms=0)
+    nwqec.set_synthesis_limits()
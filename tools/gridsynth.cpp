@@ -2,40 +2,78 @@
 #include <iomanip>
 #include <string>
 #include <cmath>
+#include <sstream>
+#include <vector>
 
 #include "nwqec/gridsynth/gridsynth.hpp"
 #include "nwqec/core/constants.hpp"
 
 void print_usage(const char *program_name)
 {
-    std::cout << "Usage: " << program_name << " <angle> [epsilon]" << std::endl;
+    std::cout << "Usage: " << program_name << " [--threads <n>] [--lookahead <n>] <angle> [epsilon]" << std::endl;
     std::cout << "  angle   - Target rotation angle in radians (or 'pi/n')" << std::endl;
     std::cout << "  epsilon - Optional absolute tolerance (e.g., 1e-6).\n"
                  "            If omitted, defaults to |theta| * 1e-2." << std::endl;
+    std::cout << "  --threads <n> - Workers racing the diophantine candidates of each k\n"
+                 "            (1 = serial search, default; 0 = all cores). Racing may return a\n"
+                 "            different, equally valid sequence than the serial search" << std::endl;
+    std::cout << "  --lookahead <n> - Further k levels whose TDGP is solved ahead on --threads\n"
+                 "            workers (0 = off, default)" << std::endl;
     std::cout << std::endl;
     std::cout << "Examples:" << std::endl;
     std::cout << "  " << program_name << " 0.785398 1e-10   # π/4 with ε=1e-10" << std::endl;
     std::cout << "  " << program_name << " pi/4             # ε defaults to |θ|*1e-2" << std::endl;
     std::cout << "  " << program_name << " pi/8 1e-12       # π/8 with ε=1e-12" << std::endl;
+    std::cout << "  " << program_name << " --threads 0 pi/8 # race on all cores" << std::endl;
+    std::cout << "  " << program_name << " --threads 0 --lookahead 2 pi/8 # also solve TDGP two k ahead" << std::endl;
 }
 
 int main(int argc, char *argv[])
 {
     std::string theta;
     std::string epsilon;
+    size_t num_threads = 1;
+    size_t lookahead = 0;
 
-    if (argc < 2)
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--threads" || arg == "--lookahead")
+        {
+            if (i + 1 >= argc)
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            try
+            {
+                (arg == "--threads" ? num_threads : lookahead) = static_cast<size_t>(std::stoul(argv[++i]));
+            }
+            catch (...)
+            {
+                std::cout << "Error: invalid " << arg << " value: '" << argv[i] << "'" << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.empty())
     {
         print_usage(argv[0]);
         return 1;
     }
 
-    theta = argv[1];
+    theta = positional[0];
 
-    if (argc >= 3)
+    if (positional.size() >= 2)
     {
         // Use provided epsilon verbatim (supports values like 1e-10 or 0.001)
-        epsilon = argv[2];
+        epsilon = positional[1];
     }
     else
     {
@@ -86,11 +124,23 @@ int main(int argc, char *argv[])
     // Call gridsynth
     std::cout << "Computing optimal gate sequence..." << std::endl;
 
-    // Use high precision values for computation
-    auto gates = gridsynth::gridsynth_gates(theta, epsilon,
-                                            NWQEC::DEFAULT_DIOPHANTINE_TIMEOUT_MS,
-                                            NWQEC::DEFAULT_FACTORING_TIMEOUT_MS,
-                                            false, true);
+    gridsynth::SynthesisContext context;
+    if (num_threads != 1)
+        context.race_diophantine(num_threads);
+    if (lookahead > 0)
+        context.speculate_k(lookahead, num_threads);
+    gridsynth::SynthesisResult result = gridsynth::gridsynth_gates_budgeted(context, theta, epsilon, gridsynth::SynthesisBudget{});
+    if (!result.success)
+    {
+        std::cout << "Error: no solution found" << std::endl;
+        return 1;
+    }
+    const std::string &gates = result.gates;
+
+    std::cout << "time of to_upright: " << result.to_upright_ms << " ms" << std::endl;
+    std::cout << "time of solve_TDGP(" << result.tdgp_candidates << " candidates): " << result.tdgp_ms << " ms" << std::endl;
+    std::cout << "time of diophantine(" << result.diophantine_calls << "): " << result.diophantine_ms << " ms" << std::endl;
+    std::cout << "Gridsynth time: " << result.elapsed_ms << " ms" << std::endl;
 
     // Print results
     std::cout << std::endl;
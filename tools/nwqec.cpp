@@ -1,5 +1,8 @@
 #include "nwqec/parser/qasm_parser.hpp"
+#include "nwqec/parser/circuit_binary.hpp"
 #include "nwqec/core/transpiler.hpp"
+#include "nwqec/core/circuit_generators.hpp"
+#include "nwqec/core/socket_synthesis_backend.hpp"
 
 #include <iostream>
 #include <sstream>
@@ -10,6 +13,7 @@
 #include <filesystem>
 #include <cmath>
 #include <fstream>
+#include <limits>
 
 // PROJECT_ROOT_DIR is defined by CMake during compilation
 // This fallback is for IDE IntelliSense support only
@@ -17,9 +21,6 @@
 #define PROJECT_ROOT_DIR "."
 #endif
 
-std::unique_ptr<NWQEC::Circuit> generate_qft_circuit(int n_qubits);
-std::unique_ptr<NWQEC::Circuit> generate_shor_circuit(int n_bits);
-
 int main(int argc, char *argv[])
 {
     // Parse the QASM code
@@ -33,12 +34,25 @@ int main(int argc, char *argv[])
     int shor_bits = 0;
     bool save_to_file = true;
     std::string output_filename = "";
+    bool binary_output = false;
     bool to_pbc = false;
     bool to_clifford_reduction = false;
     bool t_pauli_opt = false;
     bool remove_pauli = false;
     bool keep_ccx = false;
     bool keep_cx = false;
+    bool pbc_stream = false;
+    size_t num_threads = 0;
+    std::string synth_cache_path = "";
+    uint64_t synth_cache_max_bytes = NWQEC::DEFAULT_SYNTHESIS_CACHE_MAX_BYTES;
+    int synth_timeout_ms = 0;
+    int synth_budget_ms = 0;
+    bool synth_race = false;
+    bool use_rz_table = true;
+    size_t synth_lookahead = 0;
+    std::string synth_workers;
+    std::string dump_dir;
+    std::string trace_path;
 
     // Helper function to print usage
     auto print_usage = [&](bool detailed = false)
@@ -57,7 +71,7 @@ int main(int argc, char *argv[])
         }
 
         std::cout << "INPUT OPTIONS:" << std::endl;
-        std::cout << "  <qasm_file>           Path to QASM file to transpile" << std::endl;
+        std::cout << "  <qasm_file>           Path to QASM file to transpile (or a binary circuit from --binary)" << std::endl;
         std::cout << "  --qft <n_qubits>      Generate QFT circuit with n_qubits qubits" << std::endl;
         std::cout << "  --shor <n_bits>       Generate Shor test circuit for n_bits-bit number" << std::endl;
         std::cout << "" << std::endl;
@@ -68,6 +82,16 @@ int main(int argc, char *argv[])
         std::cout << "  --t-opt               Apply T-count optimization (works on PBC circuits)" << std::endl;
         std::cout << "  --keep-ccx            Preserve CCX gates during Clifford+T conversion" << std::endl;
         std::cout << "  --keep-cx             Preserve CX gates during PBC conversion" << std::endl;
+        std::cout << "  --pbc-stream          Convert to PBC in one forward pass with memory bounded by qubit count" << std::endl;
+        std::cout << "  --threads <n>         Worker threads for QASM parsing, RZ synthesis, PBC and Tfuse (0 = all cores, default)" << std::endl;
+        std::cout << "  --synth-cache <file>  Reuse RZ synthesis results stored in <file> across runs" << std::endl;
+        std::cout << "  --synth-cache-mb <n>  Size cap for the synthesis cache file (0 = unlimited, default 256)" << std::endl;
+        std::cout << "  --synth-timeout <ms>  Give up on an RZ angle after <ms> milliseconds (default: no limit)" << std::endl;
+        std::cout << "  --synth-budget <ms>   Give up on RZ synthesis after <ms> milliseconds in total (default: no limit)" << std::endl;
+        std::cout << "  --synth-race          Solve each angle's diophantine candidates concurrently on idle threads" << std::endl;
+        std::cout << "  --synth-lookahead <n> Solve TDGP for <n> further k levels ahead on idle threads (default: 0)" << std::endl;
+        std::cout << "  --no-rz-table         Synthesize every angle instead of using the shipped table of dyadic angles" << std::endl;
+        std::cout << "  --synth-workers <w>   Synthesize RZs on nwqec-synth-worker processes, <w> = host:port[,host:port...]" << std::endl;
         std::cout << "" << std::endl;
 
         std::cout << "ANALYSIS OPTIONS:" << std::endl;
@@ -76,7 +100,10 @@ int main(int argc, char *argv[])
 
         std::cout << "OUTPUT OPTIONS:" << std::endl;
         std::cout << "  --no-save             Don't save transpiled circuit to file" << std::endl;
+        std::cout << "  --dump-dir <dir>      Write debug dumps (the --t-opt optimized circuit) into <dir>" << std::endl;
+        std::cout << "  --trace <file>        Write a Chrome trace (JSON) of the pass pipeline to <file>" << std::endl;
         std::cout << "  -o <file>             Specify output filename for transpiled circuit" << std::endl;
+        std::cout << "  --binary              Save in the compact binary circuit format instead of QASM" << std::endl;
         std::cout << "" << std::endl;
 
         std::cout << "OTHER OPTIONS:" << std::endl;
@@ -110,6 +137,9 @@ int main(int argc, char *argv[])
             std::cout << "  " << argv[0] << " circuit.qasm -o my_output.qasm" << std::endl;
             std::cout << "    Transpile and save to custom filename" << std::endl;
             std::cout << "" << std::endl;
+            std::cout << "  " << argv[0] << " circuit.qasm --pbc --binary -o stage1.nwqc" << std::endl;
+            std::cout << "    Save a binary circuit for a later run to load without re-parsing QASM" << std::endl;
+            std::cout << "" << std::endl;
             std::cout << "WORKFLOW:" << std::endl;
             std::cout << "  1. Basic processing: decompose → remove trivial RZ → synthesize RZ" << std::endl;
             std::cout << "  2. Choose format: Clifford+T (default), PBC, or Clifford Reduction" << std::endl;
@@ -120,8 +150,10 @@ int main(int argc, char *argv[])
             std::cout << "  - T-optimization (--t-opt) works on PBC circuits (combine with --pbc or use alone)" << std::endl;
             std::cout << "  - CCX preservation (--keep-ccx) applies to Clifford+T conversion" << std::endl;
             std::cout << "  - CX preservation (--keep-cx) applies to PBC conversion" << std::endl;
+            std::cout << "  - Streaming PBC (--pbc-stream) gives the same output without a tableau over every T gate" << std::endl;
             std::cout << "  - Clifford Reduction (--cr) optimizes circuit depth while preserving parallelism" << std::endl;
-            std::cout << "  - Output files use '_transpiled.qasm' suffix by default" << std::endl;
+            std::cout << "  - Output files use '_transpiled.qasm' suffix by default ('_transpiled.nwqc' with --binary)" << std::endl;
+            std::cout << "  - Binary circuit inputs are recognized by their header, whatever the file name" << std::endl;
         }
     };
 
@@ -217,6 +249,11 @@ int main(int argc, char *argv[])
             save_to_file = false;
             std::cout << "File saving disabled" << std::endl;
         }
+        else if (arg == "--binary")
+        {
+            binary_output = true;
+            std::cout << "Binary output enabled" << std::endl;
+        }
         else if (arg == "-o")
         {
             if (arg_index + 1 >= argc)
@@ -269,6 +306,180 @@ int main(int argc, char *argv[])
             keep_cx = true;
             std::cout << "CX gate preservation enabled" << std::endl;
         }
+        else if (arg == "--pbc-stream")
+        {
+            pbc_stream = true;
+            std::cout << "Streaming PBC conversion enabled" << std::endl;
+        }
+        else if (arg == "--threads")
+        {
+            if (arg_index + 1 >= argc)
+            {
+                std::cout << "Error: --threads requires number of threads" << std::endl;
+                std::cout << "Usage: --threads <n>" << std::endl;
+                return 1;
+            }
+            arg_index++;
+            try
+            {
+                int threads = std::stoi(argv[arg_index]);
+                if (threads < 0)
+                {
+                    std::cout << "Error: number of threads must be non-negative, got: " << threads << std::endl;
+                    return 1;
+                }
+                num_threads = static_cast<size_t>(threads);
+            }
+            catch (const std::exception &e)
+            {
+                std::cout << "Error: invalid number of threads: '" << argv[arg_index] << "' (must be a non-negative integer)" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--synth-cache")
+        {
+            if (arg_index + 1 >= argc)
+            {
+                std::cout << "Error: --synth-cache requires a cache filename" << std::endl;
+                std::cout << "Usage: --synth-cache <file>" << std::endl;
+                return 1;
+            }
+            arg_index++;
+            synth_cache_path = argv[arg_index];
+            std::cout << "Synthesis cache set to: " << synth_cache_path << std::endl;
+        }
+        else if (arg == "--dump-dir")
+        {
+            if (arg_index + 1 >= argc)
+            {
+                std::cout << "Error: --dump-dir requires a directory" << std::endl;
+                std::cout << "Usage: --dump-dir <dir>" << std::endl;
+                return 1;
+            }
+            arg_index++;
+            dump_dir = argv[arg_index];
+        }
+        else if (arg == "--trace")
+        {
+            if (arg_index + 1 >= argc)
+            {
+                std::cout << "Error: --trace requires a filename" << std::endl;
+                std::cout << "Usage: --trace <file>" << std::endl;
+                return 1;
+            }
+            arg_index++;
+            trace_path = argv[arg_index];
+            std::cout << "Pass trace written to: " << trace_path << std::endl;
+        }
+        else if (arg == "--synth-cache-mb")
+        {
+            if (arg_index + 1 >= argc)
+            {
+                std::cout << "Error: --synth-cache-mb requires a size in megabytes" << std::endl;
+                std::cout << "Usage: --synth-cache-mb <n>" << std::endl;
+                return 1;
+            }
+            arg_index++;
+            try
+            {
+                long long mb = std::stoll(argv[arg_index]);
+                if (mb < 0)
+                {
+                    std::cout << "Error: cache size must be non-negative, got: " << mb << std::endl;
+                    return 1;
+                }
+                if (static_cast<uint64_t>(mb) > std::numeric_limits<uint64_t>::max() >> 20)
+                {
+                    std::cout << "Error: cache size must be at most " << (std::numeric_limits<uint64_t>::max() >> 20)
+                              << " MB, got: " << mb << std::endl;
+                    return 1;
+                }
+                synth_cache_max_bytes = static_cast<uint64_t>(mb) << 20;
+            }
+            catch (const std::exception &e)
+            {
+                std::cout << "Error: invalid cache size: '" << argv[arg_index] << "' (must be a non-negative integer)" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--synth-race")
+        {
+            synth_race = true;
+        }
+        else if (arg == "--no-rz-table")
+        {
+            use_rz_table = false;
+        }
+        else if (arg == "--synth-workers")
+        {
+            if (arg_index + 1 >= argc)
+            {
+                std::cout << "Error: --synth-workers requires a list of workers" << std::endl;
+                std::cout << "Usage: --synth-workers <host:port>[,<host:port>...]" << std::endl;
+                return 1;
+            }
+            arg_index++;
+            try
+            {
+                NWQEC::SocketSynthesisBackend::parse_endpoints(argv[arg_index]);
+            }
+            catch (const std::invalid_argument &e)
+            {
+                std::cout << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+            synth_workers = argv[arg_index];
+        }
+        else if (arg == "--synth-lookahead")
+        {
+            if (arg_index + 1 >= argc)
+            {
+                std::cout << "Error: --synth-lookahead requires a number of levels" << std::endl;
+                std::cout << "Usage: --synth-lookahead <n>" << std::endl;
+                return 1;
+            }
+            arg_index++;
+            try
+            {
+                int levels = std::stoi(argv[arg_index]);
+                if (levels < 0)
+                {
+                    std::cout << "Error: look-ahead must be non-negative, got: " << levels << std::endl;
+                    return 1;
+                }
+                synth_lookahead = static_cast<size_t>(levels);
+            }
+            catch (const std::exception &e)
+            {
+                std::cout << "Error: invalid look-ahead: '" << argv[arg_index] << "' (must be a non-negative integer)" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--synth-timeout" || arg == "--synth-budget")
+        {
+            if (arg_index + 1 >= argc)
+            {
+                std::cout << "Error: " << arg << " requires a time in milliseconds" << std::endl;
+                std::cout << "Usage: " << arg << " <ms>" << std::endl;
+                return 1;
+            }
+            arg_index++;
+            try
+            {
+                int ms = std::stoi(argv[arg_index]);
+                if (ms < 0)
+                {
+                    std::cout << "Error: time limit must be non-negative, got: " << ms << std::endl;
+                    return 1;
+                }
+                (arg == "--synth-timeout" ? synth_timeout_ms : synth_budget_ms) = ms;
+            }
+            catch (const std::exception &e)
+            {
+                std::cout << "Error: invalid time limit: '" << argv[arg_index] << "' (must be a non-negative integer)" << std::endl;
+                return 1;
+            }
+        }
         else if (arg[0] == '-')
         {
             std::cout << "Error: unknown option '" << arg << "'" << std::endl;
@@ -322,6 +533,13 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    if (pbc_stream && !to_pbc)
+    {
+        std::cout << "Error: Streaming PBC conversion (--pbc-stream) requires PBC pass (--pbc)" << std::endl;
+        std::cout << "Please add --pbc flag when using --pbc-stream" << std::endl;
+        return 1;
+    }
+
     // Show configuration summary
     {
         std::cout << "\n==== Configuration Summary ====" << std::endl;
@@ -364,6 +582,26 @@ int main(int argc, char *argv[])
             options.push_back("CCX gate preservation enabled");
         if (keep_cx)
             options.push_back("CX gate preservation enabled");
+        if (pbc_stream)
+            options.push_back("Streaming PBC conversion");
+        if (num_threads > 0)
+            options.push_back("Synthesis threads: " + std::to_string(num_threads));
+        if (!synth_cache_path.empty())
+            options.push_back("Synthesis cache: " + synth_cache_path);
+        if (synth_timeout_ms > 0)
+            options.push_back("Synthesis timeout per angle: " + std::to_string(synth_timeout_ms) + " ms");
+        if (synth_budget_ms > 0)
+            options.push_back("Synthesis budget: " + std::to_string(synth_budget_ms) + " ms");
+        if (synth_race)
+            options.push_back("Diophantine race: enabled");
+        if (synth_lookahead > 0)
+            options.push_back("TDGP look-ahead: " + std::to_string(synth_lookahead) + " levels");
+        if (!synth_workers.empty())
+            options.push_back("Synthesis workers: " + synth_workers);
+        if (!dump_dir.empty())
+            options.push_back("Debug dumps: " + dump_dir);
+        if (!trace_path.empty())
+            options.push_back("Pass trace: " + trace_path);
         
         if (!options.empty()) {
             std::cout << "Options: ";
@@ -378,6 +616,8 @@ int main(int argc, char *argv[])
             std::cout << "Output: No file will be saved" << std::endl;
         else if (!output_filename.empty())
             std::cout << "Output: Custom filename: " << output_filename << std::endl;
+        if (save_to_file && binary_output)
+            std::cout << "Output: Binary circuit format" << std::endl;
         std::cout << "==============================\n"
                   << std::endl;
     }
@@ -386,23 +626,40 @@ int main(int argc, char *argv[])
     {
         // Generate QFT circuit
         std::cout << "Generating QFT circuit with " << qft_qubits << " qubits..." << std::endl;
-        circuit = generate_qft_circuit(qft_qubits);
+        circuit = NWQEC::generate_qft_circuit(qft_qubits);
         success = true; // QFT generation always succeeds
     }
     else if (generate_shor)
     {
         // Generate Shor test circuit
         std::cout << "Generating Shor test circuit for " << shor_bits << "-bit number..." << std::endl;
-        circuit = generate_shor_circuit(shor_bits);
+        circuit = NWQEC::generate_shor_circuit(shor_bits);
         success = true; // Shor generation always succeeds
     }
     else
     {
-        // Parse QASM file
-        success = parser.parse_file(qasm_file);
-        if (success)
+        if (NWQEC::is_binary_circuit_file(qasm_file))
         {
-            circuit = parser.get_circuit();
+            try
+            {
+                circuit = NWQEC::load_binary(qasm_file);
+                success = true;
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "Error: Failed to load binary circuit '" << qasm_file << "': " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            // Parse QASM file
+            parser.set_num_threads(num_threads);
+            success = parser.stream_file(qasm_file);
+            if (success)
+            {
+                circuit = parser.get_circuit();
+            }
         }
     }
 
@@ -451,6 +708,49 @@ int main(int argc, char *argv[])
         NWQEC::PassConfig config;
         config.keep_ccx = keep_ccx;
         config.keep_cx = keep_cx;
+        config.pbc_streaming = pbc_stream;
+        config.num_threads = num_threads;
+        config.synthesis_cache_path = synth_cache_path;
+        config.synthesis_cache_max_bytes = synth_cache_max_bytes;
+        config.synthesis_angle_timeout_ms = synth_timeout_ms;
+        config.synthesis_budget_ms = synth_budget_ms;
+        config.synthesis_race_diophantine = synth_race;
+        config.synthesis_speculate_k = synth_lookahead;
+        config.use_rz_table = use_rz_table;
+        if (!synth_workers.empty())
+            config.synthesis_backend = std::make_shared<NWQEC::SocketSynthesisBackend>(
+                NWQEC::SocketSynthesisBackend::parse_endpoints(synth_workers));
+        std::shared_ptr<NWQEC::AsyncFileDumpSink> dumps;
+        if (!dump_dir.empty())
+        {
+            try
+            {
+                dumps = std::make_shared<NWQEC::AsyncFileDumpSink>(dump_dir);
+            }
+            catch (const std::runtime_error &e)
+            {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+            config.debug_dump = dumps;
+        }
+        // Report where the debug dumps went, once every one is written
+        auto report_dumps = [&dumps, &dump_dir]()
+        {
+            if (!dumps)
+                return;
+            dumps->flush();
+            for (const std::string &path : dumps->failed())
+                std::cerr << "Warning: could not write debug dump " << path << std::endl;
+            if (dumps->written() != 0)
+                std::cout << "Debug dumps written to: " << dump_dir << std::endl;
+        };
+        std::shared_ptr<NWQEC::ChromeTraceObserver> trace;
+        if (!trace_path.empty())
+        {
+            trace = std::make_shared<NWQEC::ChromeTraceObserver>(trace_path);
+            config.observers.push_back(trace);
+        }
         config.silent = false;  // CLI always shows output
         
         // Choose the appropriate pass sequence based on the logical workflow
@@ -478,7 +778,21 @@ int main(int argc, char *argv[])
             passes.push_back(NWQEC::PassType::REMOVE_PAULI);
         }
         
-        circuit = transpiler.execute_passes(std::move(circuit), passes, config);
+        try
+        {
+            circuit = transpiler.execute_passes(std::move(circuit), passes, config);
+        }
+        catch (...)
+        {
+            // Keep the trace of the passes that ran, including the one that failed
+            if (trace)
+                trace->flush();
+            report_dumps();
+            throw;
+        }
+        if (trace && !trace->flush())
+            std::cerr << "Warning: could not write pass trace to " << trace_path << std::endl;
+        report_dumps();
     }
     catch (const std::exception &e)
     {
@@ -505,16 +819,16 @@ int main(int argc, char *argv[])
         }
         else if (generate_qft)
         {
-            filename = "qft_n" + std::to_string(qft_qubits) + "_transpiled.qasm";
+            filename = "qft_n" + std::to_string(qft_qubits) + (binary_output ? "_transpiled.nwqc" : "_transpiled.qasm");
         }
         else if (generate_shor)
         {
-            filename = "shor_n" + std::to_string(shor_bits) + "_transpiled.qasm";
+            filename = "shor_n" + std::to_string(shor_bits) + (binary_output ? "_transpiled.nwqc" : "_transpiled.qasm");
         }
         else
         {
             filename = qasm_file;
-            std::string post_fix = "_transpiled.qasm";
+            std::string post_fix = binary_output ? "_transpiled.nwqc" : "_transpiled.qasm";
             size_t dot_pos = filename.find_last_of('.');
             if (dot_pos != std::string::npos)
             {
@@ -525,6 +839,20 @@ int main(int argc, char *argv[])
                 filename = filename + post_fix;
             }
         }
+        if (binary_output)
+        {
+            try
+            {
+                NWQEC::save_binary(*circuit, filename);
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+            std::cout << "Saved transpiled circuit to: " << filename << std::endl;
+        }
+        else
         {
             std::ofstream outfile(filename);
             circuit->print(outfile);
@@ -552,103 +880,3 @@ int main(int argc, char *argv[])
 
     return 0;
 }
-
-// Function to generate a QFT circuit for n qubits
-std::unique_ptr<NWQEC::Circuit> generate_qft_circuit(int n_qubits)
-{
-    auto circuit = std::make_unique<NWQEC::Circuit>();
-
-    // Add quantum register
-    circuit->add_qreg("q", n_qubits);
-
-    // Generate QFT gates
-    for (int i = 0; i < n_qubits; i++)
-    {
-        // Apply Hadamard gate
-        circuit->add_operation(NWQEC::Operation(NWQEC::Operation::Type::H, {static_cast<size_t>(i)}));
-
-        // Apply controlled phase rotations
-        for (int j = i + 1; j < n_qubits; j++)
-        {
-            double angle = M_PI / std::pow(2, j - i);
-            circuit->add_operation(NWQEC::Operation(NWQEC::Operation::Type::CP,
-                                                    {static_cast<size_t>(j), static_cast<size_t>(i)}, {angle}));
-        }
-    }
-
-    // Swap qubits to reverse the order
-    for (int i = 0; i < n_qubits / 2; i++)
-    {
-        circuit->add_operation(NWQEC::Operation(NWQEC::Operation::Type::SWAP,
-                                                {static_cast<size_t>(i), static_cast<size_t>(n_qubits - 1 - i)}));
-    }
-
-    return circuit;
-}
-
-// Function to generate a Shor test circuit for n-bit numbers
-std::unique_ptr<NWQEC::Circuit> generate_shor_circuit(int n_bits)
-{
-    auto circuit = std::make_unique<NWQEC::Circuit>();
-
-    // Calculate qubits and gates based on Shor's algorithm scaling
-    int num_qubits = static_cast<int>(3 * n_bits + 0.002 * n_bits * std::log2(n_bits));
-    int num_toffolis = static_cast<int>(0.3 * std::pow(n_bits, 3) + 0.0005 * std::pow(n_bits, 3) * std::log2(n_bits));
-
-    // Add quantum register
-    circuit->add_qreg("q", num_qubits);
-
-    // Add some initialization gates (random H gates)
-    int init_gates = std::min(num_qubits / 4, 10);
-    std::srand(42); // Fixed seed for reproducible results
-    for (int i = 0; i < init_gates; i++)
-    {
-        int qubit = std::rand() % num_qubits;
-        circuit->add_operation(NWQEC::Operation(NWQEC::Operation::Type::H, {static_cast<size_t>(qubit)}));
-    }
-
-    // Generate random Toffoli gates
-    for (int i = 0; i < num_toffolis; i++)
-    {
-        // Generate three unique random qubits
-        std::vector<int> qubits;
-        while (qubits.size() < 3)
-        {
-            int qubit = std::rand() % num_qubits;
-            if (std::find(qubits.begin(), qubits.end(), qubit) == qubits.end())
-            {
-                qubits.push_back(qubit);
-            }
-        }
-
-        // Add CCX gate
-        circuit->add_operation(NWQEC::Operation(NWQEC::Operation::Type::CCX,
-                                                {static_cast<size_t>(qubits[0]),
-                                                 static_cast<size_t>(qubits[1]),
-                                                 static_cast<size_t>(qubits[2])}));
-    }
-
-    // Add inverse QFT before measurement
-    for (int i = 0; i < num_qubits / 2; i++)
-    {
-        circuit->add_operation(NWQEC::Operation(NWQEC::Operation::Type::SWAP,
-                                                {static_cast<size_t>(i), static_cast<size_t>(num_qubits - 1 - i)}));
-    }
-
-    // Apply inverse QFT gates (reverse order of forward QFT)
-    for (int i = num_qubits - 1; i >= 0; i--)
-    {
-        // Apply inverse controlled phase rotations
-        for (int j = num_qubits - 1; j > i; j--)
-        {
-            double angle = -M_PI / std::pow(2, j - i);
-            circuit->add_operation(NWQEC::Operation(NWQEC::Operation::Type::CP,
-                                                    {static_cast<size_t>(j), static_cast<size_t>(i)}, {angle}));
-        }
-
-        // Apply Hadamard gate
-        circuit->add_operation(NWQEC::Operation(NWQEC::Operation::Type::H, {static_cast<size_t>(i)}));
-    }
-
-    return circuit;
-}
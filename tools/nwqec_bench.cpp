@@ -0,0 +1,572 @@
+// Microbenchmarks and end-to-end pipeline benchmarks for NWQEC
+//
+// Each benchmark runs one warm-up iteration and then --repeat timed ones; the
+// median is what --json records and what --compare checks against a saved run.
+
+#include "nwqec/core/circuit_generators.hpp"
+#include "nwqec/core/pauli_kernels.hpp"
+#include "nwqec/core/transpiler.hpp"
+#include "nwqec/gridsynth/diophantine.hpp"
+#include "nwqec/gridsynth/gridsynth.hpp"
+#include "nwqec/gridsynth/odgp.hpp"
+#include "nwqec/parser/qasm_parser.hpp"
+#include "nwqec/tableau/htab.hpp"
+#include "nwqec/tableau/pauli_table.hpp"
+#include "nwqec/tableau/vtab.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using Type = NWQEC::Operation::Type;
+
+    // Keeps benchmark results observable so the work is not optimized away
+    volatile size_t sink = 0;
+
+    struct BenchResult
+    {
+        std::string name;
+        size_t repeats = 0;
+        double min_ms = 0.0;
+        double median_ms = 0.0;
+        double mean_ms = 0.0;
+        double items = 0.0;                               // Work items per iteration, for the rate
+        std::vector<std::pair<std::string, double>> extra; // Benchmark-specific figures of the last iteration
+    };
+
+    struct Options
+    {
+        std::string filter;
+        std::string json_path;
+        std::string compare_path;
+        double tolerance = 0.25; // Allowed median slowdown for --compare
+        size_t repeats = 5;
+        size_t num_threads = 1;
+        bool quick = false;
+    };
+
+    class Suite
+    {
+    public:
+        explicit Suite(const Options &options) : options_(options) {}
+
+        const Options &options() const { return options_; }
+
+        /**
+         * Time body, which does one iteration of items work items
+         *
+         * setup runs before every iteration, outside the timed region. body may
+         * record extra figures in the result it is given.
+         */
+        void run(const std::string &name, double items, const std::function<void()> &setup,
+                 const std::function<void(BenchResult &)> &body)
+        {
+            if (!options_.filter.empty() && name.find(options_.filter) == std::string::npos)
+                return;
+
+            BenchResult result;
+            result.name = name;
+            result.items = items;
+            std::vector<double> times;
+            for (size_t i = 0; i <= options_.repeats; ++i)
+            {
+                setup();
+                auto start = std::chrono::steady_clock::now();
+                body(result);
+                double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                if (i > 0) // The first iteration warms caches and lazily built tables
+                    times.push_back(ms);
+            }
+            std::sort(times.begin(), times.end());
+            result.repeats = times.size();
+            result.min_ms = times.front();
+            result.median_ms = times[times.size() / 2];
+            double total = 0.0;
+            for (double t : times)
+                total += t;
+            result.mean_ms = total / static_cast<double>(times.size());
+
+            std::cout << std::left << std::setw(44) << name << std::right << std::fixed << std::setprecision(3)
+                      << std::setw(12) << result.median_ms << " ms" << std::setw(12) << result.min_ms << " ms"
+                      << std::setprecision(0) << std::setw(14) << (items * 1000.0 / result.median_ms) << " /s"
+                      << std::endl;
+            results_.push_back(std::move(result));
+        }
+
+        void run(const std::string &name, double items, const std::function<void(BenchResult &)> &body)
+        {
+            run(name, items, [] {}, body);
+        }
+
+        const std::vector<BenchResult> &results() const { return results_; }
+
+    private:
+        Options options_;
+        std::vector<BenchResult> results_;
+    };
+
+    std::string json_string(const std::string &text)
+    {
+        std::string out = "\"";
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            out += c;
+        }
+        return out + "\"";
+    }
+
+    // One benchmark per line, so --compare can read a saved file back line by line
+    void write_json(std::ostream &os, const Suite &suite)
+    {
+        const auto &kernels = NWQEC::pauli_kernels();
+        os << "{\n\"context\": {\"quick\": " << (suite.options().quick ? "true" : "false")
+           << ", \"repeats\": " << suite.options().repeats << ", \"threads\": " << suite.options().num_threads
+           << ", \"hardware_threads\": " << std::thread::hardware_concurrency()
+           << ", \"pauli_kernels\": " << json_string(kernels.name) << "},\n\"benchmarks\": [";
+        const auto &results = suite.results();
+        os << std::setprecision(6);
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const BenchResult &r = results[i];
+            os << (i ? ",\n" : "\n") << "{\"name\": " << json_string(r.name) << ", \"median_ms\": " << r.median_ms
+               << ", \"min_ms\": " << r.min_ms << ", \"mean_ms\": " << r.mean_ms << ", \"repeats\": " << r.repeats
+               << ", \"items\": " << r.items << ", \"items_per_s\": " << (r.items * 1000.0 / r.median_ms);
+            for (const auto &e : r.extra)
+                os << ", " << json_string(e.first) << ": " << e.second;
+            os << "}";
+        }
+        os << "\n]\n}\n";
+    }
+
+    // name -> median_ms from a file written by write_json
+    std::map<std::string, double> read_medians(const std::string &path)
+    {
+        std::map<std::string, double> medians;
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            const std::string name_key = "{\"name\": \"";
+            const std::string median_key = "\"median_ms\": ";
+            size_t name_at = line.find(name_key);
+            size_t median_at = line.find(median_key);
+            if (name_at == std::string::npos || median_at == std::string::npos)
+                continue;
+            name_at += name_key.size();
+            const size_t name_end = line.find('"', name_at);
+            if (name_end == std::string::npos)
+                continue;
+            medians[line.substr(name_at, name_end - name_at)] = std::atof(line.c_str() + median_at + median_key.size());
+        }
+        return medians;
+    }
+
+    // Z-only rows all commute with each other
+    NWQEC::PauliOp random_pauli(size_t n_qubits, std::mt19937_64 &rng, bool z_only = false)
+    {
+        std::bernoulli_distribution bit(0.3);
+        NWQEC::PauliOp p(n_qubits);
+        p.set_phase(bit(rng));
+        for (size_t q = 0; q < n_qubits; ++q)
+        {
+            if (bit(rng) && !z_only)
+                p.add_x(q);
+            if (bit(rng))
+                p.add_z(q);
+        }
+        return p;
+    }
+
+    NWQEC::PauliTable random_table(size_t n_qubits, size_t rows, std::mt19937_64 &rng, bool z_only = false)
+    {
+        NWQEC::PauliTable table(n_qubits);
+        table.reserve(rows);
+        for (size_t i = 0; i < rows; ++i)
+            table.push_back(random_pauli(n_qubits, rng, z_only));
+        return table;
+    }
+
+    void bench_pauli(Suite &suite)
+    {
+        std::mt19937_64 rng(1);
+        const size_t rows = suite.options().quick ? 256 : 4096;
+        for (size_t n : {64, 1024})
+        {
+            NWQEC::PauliTable table = random_table(n, rows, rng);
+            const auto &kernels = NWQEC::pauli_kernels();
+            const size_t words = table.num_words();
+            const size_t probes = 64;
+            suite.run("pauli/anticommutes/n=" + std::to_string(n), static_cast<double>(probes * rows), [&](BenchResult &)
+                      {
+                          size_t count = 0;
+                          for (size_t p = 0; p < probes; ++p)
+                              for (size_t i = 0; i < rows; ++i)
+                                  count += kernels.anticommutes(table.x(p), table.z(p), table.x(i), table.z(i), words);
+                          sink = count; });
+            suite.run("pauli/g_function/n=" + std::to_string(n), static_cast<double>(rows), [&](BenchResult &)
+                      {
+                          const NWQEC::PauliOp probe = table.to_pauli_op(0);
+                          long long total = 0;
+                          for (size_t i = 0; i < rows; ++i)
+                              total += NWQEC::pauli_g_function(probe, table.to_pauli_op(i), n);
+                          sink = static_cast<size_t>(total); });
+        }
+    }
+
+    void bench_htab(Suite &suite)
+    {
+        std::mt19937_64 rng(2);
+        const size_t rows = suite.options().quick ? 256 : 2048;
+        for (size_t n : {64, 512})
+        {
+            NWQEC::PauliTable table = random_table(n, rows, rng);
+            NWQEC::PauliTable probes = random_table(n, 64, rng);
+            const std::string suffix = "/n=" + std::to_string(n);
+
+            // Commuting rows and probes, so every check scans the whole tableau
+            NWQEC::PauliTable commuting = random_table(n, rows, rng, true);
+            NWQEC::PauliTable commuting_probes = random_table(n, 64, rng, true);
+            NWQEC::HTab filled(n);
+            for (size_t i = 0; i < rows; ++i)
+                filled.add_stab(commuting.row(i));
+            suite.run("htab/commutes_with_all" + suffix, static_cast<double>(commuting_probes.size() * rows), [&](BenchResult &)
+                      {
+                          size_t count = 0;
+                          for (size_t p = 0; p < commuting_probes.size(); ++p)
+                              count += filled.commutes_with_all(commuting_probes.row(p));
+                          sink = count; });
+
+            NWQEC::HTab tab(n);
+            suite.run("htab/front_multiply_paulis" + suffix, static_cast<double>(probes.size() * rows), [&]
+                      {
+                          tab = NWQEC::HTab(n);
+                          for (size_t i = 0; i < rows; ++i)
+                              tab.add_stab(table.row(i)); },
+                      [&](BenchResult &)
+                      {
+                          tab.front_multiply_paulis(probes);
+                          sink = tab.num_rows(); });
+
+            // Rows drawn from a small pool, so the reduction has pairs to merge
+            NWQEC::PauliTable pool = random_table(n, 16, rng);
+            std::uniform_int_distribution<size_t> pick(0, pool.size() - 1);
+            std::vector<size_t> picks(rows);
+            for (size_t &p : picks)
+                p = pick(rng);
+            suite.run("htab/apply_reduction" + suffix, static_cast<double>(rows), [&]
+                      {
+                          tab = NWQEC::HTab(n);
+                          for (size_t p : picks)
+                              tab.add_stab(pool.row(p)); },
+                      [&](BenchResult &)
+                      {
+                          tab.apply_reduction();
+                          sink = tab.num_rows(); });
+        }
+    }
+
+    void bench_vtab(Suite &suite)
+    {
+        std::mt19937_64 rng(3);
+        const size_t n = suite.options().quick ? 32 : 128;
+        const size_t n_gates = suite.options().quick ? 5000 : 200000;
+        std::uniform_int_distribution<size_t> qubit(0, n - 1);
+        std::uniform_int_distribution<int> kind(0, 3);
+        std::vector<Type> gates;
+        std::vector<size_t> qa, qb;
+        std::vector<uint8_t> phases;
+        size_t n_stabs = 0;
+        for (size_t i = 0; i < n_gates; ++i)
+        {
+            const Type types[] = {Type::H, Type::S, Type::CX, Type::T};
+            Type type = types[kind(rng)];
+            size_t a = qubit(rng), b = qubit(rng);
+            if (type == Type::CX && a == b)
+                type = Type::H;
+            n_stabs += type == Type::T;
+            gates.push_back(type);
+            qa.push_back(a);
+            qb.push_back(b);
+            phases.push_back(0);
+        }
+
+        const std::string suffix = "/n=" + std::to_string(n);
+        suite.run("vtab/replay" + suffix, static_cast<double>(n_gates), [&](BenchResult &)
+                  {
+                      NWQEC::VTab tab(n, n_stabs, gates, qa, qb, phases, {}, suite.options().num_threads);
+                      sink = tab.num_rows(); });
+
+        NWQEC::VTab tab(n, n_stabs, gates, qa, qb, phases, {}, suite.options().num_threads);
+        suite.run("vtab/get_pauli_table" + suffix, static_cast<double>(tab.num_rows()), [&](BenchResult &)
+                  { sink = tab.get_pauli_table().size(); });
+    }
+
+    void bench_parser(Suite &suite)
+    {
+        auto circuit = NWQEC::generate_qft_circuit(suite.options().quick ? 32 : 256);
+        std::ostringstream qasm;
+        circuit->print(qasm);
+        const std::string text = qasm.str();
+        suite.run("parser/qasm/qft", static_cast<double>(circuit->get_operations().size()), [&](BenchResult &result)
+                  {
+                      NWQEC::QASMParser parser;
+                      parser.parse_string(text);
+                      sink = parser.get_circuit()->get_operations().size();
+                      result.extra = {{"bytes", static_cast<double>(text.size())}}; });
+    }
+
+    void bench_gridsynth(Suite &suite)
+    {
+        using namespace gridsynth;
+
+        // ODGP at the interval widths gridsynth meets for growing k
+        for (int k : {10, 16, 22})
+        {
+            OdgpSolver solver;
+            const Interval I(Float(0.25), Float(0.2505));
+            const Interval J(Float(-1.0), Float(1.0));
+            suite.run("gridsynth/odgp/k=" + std::to_string(k), 1.0, [&](BenchResult &result)
+                      {
+                          auto solutions = solver.solve_scaled(I, J, Integer(k));
+                          sink = solutions.size();
+                          result.extra = {{"solutions", static_cast<double>(solutions.size())}}; });
+        }
+
+        // Diophantine equations on doubly-positive xi; some have no solution, as in practice
+        {
+            std::mt19937_64 rng(4);
+            const size_t count = suite.options().quick ? 16 : 200;
+            std::uniform_int_distribution<long long> a_dist(1LL << 24, 1LL << 25);
+            std::vector<DRootTwo> xis;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const long long a = a_dist(rng);
+                std::uniform_int_distribution<long long> b_dist(-a / 2, a / 2);
+                xis.emplace_back(ZRootTwo(Integer(a), Integer(b_dist(rng))), Integer(26));
+            }
+            suite.run("gridsynth/diophantine", static_cast<double>(count), [&](BenchResult &result)
+                      {
+                          seed_rng(4);
+                          size_t solved = 0;
+                          for (const DRootTwo &xi : xis)
+                              solved += diophantine_dyadic(xi, NWQEC::DEFAULT_DIOPHANTINE_TIMEOUT_MS,
+                                                           NWQEC::DEFAULT_FACTORING_TIMEOUT_MS).has_value();
+                          sink = solved;
+                          result.extra = {{"solved", static_cast<double>(solved)}}; });
+        }
+
+        // Whole syntheses; the stage split covers grid operator search, TDGP and diophantine solving
+        std::vector<std::string> thetas = {"0.1", "0.7", "1.3", "-2.1", "2.9", "0.0123", "-0.5", "1.9"};
+        if (suite.options().quick)
+            thetas.resize(2);
+        std::vector<std::string> epsilons = {"1e-4", "1e-10"};
+        if (!suite.options().quick)
+            epsilons.push_back("1e-20");
+        for (const std::string &epsilon : epsilons)
+        {
+            BatchOptions options;
+            options.num_threads = suite.options().num_threads;
+            suite.run("gridsynth/synthesize/eps=" + epsilon, static_cast<double>(thetas.size()), [&](BenchResult &result)
+                      {
+                          auto results = gridsynth_batch(thetas, epsilon, options);
+                          double upright = 0.0, tdgp = 0.0, diophantine = 0.0, t_count = 0.0, calls = 0.0;
+                          for (const auto &r : results)
+                          {
+                              upright += r.to_upright_ms;
+                              tdgp += r.tdgp_ms;
+                              diophantine += r.diophantine_ms;
+                              calls += r.diophantine_calls;
+                              t_count += static_cast<double>(std::count(r.gates.begin(), r.gates.end(), 'T'));
+                          }
+                          sink = results.size();
+                          result.extra = {{"to_upright_ms", upright}, {"tdgp_ms", tdgp}, {"diophantine_ms", diophantine},
+                                          {"diophantine_calls", calls}, {"t_count", t_count}}; });
+        }
+    }
+
+    void bench_pipelines(Suite &suite)
+    {
+        const std::vector<std::pair<std::string, const std::vector<NWQEC::PassType> *>> sequences = {
+            {"TO_CLIFFORD_T", &NWQEC::PassSequences::TO_CLIFFORD_T},
+            {"TO_PBC", &NWQEC::PassSequences::TO_PBC},
+            {"TO_PBC_OPTIMIZED", &NWQEC::PassSequences::TO_PBC_OPTIMIZED},
+            {"TO_CLIFFORD_REDUCTION", &NWQEC::PassSequences::TO_CLIFFORD_REDUCTION},
+        };
+        // qft_n18 is the circuit behind the gridsynth speed-up quoted in the README
+        const std::vector<int> qft = suite.options().quick ? std::vector<int>{8} : std::vector<int>{18, 64};
+        const int shor = suite.options().quick ? 3 : 8;
+        const std::vector<std::pair<std::string, std::unique_ptr<NWQEC::Circuit>>> circuits = [&]
+        {
+            std::vector<std::pair<std::string, std::unique_ptr<NWQEC::Circuit>>> list;
+            for (int n : qft)
+                list.emplace_back("qft_n" + std::to_string(n), NWQEC::generate_qft_circuit(n));
+            list.emplace_back("shor_n" + std::to_string(shor), NWQEC::generate_shor_circuit(shor));
+            return list;
+        }();
+
+        NWQEC::PassConfig config;
+        config.num_threads = suite.options().num_threads;
+        config.silent = true;
+        for (const auto &circuit : circuits)
+        {
+            for (const auto &sequence : sequences)
+            {
+                suite.run("pipeline/" + sequence.first + "/" + circuit.first,
+                          static_cast<double>(circuit.second->get_operations().size()), [&](BenchResult &result)
+                          {
+                              NWQEC::Transpiler transpiler;
+                              auto out = transpiler.execute_passes(std::make_unique<NWQEC::Circuit>(*circuit.second),
+                                                                   *sequence.second, config);
+                              sink = out->get_operations().size();
+                              result.extra = {{"ops_out", static_cast<double>(out->get_operations().size())},
+                                              {"synthesis_ms", transpiler.synthesis_stats().elapsed_ms}}; });
+            }
+
+            // Tfuse on its own, from the PBC form it expects
+            NWQEC::Transpiler transpiler;
+            auto pbc = transpiler.execute_passes(std::make_unique<NWQEC::Circuit>(*circuit.second),
+                                                 NWQEC::PassSequences::TO_PBC, config);
+            suite.run("pipeline/T_OPTIMIZATION_ONLY/" + circuit.first, static_cast<double>(pbc->get_operations().size()),
+                      [&](BenchResult &)
+                      {
+                          NWQEC::Transpiler t;
+                          sink = t.execute_passes(std::make_unique<NWQEC::Circuit>(*pbc),
+                                                  NWQEC::PassSequences::T_OPTIMIZATION_ONLY, config)
+                                     ->get_operations()
+                                     .size(); });
+        }
+    }
+
+    void print_usage(const char *program)
+    {
+        std::cout << "Usage: " << program << " [options]\n"
+                  << "  --filter <text>     Only run benchmarks whose name contains <text>\n"
+                  << "  --repeat <n>        Timed iterations per benchmark after one warm-up (default 5)\n"
+                  << "  --threads <n>       Worker threads for VTab, synthesis and pipelines (default 1, 0 = all cores)\n"
+                  << "  --quick             Small sizes, for smoke tests\n"
+                  << "  --json <file>       Write the results as JSON\n"
+                  << "  --compare <file>    Compare medians with a previous --json run; exit 2 on a regression\n"
+                  << "  --tolerance <x>     Allowed slowdown for --compare as a fraction (default 0.25)\n";
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        auto value = [&](const char *what) -> std::string
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Error: " << arg << " requires " << what << std::endl;
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        try
+        {
+            if (arg == "-h" || arg == "--help")
+            {
+                print_usage(argv[0]);
+                return 0;
+            }
+            else if (arg == "--filter")
+                options.filter = value("a name fragment");
+            else if (arg == "--repeat")
+                options.repeats = std::max(1, std::stoi(value("a count")));
+            else if (arg == "--threads")
+                options.num_threads = static_cast<size_t>(std::stoul(value("a thread count")));
+            else if (arg == "--quick")
+                options.quick = true;
+            else if (arg == "--json")
+                options.json_path = value("a filename");
+            else if (arg == "--compare")
+                options.compare_path = value("a filename");
+            else if (arg == "--tolerance")
+                options.tolerance = std::stod(value("a fraction"));
+            else
+            {
+                std::cerr << "Error: unknown option " << arg << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        }
+        catch (const std::exception &)
+        {
+            std::cerr << "Error: invalid value for " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << std::left << std::setw(44) << "Benchmark" << std::right << std::setw(15) << "Median"
+              << std::setw(15) << "Min" << std::setw(17) << "Rate" << std::endl;
+    std::cout << std::string(91, '-') << std::endl;
+
+    Suite suite(options);
+    bench_pauli(suite);
+    bench_htab(suite);
+    bench_vtab(suite);
+    bench_parser(suite);
+    bench_gridsynth(suite);
+    bench_pipelines(suite);
+
+    if (!options.json_path.empty())
+    {
+        std::ofstream file(options.json_path);
+        if (!file)
+        {
+            std::cerr << "Error: cannot write " << options.json_path << std::endl;
+            return 1;
+        }
+        write_json(file, suite);
+        std::cout << "Results written to: " << options.json_path << std::endl;
+    }
+
+    if (!options.compare_path.empty())
+    {
+        const std::map<std::string, double> baseline = read_medians(options.compare_path);
+        if (baseline.empty())
+        {
+            std::cerr << "Error: no benchmark results in " << options.compare_path << std::endl;
+            return 1;
+        }
+        size_t regressions = 0;
+        std::cout << "\n---- Comparison with " << options.compare_path << " ----" << std::endl;
+        for (const BenchResult &r : suite.results())
+        {
+            auto it = baseline.find(r.name);
+            if (it == baseline.end() || it->second <= 0.0)
+                continue;
+            const double ratio = r.median_ms / it->second;
+            const bool regressed = ratio > 1.0 + options.tolerance;
+            regressions += regressed;
+            std::cout << std::left << std::setw(44) << r.name << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(8) << ratio << "x" << (regressed ? "  REGRESSION" : "") << std::endl;
+        }
+        if (regressions > 0)
+        {
+            std::cout << regressions << " benchmark(s) slower than the baseline by more than "
+                      << static_cast<int>(options.tolerance * 100) << "%" << std::endl;
+            return 2;
+        }
+    }
+    return 0;
+}
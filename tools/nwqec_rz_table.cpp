@@ -0,0 +1,181 @@
+// Generates the table of precomputed RZ sequences shipped as data/rz_table.nwqt
+//
+// Every entry is produced by the same gridsynth_batch call SynthesizeRzPass
+// makes, from the same theta and epsilon strings, so a table hit returns
+// exactly what the pass would have synthesized.
+
+#include "nwqec/core/angle_table.hpp"
+#include "nwqec/core/constants.hpp"
+#include "nwqec/core/rz_table.hpp"
+#include "nwqec/gridsynth/gridsynth.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        int max_m = 24;  // Largest m of the ±π/2^m and ±3π/2^m angles
+        int full_m = 6;  // Every odd k·π/2^m in (-2π, 2π) up to this m
+        std::vector<double> epsilons = {1e-3, 1e-4, 1e-6, 1e-8, 1e-10}; // Fixed tolerances, as for epsilon_override
+        size_t num_threads = 0;
+        std::string output = "rz_table.nwqt";
+    };
+
+    void print_usage(const char *program)
+    {
+        std::cout << "Usage: " << program << " [OPTIONS]\n\n"
+                  << "Synthesize the dyadic RZ angles k*pi/2^m into a table for RzTable.\n\n"
+                  << "OPTIONS:\n"
+                  << "  --max-m <m>       Include +-pi/2^m and +-3pi/2^m up to this m (default: 24)\n"
+                  << "  --full-m <m>      Include every odd k*pi/2^m with |angle| < 2pi up to this m (default: 6)\n"
+                  << "  --eps <list>      Comma-separated fixed tolerances, besides the default relative one\n"
+                  << "                    (default: 1e-3,1e-4,1e-6,1e-8,1e-10)\n"
+                  << "  --threads <n>     Worker threads (0 = all cores, default)\n"
+                  << "  -o <file>         Output file (default: rz_table.nwqt)\n"
+                  << "  -h, --help        Show this help message\n";
+    }
+
+    bool parse_options(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if (arg == "-h" || arg == "--help")
+            {
+                print_usage(argv[0]);
+                std::exit(0);
+            }
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Error: unknown option or missing value: " << arg << std::endl;
+                return false;
+            }
+            const std::string value = argv[++i];
+            try
+            {
+                if (arg == "--max-m")
+                    options.max_m = std::stoi(value);
+                else if (arg == "--full-m")
+                    options.full_m = std::stoi(value);
+                else if (arg == "--threads")
+                    options.num_threads = static_cast<size_t>(std::stoul(value));
+                else if (arg == "-o")
+                    options.output = value;
+                else if (arg == "--eps")
+                {
+                    options.epsilons.clear();
+                    std::istringstream list(value);
+                    std::string item;
+                    while (std::getline(list, item, ','))
+                        if (!item.empty())
+                            options.epsilons.push_back(std::stod(item));
+                }
+                else
+                {
+                    std::cerr << "Error: unknown option: " << arg << std::endl;
+                    return false;
+                }
+            }
+            catch (const std::exception &)
+            {
+                std::cerr << "Error: invalid value for " << arg << ": '" << value << "'" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The dyadic angles a circuit passes to SynthesizeRzPass unchanged
+    std::vector<double> direct_angles(const Options &options)
+    {
+        std::vector<double> angles;
+        for (int m = 1; m <= std::max(options.full_m, options.max_m); ++m)
+        {
+            const long long limit = 1LL << (m + 1); // |k·π/2^m| < 2π
+            for (long long k = 1; k < limit; k += 2)
+            {
+                if (m > options.full_m && k != 1 && k != 3)
+                    continue;
+                const double angle = static_cast<double>(k) * M_PI / std::ldexp(1.0, m);
+                angles.push_back(angle);
+                angles.push_back(-angle);
+            }
+        }
+        return angles;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parse_options(argc, argv, options))
+        return 1;
+
+    // (theta, epsilon) exactly as SynthesizeRzPass formats them: each angle at the
+    // default relative tolerance and at every fixed one, both as written and at its
+    // canonical residual (what grouping merged angles are synthesized at)
+    std::set<std::pair<std::string, std::string>> requests;
+    auto request = [&requests](double angle, double epsilon)
+    {
+        if (angle != 0.0)
+            requests.emplace(NWQEC::synthesis_theta_string(angle), NWQEC::synthesis_epsilon_string(epsilon));
+    };
+    for (double angle : direct_angles(options))
+    {
+        const double residual = NWQEC::canonicalize_rz_angle(angle).residual;
+        request(angle, NWQEC::DEFAULT_EPSILON_MULTIPLIER * std::abs(angle));
+        request(residual, NWQEC::DEFAULT_EPSILON_MULTIPLIER * residual);
+        for (double epsilon : options.epsilons)
+        {
+            request(angle, epsilon);
+            request(residual, epsilon);
+        }
+    }
+
+    std::vector<std::string> thetas, epsilons;
+    for (const auto &entry : requests)
+    {
+        thetas.push_back(entry.first);
+        epsilons.push_back(entry.second);
+    }
+
+    gridsynth::BatchOptions batch_options;
+    batch_options.num_threads = options.num_threads;
+    const auto start = std::chrono::steady_clock::now();
+    const auto results = gridsynth::gridsynth_batch(thetas, epsilons, batch_options);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<NWQEC::RzTable::Entry> entries;
+    size_t failed = 0;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        if (!results[i].success)
+        {
+            ++failed;
+            continue;
+        }
+        entries.push_back({thetas[i], epsilons[i], results[i].gates});
+    }
+
+    if (!NWQEC::RzTable::write(options.output, std::move(entries)))
+    {
+        std::cerr << "Error: could not write " << options.output << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << (results.size() - failed) << " sequences to " << options.output << " in "
+              << seconds << " s";
+    if (failed > 0)
+        std::cout << " (" << failed << " angles failed and were left out)";
+    std::cout << std::endl;
+    return 0;
+}
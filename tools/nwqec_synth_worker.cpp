@@ -0,0 +1,123 @@
+// RZ synthesis worker for SocketSynthesisBackend (nwqec-cli --synth-workers)
+//
+// Answers batches of angles with gridsynth_batch on all of the node's
+// threads. Start one per node; every client connection is served on its
+// own thread until the client closes it. Requests are not authenticated,
+// so the worker only listens on loopback unless --bind says otherwise.
+
+#include "nwqec/core/socket_synthesis_backend.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    struct Options
+    {
+        std::string bind = "127.0.0.1";
+        int port = 7733;
+        size_t num_threads = 0;
+    };
+
+    void print_usage(const char *program)
+    {
+        std::cout << "Usage: " << program << " [OPTIONS]\n\n"
+                  << "Synthesize RZ angles for nwqec-cli --synth-workers host:port,...\n\n"
+                  << "OPTIONS:\n"
+                  << "  --bind <addr>     Address to listen on (default: 127.0.0.1; 0.0.0.0 or :: for all\n"
+                  << "                    interfaces, on trusted networks only)\n"
+                  << "  --port <p>        TCP port to listen on (0 = any free port, default: 7733)\n"
+                  << "  --threads <n>     Synthesis threads per batch (0 = all cores, default)\n"
+                  << "  -h, --help        Show this help message\n";
+    }
+
+    bool parse_options(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if (arg == "-h" || arg == "--help")
+            {
+                print_usage(argv[0]);
+                std::exit(0);
+            }
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Error: unknown option or missing value: " << arg << std::endl;
+                return false;
+            }
+            const std::string value = argv[++i];
+            try
+            {
+                if (arg == "--bind")
+                    options.bind = value;
+                else if (arg == "--port")
+                    options.port = std::stoi(value);
+                else if (arg == "--threads")
+                    options.num_threads = static_cast<size_t>(std::stoul(value));
+                else
+                {
+                    std::cerr << "Error: unknown option: " << arg << std::endl;
+                    return false;
+                }
+            }
+            catch (const std::exception &)
+            {
+                std::cerr << "Error: invalid value for " << arg << ": '" << value << "'" << std::endl;
+                return false;
+            }
+        }
+        if (options.port < 0 || options.port > 65535)
+        {
+            std::cerr << "Error: --port must be between 0 and 65535" << std::endl;
+            return false;
+        }
+        return true;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parse_options(argc, argv, options))
+        return 1;
+
+    int port = 0;
+    const int listener = NWQEC::synthesis_protocol::listen_on(options.bind, options.port, port);
+    if (listener < 0)
+    {
+        std::cerr << "Error: cannot listen on " << options.bind << " port " << options.port << std::endl;
+        return 1;
+    }
+    std::cout << "nwqec-synth-worker listening on " << options.bind << " port " << port << std::endl;
+
+    while (true)
+    {
+        const int client = ::accept(listener, nullptr, nullptr);
+        if (client < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            std::cerr << "Error: accept failed: " << std::strerror(errno) << std::endl;
+            ::close(listener);
+            return 1;
+        }
+        try
+        {
+            std::thread(NWQEC::synthesis_protocol::serve_connection, client, options.num_threads).detach();
+        }
+        catch (const std::system_error &e)
+        {
+            std::cerr << "Warning: cannot serve connection: " << e.what() << std::endl;
+            ::close(client);
+        }
+    }
+}